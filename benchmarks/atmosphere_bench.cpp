@@ -0,0 +1,89 @@
+#include <cstdint>
+#include <vector>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <fmt/format.h>
+
+#include "atmosphere.hpp"
+#include "latency_histogram.hpp"
+#include "timer.hpp"
+
+using namespace void_crew;
+using namespace void_crew::server;
+
+namespace {
+
+constexpr float DT = 1.0f / 60.0f;
+constexpr float VOLUME = 40.0f;  // m^3
+constexpr float DOOR = 2.0f;     // m^3/s
+constexpr float BREACH = 1.0f;   // m^3/s, a fist-sized hole
+constexpr uint32_t SECTION = 10; // compartments between closed bulkheads
+constexpr int TICKS_PER_BREACH = 30;
+constexpr int CASCADE_TICKS = 60 * 20;
+
+struct Ship {
+    std::vector<AtmosphereLinkId> bulkheads;
+    std::vector<AtmosphereLinkId> breaches; // one per section, closed
+};
+
+/// Sections of SECTION compartments in a row with open doors between them,
+/// joined end to end by closed bulkheads. Every section has a hull panel
+/// that can breach.
+Ship buildShip(Atmosphere &atmosphere, uint32_t compartments) {
+    Ship ship;
+    for (CompartmentId id = 0; id < compartments; ++id) {
+        atmosphere.addCompartment(id, VOLUME, standardAir(VOLUME));
+        if (id == 0) {
+            continue;
+        }
+        if (id % SECTION == 0) {
+            ship.bulkheads.push_back(atmosphere.connect(id - 1, id, DOOR, false));
+        } else {
+            atmosphere.connect(id - 1, id, DOOR);
+        }
+    }
+    for (CompartmentId id = SECTION / 2; id < compartments; id += SECTION) {
+        ship.breaches.push_back(atmosphere.connectToSpace(id, BREACH, false));
+    }
+    return ship;
+}
+
+} // namespace
+
+TEST_CASE("Atmosphere at equilibrium vs during a breach cascade", "[atmosphere][benchmark]") {
+    for (uint32_t compartments : {50u, 200u, 500u, 2000u}) {
+        Atmosphere atmosphere;
+        auto ship = buildShip(atmosphere, compartments);
+        atmosphere.step(DT);
+
+        BENCHMARK(fmt::format("{} compartments: step at equilibrium", compartments)) {
+            atmosphere.step(DT);
+            return atmosphere.stats().steppedCompartments;
+        };
+
+        // Hull panels give way one after another and every other bulkhead
+        // behind them is forced open; each one regroups the graph. Timed by
+        // hand: the cascade must not be replayed from the drained end state.
+        LatencyHistogram stepTimes;
+        std::size_t solved = 0;
+        for (int tick = 0; tick < CASCADE_TICKS; ++tick) {
+            if (tick % TICKS_PER_BREACH == 0) {
+                auto section = static_cast<std::size_t>(tick / TICKS_PER_BREACH) % ship.breaches.size();
+                atmosphere.setOpen(ship.breaches[section], true);
+                if (section % 2 == 0 && section < ship.bulkheads.size()) {
+                    atmosphere.setOpen(ship.bulkheads[section], true);
+                }
+            }
+            Timer timer;
+            atmosphere.step(DT);
+            stepTimes.record(timer.elapsedSeconds());
+            solved += atmosphere.stats().steppedCompartments;
+        }
+        auto stats = atmosphere.stats();
+        fmt::print("atmosphere: {:>4} compartments, breach cascade: mean {:.2f} us, max {:.2f} us per step, "
+                   "{} compartments solved per step on average, {} of {} components active at the end\n",
+                   compartments, stepTimes.mean() * 1e6, stepTimes.max() * 1e6, solved / CASCADE_TICKS,
+                   stats.activeComponents, stats.components);
+    }
+}
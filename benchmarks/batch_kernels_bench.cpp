@@ -0,0 +1,91 @@
+#include <cstddef>
+#include <random>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+#include <fmt/format.h>
+#include <glm/glm.hpp>
+
+#include "batch_kernels.hpp"
+#include "timer.hpp"
+
+using namespace void_crew;
+
+namespace {
+
+constexpr std::size_t COUNT = 100'000;
+constexpr int PASSES = 200;
+constexpr float DT = 1.0f / 60.0f;
+
+template <typename Fn>
+double perPass(Fn &&fn) {
+    fn(); // warm-up
+    Timer timer;
+    for (int pass = 0; pass < PASSES; ++pass) {
+        fn();
+    }
+    return timer.elapsedSeconds() / PASSES;
+}
+
+} // namespace
+
+TEST_CASE("Batch kernels vs per-entity glm at 100k entities", "[simd][benchmark]") {
+    std::minstd_rand random(1);
+    std::uniform_real_distribution<float> coordinate(-200.0f, 200.0f);
+    std::vector<glm::vec3> positions(COUNT);
+    std::vector<glm::vec3> velocities(COUNT);
+    std::vector<float> lanes[6];
+    for (auto &lane : lanes) {
+        lane.resize(COUNT);
+    }
+    for (std::size_t i = 0; i < COUNT; ++i) {
+        positions[i] = {coordinate(random), coordinate(random), coordinate(random)};
+        velocities[i] = {coordinate(random), coordinate(random), coordinate(random)};
+        for (int axis = 0; axis < 3; ++axis) {
+            lanes[axis][i] = positions[i][axis];
+            lanes[axis + 3][i] = velocities[i][axis];
+        }
+    }
+    PointLanes points{lanes[0], lanes[1], lanes[2]};
+    BoxLanes boxes{lanes[0], lanes[1], lanes[2], lanes[3], lanes[4], lanes[5]};
+    const glm::vec3 center{10.0f, 0.0f, -5.0f};
+    constexpr float RADIUS = 40.0f;
+    std::vector<uint32_t> found;
+    std::vector<int32_t> fixed(COUNT);
+
+    double glmIntegrate = perPass([&] {
+        for (std::size_t i = 0; i < COUNT; ++i) {
+            positions[i] += velocities[i] * DT;
+        }
+    });
+    double glmDistance = perPass([&] {
+        found.clear();
+        for (std::size_t i = 0; i < COUNT; ++i) {
+            glm::vec3 d = positions[i] - center;
+            if (glm::dot(d, d) <= RADIUS * RADIUS) {
+                found.push_back(static_cast<uint32_t>(i));
+            }
+        }
+    });
+    fmt::print("simd: glm per entity: integrate {:.1f} us, distance cull {:.1f} us\n", glmIntegrate * 1e6,
+               glmDistance * 1e6);
+
+    for (auto level : {SimdLevel::Scalar, SimdLevel::Sse2, SimdLevel::Avx2}) {
+        if (level > detectSimdLevel()) {
+            continue;
+        }
+        setSimdLevel(level);
+        double integration = perPass([&] {
+            integrate(lanes[0], lanes[3], DT);
+            integrate(lanes[1], lanes[4], DT);
+            integrate(lanes[2], lanes[5], DT);
+        });
+        double distance = perPass([&] { withinDistance(points, center, RADIUS, found); });
+        double box = perPass([&] { overlapping(boxes, {-20.0f, -20.0f, -20.0f}, {20.0f, 20.0f, 20.0f}, found); });
+        double quantization = perPass([&] { quantize(lanes[0], 0.5f, fixed); });
+        fmt::print("simd: {:>6}: integrate {:.1f} us, distance cull {:.1f} us, box overlap {:.1f} us, "
+                   "quantize {:.1f} us\n",
+                   simdLevelName(level), integration * 1e6, distance * 1e6, box * 1e6, quantization * 1e6);
+    }
+    setSimdLevel(detectSimdLevel());
+}
@@ -0,0 +1,58 @@
+#include <cstddef>
+#include <memory_resource>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+#include <fmt/format.h>
+
+#include "frame_arena.hpp"
+#include "timer.hpp"
+
+using namespace void_crew;
+
+namespace {
+
+constexpr int TICKS = 200;
+
+// A tick's worth of transient containers: one short query result per entity,
+// the shape of perception and proximity scratch.
+std::size_t simulateTick(std::pmr::memory_resource *memory, std::size_t entities) {
+    std::size_t checksum = 0;
+    std::pmr::vector<std::pmr::vector<uint32_t>> results(memory);
+    results.reserve(entities);
+    for (std::size_t i = 0; i < entities; ++i) {
+        auto &hits = results.emplace_back();
+        for (uint32_t hit = 0; hit < 1 + i % 12; ++hit) {
+            hits.push_back(hit);
+        }
+        checksum += hits.size();
+    }
+    return checksum;
+}
+
+} // namespace
+
+TEST_CASE("Frame arena vs global heap for per-tick scratch", "[arena][benchmark]") {
+    for (std::size_t entities : {1'000u, 10'000u, 100'000u}) {
+        std::size_t checksum = 0;
+
+        Timer heapTimer;
+        for (int tick = 0; tick < TICKS; ++tick) {
+            checksum += simulateTick(std::pmr::new_delete_resource(), entities);
+        }
+        double heap = heapTimer.elapsedSeconds() / TICKS;
+
+        FrameArena arena;
+        Timer arenaTimer;
+        for (int tick = 0; tick < TICKS; ++tick) {
+            arena.reset();
+            checksum += simulateTick(&arena, entities);
+        }
+        double bump = arenaTimer.elapsedSeconds() / TICKS;
+
+        auto stats = arena.stats();
+        fmt::print("arena: {:>6} entities: heap {:.3f} ms/tick, arena {:.3f} ms/tick ({:.1f}x), "
+                   "high water {} KiB, {} overflows (checksum {})\n",
+                   entities, heap * 1e3, bump * 1e3, heap / bump, stats.highWater / 1024, stats.overflows, checksum);
+    }
+}
@@ -0,0 +1,77 @@
+#include <cstdint>
+#include <vector>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <entt/entt.hpp>
+#include <fmt/format.h>
+
+#include "components.hpp"
+#include "delta_snapshot.hpp"
+#include "interest_manager.hpp"
+
+using namespace void_crew;
+using namespace void_crew::server;
+
+namespace {
+
+constexpr uint32_t COMPARTMENTS = 100;
+constexpr uint32_t ENTITIES_PER_COMPARTMENT = 100;
+constexpr uint32_t CLIENTS = 12;
+
+/// A ship of COMPARTMENTS compartments in a ring; every fourth door is
+/// closed, so each viewer sees a handful of compartments.
+std::vector<entt::entity> buildShip(entt::registry &registry) {
+    uint32_t id = 1;
+    for (CompartmentId c = 0; c < COMPARTMENTS; ++c) {
+        for (uint32_t i = 0; i < ENTITIES_PER_COMPARTMENT; ++i) {
+            auto entity = registry.create();
+            registry.emplace<NetworkId>(entity, id++);
+            registry.emplace<Transform>(entity, Transform{{static_cast<float>(c), static_cast<float>(i), 0.0f}});
+            registry.emplace<InCompartment>(entity, c);
+        }
+        registry.emplace<Door>(registry.create(), c, (c + 1) % COMPARTMENTS, c % 4 != 3);
+    }
+
+    std::vector<entt::entity> viewers;
+    for (uint32_t client = 0; client < CLIENTS; ++client) {
+        auto viewer = registry.create();
+        registry.emplace<NetworkId>(viewer, id++);
+        registry.emplace<Transform>(viewer);
+        registry.emplace<InCompartment>(viewer, client * (COMPARTMENTS / CLIENTS));
+        viewers.push_back(viewer);
+    }
+    return viewers;
+}
+
+} // namespace
+
+TEST_CASE("Compartment area of interest", "[interest][benchmark]") {
+    entt::registry registry;
+    InterestManager interest(registry);
+    auto viewers = buildShip(registry);
+    for (uint32_t client = 0; client < CLIENTS; ++client) {
+        interest.setViewer(client + 1, viewers[client]);
+    }
+
+    std::vector<ClientView> views;
+    interest.buildViews(1, views);
+    std::size_t visible = 0;
+    for (const auto &view : views) {
+        visible += view.state.entities.size();
+    }
+    fmt::print("interest: {} entities in {} compartments, {:.0f} visible per client on average\n",
+               COMPARTMENTS * ENTITIES_PER_COMPARTMENT, COMPARTMENTS,
+               static_cast<double>(visible) / static_cast<double>(CLIENTS));
+
+    BENCHMARK(fmt::format("build {} filtered views", CLIENTS)) {
+        interest.buildViews(2, views);
+        return views.size();
+    };
+
+    WorldState world;
+    BENCHMARK("capture the whole world once") {
+        captureWorldState(registry, 2, world);
+        return world.entities.size();
+    };
+}
@@ -0,0 +1,128 @@
+#include <algorithm>
+#include <cstddef>
+#include <random>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+#include <entt/entt.hpp>
+#include <fmt/format.h>
+
+#include "component_layout.hpp"
+#include "components.hpp"
+#include "timer.hpp"
+
+using namespace void_crew;
+using namespace void_crew::server;
+
+namespace {
+
+constexpr float DT = 1.0f / 60.0f;
+constexpr int PASSES = 50;
+constexpr CompartmentId COMPARTMENTS = 100;
+
+// A ship-like population: half the entities move, a quarter are static
+// props with only a Transform, the rest carry a Velocity but no Transform
+// (pending spawns). Entities are created and destroyed in random order first,
+// so the pools are as shuffled as after a long session.
+void populate(entt::registry &registry, std::size_t entities) {
+    std::minstd_rand random(11);
+    std::uniform_real_distribution<float> coordinate(-100.0f, 100.0f);
+    std::vector<entt::entity> created;
+    for (std::size_t i = 0; i < entities * 5 / 4; ++i) {
+        auto entity = registry.create();
+        created.push_back(entity);
+        auto kind = random() % 4;
+        if (kind != 3) {
+            registry.emplace<Transform>(entity, Transform{{coordinate(random), coordinate(random), 0.0f}});
+            registry.emplace<InCompartment>(entity, static_cast<CompartmentId>(random() % COMPARTMENTS));
+        }
+        if (kind <= 1 || kind == 3) {
+            registry.emplace<Velocity>(entity, Velocity{{coordinate(random), 0.0f, 0.0f}});
+        }
+    }
+    std::shuffle(created.begin(), created.end(), random);
+    created.resize(entities / 4);
+    for (auto entity : created) {
+        registry.destroy(entity);
+    }
+}
+
+template <typename Fn>
+double perPass(Fn &&fn) {
+    fn(); // warm-up
+    Timer timer;
+    for (int pass = 0; pass < PASSES; ++pass) {
+        fn();
+    }
+    return timer.elapsedSeconds() / PASSES;
+}
+
+} // namespace
+
+TEST_CASE("Motion iteration: view vs owning group vs SoA lanes", "[layout][benchmark]") {
+    for (std::size_t entities : {1'000u, 10'000u, 100'000u}) {
+        entt::registry viewRegistry;
+        populate(viewRegistry, entities);
+        double view = perPass([&] {
+            for (auto [entity, transform, velocity] : viewRegistry.view<Transform, const Velocity>().each()) {
+                transform.position += velocity.linear * DT;
+            }
+        });
+
+        entt::registry groupRegistry;
+        ComponentLayout layout(groupRegistry);
+        populate(groupRegistry, entities);
+        layout.sortByCompartment();
+        double group = perPass([&] {
+            for (auto [entity, transform, velocity] : layout.motion().each()) {
+                transform.position += velocity.linear * DT;
+            }
+        });
+
+        MotionSoA lanes;
+        double gather = perPass([&] { layout.gather(lanes); });
+        double soa = perPass([&] { integratePositions(lanes, DT); });
+
+        fmt::print("layout: {:>6} entities ({} moving): view {:.1f} us, group {:.1f} us, "
+                   "SoA lanes {:.1f} us (+{:.1f} us to gather), compartment sort {:.2f} ms\n",
+                   entities, layout.motion().size(), view * 1e6, group * 1e6, soa * 1e6, gather * 1e6,
+                   layout.stats().lastSortSeconds * 1e3);
+    }
+}
+
+TEST_CASE("Kinematic step: group loop vs gather + SoA kernel + scatter", "[layout][benchmark]") {
+    // Every moved entity is patched either way so the listeners (spatial
+    // index, checksum, interest) see it; one stands in for them here.
+    struct Listener {
+        std::size_t updates = 0;
+        void onUpdate(entt::registry &, entt::entity) { ++updates; }
+    };
+
+    for (std::size_t entities : {1'000u, 10'000u, 100'000u}) {
+        entt::registry loopRegistry;
+        ComponentLayout loopLayout(loopRegistry);
+        Listener loopListener;
+        loopRegistry.on_update<Transform>().connect<&Listener::onUpdate>(loopListener);
+        populate(loopRegistry, entities);
+        loopLayout.sortByCompartment();
+        double loop = perPass([&] { loopLayout.integrateMotion(DT); });
+
+        entt::registry lanesRegistry;
+        ComponentLayout lanesLayout(lanesRegistry);
+        Listener lanesListener;
+        lanesRegistry.on_update<Transform>().connect<&Listener::onUpdate>(lanesListener);
+        populate(lanesRegistry, entities);
+        lanesLayout.sortByCompartment();
+        MotionSoA lanes;
+        double soa = perPass([&] {
+            lanesLayout.gather(lanes);
+            integratePositions(lanes, DT);
+            lanesLayout.scatterPositions(lanes);
+        });
+
+        fmt::print("kinematic step: {:>6} entities ({} moving, {} / {} patches): group loop {:.1f} us, "
+                   "gather + SoA kernel + scatter {:.1f} us\n",
+                   entities, loopLayout.motion().size(), loopListener.updates, lanesListener.updates, loop * 1e6,
+                   soa * 1e6);
+    }
+}
@@ -0,0 +1,73 @@
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <spdlog/sinks/null_sink.h>
+#include <spdlog/sinks/stdout_color_sinks.h>
+
+#include "logging.hpp"
+
+namespace {
+
+// Routes everything to a null sink so "emitted" measures formatting and
+// dispatch, not console or disk I/O.
+void installNullLogger(spdlog::level::level_enum level) {
+    spdlog::drop_all();
+    auto logger = std::make_shared<spdlog::logger>("bench", std::make_shared<spdlog::sinks::null_sink_mt>());
+    logger->set_level(level);
+    spdlog::set_default_logger(std::move(logger));
+    void_crew::refreshTagLoggers();
+}
+
+// The pre-TagLogger getLogger(): spdlog's registry lookup, creating the
+// logger on first use. TLOG_* expanded to this on every statement.
+std::shared_ptr<spdlog::logger> lookupLogger(std::string_view tag) {
+    std::string name(tag);
+    if (auto existing = spdlog::get(name)) {
+        return existing;
+    }
+    auto def = spdlog::default_logger();
+    auto& sinks = def->sinks();
+    auto logger = std::make_shared<spdlog::logger>(name, sinks.begin(), sinks.end());
+    logger->set_level(def->level());
+    spdlog::register_logger(logger);
+    return logger;
+}
+
+} // namespace
+
+// "lookup" is the pre-TagLogger expansion of TLOG_*: a spdlog::get() under
+// spdlog's registry mutex on every statement. "cached" is the current
+// TLOG_* macro.
+TEST_CASE("Tagged logging cost", "[logging][benchmark]") {
+    int tick = 0;
+
+    SECTION("filtered") {
+        installNullLogger(spdlog::level::warn);
+
+        BENCHMARK("lookup: filtered info") {
+            SPDLOG_LOGGER_INFO(lookupLogger("bench"), "tick {}", ++tick);
+        };
+        BENCHMARK("cached: filtered info") {
+            TLOG_INFO("bench", "tick {}", ++tick);
+        };
+    }
+
+    SECTION("emitted") {
+        installNullLogger(spdlog::level::info);
+
+        BENCHMARK("lookup: emitted info") {
+            SPDLOG_LOGGER_INFO(lookupLogger("bench"), "tick {}", ++tick);
+        };
+        BENCHMARK("cached: emitted info") {
+            TLOG_INFO("bench", "tick {}", ++tick);
+        };
+    }
+
+    spdlog::drop_all();
+    spdlog::set_default_logger(
+        std::make_shared<spdlog::logger>("default", std::make_shared<spdlog::sinks::stdout_color_sink_mt>()));
+    void_crew::refreshTagLoggers();
+}
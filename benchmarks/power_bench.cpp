@@ -0,0 +1,88 @@
+#include <cstddef>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <entt/entt.hpp>
+#include <fmt/format.h>
+
+#include "power_grid.hpp"
+
+using namespace void_crew::server;
+
+namespace {
+
+constexpr std::size_t FANOUT = 8;     // feeders per distribution panel
+constexpr float DEMAND = 100.0f;      // W per consumer
+constexpr float PANEL_RATING = 1e12f; // breakers that never trip, but are still checked
+
+/// A reactor feeding a tree of @p nodes panels and consumers, FANOUT wide.
+/// Every node draws power; panels with feeders below them have a breaker.
+std::vector<entt::entity> buildGrid(entt::registry &registry, std::size_t nodes, std::minstd_rand &random) {
+    std::uniform_int_distribution<int> priority(0, static_cast<int>(POWER_PRIORITIES) - 1);
+    std::vector<entt::entity> entities;
+    entities.reserve(nodes);
+    auto reactor = registry.create();
+    registry.emplace<PowerSource>(reactor, PowerSource{DEMAND * static_cast<float>(nodes)});
+    entities.push_back(reactor);
+    for (std::size_t i = 1; i < nodes; ++i) {
+        auto entity = registry.create();
+        bool panel = i * FANOUT + 1 < nodes;
+        registry.emplace<PowerLink>(entity, PowerLink{entities[(i - 1) / FANOUT],
+                                                      panel ? PANEL_RATING : std::numeric_limits<float>::infinity()});
+        registry.emplace<PowerConsumer>(entity, PowerConsumer{DEMAND, static_cast<uint8_t>(priority(random))});
+        entities.push_back(entity);
+    }
+    return entities;
+}
+
+} // namespace
+
+TEST_CASE("Power grid: incremental updates vs full recomputation", "[power][benchmark]") {
+    for (std::size_t nodes : {100u, 1'000u, 10'000u, 50'000u}) {
+        entt::registry registry;
+        std::minstd_rand random(11);
+        auto entities = buildGrid(registry, nodes, random);
+        PowerGrid grid(registry);
+        grid.update();
+
+        // A panel two levels above the leaves: a few dozen nodes behind it.
+        auto panel = entities[(nodes - 1) / FANOUT / FANOUT];
+        BENCHMARK(fmt::format("{} nodes: flip a panel switch + update", nodes)) {
+            registry.patch<PowerLink>(panel, [](PowerLink &link) { link.closed = !link.closed; });
+            grid.update();
+            return grid.stats().propagated;
+        };
+
+        std::uniform_int_distribution<std::size_t> pick(1, nodes - 1);
+        std::uniform_real_distribution<float> demand(0.5f * DEMAND, 1.5f * DEMAND);
+        BENCHMARK(fmt::format("{} nodes: 10 demand changes + update", nodes)) {
+            for (int i = 0; i < 10; ++i) {
+                registry.patch<PowerConsumer>(entities[pick(random)],
+                                              [&](PowerConsumer &c) { c.demand = demand(random); });
+            }
+            grid.update();
+            return grid.stats().propagated;
+        };
+
+        // Shedding and un-shedding every class: scans each breaker of the grid.
+        auto reactor = entities.front();
+        BENCHMARK(fmt::format("{} nodes: reactor damaged and repaired", nodes)) {
+            registry.patch<PowerSource>(reactor, [](PowerSource &source) { source.capacity = 0.0f; });
+            grid.update();
+            registry.patch<PowerSource>(reactor, [&](PowerSource &source) {
+                source.capacity = 2.0f * DEMAND * static_cast<float>(nodes);
+            });
+            grid.update();
+            return grid.stats().passes;
+        };
+
+        BENCHMARK(fmt::format("{} nodes: full recomputation", nodes)) {
+            PowerGrid rebuilt(registry);
+            rebuilt.update();
+            return rebuilt.stats().nodes;
+        };
+    }
+}
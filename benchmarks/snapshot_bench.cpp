@@ -0,0 +1,158 @@
+#include <algorithm>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <entt/entt.hpp>
+#include <fmt/format.h>
+#include <lz4.h>
+
+#include "components.hpp"
+#include "delta_snapshot.hpp"
+#include "snapshot.hpp"
+#include "timer.hpp"
+
+using namespace void_crew;
+
+namespace {
+
+// Every entity replicated with a transform; every other one also moving.
+void populate(entt::registry& registry, std::size_t count) {
+    for (std::size_t i = 0; i < count; ++i) {
+        auto entity = registry.create();
+        auto id = static_cast<uint32_t>(i + 1);
+        registry.emplace<NetworkId>(entity, id);
+        registry.emplace<Transform>(entity, Transform{{static_cast<float>(i), 0.0f, 1.0f}});
+        if (i % 2 == 0) {
+            registry.emplace<Velocity>(entity, Velocity{{1.0f, 0.0f, 0.0f}, {}});
+        }
+    }
+}
+
+void reportSnapshotCost(std::size_t count) {
+    entt::registry registry;
+    populate(registry, count);
+    SnapshotBuilder builder;
+    builder.reserve(count);
+    builder.build(registry, 0); // warm up
+
+    constexpr int ITERATIONS = 50;
+    Timer timer;
+    std::size_t bytes = 0;
+    for (int i = 0; i < ITERATIONS; ++i) {
+        bytes = builder.build(registry, static_cast<uint64_t>(i)).size();
+    }
+    double microseconds = timer.elapsedSeconds() * 1e6 / ITERATIONS;
+    fmt::print("snapshot {:>6} entities: {:>9} bytes ({:.1f} per entity), {:>9.1f} us per build\n", count, bytes,
+               static_cast<double>(bytes) / static_cast<double>(count), microseconds);
+}
+
+/// Moves every tenth entity (a ship's crew and loose objects among static
+/// fittings) and returns the state for @p tick.
+void advance(entt::registry& registry, uint64_t tick, WorldState& state) {
+    for (auto [entity, id, transform] : registry.view<const NetworkId, Transform>().each()) {
+        if (id.value % 10 == 0) {
+            transform.position.y += 0.001f * static_cast<float>(id.value);
+        }
+    }
+    captureWorldState(registry, tick, state);
+}
+
+std::size_t lz4Size(std::span<const uint8_t> bytes, std::vector<char>& scratch) {
+    scratch.resize(static_cast<std::size_t>(LZ4_compressBound(static_cast<int>(bytes.size()))));
+    return static_cast<std::size_t>(LZ4_compress_default(reinterpret_cast<const char*>(bytes.data()), scratch.data(),
+                                                         static_cast<int>(bytes.size()),
+                                                         static_cast<int>(scratch.size())));
+}
+
+/// Per-client bytes per tick and bandwidth at the default 60 Hz for a full
+/// FlatBuffers snapshot, a full bit-packed one, and deltas against the
+/// previous tick (the steady state for a client acking every snapshot).
+void reportDeltaBandwidth(std::size_t count) {
+    entt::registry registry;
+    populate(registry, count);
+    SnapshotBuilder builder;
+    BitWriter writer;
+    std::vector<char> scratch;
+
+    WorldState baseline;
+    WorldState current;
+    advance(registry, 1, baseline);
+    advance(registry, 2, current);
+
+    auto flatBytes = builder.build(registry, 2).size();
+    auto fullBytes = encodeDelta(nullptr, current, writer).size();
+    auto delta = encodeDelta(&baseline, current, writer);
+    auto deltaBytes = delta.size();
+    auto compressedBytes = std::min(deltaBytes, lz4Size(delta, scratch));
+
+    auto kbps = [](std::size_t bytes) { return static_cast<double>(bytes) * 8.0 * 60.0 / 1000.0; };
+    fmt::print("delta {:>6} entities (10% moving): flatbuffers {:>8} B, full {:>8} B, delta {:>7} B, "
+               "delta+lz4 {:>7} B = {:>8.1f} kbit/s per client at 60 Hz ({:.1f}x less than full)\n",
+               count, flatBytes, fullBytes, deltaBytes, compressedBytes, kbps(compressedBytes),
+               static_cast<double>(flatBytes) / static_cast<double>(std::max<std::size_t>(compressedBytes, 1)));
+}
+
+} // namespace
+
+TEST_CASE("Delta snapshot size and encode cost", "[snapshot][delta][benchmark]") {
+    for (std::size_t count : {1000, 10000}) {
+        reportDeltaBandwidth(count);
+    }
+
+    entt::registry registry;
+    populate(registry, 10000);
+    WorldState baseline;
+    WorldState current;
+    advance(registry, 1, baseline);
+    advance(registry, 2, current);
+    BitWriter writer;
+    std::vector<char> scratch;
+
+    BENCHMARK("capture 10000 entities") {
+        captureWorldState(registry, 2, current);
+        return current.entities.size();
+    };
+    BENCHMARK("encode delta 10000 entities") {
+        return encodeDelta(&baseline, current, writer).size();
+    };
+    BENCHMARK("encode delta + lz4 10000 entities") {
+        return lz4Size(encodeDelta(&baseline, current, writer), scratch);
+    };
+
+    auto delta = encodeDelta(&baseline, current, writer);
+    std::vector<uint8_t> bytes(delta.begin(), delta.end());
+    WorldState decoded;
+    BENCHMARK("decode delta 10000 entities") {
+        return decodeDelta(&baseline, bytes, decoded);
+    };
+}
+
+TEST_CASE("World snapshot build and read", "[snapshot][benchmark]") {
+    for (std::size_t count : {1000, 10000, 100000}) {
+        reportSnapshotCost(count);
+    }
+
+    for (std::size_t count : {1000, 10000, 100000}) {
+        entt::registry registry;
+        populate(registry, count);
+        SnapshotBuilder builder;
+        builder.reserve(count);
+
+        BENCHMARK(fmt::format("build {} entities", count)) {
+            return builder.build(registry, 1).size();
+        };
+
+        auto bytes = builder.build(registry, 1);
+        BENCHMARK(fmt::format("verify + read {} entities", count)) {
+            const auto* snapshot = readSnapshot(bytes);
+            float sum = 0.0f;
+            for (const auto* transform : *snapshot->transforms()) {
+                sum += transform->position().x();
+            }
+            return sum;
+        };
+    }
+}
@@ -0,0 +1,125 @@
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <entt/entt.hpp>
+#include <fmt/format.h>
+
+#include "components.hpp"
+#include "spatial_index.hpp"
+
+using namespace void_crew;
+using namespace void_crew::server;
+
+namespace {
+
+constexpr float QUERY_RADIUS = 10.0f; // hearing / vision range
+constexpr std::size_t QUERY_K = 8;
+constexpr std::size_t QUERIES = 100;  // per tick: a dozen players plus AI agents
+constexpr std::size_t MOVERS = 10;    // percent of entities that move per tick
+
+/// @p count entities at roughly one per 8 m^3, the density of a crowded ship.
+std::vector<entt::entity> populate(entt::registry &registry, std::size_t count, std::minstd_rand &random) {
+    float side = 2.0f * std::cbrt(static_cast<float>(count));
+    std::uniform_real_distribution<float> coordinate(0.0f, side);
+    std::vector<entt::entity> entities;
+    entities.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        auto entity = registry.create();
+        registry.emplace<Transform>(entity,
+                                    Transform{{coordinate(random), coordinate(random), coordinate(random)}});
+        entities.push_back(entity);
+    }
+    return entities;
+}
+
+std::size_t bruteRadius(entt::registry &registry, const glm::vec3 &center, std::vector<entt::entity> &out) {
+    out.clear();
+    for (auto [entity, transform] : registry.view<const Transform>().each()) {
+        auto d = transform.position - center;
+        if (glm::dot(d, d) <= QUERY_RADIUS * QUERY_RADIUS) {
+            out.push_back(entity);
+        }
+    }
+    return out.size();
+}
+
+std::size_t bruteNearest(entt::registry &registry, const glm::vec3 &center,
+                         std::vector<std::pair<float, entt::entity>> &scratch) {
+    scratch.clear();
+    for (auto [entity, transform] : registry.view<const Transform>().each()) {
+        auto d = transform.position - center;
+        scratch.emplace_back(glm::dot(d, d), entity);
+    }
+    auto k = std::min(QUERY_K, scratch.size());
+    std::partial_sort(scratch.begin(), scratch.begin() + static_cast<std::ptrdiff_t>(k), scratch.end());
+    return k;
+}
+
+} // namespace
+
+TEST_CASE("Spatial index vs brute force", "[spatial][benchmark]") {
+    for (std::size_t count : {1'000u, 10'000u, 100'000u}) {
+        entt::registry registry;
+        std::minstd_rand random(7);
+        auto entities = populate(registry, count, random);
+        SpatialIndex index(registry);
+
+        std::vector<glm::vec3> centers;
+        for (std::size_t i = 0; i < QUERIES; ++i) {
+            centers.push_back(registry.get<Transform>(entities[i * count / QUERIES]).position);
+        }
+        std::vector<entt::entity> found;
+        std::vector<std::pair<float, entt::entity>> scratch;
+
+        BENCHMARK(fmt::format("{} entities: {} radius queries, index", count, QUERIES)) {
+            std::size_t total = 0;
+            for (const auto &center : centers) {
+                index.radius(center, QUERY_RADIUS, found);
+                total += found.size();
+            }
+            return total;
+        };
+        BENCHMARK(fmt::format("{} entities: {} radius queries, brute force", count, QUERIES)) {
+            std::size_t total = 0;
+            for (const auto &center : centers) {
+                total += bruteRadius(registry, center, found);
+            }
+            return total;
+        };
+
+        BENCHMARK(fmt::format("{} entities: {} nearest-{} queries, index", count, QUERIES, QUERY_K)) {
+            std::size_t total = 0;
+            for (const auto &center : centers) {
+                index.nearest(center, QUERY_K, found);
+                total += found.size();
+            }
+            return total;
+        };
+        BENCHMARK(fmt::format("{} entities: {} nearest-{} queries, brute force", count, QUERIES, QUERY_K)) {
+            std::size_t total = 0;
+            for (const auto &center : centers) {
+                total += bruteNearest(registry, center, scratch);
+            }
+            return total;
+        };
+
+        // Upkeep: the index pays per moved entity, a rebuild pays for the world.
+        std::uniform_real_distribution<float> step(-0.1f, 0.1f);
+        BENCHMARK(fmt::format("{} entities: move {}% through patch()", count, MOVERS)) {
+            for (std::size_t i = 0; i < count; i += 100 / MOVERS) {
+                registry.patch<Transform>(entities[i], [&](Transform &t) { t.position.x += step(random); });
+            }
+            return index.size();
+        };
+        BENCHMARK(fmt::format("{} entities: rebuild the index from scratch", count)) {
+            SpatialIndex rebuilt(registry);
+            return rebuilt.size();
+        };
+    }
+}
@@ -0,0 +1,76 @@
+#include <algorithm>
+#include <cstddef>
+#include <random>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+#include <entt/entt.hpp>
+#include <fmt/format.h>
+
+#include "components.hpp"
+#include "latency_histogram.hpp"
+#include "time_slicer.hpp"
+#include "timer.hpp"
+
+using namespace void_crew;
+using namespace void_crew::server;
+
+namespace {
+
+constexpr float DT = 1.0f / 60.0f;
+constexpr double THINK_SECONDS = 20e-6; // one behaviour tree tick with perception
+constexpr int TICKS = 120;
+
+struct Creature {};
+
+void think() {
+    Timer busy;
+    while (busy.elapsedSeconds() < THINK_SECONDS) {
+    }
+}
+
+} // namespace
+
+TEST_CASE("Time-sliced AI vs updating every creature every tick", "[slicing][benchmark]") {
+    std::vector<glm::vec3> players{{0.0f, 0.0f, 0.0f}, {40.0f, 0.0f, 10.0f}, {-30.0f, 0.0f, 25.0f}};
+    for (std::size_t creatures : {100u, 1'000u, 10'000u}) {
+        entt::registry registry;
+        std::minstd_rand random(3);
+        std::uniform_real_distribution<float> coordinate(-200.0f, 200.0f);
+        for (std::size_t i = 0; i < creatures; ++i) {
+            auto entity = registry.create();
+            registry.emplace<Creature>(entity);
+            registry.emplace<Transform>(entity, Transform{{coordinate(random), 0.0f, coordinate(random)}});
+        }
+
+        // Only the small swarm fits a tick when everyone thinks every tick.
+        if (creatures <= 1'000) {
+            LatencyHistogram ticks;
+            for (int tick = 0; tick < TICKS / 4; ++tick) {
+                Timer timer;
+                for (auto entity : registry.view<Creature>()) {
+                    static_cast<void>(entity);
+                    think();
+                }
+                ticks.record(timer.elapsedSeconds());
+            }
+            fmt::print("slicing: {:>5} creatures, every tick: mean {:.2f} ms, max {:.2f} ms\n", creatures,
+                       ticks.mean() * 1e3, ticks.max() * 1e3);
+        }
+
+        TimeSlicer slicer;
+        slicer.setFocus(players);
+        LatencyHistogram ticks;
+        float worstPending = 0.0f;
+        std::size_t processed = 0;
+        for (int tick = 0; tick < TICKS; ++tick) {
+            slicer.update<Creature>(registry, DT, [](entt::entity, float) { think(); });
+            ticks.record(slicer.stats().lastSeconds);
+            worstPending = std::max(worstPending, slicer.stats().maxPendingDt);
+            processed += slicer.stats().processed;
+        }
+        fmt::print("slicing: {:>5} creatures, sliced (2 ms): mean {:.2f} ms, max {:.2f} ms, {} per tick, "
+                   "longest wait {:.2f} s\n",
+                   creatures, ticks.mean() * 1e3, ticks.max() * 1e3, processed / TICKS, worstPending);
+    }
+}
@@ -0,0 +1,135 @@
+#include <array>
+#include <memory>
+#include <vector>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <fmt/format.h>
+
+#include "protocol.hpp"
+#include "timer.hpp"
+#include "udp_transport.hpp"
+
+using namespace void_crew::server;
+
+namespace {
+
+constexpr std::size_t SNAPSHOT_BYTES = 600; // stand-in for a per-client state update
+
+/// One server and @p clientCount clients on loopback, driven from one thread.
+/// A round is one simulated tick: every client sends a command, the server
+/// replies with a snapshot-sized message to every client, and all sides
+/// flush and receive once.
+class LoopbackHarness {
+public:
+    explicit LoopbackHarness(std::size_t clientCount)
+        : m_server({.local = Endpoint::loopback(0), .maxConnections = static_cast<uint32_t>(clientCount)},
+                   {.onConnect = [this](ConnectionId id, Endpoint) { m_serverLinks.push_back(id); },
+                    .onDisconnect = {},
+                    .onMessage = [this](ConnectionId, std::span<const std::byte>, Delivery) { ++m_commands; }}) {
+        for (std::size_t i = 0; i < clientCount; ++i) {
+            m_clients.push_back(std::make_unique<UdpTransport>(
+                TransportConfig{.local = Endpoint::loopback(0), .maxConnections = 1, .acceptConnections = false},
+                TransportCallbacks{}));
+            m_clientLinks.push_back(*m_clients.back()->connect(m_server.localEndpoint()));
+        }
+        void_crew::Timer timeout;
+        while (m_serverLinks.size() < clientCount && timeout.elapsedSeconds() < 5.0) {
+            round();
+        }
+    }
+
+    void round() {
+        std::array<std::byte, 64> command{};
+        ClientCommand input;
+        input.sequence = ++m_sequence;
+        auto commandSize = encodeCommand(input, command);
+        for (std::size_t i = 0; i < m_clients.size(); ++i) {
+            m_clients[i]->sendUnreliable(m_clientLinks[i], std::span(command).first(commandSize));
+            m_clients[i]->flush();
+        }
+
+        void_crew::Timer serverTime;
+        m_server.receive();
+        for (auto link : m_serverLinks) {
+            m_server.sendUnreliable(link, m_snapshot);
+        }
+        m_server.flush();
+        m_serverSeconds += serverTime.elapsedSeconds();
+
+        for (auto &client : m_clients) {
+            client->receive();
+        }
+    }
+
+    std::size_t clientCount() const noexcept {
+        return m_clients.size();
+    }
+
+    const UdpTransport &server() const noexcept {
+        return m_server;
+    }
+
+    double serverSeconds() const noexcept {
+        return m_serverSeconds;
+    }
+
+    uint64_t commandsReceived() const noexcept {
+        return m_commands;
+    }
+
+private:
+    UdpTransport m_server;
+    std::vector<std::unique_ptr<UdpTransport>> m_clients;
+    std::vector<ConnectionId> m_clientLinks;
+    std::vector<ConnectionId> m_serverLinks;
+    std::array<std::byte, SNAPSHOT_BYTES> m_snapshot{};
+    uint32_t m_sequence = 0;
+    uint64_t m_commands = 0;
+    double m_serverSeconds = 0.0;
+};
+
+/// Runs rounds for about a second and prints server-side throughput and cost.
+void reportThroughput(std::size_t clientCount) {
+    LoopbackHarness harness(clientCount);
+    auto before = harness.server().stats();
+    double serverBefore = harness.serverSeconds();
+
+    constexpr double DURATION = 1.0;
+    void_crew::Timer wall;
+    uint64_t rounds = 0;
+    while (wall.elapsedSeconds() < DURATION) {
+        harness.round();
+        ++rounds;
+    }
+    double elapsed = wall.elapsedSeconds();
+
+    auto after = harness.server().stats();
+    double serverSeconds = harness.serverSeconds() - serverBefore;
+    auto packets = (after.packetsSent - before.packetsSent) + (after.packetsReceived - before.packetsReceived);
+    auto calls = (after.sendCalls - before.sendCalls) + (after.receiveCalls - before.receiveCalls);
+
+    fmt::print("transport {:>2} clients: {:>8.0f} server packets/s, {:>6.2f} packets/syscall, "
+               "{:>6.2f} us server time per client per tick, {} send failures\n",
+               clientCount, static_cast<double>(packets) / elapsed,
+               calls > 0 ? static_cast<double>(packets) / static_cast<double>(calls) : 0.0,
+               serverSeconds * 1e6 / static_cast<double>(rounds * clientCount), after.sendFailures);
+}
+
+} // namespace
+
+TEST_CASE("UDP transport loopback", "[net][benchmark]") {
+    for (std::size_t clients : {12, 32, 64}) {
+        reportThroughput(clients);
+    }
+
+    LoopbackHarness twelve(12);
+    BENCHMARK("12 clients: one tick") {
+        twelve.round();
+    };
+
+    LoopbackHarness sixtyFour(64);
+    BENCHMARK("64 clients: one tick") {
+        sixtyFour.round();
+    };
+}
@@ -0,0 +1,74 @@
+#include <cstddef>
+#include <random>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+#include <entt/entt.hpp>
+#include <fmt/format.h>
+
+#include "components.hpp"
+#include "world_checksum.hpp"
+
+using namespace void_crew;
+using namespace void_crew::server;
+
+namespace {
+
+constexpr int PASSES = 200;
+constexpr double TICK_BUDGET = 1.0 / 60.0;
+
+/// Mean update() time over PASSES ticks, each first running @p tick.
+template <typename Fn>
+double perUpdate(WorldChecksum &checksum, Fn &&tick) {
+    tick(); // warm-up
+    checksum.update();
+    double total = 0.0;
+    for (int pass = 0; pass < PASSES; ++pass) {
+        tick();
+        checksum.update();
+        total += checksum.stats().lastUpdateSeconds;
+    }
+    return total / PASSES;
+}
+
+} // namespace
+
+TEST_CASE("World checksum per tick at 1k-100k entities", "[checksum][benchmark]") {
+    for (std::size_t count : {1'000, 10'000, 100'000}) {
+        entt::registry registry;
+        WorldChecksum checksum(registry);
+        checksum.track<NetworkId>("network_id");
+        checksum.track<Transform>("transform");
+        checksum.track<Velocity>("velocity");
+        checksum.track<InCompartment>("compartment");
+
+        std::minstd_rand random(3);
+        std::uniform_real_distribution<float> coordinate(-100.0f, 100.0f);
+        std::vector<entt::entity> entities;
+        for (std::size_t i = 0; i < count; ++i) {
+            auto entity = entities.emplace_back(registry.create());
+            registry.emplace<NetworkId>(entity, static_cast<uint32_t>(i));
+            registry.emplace<Transform>(entity, Transform{{coordinate(random), coordinate(random), 0.0f}});
+            registry.emplace<Velocity>(entity, Velocity{{coordinate(random), 0.0f, 0.0f}, {}});
+            registry.emplace<InCompartment>(entity, static_cast<CompartmentId>(i % 100));
+        }
+        checksum.update();
+
+        // A movement step patches Transform and Velocity of every entity that moved.
+        auto move = [&](std::size_t stride) {
+            for (std::size_t i = 0; i < entities.size(); i += stride) {
+                registry.patch<Transform>(entities[i], [](Transform &t) { t.position.x += 0.01f; });
+                registry.patch<Velocity>(entities[i], [](Velocity &v) { v.linear.x += 0.01f; });
+            }
+        };
+        double whole = perUpdate(checksum, [&] { checksum.invalidate(); });
+        double allMoved = perUpdate(checksum, [&] { move(1); });
+        double tenthMoved = perUpdate(checksum, [&] { move(10); });
+        double idle = perUpdate(checksum, [] {});
+
+        fmt::print("checksum: {:>6} entities: whole {:.1f} us, all moved {:.1f} us ({:.2f}% of a 60 Hz tick), "
+                   "10% moved {:.1f} us ({:.2f}%), idle {:.2f} us\n",
+                   count, whole * 1e6, allMoved * 1e6, allMoved / TICK_BUDGET * 100.0, tenthMoved * 1e6,
+                   tenthMoved / TICK_BUDGET * 100.0, idle * 1e6);
+    }
+}
@@ -0,0 +1,239 @@
+#include "async_log_sink.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cstdio>
+
+#include <fmt/format.h>
+
+namespace void_crew {
+
+namespace {
+
+// Upper bound on how long the writer sleeps when idle. Wake-ups from
+// producers are best-effort; this caps the latency if one is missed.
+constexpr auto WRITER_IDLE_WAIT = std::chrono::milliseconds(5);
+
+// DropLowestLevel: below-warn messages are shed once the queue is this full,
+// so the remaining headroom is reserved for warnings and errors.
+constexpr std::size_t LOW_LEVEL_FILL_NUMERATOR = 3;
+constexpr std::size_t LOW_LEVEL_FILL_DENOMINATOR = 4;
+
+constexpr std::size_t MIN_QUEUE_SIZE = 2;
+
+} // namespace
+
+std::optional<LogOverflowPolicy> parseLogOverflowPolicy(std::string_view name) {
+    if (name == "drop") {
+        return LogOverflowPolicy::Drop;
+    }
+    if (name == "block") {
+        return LogOverflowPolicy::Block;
+    }
+    if (name == "drop_lowest_level") {
+        return LogOverflowPolicy::DropLowestLevel;
+    }
+    return std::nullopt;
+}
+
+AsyncLogSink::AsyncLogSink(std::vector<spdlog::sink_ptr> sinks, const AsyncLogOptions& options)
+    : m_sinks(std::move(sinks)),
+      m_overflow(options.overflow),
+      m_flushLevel(options.flushLevel),
+      m_capacity(std::bit_ceil(std::max(options.queueSize, MIN_QUEUE_SIZE))),
+      m_mask(m_capacity - 1),
+      m_slots(std::make_unique<Slot[]>(m_capacity)) {
+    for (std::size_t i = 0; i < m_capacity; ++i) {
+        m_slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    m_writer = std::thread([this]() { writerLoop(); });
+}
+
+AsyncLogSink::~AsyncLogSink() {
+    {
+        std::lock_guard lock(m_wakeMutex);
+        m_stopping.store(true, std::memory_order_release);
+    }
+    m_wake.notify_one();
+    m_writer.join();
+}
+
+void AsyncLogSink::log(const spdlog::details::log_msg& msg) {
+    if (!hasRoomFor(msg.level)) {
+        recordDrop(msg.level);
+        return;
+    }
+
+    if (!tryEnqueue(msg)) {
+        if (m_overflow != LogOverflowPolicy::Block) {
+            recordDrop(msg.level);
+            return;
+        }
+        m_blockedWaits.fetch_add(1, std::memory_order_relaxed);
+        do {
+            wakeWriter();
+            std::this_thread::yield();
+        } while (!tryEnqueue(msg));
+    }
+
+    if (m_writerIdle.load(std::memory_order_seq_cst)) {
+        wakeWriter();
+    }
+}
+
+void AsyncLogSink::flush() {
+    auto target = m_enqueuePos.load(std::memory_order_acquire);
+    while (m_writtenPos.load(std::memory_order_acquire) < target) {
+        wakeWriter();
+        std::this_thread::yield();
+    }
+    for (auto& sink : m_sinks) {
+        sink->flush();
+    }
+}
+
+void AsyncLogSink::set_pattern(const std::string& pattern) {
+    for (auto& sink : m_sinks) {
+        sink->set_pattern(pattern);
+    }
+}
+
+void AsyncLogSink::set_formatter(std::unique_ptr<spdlog::formatter> sinkFormatter) {
+    for (auto& sink : m_sinks) {
+        sink->set_formatter(sinkFormatter->clone());
+    }
+}
+
+AsyncLogStats AsyncLogSink::stats() const noexcept {
+    AsyncLogStats result;
+    for (std::size_t i = 0; i < m_droppedByLevel.size(); ++i) {
+        result.droppedByLevel[i] = m_droppedByLevel[i].load(std::memory_order_relaxed);
+        result.dropped += result.droppedByLevel[i];
+    }
+    result.blockedWaits = m_blockedWaits.load(std::memory_order_relaxed);
+    return result;
+}
+
+std::size_t AsyncLogSink::capacity() const noexcept {
+    return m_capacity;
+}
+
+bool AsyncLogSink::tryEnqueue(const spdlog::details::log_msg& msg) {
+    auto pos = m_enqueuePos.load(std::memory_order_relaxed);
+    Slot* slot = nullptr;
+
+    for (;;) {
+        slot = &m_slots[pos & m_mask];
+        auto sequence = slot->sequence.load(std::memory_order_acquire);
+        auto diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos);
+
+        if (diff == 0) {
+            if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_seq_cst)) {
+                break;
+            }
+        } else if (diff < 0) {
+            return false; // the writer has not released this slot yet: full
+        } else {
+            pos = m_enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+
+    // log_msg only holds views into the caller's buffers; copy them into the
+    // slot. Messages within the inline buffer size reuse slot storage.
+    slot->message = spdlog::details::log_msg_buffer(msg);
+    slot->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+bool AsyncLogSink::hasRoomFor(spdlog::level::level_enum level) const noexcept {
+    if (m_overflow != LogOverflowPolicy::DropLowestLevel || level >= spdlog::level::warn) {
+        return true;
+    }
+    auto used = m_enqueuePos.load(std::memory_order_relaxed) - m_writtenPos.load(std::memory_order_relaxed);
+    return used * LOW_LEVEL_FILL_DENOMINATOR < m_capacity * LOW_LEVEL_FILL_NUMERATOR;
+}
+
+void AsyncLogSink::recordDrop(spdlog::level::level_enum level) noexcept {
+    m_droppedByLevel[static_cast<std::size_t>(level)].fetch_add(1, std::memory_order_relaxed);
+}
+
+void AsyncLogSink::wakeWriter() {
+    m_wake.notify_one();
+}
+
+void AsyncLogSink::writerLoop() {
+    bool hasUnflushed = false;
+
+    for (;;) {
+        if (writeNext()) {
+            hasUnflushed = true;
+            continue;
+        }
+
+        bool drained =
+            m_writtenPos.load(std::memory_order_relaxed) == m_enqueuePos.load(std::memory_order_seq_cst);
+        if (drained && m_stopping.load(std::memory_order_acquire)) {
+            break;
+        }
+
+        // Push a finished burst out before going idle so console and file
+        // stay current even when nothing reaches the flush level.
+        if (drained && hasUnflushed) {
+            for (auto& sink : m_sinks) {
+                sink->flush();
+            }
+            hasUnflushed = false;
+            continue;
+        }
+
+        if (!drained) {
+            // A producer claimed a slot but has not published it yet.
+            std::this_thread::yield();
+            continue;
+        }
+
+        std::unique_lock lock(m_wakeMutex);
+        m_writerIdle.store(true, std::memory_order_seq_cst);
+        if (m_enqueuePos.load(std::memory_order_seq_cst) == m_writtenPos.load(std::memory_order_relaxed) &&
+            !m_stopping.load(std::memory_order_acquire)) {
+            m_wake.wait_for(lock, WRITER_IDLE_WAIT);
+        }
+        m_writerIdle.store(false, std::memory_order_relaxed);
+    }
+
+    for (auto& sink : m_sinks) {
+        sink->flush();
+    }
+}
+
+bool AsyncLogSink::writeNext() {
+    auto pos = m_writtenPos.load(std::memory_order_relaxed);
+    auto& slot = m_slots[pos & m_mask];
+    if (slot.sequence.load(std::memory_order_acquire) != pos + 1) {
+        return false;
+    }
+
+    const auto& msg = slot.message;
+    try {
+        for (auto& sink : m_sinks) {
+            if (sink->should_log(msg.level)) {
+                sink->log(msg);
+            }
+        }
+        if (msg.level >= m_flushLevel) {
+            for (auto& sink : m_sinks) {
+                sink->flush();
+            }
+        }
+    } catch (const std::exception& e) {
+        // Nowhere left to log to; a sink failure must not kill the writer.
+        fmt::print(stderr, "[async log] sink error: {}\n", e.what());
+    }
+
+    slot.sequence.store(pos + m_capacity, std::memory_order_release);
+    m_writtenPos.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+} // namespace void_crew
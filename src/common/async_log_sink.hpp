@@ -0,0 +1,108 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <spdlog/details/log_msg_buffer.h>
+#include <spdlog/sinks/sink.h>
+
+namespace void_crew {
+
+/// What a producer does when the async log queue has no room.
+enum class LogOverflowPolicy {
+    Drop,            // discard the new message
+    Block,           // wait for the writer thread to make room
+    DropLowestLevel, // shed below-warn messages early, keep room for warn and above
+};
+
+/// Parses "drop", "block" or "drop_lowest_level". Returns nullopt otherwise.
+std::optional<LogOverflowPolicy> parseLogOverflowPolicy(std::string_view name);
+
+struct AsyncLogOptions {
+    std::size_t queueSize = 8192; // rounded up to a power of two
+    LogOverflowPolicy overflow = LogOverflowPolicy::DropLowestLevel;
+    spdlog::level::level_enum flushLevel = spdlog::level::warn;
+};
+
+/// Counters since the sink was created. Reads are relaxed snapshots.
+struct AsyncLogStats {
+    uint64_t dropped = 0;
+    std::array<uint64_t, spdlog::level::n_levels> droppedByLevel{};
+    uint64_t blockedWaits = 0; // Block policy: enqueue attempts that found the queue full
+};
+
+/// spdlog sink that hands messages to a dedicated writer thread.
+///
+/// Producers copy each message into a slot of a bounded lock-free MPSC ring
+/// (Vyukov's bounded queue) and return. The writer thread runs the wrapped
+/// sinks: pattern formatting, console and file I/O all happen there. The
+/// message text itself is still formatted by the logger on the calling thread,
+/// as with spdlog's own async logger.
+///
+/// Flush-on-level is handled by the writer thread (see AsyncLogOptions), so
+/// the owning logger should use flush_on(off). An explicit flush() blocks until
+/// everything queued before the call has been written.
+class AsyncLogSink final : public spdlog::sinks::sink {
+public:
+    AsyncLogSink(std::vector<spdlog::sink_ptr> sinks, const AsyncLogOptions& options);
+    ~AsyncLogSink() override;
+
+    AsyncLogSink(const AsyncLogSink&) = delete;
+    AsyncLogSink(AsyncLogSink&&) = delete;
+    AsyncLogSink& operator=(const AsyncLogSink&) = delete;
+    AsyncLogSink& operator=(AsyncLogSink&&) = delete;
+
+    void log(const spdlog::details::log_msg& msg) override;
+    void flush() override;
+    void set_pattern(const std::string& pattern) override;
+    void set_formatter(std::unique_ptr<spdlog::formatter> sinkFormatter) override;
+
+    AsyncLogStats stats() const noexcept;
+    std::size_t capacity() const noexcept;
+
+private:
+    struct Slot {
+        std::atomic<std::size_t> sequence{0};
+        spdlog::details::log_msg_buffer message;
+    };
+
+    bool tryEnqueue(const spdlog::details::log_msg& msg);
+    bool hasRoomFor(spdlog::level::level_enum level) const noexcept;
+    void recordDrop(spdlog::level::level_enum level) noexcept;
+    void wakeWriter();
+
+    void writerLoop();
+    bool writeNext();
+
+    std::vector<spdlog::sink_ptr> m_sinks;
+    LogOverflowPolicy m_overflow;
+    spdlog::level::level_enum m_flushLevel;
+
+    std::size_t m_capacity;
+    std::size_t m_mask;
+    std::unique_ptr<Slot[]> m_slots;
+
+    // Producers contend on the enqueue cursor; keep it off the writer's line.
+    alignas(64) std::atomic<std::size_t> m_enqueuePos{0};
+    alignas(64) std::atomic<std::size_t> m_writtenPos{0};
+
+    std::array<std::atomic<uint64_t>, spdlog::level::n_levels> m_droppedByLevel{};
+    std::atomic<uint64_t> m_blockedWaits{0};
+
+    std::mutex m_wakeMutex;
+    std::condition_variable m_wake;
+    std::atomic<bool> m_writerIdle{false};
+    std::atomic<bool> m_stopping{false};
+    std::thread m_writer;
+};
+
+} // namespace void_crew
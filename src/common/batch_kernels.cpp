@@ -0,0 +1,390 @@
+#include "batch_kernels.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cmath>
+#include <stdexcept>
+
+#include <fmt/format.h>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define VOID_CREW_SIMD_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+// GCC and Clang compile AVX2 intrinsics only inside functions marked for it;
+// MSVC accepts them anywhere. Either way nothing here runs without the check
+// in detectSimdLevel().
+#if defined(__GNUC__) || defined(__clang__)
+#define VOID_CREW_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define VOID_CREW_TARGET_AVX2
+#endif
+
+namespace void_crew {
+
+namespace {
+
+// Largest float below 2^31: quantize() clamps to it so the conversion to
+// int32 is always defined. NaN, which no clamp catches, is mapped to 0 first.
+constexpr float QUANTIZE_LIMIT = 2147483520.0f;
+
+struct Kernels {
+    void (*integrate)(float *values, const float *rates, std::size_t count, float dt);
+    std::size_t (*withinDistance)(const PointLanes &points, std::size_t count, const glm::vec3 &center,
+                                  float radiusSquared, uint32_t *out);
+    std::size_t (*overlapping)(const BoxLanes &boxes, std::size_t count, const glm::vec3 &min,
+                               const glm::vec3 &max, uint32_t *out);
+    void (*quantize)(const float *values, std::size_t count, float step, int32_t *out);
+};
+
+// --- Scalar: the reference, and the tail of every vector path ---
+
+void integrateScalar(float *values, const float *rates, std::size_t begin, std::size_t end, float dt) {
+    for (std::size_t i = begin; i < end; ++i) {
+        values[i] += rates[i] * dt;
+    }
+}
+
+std::size_t withinDistanceScalar(const PointLanes &points, std::size_t begin, std::size_t end,
+                                 const glm::vec3 &center, float radiusSquared, uint32_t *out, std::size_t found) {
+    for (std::size_t i = begin; i < end; ++i) {
+        float dx = points.x[i] - center.x;
+        float dy = points.y[i] - center.y;
+        float dz = points.z[i] - center.z;
+        if (dx * dx + dy * dy + dz * dz <= radiusSquared) {
+            out[found++] = static_cast<uint32_t>(i);
+        }
+    }
+    return found;
+}
+
+std::size_t overlappingScalar(const BoxLanes &boxes, std::size_t begin, std::size_t end, const glm::vec3 &min,
+                              const glm::vec3 &max, uint32_t *out, std::size_t found) {
+    for (std::size_t i = begin; i < end; ++i) {
+        if (boxes.minX[i] <= max.x && boxes.maxX[i] >= min.x && boxes.minY[i] <= max.y && boxes.maxY[i] >= min.y &&
+            boxes.minZ[i] <= max.z && boxes.maxZ[i] >= min.z) {
+            out[found++] = static_cast<uint32_t>(i);
+        }
+    }
+    return found;
+}
+
+// Truncate, then step away from zero when the dropped fraction is at least
+// a half: std::round without a rounding-mode dependency, and the same
+// operations the vector paths can do.
+void quantizeScalar(const float *values, std::size_t begin, std::size_t end, float step, int32_t *out) {
+    for (std::size_t i = begin; i < end; ++i) {
+        float quotient = values[i] / step;
+        float scaled = std::isnan(quotient) ? 0.0f : std::clamp(quotient, -QUANTIZE_LIMIT, QUANTIZE_LIMIT);
+        auto whole = static_cast<int32_t>(scaled);
+        float fraction = scaled - static_cast<float>(whole);
+        out[i] = whole + (fraction >= 0.5f ? 1 : 0) - (fraction <= -0.5f ? 1 : 0);
+    }
+}
+
+void integrateScalarAll(float *values, const float *rates, std::size_t count, float dt) {
+    integrateScalar(values, rates, 0, count, dt);
+}
+
+std::size_t withinDistanceScalarAll(const PointLanes &points, std::size_t count, const glm::vec3 &center,
+                                    float radiusSquared, uint32_t *out) {
+    return withinDistanceScalar(points, 0, count, center, radiusSquared, out, 0);
+}
+
+std::size_t overlappingScalarAll(const BoxLanes &boxes, std::size_t count, const glm::vec3 &min,
+                                 const glm::vec3 &max, uint32_t *out) {
+    return overlappingScalar(boxes, 0, count, min, max, out, 0);
+}
+
+void quantizeScalarAll(const float *values, std::size_t count, float step, int32_t *out) {
+    quantizeScalar(values, 0, count, step, out);
+}
+
+#ifdef VOID_CREW_SIMD_X86
+
+/// Appends the lane indices set in @p mask, lowest first.
+std::size_t appendMatches(unsigned mask, std::size_t base, uint32_t *out, std::size_t found) {
+    while (mask != 0) {
+        out[found++] = static_cast<uint32_t>(base + static_cast<std::size_t>(std::countr_zero(mask)));
+        mask &= mask - 1;
+    }
+    return found;
+}
+
+// --- SSE2: four lanes; always present on x86-64 ---
+
+void integrateSse2(float *values, const float *rates, std::size_t count, float dt) {
+    __m128 step = _mm_set1_ps(dt);
+    std::size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 value = _mm_loadu_ps(values + i);
+        _mm_storeu_ps(values + i, _mm_add_ps(value, _mm_mul_ps(_mm_loadu_ps(rates + i), step)));
+    }
+    integrateScalar(values, rates, i, count, dt);
+}
+
+std::size_t withinDistanceSse2(const PointLanes &points, std::size_t count, const glm::vec3 &center,
+                               float radiusSquared, uint32_t *out) {
+    __m128 cx = _mm_set1_ps(center.x);
+    __m128 cy = _mm_set1_ps(center.y);
+    __m128 cz = _mm_set1_ps(center.z);
+    __m128 limit = _mm_set1_ps(radiusSquared);
+    std::size_t found = 0;
+    std::size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 dx = _mm_sub_ps(_mm_loadu_ps(points.x.data() + i), cx);
+        __m128 dy = _mm_sub_ps(_mm_loadu_ps(points.y.data() + i), cy);
+        __m128 dz = _mm_sub_ps(_mm_loadu_ps(points.z.data() + i), cz);
+        __m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+        auto mask = static_cast<unsigned>(_mm_movemask_ps(_mm_cmple_ps(distance, limit)));
+        found = appendMatches(mask, i, out, found);
+    }
+    return withinDistanceScalar(points, i, count, center, radiusSquared, out, found);
+}
+
+std::size_t overlappingSse2(const BoxLanes &boxes, std::size_t count, const glm::vec3 &min, const glm::vec3 &max,
+                            uint32_t *out) {
+    __m128 loX = _mm_set1_ps(min.x);
+    __m128 loY = _mm_set1_ps(min.y);
+    __m128 loZ = _mm_set1_ps(min.z);
+    __m128 hiX = _mm_set1_ps(max.x);
+    __m128 hiY = _mm_set1_ps(max.y);
+    __m128 hiZ = _mm_set1_ps(max.z);
+    std::size_t found = 0;
+    std::size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 x = _mm_and_ps(_mm_cmple_ps(_mm_loadu_ps(boxes.minX.data() + i), hiX),
+                              _mm_cmpge_ps(_mm_loadu_ps(boxes.maxX.data() + i), loX));
+        __m128 y = _mm_and_ps(_mm_cmple_ps(_mm_loadu_ps(boxes.minY.data() + i), hiY),
+                              _mm_cmpge_ps(_mm_loadu_ps(boxes.maxY.data() + i), loY));
+        __m128 z = _mm_and_ps(_mm_cmple_ps(_mm_loadu_ps(boxes.minZ.data() + i), hiZ),
+                              _mm_cmpge_ps(_mm_loadu_ps(boxes.maxZ.data() + i), loZ));
+        auto mask = static_cast<unsigned>(_mm_movemask_ps(_mm_and_ps(_mm_and_ps(x, y), z)));
+        found = appendMatches(mask, i, out, found);
+    }
+    return overlappingScalar(boxes, i, count, min, max, out, found);
+}
+
+void quantizeSse2(const float *values, std::size_t count, float step, int32_t *out) {
+    __m128 divisor = _mm_set1_ps(step);
+    __m128 low = _mm_set1_ps(-QUANTIZE_LIMIT);
+    __m128 high = _mm_set1_ps(QUANTIZE_LIMIT);
+    __m128 half = _mm_set1_ps(0.5f);
+    __m128 minusHalf = _mm_set1_ps(-0.5f);
+    std::size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 quotient = _mm_div_ps(_mm_loadu_ps(values + i), divisor);
+        quotient = _mm_and_ps(quotient, _mm_cmpord_ps(quotient, quotient)); // NaN -> 0
+        __m128 scaled = _mm_min_ps(_mm_max_ps(quotient, low), high);
+        __m128i whole = _mm_cvttps_epi32(scaled);
+        __m128 fraction = _mm_sub_ps(scaled, _mm_cvtepi32_ps(whole));
+        // Comparison masks are all ones (-1) where true.
+        whole = _mm_sub_epi32(whole, _mm_castps_si128(_mm_cmpge_ps(fraction, half)));
+        whole = _mm_add_epi32(whole, _mm_castps_si128(_mm_cmple_ps(fraction, minusHalf)));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i), whole);
+    }
+    quantizeScalar(values, i, count, step, out);
+}
+
+// --- AVX2: eight lanes ---
+
+VOID_CREW_TARGET_AVX2 void integrateAvx2(float *values, const float *rates, std::size_t count, float dt) {
+    __m256 step = _mm256_set1_ps(dt);
+    std::size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 value = _mm256_loadu_ps(values + i);
+        _mm256_storeu_ps(values + i, _mm256_add_ps(value, _mm256_mul_ps(_mm256_loadu_ps(rates + i), step)));
+    }
+    integrateScalar(values, rates, i, count, dt);
+}
+
+VOID_CREW_TARGET_AVX2 std::size_t withinDistanceAvx2(const PointLanes &points, std::size_t count,
+                                                     const glm::vec3 &center, float radiusSquared, uint32_t *out) {
+    __m256 cx = _mm256_set1_ps(center.x);
+    __m256 cy = _mm256_set1_ps(center.y);
+    __m256 cz = _mm256_set1_ps(center.z);
+    __m256 limit = _mm256_set1_ps(radiusSquared);
+    std::size_t found = 0;
+    std::size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 dx = _mm256_sub_ps(_mm256_loadu_ps(points.x.data() + i), cx);
+        __m256 dy = _mm256_sub_ps(_mm256_loadu_ps(points.y.data() + i), cy);
+        __m256 dz = _mm256_sub_ps(_mm256_loadu_ps(points.z.data() + i), cz);
+        __m256 distance =
+            _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy)), _mm256_mul_ps(dz, dz));
+        auto mask = static_cast<unsigned>(_mm256_movemask_ps(_mm256_cmp_ps(distance, limit, _CMP_LE_OQ)));
+        found = appendMatches(mask, i, out, found);
+    }
+    return withinDistanceScalar(points, i, count, center, radiusSquared, out, found);
+}
+
+VOID_CREW_TARGET_AVX2 std::size_t overlappingAvx2(const BoxLanes &boxes, std::size_t count, const glm::vec3 &min,
+                                                  const glm::vec3 &max, uint32_t *out) {
+    __m256 loX = _mm256_set1_ps(min.x);
+    __m256 loY = _mm256_set1_ps(min.y);
+    __m256 loZ = _mm256_set1_ps(min.z);
+    __m256 hiX = _mm256_set1_ps(max.x);
+    __m256 hiY = _mm256_set1_ps(max.y);
+    __m256 hiZ = _mm256_set1_ps(max.z);
+    std::size_t found = 0;
+    std::size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 x = _mm256_and_ps(_mm256_cmp_ps(_mm256_loadu_ps(boxes.minX.data() + i), hiX, _CMP_LE_OQ),
+                                 _mm256_cmp_ps(_mm256_loadu_ps(boxes.maxX.data() + i), loX, _CMP_GE_OQ));
+        __m256 y = _mm256_and_ps(_mm256_cmp_ps(_mm256_loadu_ps(boxes.minY.data() + i), hiY, _CMP_LE_OQ),
+                                 _mm256_cmp_ps(_mm256_loadu_ps(boxes.maxY.data() + i), loY, _CMP_GE_OQ));
+        __m256 z = _mm256_and_ps(_mm256_cmp_ps(_mm256_loadu_ps(boxes.minZ.data() + i), hiZ, _CMP_LE_OQ),
+                                 _mm256_cmp_ps(_mm256_loadu_ps(boxes.maxZ.data() + i), loZ, _CMP_GE_OQ));
+        auto mask = static_cast<unsigned>(_mm256_movemask_ps(_mm256_and_ps(_mm256_and_ps(x, y), z)));
+        found = appendMatches(mask, i, out, found);
+    }
+    return overlappingScalar(boxes, i, count, min, max, out, found);
+}
+
+VOID_CREW_TARGET_AVX2 void quantizeAvx2(const float *values, std::size_t count, float step, int32_t *out) {
+    __m256 divisor = _mm256_set1_ps(step);
+    __m256 low = _mm256_set1_ps(-QUANTIZE_LIMIT);
+    __m256 high = _mm256_set1_ps(QUANTIZE_LIMIT);
+    __m256 half = _mm256_set1_ps(0.5f);
+    __m256 minusHalf = _mm256_set1_ps(-0.5f);
+    std::size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 quotient = _mm256_div_ps(_mm256_loadu_ps(values + i), divisor);
+        quotient = _mm256_and_ps(quotient, _mm256_cmp_ps(quotient, quotient, _CMP_ORD_Q)); // NaN -> 0
+        __m256 scaled = _mm256_min_ps(_mm256_max_ps(quotient, low), high);
+        __m256i whole = _mm256_cvttps_epi32(scaled);
+        __m256 fraction = _mm256_sub_ps(scaled, _mm256_cvtepi32_ps(whole));
+        whole = _mm256_sub_epi32(whole, _mm256_castps_si256(_mm256_cmp_ps(fraction, half, _CMP_GE_OQ)));
+        whole = _mm256_add_epi32(whole, _mm256_castps_si256(_mm256_cmp_ps(fraction, minusHalf, _CMP_LE_OQ)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i), whole);
+    }
+    quantizeScalar(values, i, count, step, out);
+}
+
+bool cpuHasAvx2() noexcept {
+#ifdef _MSC_VER
+    std::array<int, 4> info{};
+    __cpuid(info.data(), 0);
+    if (info[0] < 7) {
+        return false;
+    }
+    __cpuid(info.data(), 1);
+    bool osSavesYmm = (info[2] & (1 << 27)) != 0 && (info[2] & (1 << 28)) != 0 && (_xgetbv(0) & 0x6) == 0x6;
+    __cpuidex(info.data(), 7, 0);
+    return osSavesYmm && (info[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") != 0; // includes the OS check
+#endif
+}
+
+#endif // VOID_CREW_SIMD_X86
+
+constexpr std::array<Kernels, 3> KERNELS{{
+    {integrateScalarAll, withinDistanceScalarAll, overlappingScalarAll, quantizeScalarAll},
+#ifdef VOID_CREW_SIMD_X86
+    {integrateSse2, withinDistanceSse2, overlappingSse2, quantizeSse2},
+    {integrateAvx2, withinDistanceAvx2, overlappingAvx2, quantizeAvx2},
+#else
+    {integrateScalarAll, withinDistanceScalarAll, overlappingScalarAll, quantizeScalarAll},
+    {integrateScalarAll, withinDistanceScalarAll, overlappingScalarAll, quantizeScalarAll},
+#endif
+}};
+
+std::atomic<SimdLevel> &activeLevel() {
+    static std::atomic<SimdLevel> level{detectSimdLevel()};
+    return level;
+}
+
+const Kernels &kernels() {
+    return KERNELS[static_cast<std::size_t>(activeLevel().load(std::memory_order_relaxed))];
+}
+
+void requireSameLength(std::size_t expected, std::size_t actual, std::string_view what) {
+    if (actual != expected) {
+        throw std::invalid_argument(fmt::format("{} has {} elements, expected {}", what, actual, expected));
+    }
+}
+
+} // namespace
+
+SimdLevel detectSimdLevel() noexcept {
+#ifdef VOID_CREW_SIMD_X86
+    static const SimdLevel detected = cpuHasAvx2() ? SimdLevel::Avx2 : SimdLevel::Sse2;
+    return detected;
+#else
+    return SimdLevel::Scalar;
+#endif
+}
+
+SimdLevel simdLevel() noexcept {
+    return activeLevel().load(std::memory_order_relaxed);
+}
+
+void setSimdLevel(SimdLevel level) {
+    if (level > detectSimdLevel()) {
+        throw std::invalid_argument(fmt::format("SIMD level {} is not supported here (best: {})",
+                                                simdLevelName(level), simdLevelName(detectSimdLevel())));
+    }
+    activeLevel().store(level, std::memory_order_relaxed);
+}
+
+std::string_view simdLevelName(SimdLevel level) noexcept {
+    switch (level) {
+    case SimdLevel::Scalar:
+        return "scalar";
+    case SimdLevel::Sse2:
+        return "sse2";
+    case SimdLevel::Avx2:
+        return "avx2";
+    }
+    return "unknown";
+}
+
+std::optional<SimdLevel> parseSimdLevel(std::string_view name) {
+    for (auto level : {SimdLevel::Scalar, SimdLevel::Sse2, SimdLevel::Avx2}) {
+        if (name == simdLevelName(level)) {
+            return level;
+        }
+    }
+    return std::nullopt;
+}
+
+void integrate(std::span<float> values, std::span<const float> rates, float dt) {
+    requireSameLength(values.size(), rates.size(), "rates");
+    kernels().integrate(values.data(), rates.data(), values.size(), dt);
+}
+
+std::size_t withinDistance(const PointLanes &points, const glm::vec3 &center, float radius,
+                           std::vector<uint32_t> &out) {
+    std::size_t count = points.x.size();
+    requireSameLength(count, points.y.size(), "y lane");
+    requireSameLength(count, points.z.size(), "z lane");
+    out.resize(count);
+    out.resize(kernels().withinDistance(points, count, center, radius * radius, out.data()));
+    return out.size();
+}
+
+std::size_t overlapping(const BoxLanes &boxes, const glm::vec3 &min, const glm::vec3 &max,
+                        std::vector<uint32_t> &out) {
+    std::size_t count = boxes.minX.size();
+    for (auto lane : {boxes.minY, boxes.minZ, boxes.maxX, boxes.maxY, boxes.maxZ}) {
+        requireSameLength(count, lane.size(), "box lane");
+    }
+    out.resize(count);
+    out.resize(kernels().overlapping(boxes, count, min, max, out.data()));
+    return out.size();
+}
+
+void quantize(std::span<const float> values, float step, std::span<int32_t> out) {
+    requireSameLength(values.size(), out.size(), "output");
+    kernels().quantize(values.data(), values.size(), step, out.data());
+}
+
+} // namespace void_crew
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+namespace void_crew {
+
+/// Instruction sets the batch kernels have paths for, weakest first.
+enum class SimdLevel {
+    Scalar,
+    Sse2,
+    Avx2,
+};
+
+/// Best level this CPU (and OS) supports. Scalar off x86-64.
+SimdLevel detectSimdLevel() noexcept;
+
+/// Level the kernels currently run at; detectSimdLevel() until changed.
+SimdLevel simdLevel() noexcept;
+
+/// Forces a level, for tests and benchmarks. Throws std::invalid_argument if
+/// the CPU does not support it. Not thread-safe against running kernels.
+void setSimdLevel(SimdLevel level);
+
+std::string_view simdLevelName(SimdLevel level) noexcept;
+
+/// Parses "scalar", "sse2" or "avx2". Returns nullopt otherwise.
+std::optional<SimdLevel> parseSimdLevel(std::string_view name);
+
+/// Points as structure-of-arrays lanes of equal length.
+struct PointLanes {
+    std::span<const float> x;
+    std::span<const float> y;
+    std::span<const float> z;
+};
+
+/// Axis-aligned boxes as structure-of-arrays lanes of equal length.
+struct BoxLanes {
+    std::span<const float> minX;
+    std::span<const float> minY;
+    std::span<const float> minZ;
+    std::span<const float> maxX;
+    std::span<const float> maxY;
+    std::span<const float> maxZ;
+};
+
+// Batch kernels over SoA float lanes, dispatched at run time to the best
+// path for the CPU. Every path does the same IEEE operations in the same
+// order as the per-entity glm code (no FMA), so results are bit-identical
+// across paths and with glm. Lanes of different lengths throw
+// std::invalid_argument.
+
+/// values[i] += rates[i] * dt: positions from velocities, velocities from
+/// accelerations, one axis per call.
+void integrate(std::span<float> values, std::span<const float> rates, float dt);
+
+/// Indices of the points within @p radius of @p center (squared distance
+/// <= radius squared), ascending. Fills @p out, reusing its storage; returns
+/// its size.
+std::size_t withinDistance(const PointLanes &points, const glm::vec3 &center, float radius,
+                           std::vector<uint32_t> &out);
+
+/// Indices of the boxes overlapping [@p min, @p max], touching included,
+/// ascending. Fills @p out like withinDistance().
+std::size_t overlapping(const BoxLanes &boxes, const glm::vec3 &min, const glm::vec3 &max,
+                        std::vector<uint32_t> &out);
+
+/// out[i] = std::round(values[i] / step): fixed point with @p step units,
+/// halves rounded away from zero. Results beyond the int32 range, infinities
+/// included, are clamped to about +-2^31; NaN quantizes to 0.
+void quantize(std::span<const float> values, float step, std::span<int32_t> out);
+
+} // namespace void_crew
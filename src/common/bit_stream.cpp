@@ -0,0 +1,98 @@
+#include "bit_stream.hpp"
+
+#include <array>
+#include <bit>
+
+namespace void_crew {
+
+namespace {
+
+constexpr std::array<unsigned, 4> VAR_UINT_WIDTHS{4, 8, 16, 32};
+
+constexpr uint32_t lowMask(unsigned bits) noexcept {
+    return bits >= 32 ? 0xFFFFFFFFu : (1u << bits) - 1;
+}
+
+} // namespace
+
+void BitWriter::clear() noexcept {
+    m_bytes.clear();
+    m_scratch = 0;
+    m_scratchBits = 0;
+}
+
+void BitWriter::write(uint32_t value, unsigned bits) {
+    m_scratch |= uint64_t{value & lowMask(bits)} << m_scratchBits;
+    m_scratchBits += bits;
+    while (m_scratchBits >= 8) {
+        m_bytes.push_back(static_cast<uint8_t>(m_scratch));
+        m_scratch >>= 8;
+        m_scratchBits -= 8;
+    }
+}
+
+void BitWriter::writeBool(bool value) {
+    write(value ? 1 : 0, 1);
+}
+
+void BitWriter::writeFloat(float value) {
+    write(std::bit_cast<uint32_t>(value), 32);
+}
+
+void BitWriter::writeVarUint(uint32_t value) {
+    unsigned sizeClass = 0;
+    while (value > lowMask(VAR_UINT_WIDTHS[sizeClass])) {
+        ++sizeClass;
+    }
+    write(sizeClass, 2);
+    write(value, VAR_UINT_WIDTHS[sizeClass]);
+}
+
+std::span<const uint8_t> BitWriter::finish() {
+    if (m_scratchBits > 0) {
+        m_bytes.push_back(static_cast<uint8_t>(m_scratch));
+        m_scratch = 0;
+        m_scratchBits = 0;
+    }
+    return m_bytes;
+}
+
+std::size_t BitWriter::bitCount() const noexcept {
+    return m_bytes.size() * 8 + m_scratchBits;
+}
+
+BitReader::BitReader(std::span<const uint8_t> bytes) noexcept
+    : m_bytes(bytes) {}
+
+uint32_t BitReader::read(unsigned bits) noexcept {
+    while (m_scratchBits < bits) {
+        if (m_position == m_bytes.size()) {
+            m_failed = true;
+            return 0;
+        }
+        m_scratch |= uint64_t{m_bytes[m_position++]} << m_scratchBits;
+        m_scratchBits += 8;
+    }
+    auto value = static_cast<uint32_t>(m_scratch) & lowMask(bits);
+    m_scratch >>= bits;
+    m_scratchBits -= bits;
+    return value;
+}
+
+bool BitReader::readBool() noexcept {
+    return read(1) != 0;
+}
+
+float BitReader::readFloat() noexcept {
+    return std::bit_cast<float>(read(32));
+}
+
+uint32_t BitReader::readVarUint() noexcept {
+    return read(VAR_UINT_WIDTHS[read(2)]);
+}
+
+bool BitReader::failed() const noexcept {
+    return m_failed;
+}
+
+} // namespace void_crew
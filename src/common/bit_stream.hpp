@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace void_crew {
+
+/// Appends values of arbitrary bit width to a byte buffer, LSB first.
+///
+/// The buffer is kept across clear() calls, so a long-lived writer stops
+/// allocating once it has seen its largest message.
+class BitWriter {
+public:
+    void clear() noexcept;
+
+    /// Writes the low @p bits (1-32) of @p value.
+    void write(uint32_t value, unsigned bits);
+    void writeBool(bool value);
+
+    /// Writes the raw IEEE-754 bits, so values round-trip exactly.
+    void writeFloat(float value);
+
+    /// Writes @p value with a 2-bit size class (4, 8, 16 or 32 bits): small
+    /// values such as id gaps and counts cost 6 or 10 bits instead of 32.
+    void writeVarUint(uint32_t value);
+
+    /// Flushes the partial last byte and returns everything written.
+    std::span<const uint8_t> finish();
+
+    std::size_t bitCount() const noexcept;
+
+private:
+    std::vector<uint8_t> m_bytes;
+    uint64_t m_scratch = 0;
+    unsigned m_scratchBits = 0;
+};
+
+/// Reads what BitWriter wrote. Reading past the end returns zeros and sets
+/// failed(); callers check once after decoding instead of after every field.
+class BitReader {
+public:
+    explicit BitReader(std::span<const uint8_t> bytes) noexcept;
+
+    uint32_t read(unsigned bits) noexcept;
+    bool readBool() noexcept;
+    float readFloat() noexcept;
+    uint32_t readVarUint() noexcept;
+
+    bool failed() const noexcept;
+
+private:
+    std::span<const uint8_t> m_bytes;
+    std::size_t m_position = 0;
+    uint64_t m_scratch = 0;
+    unsigned m_scratchBits = 0;
+    bool m_failed = false;
+};
+
+} // namespace void_crew
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+namespace void_crew {
+
+/// Stable identifier of a replicated entity. entt::entity values are local to
+/// one registry; this is what clients and snapshots refer to. Entities without
+/// it are server-only and never serialized.
+struct NetworkId {
+    uint32_t value = 0;
+};
+
+struct Transform {
+    glm::vec3 position{0.0f};
+    glm::quat rotation{1.0f, 0.0f, 0.0f, 0.0f}; // identity (w, x, y, z)
+};
+
+struct Velocity {
+    glm::vec3 linear{0.0f};  // m/s
+    glm::vec3 angular{0.0f}; // rad/s
+};
+
+using CompartmentId = uint32_t;
+
+/// The compartment an entity is in. Entities without it are outside the
+/// ship's interior (hull, open space). Change it with registry.replace() or
+/// patch() so the server's interest index sees the move.
+struct InCompartment {
+    CompartmentId id = 0;
+};
+
+/// A door, hatch or bulkhead joining two compartments. Open doors let
+/// compartments see each other; toggle @c open with registry.patch().
+struct Door {
+    CompartmentId first = 0;
+    CompartmentId second = 0;
+    bool open = false;
+};
+
+} // namespace void_crew
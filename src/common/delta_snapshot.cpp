@@ -0,0 +1,220 @@
+#include "delta_snapshot.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+
+#include <glm/gtc/type_ptr.hpp>
+
+#include "components.hpp"
+
+namespace void_crew {
+
+namespace {
+
+constexpr std::size_t GROUP_COUNT = 4;
+constexpr std::size_t ENTRY_HEADER_BITS = 12; // more bit, id gap in the 8-bit size class, removed bit
+constexpr std::array<unsigned, GROUP_COUNT> GROUP_SIZES{3, 4, 3, 3};
+
+std::array<const float*, GROUP_COUNT> groups(const EntityState& state) {
+    return {glm::value_ptr(state.position), glm::value_ptr(state.rotation), glm::value_ptr(state.linearVelocity),
+            glm::value_ptr(state.angularVelocity)};
+}
+
+std::array<float*, GROUP_COUNT> groups(EntityState& state) {
+    return {glm::value_ptr(state.position), glm::value_ptr(state.rotation), glm::value_ptr(state.linearVelocity),
+            glm::value_ptr(state.angularVelocity)};
+}
+
+// Bitwise, so -0.0f vs 0.0f and NaN payloads are replicated exactly.
+bool sameFloat(float lhs, float rhs) noexcept {
+    return std::bit_cast<uint32_t>(lhs) == std::bit_cast<uint32_t>(rhs);
+}
+
+void writeEntry(BitWriter& writer, uint32_t& nextId, uint32_t id, bool removed) {
+    writer.writeBool(true); // another entry follows
+    writer.writeVarUint(id - nextId);
+    writer.writeBool(removed);
+    nextId = id + 1;
+}
+
+/// Writes @p current's fields against @p reference. With @p force the entry is
+/// written even if nothing changed (a new entity equal to the defaults).
+void writeEntity(BitWriter& writer, uint32_t& nextId, const EntityState& reference, const EntityState& current,
+                 bool force) {
+    auto from = groups(reference);
+    auto to = groups(current);
+
+    std::array<uint32_t, GROUP_COUNT> changed{};
+    bool any = false;
+    for (std::size_t g = 0; g < GROUP_COUNT; ++g) {
+        for (unsigned c = 0; c < GROUP_SIZES[g]; ++c) {
+            if (!sameFloat(from[g][c], to[g][c])) {
+                changed[g] |= 1u << c;
+                any = true;
+            }
+        }
+    }
+    if (!any && !force) {
+        return;
+    }
+
+    writeEntry(writer, nextId, current.id, false);
+    for (std::size_t g = 0; g < GROUP_COUNT; ++g) {
+        writer.writeBool(changed[g] != 0);
+        if (changed[g] == 0) {
+            continue;
+        }
+        for (unsigned c = 0; c < GROUP_SIZES[g]; ++c) {
+            bool componentChanged = (changed[g] & (1u << c)) != 0;
+            writer.writeBool(componentChanged);
+            if (componentChanged) {
+                writer.writeFloat(to[g][c]);
+            }
+        }
+    }
+}
+
+} // namespace
+
+void captureWorldState(const entt::registry& registry, uint64_t tick, WorldState& out) {
+    out.tick = tick;
+    out.entities.clear();
+    for (auto [entity, id, transform] : registry.view<const NetworkId, const Transform>().each()) {
+        auto& state = out.entities.emplace_back();
+        state.id = id.value;
+        state.position = transform.position;
+        state.rotation = transform.rotation;
+        if (const auto* velocity = registry.try_get<Velocity>(entity)) {
+            state.linearVelocity = velocity->linear;
+            state.angularVelocity = velocity->angular;
+        }
+    }
+    std::sort(out.entities.begin(), out.entities.end(),
+              [](const EntityState& lhs, const EntityState& rhs) { return lhs.id < rhs.id; });
+}
+
+std::size_t estimateEntryBits(const EntityState* reference, const EntityState* current) noexcept {
+    static const EntityState DEFAULT_STATE;
+    if (current == nullptr) {
+        return ENTRY_HEADER_BITS;
+    }
+    auto from = groups(reference != nullptr ? *reference : DEFAULT_STATE);
+    auto to = groups(*current);
+
+    std::size_t bits = 0;
+    for (std::size_t g = 0; g < GROUP_COUNT; ++g) {
+        std::size_t changed = 0;
+        for (unsigned c = 0; c < GROUP_SIZES[g]; ++c) {
+            changed += sameFloat(from[g][c], to[g][c]) ? 0 : 1;
+        }
+        bits += 1 + (changed > 0 ? GROUP_SIZES[g] + changed * 32 : 0);
+    }
+    bool changed = bits > GROUP_COUNT;
+    return changed || reference == nullptr ? ENTRY_HEADER_BITS + bits : 0;
+}
+
+std::span<const uint8_t> encodeDelta(const WorldState* baseline, const WorldState& current, BitWriter& writer) {
+    static const EntityState DEFAULT_STATE;
+    static const std::vector<EntityState> NO_ENTITIES;
+    const auto& before = baseline != nullptr ? baseline->entities : NO_ENTITIES;
+    const auto& after = current.entities;
+
+    writer.clear();
+    uint32_t nextId = 0;
+    std::size_t b = 0;
+    std::size_t a = 0;
+    while (b < before.size() || a < after.size()) {
+        if (a == after.size() || (b < before.size() && before[b].id < after[a].id)) {
+            writeEntry(writer, nextId, before[b].id, true);
+            ++b;
+        } else if (b < before.size() && before[b].id == after[a].id) {
+            writeEntity(writer, nextId, before[b], after[a], false);
+            ++b;
+            ++a;
+        } else {
+            writeEntity(writer, nextId, DEFAULT_STATE, after[a], true);
+            ++a;
+        }
+    }
+    writer.writeBool(false); // end of entries
+    return writer.finish();
+}
+
+bool decodeDelta(const WorldState* baseline, std::span<const uint8_t> delta, WorldState& out) {
+    static const std::vector<EntityState> NO_ENTITIES;
+    const auto& before = baseline != nullptr ? baseline->entities : NO_ENTITIES;
+
+    out.entities.clear();
+    BitReader reader(delta);
+    uint64_t nextId = 0;
+    std::size_t b = 0;
+
+    while (reader.readBool()) {
+        uint64_t id = nextId + reader.readVarUint();
+        bool removed = reader.readBool();
+        if (reader.failed() || id > UINT32_MAX) {
+            return false;
+        }
+        nextId = id + 1;
+
+        while (b < before.size() && before[b].id < id) {
+            out.entities.push_back(before[b++]);
+        }
+        bool known = b < before.size() && before[b].id == id;
+        if (removed) {
+            if (!known) {
+                return false;
+            }
+            ++b;
+            continue;
+        }
+
+        auto& state = out.entities.emplace_back(known ? before[b++] : EntityState{});
+        state.id = static_cast<uint32_t>(id);
+        auto fields = groups(state);
+        for (std::size_t g = 0; g < GROUP_COUNT; ++g) {
+            if (!reader.readBool()) {
+                continue;
+            }
+            for (unsigned c = 0; c < GROUP_SIZES[g]; ++c) {
+                if (reader.readBool()) {
+                    fields[g][c] = reader.readFloat();
+                }
+            }
+        }
+    }
+
+    out.entities.insert(out.entities.end(), before.begin() + static_cast<std::ptrdiff_t>(b), before.end());
+    return !reader.failed();
+}
+
+SnapshotHistory::SnapshotHistory(std::size_t capacity)
+    : m_states(std::max<std::size_t>(capacity, 1)),
+      m_valid(m_states.size(), 0) {}
+
+void SnapshotHistory::swapIn(WorldState& state) {
+    auto index = static_cast<std::size_t>(state.tick % m_states.size());
+    std::swap(m_states[index], state);
+    m_valid[index] = 1;
+    m_latest = index;
+    m_empty = false;
+}
+
+const WorldState* SnapshotHistory::find(uint64_t tick) const noexcept {
+    auto index = static_cast<std::size_t>(tick % m_states.size());
+    if (m_valid[index] == 0 || m_states[index].tick != tick) {
+        return nullptr;
+    }
+    return &m_states[index];
+}
+
+const WorldState* SnapshotHistory::latest() const noexcept {
+    return m_empty ? nullptr : &m_states[m_latest];
+}
+
+std::size_t SnapshotHistory::capacity() const noexcept {
+    return m_states.size();
+}
+
+} // namespace void_crew
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <entt/entt.hpp>
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include "bit_stream.hpp"
+
+namespace void_crew {
+
+/// Snapshots kept for delta baselines: about one second at 60 Hz. Server and
+/// client must agree, since the server only deltas against ticks the client
+/// acked and the client must still hold them.
+constexpr std::size_t SNAPSHOT_HISTORY_SIZE = 64;
+
+/// Replicated state of one entity, flattened for delta encoding.
+struct EntityState {
+    uint32_t id = 0; // NetworkId
+    glm::vec3 position{0.0f};
+    glm::quat rotation{1.0f, 0.0f, 0.0f, 0.0f};
+    glm::vec3 linearVelocity{0.0f};
+    glm::vec3 angularVelocity{0.0f};
+
+    bool operator==(const EntityState&) const noexcept = default;
+};
+
+/// Replicated world at one tick; entities sorted by id.
+struct WorldState {
+    uint64_t tick = 0;
+    std::vector<EntityState> entities;
+};
+
+/// Copies every entity with NetworkId and Transform (and Velocity, if any)
+/// into @p out. Reuses @p out's storage.
+void captureWorldState(const entt::registry& registry, uint64_t tick, WorldState& out);
+
+/// Encodes @p current as a bit-packed delta against @p baseline (nullptr:
+/// against an empty world, i.e. a full snapshot).
+///
+/// Entities are written in id order as a merged list: removed ids, new
+/// entities and changed ones; unchanged entities cost nothing. Each entry is
+/// an id gap, a removed bit, then per field group (position, rotation, linear
+/// and angular velocity) a changed bit followed by changed components as raw
+/// floats, so decoding is exact. Returns the bytes in @p writer.
+std::span<const uint8_t> encodeDelta(const WorldState* baseline, const WorldState& current, BitWriter& writer);
+
+/// Approximate bits encodeDelta() spends on one entry: @p reference is the
+/// entity in the baseline (nullptr: new entity), @p current the entity now
+/// (nullptr: removed). Returns 0 for an unchanged entity. Used to fill a
+/// byte budget without encoding.
+std::size_t estimateEntryBits(const EntityState* reference, const EntityState* current) noexcept;
+
+/// Rebuilds the world from @p baseline and a delta made by encodeDelta().
+/// @p out must not alias @p baseline; its tick is left to the caller.
+/// Returns false if the data is truncated or does not fit the baseline.
+bool decodeDelta(const WorldState* baseline, std::span<const uint8_t> delta, WorldState& out);
+
+/// Ring of recent world states indexed by tick.
+///
+/// swapIn() exchanges the caller's state with the slot it replaces, so the
+/// producer gets the evicted state's buffers back and the steady state does
+/// not allocate.
+class SnapshotHistory {
+public:
+    explicit SnapshotHistory(std::size_t capacity = SNAPSHOT_HISTORY_SIZE);
+
+    /// Stores @p state as the latest; @p state receives the replaced slot.
+    void swapIn(WorldState& state);
+
+    /// The state for @p tick, or nullptr if it was never stored or evicted.
+    const WorldState* find(uint64_t tick) const noexcept;
+    const WorldState* latest() const noexcept;
+
+    std::size_t capacity() const noexcept;
+
+private:
+    std::vector<WorldState> m_states;
+    std::vector<uint8_t> m_valid;
+    std::size_t m_latest = 0;
+    bool m_empty = true;
+};
+
+} // namespace void_crew
@@ -0,0 +1,191 @@
+#include "frame_arena.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#include "logging.hpp"
+
+#if defined(__SANITIZE_ADDRESS__)
+#define VOID_CREW_ARENA_ASAN 1
+#elif defined(__has_feature)
+#if __has_feature(address_sanitizer)
+#define VOID_CREW_ARENA_ASAN 1
+#endif
+#endif
+
+#ifdef VOID_CREW_ARENA_ASAN
+#include <sanitizer/asan_interface.h>
+#endif
+
+namespace void_crew {
+
+namespace {
+
+constexpr std::size_t MIN_CHUNK_BYTES = 1024;
+constexpr std::byte RELEASED_PATTERN{0xDD};
+
+// Checked builds put the allocation's generation right before it.
+using Tag = uint64_t;
+
+void poison([[maybe_unused]] const void *begin, [[maybe_unused]] std::size_t bytes) noexcept {
+#ifdef VOID_CREW_ARENA_ASAN
+    ASAN_POISON_MEMORY_REGION(begin, bytes);
+#endif
+}
+
+void unpoison([[maybe_unused]] const void *begin, [[maybe_unused]] std::size_t bytes) noexcept {
+#ifdef VOID_CREW_ARENA_ASAN
+    ASAN_UNPOISON_MEMORY_REGION(begin, bytes);
+#endif
+}
+
+} // namespace
+
+FrameArena::FrameArena(std::size_t initialBytes) {
+    addChunk(std::max(initialBytes, MIN_CHUNK_BYTES));
+}
+
+FrameArena::~FrameArena() {
+    for (const auto &chunk : m_chunks) {
+        unpoison(chunk.data.get(), chunk.size);
+    }
+}
+
+void FrameArena::reset() {
+    std::size_t capacity = 0;
+    for (auto &chunk : m_chunks) {
+        if constexpr (CHECKED) {
+            unpoison(chunk.data.get(), chunk.used); // alignment gaps were never handed out
+            std::memset(chunk.data.get(), std::to_integer<int>(RELEASED_PATTERN), chunk.used);
+            poison(chunk.data.get(), chunk.size);
+        }
+        chunk.used = 0;
+        capacity += chunk.size;
+    }
+
+    // The last tick outgrew the first chunk: make room for it in one piece.
+    if (m_chunks.size() > 1) {
+        for (const auto &chunk : m_chunks) {
+            unpoison(chunk.data.get(), chunk.size);
+        }
+        m_chunks.clear();
+        addChunk(capacity);
+    }
+    m_fullBytes = 0;
+    ++m_stats.resets;
+}
+
+std::size_t FrameArena::used() const noexcept {
+    return m_fullBytes + m_chunks.back().used;
+}
+
+std::size_t FrameArena::highWater() const noexcept {
+    return m_stats.highWater;
+}
+
+uint64_t FrameArena::generation() const noexcept {
+    return m_stats.resets;
+}
+
+FrameArenaStats FrameArena::stats() const noexcept {
+    auto stats = m_stats;
+    stats.used = used();
+    stats.chunks = m_chunks.size();
+    for (const auto &chunk : m_chunks) {
+        stats.capacity += chunk.size;
+    }
+    return stats;
+}
+
+void *FrameArena::do_allocate(std::size_t bytes, std::size_t alignment) {
+    std::size_t header = CHECKED ? std::max(alignment, sizeof(Tag)) : 0;
+    std::size_t total = bytes + header;
+
+    void *block = bump(m_chunks.back(), total, alignment);
+    if (block == nullptr) {
+        m_fullBytes += m_chunks.back().used;
+        ++m_stats.overflows;
+        addChunk(std::max(m_chunks.back().size * 2, total + alignment));
+        block = bump(m_chunks.back(), total, alignment);
+    }
+    m_stats.highWater = std::max(m_stats.highWater, used());
+
+    if constexpr (CHECKED) {
+        unpoison(block, total);
+        auto *start = static_cast<std::byte *>(block) + header;
+        Tag generation = m_stats.resets;
+        std::memcpy(start - sizeof(Tag), &generation, sizeof(Tag));
+        return start;
+    }
+    return block;
+}
+
+void FrameArena::do_deallocate(void *pointer, [[maybe_unused]] std::size_t bytes,
+                               [[maybe_unused]] std::size_t alignment) {
+    // Memory goes back in bulk on reset(); this only checks the caller.
+    if constexpr (CHECKED) {
+        const auto *start = static_cast<const std::byte *>(pointer);
+        bool live = std::any_of(m_chunks.begin(), m_chunks.end(), [&](const Chunk &chunk) {
+            if (start < chunk.data.get() + sizeof(Tag) || start > chunk.data.get() + chunk.used) {
+                return false;
+            }
+            Tag generation = 0;
+            std::memcpy(&generation, start - sizeof(Tag), sizeof(Tag));
+            return generation == m_stats.resets;
+        });
+        if (!live) {
+            ++m_stats.staleReleases;
+            TLOG_ERROR("arena", "Frame arena memory released after its tick ({} bytes); it was used past reset()",
+                       bytes);
+        }
+    }
+}
+
+bool FrameArena::do_is_equal(const std::pmr::memory_resource &other) const noexcept {
+    return this == &other;
+}
+
+void *FrameArena::bump(Chunk &chunk, std::size_t bytes, std::size_t alignment) noexcept {
+    auto base = reinterpret_cast<std::uintptr_t>(chunk.data.get());
+    auto start = (base + chunk.used + alignment - 1) & ~(static_cast<std::uintptr_t>(alignment) - 1);
+    if (start + bytes > base + chunk.size) {
+        return nullptr;
+    }
+    chunk.used = start + bytes - base;
+    return reinterpret_cast<void *>(start);
+}
+
+void FrameArena::addChunk(std::size_t minimumBytes) {
+    Chunk chunk;
+    chunk.data = std::make_unique_for_overwrite<std::byte[]>(minimumBytes);
+    chunk.size = minimumBytes;
+    if constexpr (CHECKED) {
+        poison(chunk.data.get(), chunk.size);
+    }
+    m_chunks.push_back(std::move(chunk));
+}
+
+FrameArenaSet::FrameArenaSet(std::size_t count, std::size_t initialBytes) {
+    m_arenas.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        m_arenas.push_back(std::make_unique<FrameArena>(initialBytes));
+    }
+}
+
+FrameArena &FrameArenaSet::operator[](std::size_t index) {
+    return *m_arenas[index];
+}
+
+std::size_t FrameArenaSet::size() const noexcept {
+    return m_arenas.size();
+}
+
+std::size_t FrameArenaSet::used() const noexcept {
+    std::size_t total = 0;
+    for (const auto &arena : m_arenas) {
+        total += arena->used();
+    }
+    return total;
+}
+
+} // namespace void_crew
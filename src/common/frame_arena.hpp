@@ -0,0 +1,110 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+
+// Debug builds check that nothing allocated in a tick is touched or released
+// after the arena was reset. Override with -DVOID_CREW_FRAME_ARENA_CHECKS=0/1.
+#ifndef VOID_CREW_FRAME_ARENA_CHECKS
+#ifdef NDEBUG
+#define VOID_CREW_FRAME_ARENA_CHECKS 0
+#else
+#define VOID_CREW_FRAME_ARENA_CHECKS 1
+#endif
+#endif
+
+namespace void_crew {
+
+/// Initial size of a frame arena; it grows to the busiest tick seen.
+constexpr std::size_t DEFAULT_FRAME_ARENA_BYTES = 256 * 1024;
+
+struct FrameArenaStats {
+    std::size_t used = 0;      // bytes handed out since the last reset, padding included
+    std::size_t capacity = 0;  // bytes reserved across chunks
+    std::size_t highWater = 0; // most bytes used between two resets
+    std::size_t chunks = 0;
+    uint64_t resets = 0;
+    uint64_t overflows = 0;     // allocations that needed a new chunk
+    uint64_t staleReleases = 0; // checked builds: memory released after its tick
+};
+
+/// Linear (bump) allocator for data that lives for one tick: snapshot
+/// scratch, query results, parsed commands, AI scratch space.
+///
+/// Allocation bumps a pointer in the current chunk; deallocation does
+/// nothing; reset() releases everything at once. When a tick needs more than
+/// the chunk holds, another chunk twice the size is taken from the heap, and
+/// the next reset() merges them into one, so after warm-up a tick touches
+/// the global heap not at all.
+///
+/// Use through std::pmr containers (`std::pmr::vector<T> v(&arena)`) or
+/// allocate() directly. Nothing allocated may outlive the next reset().
+/// Checked builds (VOID_CREW_FRAME_ARENA_CHECKS, on without NDEBUG) enforce
+/// that: reset() fills released memory with a pattern and, under
+/// AddressSanitizer, poisons it so a stale read is reported at once; every
+/// allocation carries its tick, so releasing one after a reset (a pmr
+/// container that outlived its tick) is logged and counted.
+///
+/// One thread at a time; see FrameArenaSet for one arena per worker.
+class FrameArena final : public std::pmr::memory_resource {
+public:
+    static constexpr bool CHECKED = VOID_CREW_FRAME_ARENA_CHECKS != 0;
+
+    explicit FrameArena(std::size_t initialBytes = DEFAULT_FRAME_ARENA_BYTES);
+    ~FrameArena() override;
+
+    FrameArena(const FrameArena &) = delete;
+    FrameArena &operator=(const FrameArena &) = delete;
+    FrameArena(FrameArena &&) = delete;
+    FrameArena &operator=(FrameArena &&) = delete;
+
+    /// Releases every allocation of the current tick. Chunks taken during
+    /// the tick are merged into one, which is the only allocation it makes.
+    void reset();
+
+    std::size_t used() const noexcept;
+    std::size_t highWater() const noexcept;
+
+    /// Number of resets so far: the tick allocations belong to.
+    uint64_t generation() const noexcept;
+
+    FrameArenaStats stats() const noexcept;
+
+private:
+    struct Chunk {
+        std::unique_ptr<std::byte[]> data;
+        std::size_t size = 0;
+        std::size_t used = 0;
+    };
+
+    void *do_allocate(std::size_t bytes, std::size_t alignment) override;
+    void do_deallocate(void *pointer, std::size_t bytes, std::size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override;
+
+    void *bump(Chunk &chunk, std::size_t bytes, std::size_t alignment) noexcept;
+    void addChunk(std::size_t minimumBytes);
+
+    std::vector<Chunk> m_chunks; // the last one is being filled
+    std::size_t m_fullBytes = 0; // used bytes in the chunks before the last
+    FrameArenaStats m_stats;
+};
+
+/// One FrameArena per worker thread, so parallel systems never share one.
+class FrameArenaSet {
+public:
+    explicit FrameArenaSet(std::size_t count, std::size_t initialBytes = DEFAULT_FRAME_ARENA_BYTES);
+
+    FrameArena &operator[](std::size_t index);
+    std::size_t size() const noexcept;
+
+    /// Bytes used across all arenas since their last reset.
+    std::size_t used() const noexcept;
+
+private:
+    std::vector<std::unique_ptr<FrameArena>> m_arenas;
+};
+
+} // namespace void_crew
@@ -0,0 +1,93 @@
+#include "latency_histogram.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace void_crew {
+
+namespace {
+
+// Rank (1-based) of the sample at the given fraction of @p count.
+uint64_t rankFor(double fraction, uint64_t count) noexcept {
+    auto rank = static_cast<uint64_t>(std::ceil(std::clamp(fraction, 0.0, 1.0) * static_cast<double>(count)));
+    return std::clamp<uint64_t>(rank, 1, count);
+}
+
+} // namespace
+
+double LatencyHistogram::percentile(double fraction) const noexcept {
+    if (m_count == 0) {
+        return 0.0;
+    }
+
+    uint64_t rank = rankFor(fraction, m_count);
+    uint64_t seen = 0;
+    for (std::size_t i = 0; i < BUCKET_COUNT; ++i) {
+        seen += m_counts[i];
+        if (seen >= rank) {
+            return static_cast<double>(std::min(bucketUpperBound(i), m_maxNs)) / NS_PER_SECOND;
+        }
+    }
+    return max();
+}
+
+LatencySummary LatencyHistogram::summary() const noexcept {
+    LatencySummary result;
+    result.count = m_count;
+    result.max = max();
+    if (m_count == 0) {
+        return result;
+    }
+
+    constexpr std::array<double, 4> FRACTIONS = {0.50, 0.90, 0.99, 0.999};
+    std::array<double*, 4> outputs = {&result.p50, &result.p90, &result.p99, &result.p999};
+    std::array<uint64_t, 4> ranks{};
+    for (std::size_t k = 0; k < FRACTIONS.size(); ++k) {
+        ranks[k] = rankFor(FRACTIONS[k], m_count);
+    }
+
+    std::size_t next = 0;
+    uint64_t seen = 0;
+    for (std::size_t i = 0; i < BUCKET_COUNT && next < ranks.size(); ++i) {
+        seen += m_counts[i];
+        while (next < ranks.size() && seen >= ranks[next]) {
+            *outputs[next] = static_cast<double>(std::min(bucketUpperBound(i), m_maxNs)) / NS_PER_SECOND;
+            ++next;
+        }
+    }
+    return result;
+}
+
+double LatencyHistogram::mean() const noexcept {
+    if (m_count == 0) {
+        return 0.0;
+    }
+    return static_cast<double>(m_sumNs) / static_cast<double>(m_count) / NS_PER_SECOND;
+}
+
+void LatencyHistogram::merge(const LatencyHistogram& other) noexcept {
+    for (std::size_t i = 0; i < BUCKET_COUNT; ++i) {
+        m_counts[i] += other.m_counts[i];
+    }
+    m_count += other.m_count;
+    m_sumNs += other.m_sumNs;
+    m_maxNs = std::max(m_maxNs, other.m_maxNs);
+}
+
+void LatencyHistogram::reset() noexcept {
+    m_counts.fill(0);
+    m_count = 0;
+    m_sumNs = 0;
+    m_maxNs = 0;
+}
+
+uint64_t LatencyHistogram::bucketUpperBound(std::size_t index) noexcept {
+    if (index < SUB_BUCKET_COUNT) {
+        return index;
+    }
+    auto exponent = index / SUB_BUCKET_HALF - 1;
+    auto mantissa = index % SUB_BUCKET_HALF + SUB_BUCKET_HALF;
+    return ((mantissa + 1) << exponent) - 1;
+}
+
+} // namespace void_crew
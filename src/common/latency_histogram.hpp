@@ -0,0 +1,108 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+namespace void_crew {
+
+/// Percentiles of a LatencyHistogram, in seconds.
+struct LatencySummary {
+    uint64_t count = 0;
+    double p50 = 0.0;
+    double p90 = 0.0;
+    double p99 = 0.0;
+    double p999 = 0.0;
+    double max = 0.0;
+};
+
+/// Fixed-size log-linear histogram of durations (HDR histogram layout).
+///
+/// Values are recorded in nanoseconds. Below 2^SUB_BUCKET_BITS ns every
+/// nanosecond has its own bucket; above that each power of two is split into
+/// 2^(SUB_BUCKET_BITS - 1) linear sub-buckets, giving a relative error under
+/// 1.6% up to MAX_TRACKABLE_NS. Larger values land in the last bucket; the
+/// exact maximum is tracked separately.
+///
+/// record() never allocates and costs a bit scan plus an increment, so it is
+/// safe to call every tick. Not thread-safe.
+class LatencyHistogram {
+public:
+    static constexpr unsigned SUB_BUCKET_BITS = 7;
+    static constexpr unsigned MAX_TRACKABLE_BITS = 40; // ~18 minutes
+    static constexpr uint64_t MAX_TRACKABLE_NS = (uint64_t{1} << MAX_TRACKABLE_BITS) - 1;
+
+    /// Record a duration in seconds. Negative values are recorded as zero.
+    void record(double seconds) noexcept {
+        double ns = seconds * NS_PER_SECOND;
+        if (ns <= 0.0) {
+            recordNanoseconds(0);
+        } else if (ns >= static_cast<double>(MAX_TRACKABLE_NS)) {
+            recordNanoseconds(MAX_TRACKABLE_NS);
+        } else {
+            recordNanoseconds(static_cast<uint64_t>(ns));
+        }
+    }
+
+    void recordNanoseconds(uint64_t ns) noexcept {
+        m_counts[bucketIndex(ns)]++;
+        m_count++;
+        m_sumNs += ns;
+        if (ns > m_maxNs) {
+            m_maxNs = ns;
+        }
+    }
+
+    /// Value at or below which @p fraction of samples fall, in seconds.
+    /// @p fraction is in [0, 1], e.g. 0.99 for p99. Returns 0 when empty.
+    double percentile(double fraction) const noexcept;
+
+    /// p50/p90/p99/p99.9 and max in a single pass over the buckets.
+    LatencySummary summary() const noexcept;
+
+    uint64_t count() const noexcept {
+        return m_count;
+    }
+
+    double max() const noexcept {
+        return static_cast<double>(m_maxNs) / NS_PER_SECOND;
+    }
+
+    double mean() const noexcept;
+
+    /// Add all samples from @p other into this histogram.
+    void merge(const LatencyHistogram& other) noexcept;
+
+    void reset() noexcept;
+
+private:
+    static constexpr double NS_PER_SECOND = 1e9;
+    static constexpr uint64_t SUB_BUCKET_COUNT = uint64_t{1} << SUB_BUCKET_BITS;
+    static constexpr uint64_t SUB_BUCKET_HALF = SUB_BUCKET_COUNT / 2;
+    static constexpr std::size_t BUCKET_COUNT =
+        (MAX_TRACKABLE_BITS - SUB_BUCKET_BITS) * SUB_BUCKET_HALF + SUB_BUCKET_COUNT;
+
+    static std::size_t bucketIndex(uint64_t ns) noexcept {
+        if (ns > MAX_TRACKABLE_NS) {
+            ns = MAX_TRACKABLE_NS;
+        }
+        if (ns < SUB_BUCKET_COUNT) {
+            return static_cast<std::size_t>(ns);
+        }
+        // exponent >= 1; the top SUB_BUCKET_BITS bits select the sub-bucket.
+        auto exponent = static_cast<unsigned>(std::bit_width(ns)) - SUB_BUCKET_BITS;
+        auto mantissa = ns >> exponent; // in [SUB_BUCKET_HALF, SUB_BUCKET_COUNT)
+        return static_cast<std::size_t>(exponent * SUB_BUCKET_HALF + mantissa);
+    }
+
+    /// Largest value that maps to bucket @p index.
+    static uint64_t bucketUpperBound(std::size_t index) noexcept;
+
+    std::array<uint64_t, BUCKET_COUNT> m_counts{};
+    uint64_t m_count = 0;
+    uint64_t m_sumNs = 0;
+    uint64_t m_maxNs = 0;
+};
+
+} // namespace void_crew
@@ -1,6 +1,10 @@
 #include "logging.hpp"
 
+#include <deque>
+#include <map>
+#include <mutex>
 #include <string>
+#include <vector>
 
 #include <spdlog/spdlog.h>
 #include <spdlog/sinks/rotating_file_sink.h>
@@ -11,6 +15,73 @@ namespace void_crew {
 constexpr std::size_t LOG_MAX_FILE_SIZE = 5 * 1024 * 1024; // 5 MB
 constexpr std::size_t LOG_MAX_FILES = 3;
 
+namespace detail {
+
+std::atomic<uint32_t> g_tagLoggerGeneration{1};
+
+} // namespace detail
+
+namespace {
+
+// Owns the tagged loggers handed out. spdlog's registry can drop loggers
+// (drop_all), but TagLogger call sites keep raw pointers, so the owning
+// references live here instead. A refresh retires the current generation
+// and releases the one before it: every cached pointer to that one was
+// invalidated a refresh ago, and only a log call spanning two refreshes
+// could still be using it.
+//
+// The {logger, generation} records call sites cache are kept forever: a call
+// site may hold a record of any age and must still be able to read its
+// generation. There is one per tag per generation, and refreshes are rare.
+struct TagEntry {
+    std::shared_ptr<spdlog::logger> logger;
+    const detail::ResolvedTagLogger* resolved;
+};
+
+struct TagRegistry {
+    std::mutex mutex;
+    std::map<std::string, TagEntry, std::less<>> loggers;
+    std::vector<std::shared_ptr<spdlog::logger>> retired; // previous generation only
+    std::deque<detail::ResolvedTagLogger> resolved;        // append-only, never freed
+};
+
+// Active async sink, if any. Weak so stats never extend the sink's lifetime.
+std::mutex s_asyncSinkMutex;
+std::weak_ptr<AsyncLogSink> s_asyncSink;
+
+TagRegistry& tagRegistry() {
+    static TagRegistry s_registry;
+    return s_registry;
+}
+
+std::shared_ptr<spdlog::logger> createTagLogger(const std::string& name) {
+    if (auto existing = spdlog::get(name)) {
+        return existing;
+    }
+
+    auto def = spdlog::default_logger();
+    auto& sinks = def->sinks();
+    auto logger = std::make_shared<spdlog::logger>(name, sinks.begin(), sinks.end());
+    logger->set_level(def->level());
+    logger->flush_on(def->flush_level());
+    spdlog::register_logger(logger);
+    return logger;
+}
+
+TagEntry& lookupOrCreate(TagRegistry& registry, std::string_view tag) {
+    auto it = registry.loggers.find(tag);
+    if (it == registry.loggers.end()) {
+        std::string name(tag);
+        auto logger = createTagLogger(name);
+        const auto& resolved = registry.resolved.emplace_back(detail::ResolvedTagLogger{
+            logger.get(), detail::g_tagLoggerGeneration.load(std::memory_order_relaxed)});
+        it = registry.loggers.emplace(std::move(name), TagEntry{std::move(logger), &resolved}).first;
+    }
+    return it->second;
+}
+
+} // namespace
+
 void initLogging(std::string_view level, const std::filesystem::path& logFile) {
     auto logDir = logFile.parent_path();
     if (!logDir.empty()) {
@@ -32,28 +103,67 @@ void initLogging(std::string_view level, const std::filesystem::path& logFile) {
     logger->flush_on(spdlog::level::warn);
 
     spdlog::set_default_logger(std::move(logger));
+    refreshTagLoggers();
+
+    std::lock_guard lock(s_asyncSinkMutex);
+    s_asyncSink.reset();
 }
 
-std::shared_ptr<spdlog::logger> getLogger(std::string_view tag) {
-    std::string name(tag);
-    auto existing = spdlog::get(name);
-    if (existing) {
-        return existing;
+void enableAsyncLogging(const AsyncLogOptions& options) {
+    auto current = spdlog::default_logger();
+    auto asyncSink = std::make_shared<AsyncLogSink>(current->sinks(), options);
+
+    auto logger = std::make_shared<spdlog::logger>(current->name(), asyncSink);
+    logger->set_level(current->level());
+    // The writer thread flushes at options.flushLevel; flushing from the
+    // logger would block the caller on the queue draining.
+    logger->flush_on(spdlog::level::off);
+
+    spdlog::set_default_logger(std::move(logger));
+    refreshTagLoggers();
+
+    std::lock_guard lock(s_asyncSinkMutex);
+    s_asyncSink = asyncSink;
+}
+
+AsyncLogStats asyncLogStats() {
+    std::lock_guard lock(s_asyncSinkMutex);
+    if (auto sink = s_asyncSink.lock()) {
+        return sink->stats();
     }
+    return {};
+}
 
-    auto def = spdlog::default_logger();
-    auto& sinks = def->sinks();
-    auto logger = std::make_shared<spdlog::logger>(name, sinks.begin(), sinks.end());
-    logger->set_level(def->level());
-    logger->flush_on(def->flush_level());
+std::shared_ptr<spdlog::logger> getLogger(std::string_view tag) {
+    auto& registry = tagRegistry();
+    std::lock_guard lock(registry.mutex);
+    return lookupOrCreate(registry, tag).logger;
+}
 
-    // Another thread might have registered the same name between get() and here.
-    try {
-        spdlog::register_logger(logger);
-    } catch (const spdlog::spdlog_ex&) {
-        return spdlog::get(name);
+void refreshTagLoggers() {
+    auto& registry = tagRegistry();
+    std::lock_guard lock(registry.mutex);
+    registry.retired.clear();
+    for (auto& [name, entry] : registry.loggers) {
+        // Only unregister our own logger, not one registered under the same
+        // name by someone else after a drop_all().
+        if (spdlog::get(name) == entry.logger) {
+            spdlog::drop(name);
+        }
+        registry.retired.push_back(std::move(entry.logger));
     }
-    return logger;
+    registry.loggers.clear();
+    detail::g_tagLoggerGeneration.fetch_add(1, std::memory_order_relaxed);
 }
 
+namespace detail {
+
+const ResolvedTagLogger* resolveTagLogger(std::string_view tag) {
+    auto& registry = tagRegistry();
+    std::lock_guard lock(registry.mutex);
+    return lookupOrCreate(registry, tag).resolved;
+}
+
+} // namespace detail
+
 } // namespace void_crew
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <atomic>
+#include <cstdint>
 #include <filesystem>
 #include <memory>
 #include <string_view>
@@ -8,6 +10,8 @@
 // It must be defined before including spdlog — the compile definition handles this.
 #include <spdlog/spdlog.h>
 
+#include "async_log_sink.hpp"
+
 namespace void_crew {
 
 // Initializes spdlog with console (colored) and file sinks.
@@ -17,11 +21,81 @@ namespace void_crew {
 void initLogging(std::string_view level = "info",
                  const std::filesystem::path& logFile = "logs/void_crew.log");
 
+// Moves the current default logger's sinks behind an AsyncLogSink so console
+// and file I/O happen on a background writer thread. Call after initLogging().
+// Flush-on-warn moves to the writer thread; logger->flush() still blocks until
+// everything logged before it has been written.
+void enableAsyncLogging(const AsyncLogOptions& options = {});
+
+// Drop counters of the active async sink. All zeros in synchronous mode.
+AsyncLogStats asyncLogStats();
+
 // Returns a logger tagged with the given subsystem name.
 // Creates it on first call for a given tag, sharing sinks with the root logger.
 // Thread-safe. Subsequent calls with the same tag return the cached logger.
+// Takes a mutex and a map lookup; hot paths should use the TLOG_* macros.
 std::shared_ptr<spdlog::logger> getLogger(std::string_view tag);
 
+// Forgets all tagged loggers so they are rebuilt from the current default
+// logger's sinks on next use. initLogging() calls this; call it directly only
+// after replacing the default logger by hand (tests, benchmarks).
+// The replaced loggers stay alive until the next refresh, since TLOG_* call
+// sites may still be mid-call on raw pointers to them.
+void refreshTagLoggers();
+
+namespace detail {
+
+// Bumped by refreshTagLoggers(). Call-site caches compare against it.
+extern std::atomic<uint32_t> g_tagLoggerGeneration;
+
+// A tagged logger and the generation it belongs to. Records are never freed
+// or modified, so a call site can always read the generation; the logger
+// itself is freed by the second refreshTagLoggers() after that generation.
+struct ResolvedTagLogger {
+    spdlog::logger* logger;
+    uint32_t generation;
+};
+
+// Raw-pointer variant of getLogger() for call-site caches.
+const ResolvedTagLogger* resolveTagLogger(std::string_view tag);
+
+// Forces the tag to be a compile-time constant: TagLogger caches per call
+// site, so a tag that varied between calls would log under a stale name.
+consteval std::string_view literalTag(std::string_view tag) {
+    return tag;
+}
+
+} // namespace detail
+
+/// Per-call-site handle to a tagged logger.
+///
+/// Resolves the logger on first use and again only after refreshTagLoggers(),
+/// so the steady-state cost of a TLOG_* statement is a couple of uncontended
+/// atomic loads plus spdlog's own level check. Safe to share between threads:
+/// the logger and its generation are published as one pointer, so a racing
+/// re-resolve replaces the pair whole and a stale logger always carries the
+/// stale generation that gets it re-resolved.
+class TagLogger {
+public:
+    explicit TagLogger(std::string_view tag) noexcept : m_tag(tag) {}
+
+    spdlog::logger* get() {
+        // resolveTagLogger() locks the tag registry, which orders it after
+        // the refresh that bumped the generation.
+        const auto* resolved = m_resolved.load(std::memory_order_acquire);
+        if (resolved == nullptr ||
+            resolved->generation != detail::g_tagLoggerGeneration.load(std::memory_order_relaxed)) {
+            resolved = detail::resolveTagLogger(m_tag);
+            m_resolved.store(resolved, std::memory_order_release);
+        }
+        return resolved->logger;
+    }
+
+private:
+    std::string_view m_tag;
+    std::atomic<const detail::ResolvedTagLogger*> m_resolved{nullptr};
+};
+
 } // namespace void_crew
 
 // ---------------------------------------------------------------------------
@@ -44,19 +118,63 @@ std::shared_ptr<spdlog::logger> getLogger(std::string_view tag);
 // Tagged macros — log via a subsystem-specific logger.
 //   TLOG_INFO("config", "Loaded '{}'", path);
 //   -> [2024-01-15 14:30:22.123] [info] [config] Loaded 'server.toml'
-// For hot paths, cache the logger in a local static instead:
-//   static auto s_log = void_crew::getLogger("physics");
-//   SPDLOG_LOGGER_INFO(s_log, "tick");
+// The tag must be a string literal. Each call site caches its logger in a
+// TagLogger, and format arguments are only evaluated when the level passes.
+// Levels below SPDLOG_ACTIVE_LEVEL compile out entirely, as with LOG_*.
 // ---------------------------------------------------------------------------
 // NOLINTNEXTLINE(cppcoreguidelines-macro-usage)
-#define TLOG_TRACE(tag, ...) SPDLOG_LOGGER_TRACE(::void_crew::getLogger(tag), __VA_ARGS__)
+#define VOID_CREW_TLOG_CALL(tag, level, ...)                                                                         \
+    do {                                                                                                             \
+        static ::void_crew::TagLogger s_voidCrewTagLogger{::void_crew::detail::literalTag(tag)};                     \
+        if (auto* voidCrewLogger = s_voidCrewTagLogger.get(); voidCrewLogger->should_log(level)) {                   \
+            voidCrewLogger->log(spdlog::source_loc{__FILE__, __LINE__, SPDLOG_FUNCTION}, level, __VA_ARGS__);        \
+        }                                                                                                            \
+    } while (false)
+
+#if SPDLOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_TRACE
+// NOLINTNEXTLINE(cppcoreguidelines-macro-usage)
+#define TLOG_TRACE(tag, ...) VOID_CREW_TLOG_CALL(tag, spdlog::level::trace, __VA_ARGS__)
+#else
 // NOLINTNEXTLINE(cppcoreguidelines-macro-usage)
-#define TLOG_DEBUG(tag, ...) SPDLOG_LOGGER_DEBUG(::void_crew::getLogger(tag), __VA_ARGS__)
+#define TLOG_TRACE(tag, ...) (void)0
+#endif
+
+#if SPDLOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_DEBUG
 // NOLINTNEXTLINE(cppcoreguidelines-macro-usage)
-#define TLOG_INFO(tag, ...) SPDLOG_LOGGER_INFO(::void_crew::getLogger(tag), __VA_ARGS__)
+#define TLOG_DEBUG(tag, ...) VOID_CREW_TLOG_CALL(tag, spdlog::level::debug, __VA_ARGS__)
+#else
 // NOLINTNEXTLINE(cppcoreguidelines-macro-usage)
-#define TLOG_WARN(tag, ...) SPDLOG_LOGGER_WARN(::void_crew::getLogger(tag), __VA_ARGS__)
+#define TLOG_DEBUG(tag, ...) (void)0
+#endif
+
+#if SPDLOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_INFO
+// NOLINTNEXTLINE(cppcoreguidelines-macro-usage)
+#define TLOG_INFO(tag, ...) VOID_CREW_TLOG_CALL(tag, spdlog::level::info, __VA_ARGS__)
+#else
+// NOLINTNEXTLINE(cppcoreguidelines-macro-usage)
+#define TLOG_INFO(tag, ...) (void)0
+#endif
+
+#if SPDLOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_WARN
+// NOLINTNEXTLINE(cppcoreguidelines-macro-usage)
+#define TLOG_WARN(tag, ...) VOID_CREW_TLOG_CALL(tag, spdlog::level::warn, __VA_ARGS__)
+#else
+// NOLINTNEXTLINE(cppcoreguidelines-macro-usage)
+#define TLOG_WARN(tag, ...) (void)0
+#endif
+
+#if SPDLOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_ERROR
+// NOLINTNEXTLINE(cppcoreguidelines-macro-usage)
+#define TLOG_ERROR(tag, ...) VOID_CREW_TLOG_CALL(tag, spdlog::level::err, __VA_ARGS__)
+#else
+// NOLINTNEXTLINE(cppcoreguidelines-macro-usage)
+#define TLOG_ERROR(tag, ...) (void)0
+#endif
+
+#if SPDLOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_CRITICAL
 // NOLINTNEXTLINE(cppcoreguidelines-macro-usage)
-#define TLOG_ERROR(tag, ...) SPDLOG_LOGGER_ERROR(::void_crew::getLogger(tag), __VA_ARGS__)
+#define TLOG_CRITICAL(tag, ...) VOID_CREW_TLOG_CALL(tag, spdlog::level::critical, __VA_ARGS__)
+#else
 // NOLINTNEXTLINE(cppcoreguidelines-macro-usage)
-#define TLOG_CRITICAL(tag, ...) SPDLOG_LOGGER_CRITICAL(::void_crew::getLogger(tag), __VA_ARGS__)
+#define TLOG_CRITICAL(tag, ...) (void)0
+#endif
@@ -0,0 +1,175 @@
+#include "profiler.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <set>
+#include <string>
+
+#include <fmt/format.h>
+
+namespace void_crew {
+
+namespace {
+
+constexpr uint64_t RING_MASK = ProfileRing::CAPACITY - 1;
+constexpr double NS_PER_US = 1000.0;
+
+std::atomic<bool> g_profilingEnabled{true};
+std::atomic<uint32_t> g_nextThreadId{1};
+
+struct NameTable {
+    std::mutex mutex;
+    std::set<std::string, std::less<>> names; // node-based: c_str() stays valid
+};
+
+NameTable& nameTable() {
+    static NameTable s_table;
+    return s_table;
+}
+
+void appendJsonString(fmt::memory_buffer& out, const char* text) {
+    out.push_back('"');
+    for (const char* p = text; *p != '\0'; ++p) {
+        auto c = static_cast<unsigned char>(*p);
+        if (c == '"' || c == '\\') {
+            out.push_back('\\');
+            out.push_back(static_cast<char>(c));
+        } else if (c < 0x20) {
+            fmt::format_to(std::back_inserter(out), "\\u{:04x}", c);
+        } else {
+            out.push_back(static_cast<char>(c));
+        }
+    }
+    out.push_back('"');
+}
+
+} // namespace
+
+ProfileRing::ProfileRing() : m_slots(std::make_unique<Slot[]>(CAPACITY)) {}
+
+void ProfileRing::record(const char* name, uint64_t startNs, uint64_t durationNs, ProfileEventKind kind) noexcept {
+    auto index = m_next.fetch_add(1, std::memory_order_relaxed);
+    auto& slot = m_slots[index & RING_MASK];
+
+    // Seqlock publish: odd while the fields are being written, then the
+    // even value a reader expects for this index.
+    slot.sequence.store(2 * index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.name.store(name, std::memory_order_relaxed);
+    slot.startNs.store(startNs, std::memory_order_relaxed);
+    slot.durationNs.store(durationNs, std::memory_order_relaxed);
+    slot.threadId.store(profileThreadId(), std::memory_order_relaxed);
+    slot.kind.store(kind, std::memory_order_relaxed);
+    slot.sequence.store(2 * index + 2, std::memory_order_release);
+}
+
+std::vector<ProfileEvent> ProfileRing::snapshot() const {
+    auto end = m_next.load(std::memory_order_acquire);
+    auto begin = std::max(end > CAPACITY ? end - CAPACITY : 0, m_floor.load(std::memory_order_relaxed));
+
+    std::vector<ProfileEvent> events;
+    events.reserve(static_cast<std::size_t>(end - begin));
+    for (auto index = begin; index < end; ++index) {
+        const auto& slot = m_slots[index & RING_MASK];
+        auto expected = 2 * index + 2;
+        if (slot.sequence.load(std::memory_order_acquire) != expected) {
+            continue; // still being written, or already overwritten by a later lap
+        }
+
+        ProfileEvent event;
+        event.name = slot.name.load(std::memory_order_relaxed);
+        event.startNs = slot.startNs.load(std::memory_order_relaxed);
+        event.durationNs = slot.durationNs.load(std::memory_order_relaxed);
+        event.threadId = slot.threadId.load(std::memory_order_relaxed);
+        event.kind = slot.kind.load(std::memory_order_relaxed);
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.sequence.load(std::memory_order_relaxed) == expected) {
+            events.push_back(event);
+        }
+    }
+    return events;
+}
+
+void ProfileRing::writeChromeTrace(std::ostream& out) const {
+    auto events = snapshot();
+    uint64_t originNs = events.empty() ? 0 : events.front().startNs;
+    for (const auto& event : events) {
+        originNs = std::min(originNs, event.startNs);
+    }
+
+    fmt::memory_buffer buffer;
+    auto it = std::back_inserter(buffer);
+    fmt::format_to(it, "{{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+    bool first = true;
+    for (const auto& event : events) {
+        if (!first) {
+            buffer.push_back(',');
+        }
+        first = false;
+
+        double tsUs = static_cast<double>(event.startNs - originNs) / NS_PER_US;
+        fmt::format_to(it, "\n{{\"name\":");
+        appendJsonString(buffer, event.name != nullptr ? event.name : "?");
+        if (event.kind == ProfileEventKind::Frame) {
+            fmt::format_to(it, ",\"ph\":\"i\",\"s\":\"g\",\"ts\":{:.3f},\"pid\":1,\"tid\":{}}}", tsUs, event.threadId);
+        } else {
+            double durUs = static_cast<double>(event.durationNs) / NS_PER_US;
+            fmt::format_to(it, ",\"ph\":\"X\",\"ts\":{:.3f},\"dur\":{:.3f},\"pid\":1,\"tid\":{}}}", tsUs, durUs,
+                           event.threadId);
+        }
+    }
+    fmt::format_to(it, "\n]}}\n");
+
+    out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+}
+
+bool ProfileRing::writeChromeTrace(const std::filesystem::path& path) const {
+    std::error_code ec;
+    if (path.has_parent_path()) {
+        std::filesystem::create_directories(path.parent_path(), ec);
+    }
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        return false;
+    }
+    writeChromeTrace(file);
+    return static_cast<bool>(file.flush());
+}
+
+void ProfileRing::clear() noexcept {
+    m_floor.store(m_next.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+ProfileRing& profileRing() {
+    static ProfileRing s_ring;
+    return s_ring;
+}
+
+void setProfilingEnabled(bool enabled) noexcept {
+    g_profilingEnabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool isProfilingEnabled() noexcept {
+    return g_profilingEnabled.load(std::memory_order_relaxed);
+}
+
+const char* internProfileName(std::string_view name) {
+    auto& table = nameTable();
+    std::lock_guard lock(table.mutex);
+    auto it = table.names.find(name);
+    if (it == table.names.end()) {
+        it = table.names.emplace(name).first;
+    }
+    return it->c_str();
+}
+
+uint32_t profileThreadId() noexcept {
+    thread_local uint32_t t_id = g_nextThreadId.fetch_add(1, std::memory_order_relaxed);
+    return t_id;
+}
+
+} // namespace void_crew
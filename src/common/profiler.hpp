@@ -0,0 +1,151 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <ostream>
+#include <string_view>
+#include <vector>
+
+#ifdef VOID_CREW_TRACY
+#include <tracy/Tracy.hpp>
+#endif
+
+namespace void_crew {
+
+enum class ProfileEventKind : uint8_t { Zone, Frame };
+
+struct ProfileEvent {
+    const char* name = nullptr;
+    uint64_t startNs = 0;    // steady_clock, nanoseconds
+    uint64_t durationNs = 0; // 0 for frame marks
+    uint32_t threadId = 0;   // small sequential id, see profileThreadId()
+    ProfileEventKind kind = ProfileEventKind::Zone;
+};
+
+/// Fixed-size ring of recent profile events, written from any thread.
+///
+/// This is the fallback profiler used when Tracy is not compiled in: it keeps
+/// the last CAPACITY zones in memory so a headless server can dump them to a
+/// Chrome trace (chrome://tracing, Perfetto) after the fact. Writers claim a
+/// slot with one fetch_add and publish it through a per-slot sequence number,
+/// so recording never blocks and snapshots skip slots caught mid-write.
+class ProfileRing {
+public:
+    static constexpr std::size_t CAPACITY = std::size_t{1} << 16;
+
+    ProfileRing();
+
+    void record(const char* name, uint64_t startNs, uint64_t durationNs, ProfileEventKind kind) noexcept;
+
+    /// Consistent events currently in the ring, oldest first.
+    std::vector<ProfileEvent> snapshot() const;
+
+    /// Write the current contents as Chrome trace-event JSON.
+    void writeChromeTrace(std::ostream& out) const;
+
+    /// Same, to a file; parent directories are created. Returns false on I/O failure.
+    bool writeChromeTrace(const std::filesystem::path& path) const;
+
+    void clear() noexcept;
+
+private:
+    struct Slot {
+        std::atomic<uint64_t> sequence{0}; // 2 * index + 2 once published, odd while writing
+        std::atomic<const char*> name{nullptr};
+        std::atomic<uint64_t> startNs{0};
+        std::atomic<uint64_t> durationNs{0};
+        std::atomic<uint32_t> threadId{0};
+        std::atomic<ProfileEventKind> kind{ProfileEventKind::Zone};
+    };
+
+    std::unique_ptr<Slot[]> m_slots;
+    std::atomic<uint64_t> m_next{0};
+    std::atomic<uint64_t> m_floor{0}; // events before this index were cleared
+};
+
+/// The process-wide ring used by PROFILE_* macros in fallback mode.
+ProfileRing& profileRing();
+
+/// Runtime switch for the fallback profiler (on by default). Has no effect on
+/// Tracy, which is controlled by the capture client.
+void setProfilingEnabled(bool enabled) noexcept;
+bool isProfilingEnabled() noexcept;
+
+/// Returns a pointer to a copy of @p name that lives until process exit.
+/// Ring events store name pointers, so runtime names (e.g. system names)
+/// must be interned before they are used for zones.
+const char* internProfileName(std::string_view name);
+
+/// Small sequential id of the calling thread, stable for its lifetime.
+uint32_t profileThreadId() noexcept;
+
+inline uint64_t profileNowNs() noexcept {
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+            .count());
+}
+
+/// RAII zone for the fallback profiler. @p name must outlive the ring:
+/// a string literal or a pointer from internProfileName().
+class ProfileZone {
+public:
+    explicit ProfileZone(const char* name) noexcept
+        : m_name(isProfilingEnabled() ? name : nullptr),
+          m_startNs(m_name != nullptr ? profileNowNs() : 0) {}
+
+    ~ProfileZone() {
+        if (m_name != nullptr) {
+            profileRing().record(m_name, m_startNs, profileNowNs() - m_startNs, ProfileEventKind::Zone);
+        }
+    }
+
+    ProfileZone(const ProfileZone&) = delete;
+    ProfileZone(ProfileZone&&) = delete;
+    ProfileZone& operator=(const ProfileZone&) = delete;
+    ProfileZone& operator=(ProfileZone&&) = delete;
+
+private:
+    const char* m_name;
+    uint64_t m_startNs;
+};
+
+inline void markProfileFrame() noexcept {
+    if (isProfilingEnabled()) {
+        profileRing().record("frame", profileNowNs(), 0, ProfileEventKind::Frame);
+    }
+}
+
+} // namespace void_crew
+
+// ---------------------------------------------------------------------------
+// Profiling macros.
+//   PROFILE_ZONE("snapshot");          // literal name, scoped to the block
+//   PROFILE_ZONE_NAMED(internedName);  // runtime name from internProfileName()
+//   PROFILE_FRAME();                   // end of one simulation tick
+// With VOID_CREW_TRACY defined they map to Tracy zones and frame marks;
+// otherwise they record into profileRing().
+// ---------------------------------------------------------------------------
+// NOLINTNEXTLINE(cppcoreguidelines-macro-usage)
+#define VOID_CREW_PROFILE_CONCAT_INNER(a, b) a##b
+// NOLINTNEXTLINE(cppcoreguidelines-macro-usage)
+#define VOID_CREW_PROFILE_CONCAT(a, b) VOID_CREW_PROFILE_CONCAT_INNER(a, b)
+
+#ifdef VOID_CREW_TRACY
+// NOLINTNEXTLINE(cppcoreguidelines-macro-usage)
+#define PROFILE_ZONE(name) ZoneScopedN(name)
+// NOLINTNEXTLINE(cppcoreguidelines-macro-usage)
+#define PROFILE_ZONE_NAMED(name) ZoneTransientN(VOID_CREW_PROFILE_CONCAT(voidCrewZone, __LINE__), name, true)
+// NOLINTNEXTLINE(cppcoreguidelines-macro-usage)
+#define PROFILE_FRAME() FrameMark
+#else
+// NOLINTNEXTLINE(cppcoreguidelines-macro-usage)
+#define PROFILE_ZONE(name) ::void_crew::ProfileZone VOID_CREW_PROFILE_CONCAT(voidCrewZone, __LINE__)(name)
+// NOLINTNEXTLINE(cppcoreguidelines-macro-usage)
+#define PROFILE_ZONE_NAMED(name) ::void_crew::ProfileZone VOID_CREW_PROFILE_CONCAT(voidCrewZone, __LINE__)(name)
+// NOLINTNEXTLINE(cppcoreguidelines-macro-usage)
+#define PROFILE_FRAME() ::void_crew::markProfileFrame()
+#endif
@@ -0,0 +1,71 @@
+#include "snapshot.hpp"
+
+#include "components.hpp"
+
+namespace void_crew {
+
+namespace {
+
+net::Vec3 toNet(const glm::vec3& value) {
+    return {value.x, value.y, value.z};
+}
+
+net::Quat toNet(const glm::quat& value) {
+    return {value.x, value.y, value.z, value.w};
+}
+
+} // namespace
+
+SnapshotBuilder::SnapshotBuilder(std::size_t initialCapacity)
+    : m_builder(initialCapacity),
+      m_reservedBytes(initialCapacity) {}
+
+void SnapshotBuilder::reserve(std::size_t entities) {
+    m_transforms.reserve(entities);
+    m_velocities.reserve(entities);
+    // Both pools for every entity, plus table and vector headers.
+    auto bytes = entities * (sizeof(net::TransformState) + sizeof(net::VelocityState)) + 256;
+    if (bytes > m_reservedBytes) {
+        m_builder = flatbuffers::FlatBufferBuilder(bytes);
+        m_reservedBytes = bytes;
+        m_built = false;
+    }
+}
+
+std::span<const uint8_t> SnapshotBuilder::build(const entt::registry& registry, uint64_t tick) {
+    // Clear() keeps the allocated buffer: the next snapshot reuses it.
+    m_builder.Clear();
+    m_built = false;
+    m_transforms.clear();
+    m_velocities.clear();
+
+    for (auto [entity, id, transform] : registry.view<const NetworkId, const Transform>().each()) {
+        m_transforms.emplace_back(id.value, toNet(transform.position), toNet(transform.rotation));
+    }
+    for (auto [entity, id, velocity] : registry.view<const NetworkId, const Velocity>().each()) {
+        m_velocities.emplace_back(id.value, toNet(velocity.linear), toNet(velocity.angular));
+    }
+
+    auto transforms = m_builder.CreateVectorOfStructs(m_transforms.data(), m_transforms.size());
+    auto velocities = m_builder.CreateVectorOfStructs(m_velocities.data(), m_velocities.size());
+    net::FinishWorldSnapshotBuffer(m_builder, net::CreateWorldSnapshot(m_builder, tick, transforms, velocities));
+    m_built = true;
+    return data();
+}
+
+std::span<const uint8_t> SnapshotBuilder::data() const noexcept {
+    if (!m_built) {
+        return {};
+    }
+    return {m_builder.GetBufferPointer(), m_builder.GetSize()};
+}
+
+const net::WorldSnapshot* readSnapshot(std::span<const uint8_t> buffer) {
+    flatbuffers::Verifier verifier(buffer.data(), buffer.size());
+    if (!net::VerifyWorldSnapshotBuffer(verifier)) {
+        return nullptr;
+    }
+    return net::GetWorldSnapshot(buffer.data());
+}
+
+} // namespace void_crew
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <entt/entt.hpp>
+#include <flatbuffers/flatbuffers.h>
+
+#include "world_snapshot_generated.h"
+
+namespace void_crew {
+
+/// Serializes replicated registry state into a FlatBuffers WorldSnapshot.
+///
+/// Walks the Transform and Velocity pools of entities that carry a NetworkId
+/// and writes each pool as a vector of fixed-size structs. The builder's
+/// buffer and per-pool scratch are kept between calls, so after the first few
+/// snapshots build() does not allocate; reserve up front to skip even those.
+/// Not thread-safe; build() only reads the registry.
+class SnapshotBuilder {
+public:
+    static constexpr std::size_t DEFAULT_CAPACITY = 64 * 1024; // bytes
+
+    explicit SnapshotBuilder(std::size_t initialCapacity = DEFAULT_CAPACITY);
+
+    SnapshotBuilder(const SnapshotBuilder&) = delete;
+    SnapshotBuilder& operator=(const SnapshotBuilder&) = delete;
+    SnapshotBuilder(SnapshotBuilder&&) = delete;
+    SnapshotBuilder& operator=(SnapshotBuilder&&) = delete;
+
+    /// Pre-sizes the buffer and scratch for @p entities replicated entities.
+    /// Invalidates the last snapshot if the buffer has to grow.
+    void reserve(std::size_t entities);
+
+    /// Builds a snapshot of @p registry for @p tick. The returned bytes stay
+    /// valid until the next build().
+    std::span<const uint8_t> build(const entt::registry& registry, uint64_t tick);
+
+    /// The last built snapshot (empty before the first build()).
+    std::span<const uint8_t> data() const noexcept;
+
+private:
+    flatbuffers::FlatBufferBuilder m_builder;
+    std::size_t m_reservedBytes;
+    bool m_built = false;
+    std::vector<net::TransformState> m_transforms;
+    std::vector<net::VelocityState> m_velocities;
+};
+
+/// Verifies @p buffer and returns the snapshot it holds, read in place.
+/// Returns nullptr if the buffer is truncated, corrupt or not a snapshot.
+/// The result points into @p buffer and is valid as long as it is.
+const net::WorldSnapshot* readSnapshot(std::span<const uint8_t> buffer);
+
+} // namespace void_crew
@@ -0,0 +1,481 @@
+#include "atmosphere.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <stdexcept>
+
+#include <fmt/format.h>
+
+#include "logging.hpp"
+#include "profiler.hpp"
+
+namespace void_crew::server {
+
+namespace {
+
+constexpr float GAS_CONSTANT = 8.314462618f;   // J/(mol K)
+constexpr float STANDARD_PRESSURE = 101325.0f; // Pa
+constexpr float STANDARD_TEMPERATURE = 293.15f; // K
+constexpr GasMix AIR_FRACTIONS = {0.2095f, 0.7901f, 0.0004f}; // argon counted as nitrogen
+
+// Explicit diffusion stays monotone (no overshoot, no negative amounts)
+// while substep * conductance / volume summed over a node's links is at
+// most one half.
+constexpr float MAX_SUBSTEP_STIFFNESS = 0.5f;
+
+constexpr uint32_t NO_COMPONENT = UINT32_MAX;
+
+std::size_t gasIndex(Gas gas) {
+    return static_cast<std::size_t>(gas);
+}
+
+uint32_t findRoot(std::vector<uint32_t> &parent, uint32_t node) {
+    while (parent[node] != node) {
+        parent[node] = parent[parent[node]];
+        node = parent[node];
+    }
+    return node;
+}
+
+} // namespace
+
+GasMix standardAir(float volume) {
+    float moles = STANDARD_PRESSURE * volume / (GAS_CONSTANT * STANDARD_TEMPERATURE);
+    GasMix mix{};
+    for (std::size_t gas = 0; gas < GAS_COUNT; ++gas) {
+        mix[gas] = moles * AIR_FRACTIONS[gas];
+    }
+    return mix;
+}
+
+Atmosphere::Atmosphere(AtmosphereConfig config)
+    : m_config(config) {
+    // Just the space sink until compartments are added.
+    m_inverseVolume.push_back(0.0f);
+    for (auto &amounts : m_amount) {
+        amounts.push_back(0.0f);
+    }
+    m_concentration.push_back(0.0f);
+}
+
+void Atmosphere::addCompartment(CompartmentId id, float volume, const GasMix &gas) {
+    if (!(volume > 0.0f)) {
+        throw std::invalid_argument(fmt::format("atmosphere: compartment {} volume {} must be positive", id, volume));
+    }
+    auto index = static_cast<uint32_t>(m_indices.size());
+    if (!m_indices.emplace(id, index).second) {
+        throw std::invalid_argument(fmt::format("atmosphere: compartment {} already exists", id));
+    }
+
+    // The new compartment takes the sink's slot; the sink moves one up.
+    auto slot = static_cast<uint32_t>(m_inverseVolume.size() - 1);
+    m_slotOf.push_back(slot);
+    m_inverseVolume.back() = 1.0f / volume;
+    m_inverseVolume.push_back(0.0f);
+    for (std::size_t g = 0; g < GAS_COUNT; ++g) {
+        m_amount[g].back() = std::max(gas[g], 0.0f);
+        m_amount[g].push_back(0.0f);
+    }
+    m_concentration.push_back(0.0f);
+    m_componentOf.push_back(NO_COMPONENT);
+
+    m_topologyDirty = true;
+    m_woken.push_back(index);
+    ++m_stats.compartments;
+}
+
+AtmosphereLinkId Atmosphere::connect(CompartmentId first, CompartmentId second, float conductance, bool open) {
+    auto a = indexOf(first);
+    auto b = indexOf(second);
+    if (a == b) {
+        throw std::invalid_argument(fmt::format("atmosphere: compartment {} linked to itself", first));
+    }
+    return addLink(a, b, conductance, open);
+}
+
+AtmosphereLinkId Atmosphere::connectToSpace(CompartmentId compartment, float conductance, bool open) {
+    return addLink(indexOf(compartment), SPACE, conductance, open);
+}
+
+AtmosphereLinkId Atmosphere::addLink(uint32_t first, uint32_t second, float conductance, bool open) {
+    if (!(conductance >= 0.0f)) {
+        throw std::invalid_argument(fmt::format("atmosphere: link conductance {} must not be negative", conductance));
+    }
+    auto id = static_cast<AtmosphereLinkId>(m_links.size());
+    m_links.push_back({first, second, conductance, open});
+    if (open && conductance > 0.0f) {
+        m_topologyDirty = true;
+        wake(first);
+        wake(second);
+    }
+    return id;
+}
+
+void Atmosphere::setOpen(AtmosphereLinkId link, bool open) {
+    linkAt(link);
+    auto &entry = m_links[link];
+    if (entry.open == open) {
+        return;
+    }
+    entry.open = open;
+    m_topologyDirty = true;
+    wake(entry.first);
+    wake(entry.second);
+}
+
+void Atmosphere::setConductance(AtmosphereLinkId link, float conductance) {
+    linkAt(link);
+    if (!(conductance >= 0.0f)) {
+        throw std::invalid_argument(fmt::format("atmosphere: link conductance {} must not be negative", conductance));
+    }
+    auto &entry = m_links[link];
+    if (entry.conductance == conductance) {
+        return;
+    }
+    entry.conductance = conductance;
+    if (entry.open) {
+        m_topologyDirty = true;
+        wake(entry.first);
+        wake(entry.second);
+    }
+}
+
+bool Atmosphere::isOpen(AtmosphereLinkId link) const {
+    return linkAt(link).open;
+}
+
+bool Atmosphere::contains(CompartmentId compartment) const {
+    return m_indices.contains(compartment);
+}
+
+void Atmosphere::addGas(CompartmentId compartment, Gas gas, float moles) {
+    auto index = indexOf(compartment);
+    auto &amount = m_amount[gasIndex(gas)][m_slotOf[index]];
+    amount = std::max(amount + moles, 0.0f);
+    wake(index);
+}
+
+float Atmosphere::amount(CompartmentId compartment, Gas gas) const {
+    return m_amount[gasIndex(gas)][m_slotOf[indexOf(compartment)]];
+}
+
+float Atmosphere::pressure(CompartmentId compartment) const {
+    auto slot = m_slotOf[indexOf(compartment)];
+    float moles = 0.0f;
+    for (const auto &amounts : m_amount) {
+        moles += amounts[slot];
+    }
+    return moles * GAS_CONSTANT * m_config.temperature * m_inverseVolume[slot] / 1000.0f;
+}
+
+bool Atmosphere::isActive(CompartmentId compartment) const {
+    auto component = m_componentOf[m_slotOf[indexOf(compartment)]];
+    return component == NO_COMPONENT || m_components[component].awake;
+}
+
+void Atmosphere::step(float dt) {
+    if (m_topologyDirty) {
+        rebuild();
+    }
+    for (auto index : m_woken) {
+        auto &component = m_components[m_componentOf[m_slotOf[index]]];
+        if (!component.awake) {
+            component.awake = true;
+            m_awake.push_back(static_cast<uint32_t>(&component - m_components.data()));
+        }
+    }
+    m_woken.clear();
+
+    m_stats.steppedCompartments = 0;
+    m_stats.steppedLinks = 0;
+    std::size_t kept = 0;
+    for (auto id : m_awake) {
+        auto &component = m_components[id];
+        if (solve(component, dt)) {
+            m_awake[kept++] = id;
+        } else {
+            component.awake = false;
+        }
+    }
+    m_awake.resize(kept);
+    m_stats.activeComponents = kept;
+}
+
+AtmosphereStats Atmosphere::stats() const noexcept {
+    return m_stats;
+}
+
+uint32_t Atmosphere::indexOf(CompartmentId compartment) const {
+    auto it = m_indices.find(compartment);
+    if (it == m_indices.end()) {
+        throw std::out_of_range(fmt::format("atmosphere: unknown compartment {}", compartment));
+    }
+    return it->second;
+}
+
+const Atmosphere::Link &Atmosphere::linkAt(AtmosphereLinkId link) const {
+    if (link >= m_links.size()) {
+        throw std::out_of_range(fmt::format("atmosphere: unknown link {}", link));
+    }
+    return m_links[link];
+}
+
+void Atmosphere::wake(uint32_t index) {
+    if (index != SPACE) {
+        m_woken.push_back(index);
+    }
+}
+
+void Atmosphere::rebuild() {
+    PROFILE_ZONE("atmosphere.rebuild");
+    auto count = static_cast<uint32_t>(m_indices.size());
+    auto sink = count;
+    auto flows = [](const Link &link) { return link.open && link.conductance > 0.0f; };
+
+    // Components: compartments joined by open links. Space joins nothing, so
+    // two breached rooms stay independent.
+    std::vector<uint32_t> parent(count);
+    std::iota(parent.begin(), parent.end(), 0U);
+    for (const auto &link : m_links) {
+        if (flows(link) && link.first != SPACE && link.second != SPACE) {
+            parent[findRoot(parent, link.first)] = findRoot(parent, link.second);
+        }
+    }
+    std::vector<uint32_t> rootComponent(count, NO_COMPONENT);
+    std::vector<uint32_t> componentOfIndex(count);
+    uint32_t componentCount = 0;
+    for (uint32_t i = 0; i < count; ++i) {
+        auto &component = rootComponent[findRoot(parent, i)];
+        if (component == NO_COMPONENT) {
+            component = componentCount++;
+        }
+        componentOfIndex[i] = component;
+    }
+
+    // A new component stays awake if any part of it was.
+    std::vector<Component> components(componentCount);
+    for (uint32_t i = 0; i < count; ++i) {
+        auto old = m_componentOf[m_slotOf[i]];
+        if (old == NO_COMPONENT || m_components[old].awake) {
+            components[componentOfIndex[i]].awake = true;
+        }
+    }
+
+    // Nodes, counting-sorted by component.
+    for (uint32_t i = 0; i < count; ++i) {
+        ++components[componentOfIndex[i]].nodeEnd;
+    }
+    uint32_t offset = 0;
+    for (auto &component : components) {
+        component.nodeBegin = offset;
+        offset += component.nodeEnd;
+        component.nodeEnd = component.nodeBegin;
+    }
+    std::vector<uint32_t> slotOf(count);
+    std::vector<float> inverseVolume(count + 1, 0.0f);
+    std::array<std::vector<float>, GAS_COUNT> amount;
+    for (auto &amounts : amount) {
+        amounts.assign(count + 1, 0.0f);
+    }
+    std::vector<uint32_t> componentOf(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        auto component = componentOfIndex[i];
+        auto slot = components[component].nodeEnd++;
+        auto old = m_slotOf[i];
+        slotOf[i] = slot;
+        inverseVolume[slot] = m_inverseVolume[old];
+        for (std::size_t g = 0; g < GAS_COUNT; ++g) {
+            amount[g][slot] = m_amount[g][old];
+        }
+        componentOf[slot] = component;
+    }
+
+    // Open links, counting-sorted by the component of their inner end.
+    auto edgeComponent = [&](const Link &link) {
+        return componentOfIndex[link.first != SPACE ? link.first : link.second];
+    };
+    for (const auto &link : m_links) {
+        if (flows(link)) {
+            ++components[edgeComponent(link)].edgeEnd;
+        }
+    }
+    offset = 0;
+    for (auto &component : components) {
+        component.edgeBegin = offset;
+        offset += component.edgeEnd;
+        component.edgeEnd = component.edgeBegin;
+    }
+    auto slotOrSink = [&](uint32_t index) { return index == SPACE ? sink : slotOf[index]; };
+    std::vector<float> nodeConductance(count + 1, 0.0f);
+    m_edgeFirst.assign(offset, 0);
+    m_edgeSecond.assign(offset, 0);
+    m_edgeConductance.assign(offset, 0.0f);
+    m_edgeRate.assign(offset, 0.0f);
+    m_edgeFlow.assign(offset, 0.0f);
+    for (const auto &link : m_links) {
+        if (!flows(link)) {
+            continue;
+        }
+        auto edge = components[edgeComponent(link)].edgeEnd++;
+        m_edgeFirst[edge] = slotOrSink(link.first);
+        m_edgeSecond[edge] = slotOrSink(link.second);
+        m_edgeConductance[edge] = link.conductance;
+        nodeConductance[m_edgeFirst[edge]] += link.conductance;
+        nodeConductance[m_edgeSecond[edge]] += link.conductance;
+    }
+    for (auto &component : components) {
+        for (auto slot = component.nodeBegin; slot < component.nodeEnd; ++slot) {
+            component.stiffness = std::max(component.stiffness, nodeConductance[slot] * inverseVolume[slot]);
+        }
+    }
+
+    m_slotOf = std::move(slotOf);
+    m_inverseVolume = std::move(inverseVolume);
+    m_amount = std::move(amount);
+    m_componentOf = std::move(componentOf);
+    m_components = std::move(components);
+    m_concentration.assign(count + 1, 0.0f);
+    m_awake.clear();
+    for (uint32_t c = 0; c < componentCount; ++c) {
+        if (m_components[c].awake) {
+            m_awake.push_back(c);
+        }
+    }
+    m_topologyDirty = false;
+
+    ++m_stats.rebuilds;
+    m_stats.components = componentCount;
+    m_stats.links = offset;
+}
+
+bool Atmosphere::solve(Component &component, float dt) {
+    auto nodeBegin = component.nodeBegin;
+    auto nodeEnd = component.nodeEnd;
+    auto edgeBegin = component.edgeBegin;
+    auto edgeEnd = component.edgeEnd;
+    m_stats.steppedCompartments += nodeEnd - nodeBegin;
+    if (edgeBegin == edgeEnd) {
+        return false; // sealed: nothing can flow
+    }
+
+    // Substep count for stability; past the cap the component just flows
+    // slower than it should instead of blowing up.
+    float stable = MAX_SUBSTEP_STIFFNESS / component.stiffness;
+    int substeps = std::clamp(static_cast<int>(std::ceil(dt / stable)), 1, std::max(m_config.maxSubsteps, 1));
+    float substep = std::min(dt / static_cast<float>(substeps), stable);
+
+    const float *conductance = m_edgeConductance.data();
+    float *rate = m_edgeRate.data();
+    for (auto e = edgeBegin; e < edgeEnd; ++e) {
+        rate[e] = conductance[e] * substep;
+    }
+
+    const uint32_t *first = m_edgeFirst.data();
+    const uint32_t *second = m_edgeSecond.data();
+    const float *inverseVolume = m_inverseVolume.data();
+    float *concentration = m_concentration.data();
+    float *flow = m_edgeFlow.data();
+    auto sink = static_cast<uint32_t>(m_slotOf.size());
+    float largestDifference = 0.0f;
+    for (int s = 0; s < substeps; ++s) {
+        largestDifference = 0.0f;
+        for (auto &amounts : m_amount) {
+            float *amount = amounts.data();
+            for (auto slot = nodeBegin; slot < nodeEnd; ++slot) {
+                concentration[slot] = amount[slot] * inverseVolume[slot];
+            }
+            for (auto e = edgeBegin; e < edgeEnd; ++e) {
+                float difference = concentration[first[e]] - concentration[second[e]];
+                flow[e] = rate[e] * difference;
+                largestDifference = std::max(largestDifference, std::abs(difference));
+            }
+            // Scatter stays scalar: two edges may share an endpoint.
+            for (auto e = edgeBegin; e < edgeEnd; ++e) {
+                amount[first[e]] -= flow[e];
+                amount[second[e]] += flow[e];
+            }
+            amount[sink] = 0.0f; // space absorbs everything
+        }
+    }
+    m_stats.steppedLinks += static_cast<std::size_t>(edgeEnd - edgeBegin) * static_cast<std::size_t>(substeps);
+    return largestDifference >= m_config.equilibriumEpsilon;
+}
+
+AtmosphereSync::AtmosphereSync(entt::registry &registry, Atmosphere &atmosphere)
+    : m_registry(registry),
+      m_atmosphere(atmosphere) {
+    m_registry.on_construct<CompartmentVolume>().connect<&AtmosphereSync::onCompartmentAdded>(*this);
+    m_registry.on_construct<Door>().connect<&AtmosphereSync::onDoorChanged>(*this);
+    m_registry.on_update<Door>().connect<&AtmosphereSync::onDoorChanged>(*this);
+    m_registry.on_destroy<Door>().connect<&AtmosphereSync::onDoorDestroyed>(*this);
+
+    for (auto entity : m_registry.view<CompartmentVolume>()) {
+        m_addedCompartments.push_back(entity);
+    }
+    for (auto entity : m_registry.view<Door>()) {
+        m_changedDoors.push_back(entity);
+    }
+}
+
+AtmosphereSync::~AtmosphereSync() {
+    m_registry.on_construct<CompartmentVolume>().disconnect(*this);
+    m_registry.on_construct<Door>().disconnect(*this);
+    m_registry.on_update<Door>().disconnect(*this);
+    m_registry.on_destroy<Door>().disconnect(*this);
+}
+
+void AtmosphereSync::update() {
+    for (auto entity : m_addedCompartments) {
+        const auto *compartment = m_registry.valid(entity) ? m_registry.try_get<CompartmentVolume>(entity) : nullptr;
+        if (compartment == nullptr) {
+            continue;
+        }
+        if (m_atmosphere.contains(compartment->id) || !(compartment->volume > 0.0f)) {
+            TLOG_WARN("atmosphere", "Ignoring compartment {} with volume {}: duplicate or not positive",
+                      compartment->id, compartment->volume);
+            continue;
+        }
+        m_atmosphere.addCompartment(compartment->id, compartment->volume, standardAir(compartment->volume));
+    }
+    m_addedCompartments.clear();
+
+    std::size_t waiting = 0;
+    for (auto entity : m_changedDoors) {
+        const auto *door = m_registry.valid(entity) ? m_registry.try_get<Door>(entity) : nullptr;
+        if (door == nullptr || door->first == door->second) {
+            continue;
+        }
+        if (auto it = m_doorLinks.find(entity); it != m_doorLinks.end()) {
+            m_atmosphere.setOpen(it->second, door->open);
+        } else if (m_atmosphere.contains(door->first) && m_atmosphere.contains(door->second)) {
+            m_doorLinks.emplace(entity, m_atmosphere.connect(door->first, door->second, DOOR_CONDUCTANCE, door->open));
+        } else {
+            m_changedDoors[waiting++] = entity;
+        }
+    }
+    m_changedDoors.resize(waiting);
+    std::sort(m_changedDoors.begin(), m_changedDoors.end());
+    m_changedDoors.erase(std::unique(m_changedDoors.begin(), m_changedDoors.end()), m_changedDoors.end());
+}
+
+std::size_t AtmosphereSync::pendingDoors() const noexcept {
+    return m_changedDoors.size();
+}
+
+void AtmosphereSync::onCompartmentAdded(entt::registry &, entt::entity entity) {
+    m_addedCompartments.push_back(entity);
+}
+
+void AtmosphereSync::onDoorChanged(entt::registry &, entt::entity entity) {
+    m_changedDoors.push_back(entity);
+}
+
+void AtmosphereSync::onDoorDestroyed(entt::registry &, entt::entity entity) {
+    if (auto it = m_doorLinks.find(entity); it != m_doorLinks.end()) {
+        m_atmosphere.setOpen(it->second, false);
+        m_doorLinks.erase(it);
+    }
+}
+
+} // namespace void_crew::server
@@ -0,0 +1,203 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include <entt/entt.hpp>
+
+#include "components.hpp"
+
+namespace void_crew::server {
+
+enum class Gas : uint8_t { Oxygen, Nitrogen, CarbonDioxide };
+
+constexpr std::size_t GAS_COUNT = 3;
+
+/// Amount of each gas in mol, indexed by Gas.
+using GasMix = std::array<float, GAS_COUNT>;
+
+/// Breathable air at one atmosphere and 20 °C filling @p volume m^3.
+GasMix standardAir(float volume);
+
+using AtmosphereLinkId = uint32_t;
+
+/// Gives compartment @c id its air: AtmosphereSync adds it to the server's
+/// Atmosphere with @c volume m^3 of standardAir(). One entity per
+/// compartment; compartments are never removed.
+struct CompartmentVolume {
+    CompartmentId id = 0;
+    float volume = 0.0f; // m^3
+};
+
+struct AtmosphereConfig {
+    float temperature = 293.15f;      // K; one for the whole ship, for pressure readings
+    float equilibriumEpsilon = 1e-3f; // mol/m^3 across every link of a component to let it sleep
+    int maxSubsteps = 16;             // per step(); stiffer components flow slower instead
+};
+
+struct AtmosphereStats {
+    std::size_t compartments = 0;
+    std::size_t links = 0;               // open ones
+    std::size_t components = 0;          // compartments joined by open links
+    std::size_t activeComponents = 0;    // awake after the last step
+    std::size_t steppedCompartments = 0; // solved in the last step
+    std::size_t steppedLinks = 0;        // same, counting substeps
+    uint64_t rebuilds = 0;               // topology changes since construction
+};
+
+/// Gas diffusion between compartments through doors, vents and hull breaches.
+///
+/// Compartments and open links are kept as a structure of arrays grouped by
+/// connected component, so each component is a contiguous range of nodes and
+/// edges. The diffusion kernel is scalar: it streams through flat float
+/// arrays one gas at a time, gathering concentrations by edge endpoint and
+/// scattering flows back the same way. Opening, closing or adding a link regroups the arrays before
+/// the next step; that is linear in the ship's size and only happens on
+/// topology changes.
+///
+/// Evaluation is lazy: a component is stepped only while it is out of
+/// equilibrium. It falls asleep once no link carries a concentration
+/// difference above equilibriumEpsilon, and wakes when one of its links or
+/// compartments changes (a breach, a vent toggle, addGas()). A ship at rest
+/// costs nothing per tick.
+///
+/// Links to space drain into a vacuum that never fills up. Flow through a
+/// link is conductance (m^3/s) times the concentration difference; stiff
+/// components are substepped to stay stable. Game thread only.
+class Atmosphere {
+public:
+    explicit Atmosphere(AtmosphereConfig config = {});
+
+    /// Adds a sealed compartment of @p volume m^3. Throws std::invalid_argument
+    /// if @p id exists or the volume is not positive.
+    void addCompartment(CompartmentId id, float volume, const GasMix &gas);
+
+    /// Joins two compartments, e.g. a door or a vent duct.
+    AtmosphereLinkId connect(CompartmentId first, CompartmentId second, float conductance, bool open = true);
+
+    /// Joins a compartment to space, e.g. an airlock vent or a hull breach.
+    AtmosphereLinkId connectToSpace(CompartmentId compartment, float conductance, bool open = true);
+
+    void setOpen(AtmosphereLinkId link, bool open);
+    void setConductance(AtmosphereLinkId link, float conductance);
+    bool isOpen(AtmosphereLinkId link) const;
+
+    bool contains(CompartmentId compartment) const;
+
+    /// Adds (or with a negative amount removes) gas: life support, breathing,
+    /// fire. The amount never drops below zero. Wakes the compartment.
+    void addGas(CompartmentId compartment, Gas gas, float moles);
+
+    float amount(CompartmentId compartment, Gas gas) const;
+
+    /// Total pressure in kPa.
+    float pressure(CompartmentId compartment) const;
+
+    /// Whether the compartment's component is still being solved.
+    bool isActive(CompartmentId compartment) const;
+
+    /// Advances every awake component by @p dt seconds.
+    void step(float dt);
+
+    AtmosphereStats stats() const noexcept;
+
+private:
+    static constexpr uint32_t SPACE = UINT32_MAX; // link end outside the hull
+
+    struct Link {
+        uint32_t first = 0; // compartment indices
+        uint32_t second = 0;
+        float conductance = 0.0f;
+        bool open = false;
+    };
+
+    struct Component {
+        uint32_t nodeBegin = 0;
+        uint32_t nodeEnd = 0;
+        uint32_t edgeBegin = 0;
+        uint32_t edgeEnd = 0;
+        float stiffness = 0.0f; // max over nodes of total conductance / volume, 1/s
+        bool awake = false;
+    };
+
+    uint32_t indexOf(CompartmentId compartment) const;
+    AtmosphereLinkId addLink(uint32_t first, uint32_t second, float conductance, bool open);
+    const Link &linkAt(AtmosphereLinkId link) const;
+    void wake(uint32_t index);
+
+    void rebuild();
+    bool solve(Component &component, float dt);
+
+    AtmosphereConfig m_config;
+
+    std::unordered_map<CompartmentId, uint32_t> m_indices; // id -> index, stable
+    std::vector<Link> m_links;                             // as authored, indexed by AtmosphereLinkId
+
+    // Compiled graph, in slot order: compartments grouped by component. One
+    // extra slot past the last compartment is the space sink: zero inverse
+    // volume, so its concentration stays zero whatever flows in.
+    std::vector<uint32_t> m_slotOf; // index -> slot
+    std::vector<float> m_inverseVolume;
+    std::array<std::vector<float>, GAS_COUNT> m_amount;
+    std::vector<float> m_concentration;  // scratch, one gas at a time
+    std::vector<uint32_t> m_componentOf; // slot -> component
+
+    // Open links, grouped by component, endpoints as slots.
+    std::vector<uint32_t> m_edgeFirst;
+    std::vector<uint32_t> m_edgeSecond;
+    std::vector<float> m_edgeConductance;
+    std::vector<float> m_edgeRate; // conductance * substep, scratch
+    std::vector<float> m_edgeFlow; // scratch
+
+    std::vector<Component> m_components;
+    std::vector<uint32_t> m_awake; // components to step, each once
+    std::vector<uint32_t> m_woken; // compartment indices woken since the last step
+    bool m_topologyDirty = false;
+
+    AtmosphereStats m_stats;
+};
+
+/// Feeds an Atmosphere from the registry: CompartmentVolume entities become
+/// compartments and Door entities become links between them that follow
+/// Door::open.
+///
+/// Registry signals record what changed and update() applies it before the
+/// atmosphere steps. A door whose compartments do not exist yet waits for
+/// them. A door's compartments are fixed once it is linked; a destroyed door
+/// closes its link. Toggle Door::open with registry.patch(), as for
+/// InterestManager. Game thread only.
+class AtmosphereSync {
+public:
+    static constexpr float DOOR_CONDUCTANCE = 2.0f; // m^3/s through an open door
+
+    AtmosphereSync(entt::registry &registry, Atmosphere &atmosphere);
+    ~AtmosphereSync();
+
+    AtmosphereSync(const AtmosphereSync &) = delete;
+    AtmosphereSync &operator=(const AtmosphereSync &) = delete;
+    AtmosphereSync(AtmosphereSync &&) = delete;
+    AtmosphereSync &operator=(AtmosphereSync &&) = delete;
+
+    /// Adds new compartments and links or toggles the doors changed since
+    /// the last call.
+    void update();
+
+    /// Doors waiting for one of their compartments as of the last update().
+    std::size_t pendingDoors() const noexcept;
+
+private:
+    void onCompartmentAdded(entt::registry &, entt::entity entity);
+    void onDoorChanged(entt::registry &, entt::entity entity);
+    void onDoorDestroyed(entt::registry &, entt::entity entity);
+
+    entt::registry &m_registry;
+    Atmosphere &m_atmosphere;
+    std::vector<entt::entity> m_addedCompartments;
+    std::vector<entt::entity> m_changedDoors; // waiting ones stay here
+    std::unordered_map<entt::entity, AtmosphereLinkId> m_doorLinks;
+};
+
+} // namespace void_crew::server
@@ -1,6 +1,7 @@
 #include "command_line.hpp"
 
 #include <charconv>
+#include <cmath>
 #include <stdexcept>
 #include <string>
 #include <string_view>
@@ -19,6 +20,11 @@ void printUsage(std::string_view programName) {
                "Options:\n"
                "  -p, --port <port>      Server port (default: {})\n"
                "  -c, --config <path>    Config file path (default: {})\n"
+               "      --record <path>    Record client input to a file for replay\n"
+               "      --replay <path>    Replay a recording as fast as possible, then exit\n"
+               "      --mode <mode>      Run mode: realtime, scaled or batch (no sleeping)\n"
+               "      --time-scale <x>   Simulated seconds per real second in scaled mode\n"
+               "      --ticks <count>    Stop after this many ticks\n"
                "  -h, --help             Show this help message\n"
                "  -v, --version          Show version\n",
                programName,
@@ -42,6 +48,32 @@ uint16_t parsePort(std::string_view value) {
     return static_cast<uint16_t>(port);
 }
 
+RunMode parseMode(std::string_view value) {
+    auto mode = parseRunMode(value);
+    if (!mode) {
+        throw std::runtime_error(fmt::format("invalid run mode '{}', expected 'realtime', 'scaled' or 'batch'", value));
+    }
+    return *mode;
+}
+
+double parseTimeScale(std::string_view value) {
+    double scale = 0.0;
+    auto [ptr, ec] = std::from_chars(value.data(), value.data() + value.size(), scale);
+    if (ec != std::errc{} || ptr != value.data() + value.size() || !(scale > 0.0) || !std::isfinite(scale)) {
+        throw std::runtime_error(fmt::format("invalid time scale: '{}', expected a positive number", value));
+    }
+    return scale;
+}
+
+uint64_t parseTickCount(std::string_view value) {
+    uint64_t ticks = 0;
+    auto [ptr, ec] = std::from_chars(value.data(), value.data() + value.size(), ticks);
+    if (ec != std::errc{} || ptr != value.data() + value.size() || ticks == 0) {
+        throw std::runtime_error(fmt::format("invalid tick count: '{}', expected a positive integer", value));
+    }
+    return ticks;
+}
+
 } // namespace
 
 std::optional<CommandLineArgs> parseCommandLine(int argc, char *argv[]) {
@@ -76,6 +108,46 @@ std::optional<CommandLineArgs> parseCommandLine(int argc, char *argv[]) {
             continue;
         }
 
+        if (arg == "--record") {
+            if (i + 1 >= argc) {
+                throw std::runtime_error("--record requires a value");
+            }
+            args.recordFile = argv[++i];
+            continue;
+        }
+
+        if (arg == "--replay") {
+            if (i + 1 >= argc) {
+                throw std::runtime_error("--replay requires a value");
+            }
+            args.replayFile = argv[++i];
+            continue;
+        }
+
+        if (arg == "--mode") {
+            if (i + 1 >= argc) {
+                throw std::runtime_error("--mode requires a value");
+            }
+            args.runMode = parseMode(argv[++i]);
+            continue;
+        }
+
+        if (arg == "--time-scale") {
+            if (i + 1 >= argc) {
+                throw std::runtime_error("--time-scale requires a value");
+            }
+            args.timeScale = parseTimeScale(argv[++i]);
+            continue;
+        }
+
+        if (arg == "--ticks") {
+            if (i + 1 >= argc) {
+                throw std::runtime_error("--ticks requires a value");
+            }
+            args.maxTicks = parseTickCount(argv[++i]);
+            continue;
+        }
+
         throw std::runtime_error(fmt::format("unknown argument: '{}'", arg));
     }
 
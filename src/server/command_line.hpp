@@ -4,6 +4,8 @@
 #include <optional>
 #include <string>
 
+#include "game_loop.hpp"
+
 namespace void_crew::server {
 
 constexpr uint16_t DEFAULT_PORT = 27015;
@@ -12,6 +14,11 @@ constexpr const char *DEFAULT_CONFIG_PATH = "server.toml";
 struct CommandLineArgs {
     std::optional<uint16_t> port;
     std::string configPath = DEFAULT_CONFIG_PATH;
+    std::string recordFile; // overrides [recording] file
+    std::string replayFile; // non-empty: replay this recording headless instead of serving
+    std::optional<RunMode> runMode;   // overrides [server] run_mode
+    std::optional<double> timeScale;  // overrides [server] time_scale
+    std::optional<uint64_t> maxTicks; // overrides [server] max_ticks
 };
 
 // Parses argc/argv into CommandLineArgs.
@@ -0,0 +1,87 @@
+#include "command_queue.hpp"
+
+#include <algorithm>
+#include <iterator>
+
+namespace void_crew::server {
+
+CommandProducer::CommandProducer(CommandQueue &queue, ClientId client)
+    : m_queue(&queue),
+      m_token(queue.m_queue),
+      m_client(client) {}
+
+bool CommandProducer::push(ClientCommand command) {
+    // A drain since our last push opens a fresh window for this client.
+    auto epoch = m_queue->m_drainEpoch.load(std::memory_order_relaxed);
+    if (epoch != m_windowEpoch) {
+        m_windowEpoch = epoch;
+        m_acceptedInWindow = 0;
+    }
+
+    if (m_acceptedInWindow >= m_queue->m_maxCommandsPerTick) {
+        ++m_dropped;
+        m_queue->m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    command.client = m_client;
+    command.payloadSize = std::min<uint8_t>(command.payloadSize, ClientCommand::MAX_PAYLOAD);
+    if (!m_queue->m_queue.enqueue(m_token, command)) {
+        // Only fails if the queue cannot allocate another block.
+        ++m_dropped;
+        m_queue->m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    ++m_acceptedInWindow;
+    return true;
+}
+
+ClientId CommandProducer::client() const noexcept {
+    return m_client;
+}
+
+uint64_t CommandProducer::dropped() const noexcept {
+    return m_dropped;
+}
+
+CommandQueue::CommandQueue(uint32_t maxCommandsPerTick)
+    : m_maxCommandsPerTick(std::max(maxCommandsPerTick, 1U)) {
+    m_drained.reserve(DRAIN_BATCH);
+}
+
+CommandProducer CommandQueue::producer(ClientId client) {
+    return CommandProducer(*this, client);
+}
+
+std::span<const ClientCommand> CommandQueue::drain(uint64_t tick) {
+    m_drained.clear();
+
+    // Open the next window before dequeuing: anything a producer pushes from
+    // here on counts against the next tick's cap, whether or not this drain
+    // happens to pick it up.
+    m_drainEpoch.fetch_add(1, std::memory_order_relaxed);
+
+    // Dequeue straight onto the end of m_drained: only the commands actually
+    // taken are constructed, and its capacity carries over between ticks.
+    while (m_queue.try_dequeue_bulk(std::back_inserter(m_drained), DRAIN_BATCH) == DRAIN_BATCH) {
+    }
+
+    for (auto &command : m_drained) {
+        command.tick = tick;
+    }
+    return m_drained;
+}
+
+uint32_t CommandQueue::maxCommandsPerTick() const noexcept {
+    return m_maxCommandsPerTick;
+}
+
+uint64_t CommandQueue::dropped() const noexcept {
+    return m_dropped.load(std::memory_order_relaxed);
+}
+
+std::size_t CommandQueue::sizeApprox() const noexcept {
+    return m_queue.size_approx();
+}
+
+} // namespace void_crew::server
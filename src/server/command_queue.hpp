@@ -0,0 +1,129 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <concurrentqueue/concurrentqueue.h>
+
+namespace void_crew::server {
+
+using ClientId = uint32_t;
+
+constexpr uint32_t DEFAULT_MAX_CLIENT_COMMANDS_PER_TICK = 16;
+
+/// One decoded client input, handed from the network thread to the simulation.
+///
+/// Trivially copyable and fixed-size so the queue never allocates per command
+/// and commands can be recorded byte-for-byte.
+struct ClientCommand {
+    static constexpr std::size_t MAX_PAYLOAD = 48;
+
+    ClientId client = 0;
+    uint32_t sequence = 0; // client-assigned, increases per command
+    uint64_t tick = 0;     // simulation tick the command applies to; stamped by CommandQueue::drain()
+    uint16_t type = 0;     // game-defined command id
+    uint8_t payloadSize = 0;
+    std::array<std::byte, MAX_PAYLOAD> payload{};
+};
+
+/// Commands applied in the current tick. Server::tick() publishes this in the
+/// registry context before the systems run; systems read it via
+/// registry.ctx().get<TickInput>().
+struct TickInput {
+    uint64_t tick = 0;
+    std::span<const ClientCommand> commands;
+};
+
+class CommandQueue;
+
+/// Per-connection write end of a CommandQueue.
+///
+/// Wraps a moodycamel producer token, so pushes from one connection go to its
+/// own sub-queue without contending with other clients. Must be used by one
+/// thread at a time (the network thread serving the connection) and destroyed
+/// before the queue.
+class CommandProducer {
+public:
+    CommandProducer(CommandProducer &&) noexcept = default;
+    CommandProducer &operator=(CommandProducer &&) noexcept = default;
+    CommandProducer(const CommandProducer &) = delete;
+    CommandProducer &operator=(const CommandProducer &) = delete;
+    ~CommandProducer() = default;
+
+    /// Queues @p command for the next tick. The client id is overwritten with
+    /// this producer's. Returns false, and counts a drop, once the client has
+    /// sent its per-tick limit since the last drain.
+    bool push(ClientCommand command);
+
+    ClientId client() const noexcept;
+
+    /// Commands rejected by the flood cap since this producer was created.
+    uint64_t dropped() const noexcept;
+
+private:
+    friend class CommandQueue;
+
+    CommandProducer(CommandQueue &queue, ClientId client);
+
+    CommandQueue *m_queue;
+    moodycamel::ProducerToken m_token;
+    ClientId m_client;
+    uint64_t m_windowEpoch = 0;
+    uint32_t m_acceptedInWindow = 0;
+    uint64_t m_dropped = 0;
+};
+
+/// Lock-free inbound command pipeline between network I/O and the game loop.
+///
+/// Network threads push decoded commands through a CommandProducer per client;
+/// the game loop thread bulk-dequeues everything once at the start of a tick
+/// and stamps it with that tick. Commands from one client keep their order;
+/// there is no ordering between clients.
+///
+/// Flood protection is per client and per tick: after a drain each producer
+/// may queue up to maxCommandsPerTick commands, further pushes fail until the
+/// next drain. The window is tracked by the producer itself against a drain
+/// epoch, so the cap costs one relaxed load per push and no shared counters.
+class CommandQueue {
+public:
+    explicit CommandQueue(uint32_t maxCommandsPerTick = DEFAULT_MAX_CLIENT_COMMANDS_PER_TICK);
+
+    CommandQueue(const CommandQueue &) = delete;
+    CommandQueue(CommandQueue &&) = delete;
+    CommandQueue &operator=(const CommandQueue &) = delete;
+    CommandQueue &operator=(CommandQueue &&) = delete;
+
+    /// Creates the write end for a newly connected client. Thread-safe.
+    CommandProducer producer(ClientId client);
+
+    /// Dequeues everything queued so far, stamps it with @p tick and opens a
+    /// new flood window. The returned span is valid until the next drain.
+    /// Game loop thread only.
+    std::span<const ClientCommand> drain(uint64_t tick);
+
+    uint32_t maxCommandsPerTick() const noexcept;
+
+    /// Commands rejected by the flood cap, across all clients.
+    uint64_t dropped() const noexcept;
+
+    /// Approximate number of queued commands; exact only when quiescent.
+    std::size_t sizeApprox() const noexcept;
+
+private:
+    friend class CommandProducer;
+
+    /// Dequeue batch size; one bulk call moves up to this many commands.
+    static constexpr std::size_t DRAIN_BATCH = 256;
+
+    moodycamel::ConcurrentQueue<ClientCommand> m_queue;
+    uint32_t m_maxCommandsPerTick;
+    std::atomic<uint64_t> m_drainEpoch{1};
+    std::atomic<uint64_t> m_dropped{0};
+    std::vector<ClientCommand> m_drained;
+};
+
+} // namespace void_crew::server
@@ -0,0 +1,155 @@
+#include "component_layout.hpp"
+
+#include <limits>
+
+#include "batch_kernels.hpp"
+#include "timer.hpp"
+
+namespace void_crew::server {
+
+namespace {
+
+constexpr uint32_t OUTSIDE_KEY = std::numeric_limits<uint32_t>::max(); // no InCompartment: sorts last
+
+void append(MotionSoA &out, entt::entity entity, const Transform &transform, const Velocity &velocity) {
+    out.entities.push_back(entity);
+    out.positionX.push_back(transform.position.x);
+    out.positionY.push_back(transform.position.y);
+    out.positionZ.push_back(transform.position.z);
+    out.velocityX.push_back(velocity.linear.x);
+    out.velocityY.push_back(velocity.linear.y);
+    out.velocityZ.push_back(velocity.linear.z);
+}
+
+} // namespace
+
+std::size_t MotionSoA::size() const noexcept {
+    return entities.size();
+}
+
+void MotionSoA::clear() noexcept {
+    entities.clear();
+    positionX.clear();
+    positionY.clear();
+    positionZ.clear();
+    velocityX.clear();
+    velocityY.clear();
+    velocityZ.clear();
+}
+
+void integratePositions(MotionSoA &motion, float dt) {
+    integrate(motion.positionX, motion.velocityX, dt);
+    integrate(motion.positionY, motion.velocityY, dt);
+    integrate(motion.positionZ, motion.velocityZ, dt);
+}
+
+ComponentLayout::ComponentLayout(entt::registry &registry, ComponentLayoutConfig config)
+    : m_registry(registry),
+      m_config(config),
+      m_motion(registry.group<Transform, Velocity>()) {
+    m_registry.on_construct<Transform>().connect<&ComponentLayout::onChanged>(*this);
+    m_registry.on_construct<Velocity>().connect<&ComponentLayout::onChanged>(*this);
+    m_registry.on_construct<InCompartment>().connect<&ComponentLayout::onChanged>(*this);
+    m_registry.on_update<InCompartment>().connect<&ComponentLayout::onChanged>(*this);
+    m_registry.on_destroy<InCompartment>().connect<&ComponentLayout::onChanged>(*this);
+}
+
+ComponentLayout::~ComponentLayout() {
+    m_registry.on_construct<Transform>().disconnect(*this);
+    m_registry.on_construct<Velocity>().disconnect(*this);
+    m_registry.on_construct<InCompartment>().disconnect(*this);
+    m_registry.on_update<InCompartment>().disconnect(*this);
+    m_registry.on_destroy<InCompartment>().disconnect(*this);
+}
+
+void ComponentLayout::update() {
+    ++m_ticks;
+    if (m_config.sortInterval != 0 && m_ticks % m_config.sortInterval == 0 && m_dirty) {
+        sortByCompartment();
+    }
+}
+
+void ComponentLayout::sortByCompartment() {
+    Timer timer;
+
+    // Keys go into a table by entity index first: the comparator runs
+    // n log n times and must not probe the InCompartment pool each time.
+    const auto &compartments = m_registry.storage<InCompartment>();
+    for (auto entity : m_motion) {
+        auto index = static_cast<std::size_t>(entt::to_entity(entity));
+        if (index >= m_sortKeys.size()) {
+            m_sortKeys.resize(index + 1);
+        }
+        m_sortKeys[index] = compartments.contains(entity) ? compartments.get(entity).id : OUTSIDE_KEY;
+    }
+
+    // Entity index breaks ties so the order is the same on every run.
+    m_motion.sort([this](entt::entity lhs, entt::entity rhs) {
+        auto left = entt::to_entity(lhs);
+        auto right = entt::to_entity(rhs);
+        return std::pair{m_sortKeys[left], left} < std::pair{m_sortKeys[right], right};
+    });
+
+    m_dirty = false;
+    ++m_stats.sorts;
+    m_stats.lastSortSeconds = timer.elapsedSeconds();
+}
+
+MotionGroup &ComponentLayout::motion() noexcept {
+    return m_motion;
+}
+
+void ComponentLayout::gather(MotionSoA &out) {
+    out.clear();
+    for (auto [entity, transform, velocity] : m_motion.each()) {
+        append(out, entity, transform, velocity);
+    }
+}
+
+std::size_t ComponentLayout::scatterPositions(const MotionSoA &motion) {
+    std::size_t written = 0;
+    for (std::size_t i = 0; i < motion.size(); ++i) {
+        auto entity = motion.entities[i];
+        if (!m_motion.contains(entity)) {
+            continue;
+        }
+        glm::vec3 position{motion.positionX[i], motion.positionY[i], motion.positionZ[i]};
+        if (m_motion.get<Transform>(entity).position != position) {
+            m_registry.patch<Transform>(entity, [&](Transform &transform) { transform.position = position; });
+            ++written;
+        }
+    }
+    return written;
+}
+
+std::size_t ComponentLayout::integrateMotion(float dt) {
+    std::size_t integrated = 0;
+    std::size_t moved = 0;
+    for (auto [entity, transform, velocity] : m_motion.each()) {
+        ++integrated;
+        auto position = transform.position + velocity.linear * dt;
+        if (position != transform.position) {
+            m_registry.patch<Transform>(entity, [&](Transform &moving) { moving.position = position; });
+            ++moved;
+        }
+    }
+    m_stats.integrated = integrated;
+    m_stats.moved = moved;
+    return moved;
+}
+
+const ComponentLayoutConfig &ComponentLayout::config() const noexcept {
+    return m_config;
+}
+
+ComponentLayoutStats ComponentLayout::stats() const noexcept {
+    auto stats = m_stats;
+    stats.motionEntities = m_motion.size();
+    return stats;
+}
+
+void ComponentLayout::onChanged(entt::registry &, entt::entity) {
+    m_dirty = true;
+}
+
+} // namespace void_crew::server
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include <entt/entt.hpp>
+
+#include "components.hpp"
+
+namespace void_crew::server {
+
+struct ComponentLayoutConfig {
+    uint32_t sortInterval = 60; // ticks between compartment re-sorts; 0 disables them
+};
+
+struct ComponentLayoutStats {
+    std::size_t motionEntities = 0; // members of the motion group
+    std::size_t integrated = 0;     // entities in the last integrateMotion()
+    std::size_t moved = 0;          // of those, patched with a new position
+    uint64_t sorts = 0;
+    double lastSortSeconds = 0.0;
+};
+
+/// Entities with both Transform and Velocity.
+using MotionGroup = decltype(std::declval<entt::registry &>().group<Transform, Velocity>());
+
+/// Positions and linear velocities of the motion group as separate float
+/// lanes, one entry per entity in group order. Loops over lanes read
+/// contiguous floats and vectorize; the components themselves stay AoS for
+/// everything else (signals, snapshots).
+struct MotionSoA {
+    std::vector<entt::entity> entities;
+    std::vector<float> positionX;
+    std::vector<float> positionY;
+    std::vector<float> positionZ;
+    std::vector<float> velocityX;
+    std::vector<float> velocityY;
+    std::vector<float> velocityZ;
+
+    std::size_t size() const noexcept;
+    void clear() noexcept;
+};
+
+/// position += velocity * dt over every lane, with the batch kernels.
+void integratePositions(MotionSoA &motion, float dt);
+
+/// Memory layout of the components every tick walks.
+///
+/// Owns an EnTT group over Transform and Velocity: the pools keep the
+/// group's entities packed at their front in the same order, so iterating
+/// the group walks two arrays in lockstep with no per-entity lookups, unlike
+/// a view that probes one pool for every entity of the other. A pool can be
+/// owned by one group only; this is it for Transform and Velocity, so do not
+/// sort those pools directly or create other groups that own them.
+///
+/// Every sortInterval ticks, if entities joined the group or changed
+/// compartment since the last sort, the group is re-sorted by InCompartment,
+/// so entities of one compartment (which are simulated, queried and
+/// replicated together) sit next to each other. Entities outside any
+/// compartment go last. Call update() between systems, never during one.
+///
+/// Game thread only.
+class ComponentLayout {
+public:
+    explicit ComponentLayout(entt::registry &registry, ComponentLayoutConfig config = {});
+    ~ComponentLayout();
+
+    ComponentLayout(const ComponentLayout &) = delete;
+    ComponentLayout &operator=(const ComponentLayout &) = delete;
+    ComponentLayout(ComponentLayout &&) = delete;
+    ComponentLayout &operator=(ComponentLayout &&) = delete;
+
+    /// Counts a tick and re-sorts when the interval is up and anything moved.
+    void update();
+
+    /// Re-sorts the motion group by compartment now.
+    void sortByCompartment();
+
+    MotionGroup &motion() noexcept;
+
+    /// Copies the motion group into @p out, reusing its storage.
+    void gather(MotionSoA &out);
+
+    /// Writes the positions in @p motion back with registry.patch(), so
+    /// listeners see the move. Only entities whose position changed and that
+    /// are still in the group are written. Returns how many were.
+    std::size_t scatterPositions(const MotionSoA &motion);
+
+    /// Kinematic movement: moves every group member by velocity * dt in one
+    /// pass over the group, patching only those whose position changed.
+    /// Server runs it every tick after the systems. Returns how many moved.
+    std::size_t integrateMotion(float dt);
+
+    const ComponentLayoutConfig &config() const noexcept;
+    ComponentLayoutStats stats() const noexcept;
+
+private:
+    void onChanged(entt::registry &registry, entt::entity entity);
+
+    entt::registry &m_registry;
+    ComponentLayoutConfig m_config;
+    MotionGroup m_motion;
+    std::vector<uint32_t> m_sortKeys; // by entity index, filled per sort
+    uint64_t m_ticks = 0;
+    bool m_dirty = true;
+    ComponentLayoutStats m_stats;
+};
+
+} // namespace void_crew::server
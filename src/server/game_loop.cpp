@@ -1,9 +1,13 @@
 #include "game_loop.hpp"
 
 #include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <stdexcept>
 #include <thread>
 
 #include "logging.hpp"
+#include "profiler.hpp"
 
 namespace void_crew::server {
 
@@ -13,26 +17,138 @@ constexpr uint32_t MIN_TICK_RATE = 1;
 constexpr uint32_t MAX_TICK_RATE = 300;
 constexpr double EMA_ALPHA = 0.1;
 
+// Hybrid pacing spin window, seconds. The window is kept at
+// SPIN_WINDOW_MARGIN times the last wake-up error, within these bounds, and
+// shrinks by SPIN_WINDOW_DECAY of the difference per on-time wake-up.
+constexpr double INITIAL_SPIN_WINDOW = 0.001;
+constexpr double MIN_SPIN_WINDOW = 0.0001;
+constexpr double MAX_SPIN_WINDOW = 0.002;
+constexpr double SPIN_WINDOW_MARGIN = 1.5;
+constexpr double SPIN_WINDOW_DECAY = 0.02;
+
+Timer::Clock::duration toClockDuration(double seconds) {
+    return std::chrono::duration_cast<Timer::Clock::duration>(std::chrono::duration<double>(seconds));
+}
+
+double toSeconds(Timer::Clock::duration d) {
+    return std::chrono::duration<double>(d).count();
+}
+
 } // namespace
 
-GameLoop::GameLoop(uint32_t tickRate)
+std::optional<TickPacing> parseTickPacing(std::string_view name) {
+    if (name == "sleep") {
+        return TickPacing::Sleep;
+    }
+    if (name == "hybrid") {
+        return TickPacing::Hybrid;
+    }
+    return std::nullopt;
+}
+
+std::optional<RunMode> parseRunMode(std::string_view name) {
+    if (name == "realtime") {
+        return RunMode::RealTime;
+    }
+    if (name == "scaled") {
+        return RunMode::Scaled;
+    }
+    if (name == "batch") {
+        return RunMode::Batch;
+    }
+    return std::nullopt;
+}
+
+std::string_view runModeName(RunMode mode) noexcept {
+    switch (mode) {
+    case RunMode::RealTime:
+        return "realtime";
+    case RunMode::Scaled:
+        return "scaled";
+    case RunMode::Batch:
+        return "batch";
+    }
+    return "unknown";
+}
+
+GameLoop::GameLoop(uint32_t tickRate, TickPacing pacing, RunOptions options)
     : m_tickRate(std::clamp(tickRate, MIN_TICK_RATE, MAX_TICK_RATE)),
-      m_dt(1.0 / static_cast<double>(m_tickRate)) {
+      m_dt(1.0 / static_cast<double>(m_tickRate)),
+      m_pacing(pacing),
+      m_options(options),
+      m_tickInterval(m_dt),
+      m_spinWindow(pacing == TickPacing::Hybrid ? INITIAL_SPIN_WINDOW : 0.0) {
+    if (!(options.timeScale > 0.0) || !std::isfinite(options.timeScale)) {
+        throw std::invalid_argument(fmt::format("game loop: time scale {} must be positive", options.timeScale));
+    }
     if (tickRate != m_tickRate) {
         TLOG_WARN("loop", "Tick rate {} clamped to {}", tickRate, m_tickRate);
     }
-    TLOG_DEBUG("loop", "Game loop configured: {} Hz, dt = {:.6f}s", m_tickRate, m_dt);
+    if (m_options.mode == RunMode::Scaled) {
+        m_tickInterval = m_dt / m_options.timeScale;
+    }
+    m_metrics.spinWindow = m_spinWindow;
+    TLOG_DEBUG("loop", "Game loop configured: {} Hz, dt = {:.6f}s, {} pacing, {} mode", m_tickRate, m_dt,
+               m_pacing == TickPacing::Hybrid ? "hybrid" : "sleep", runModeName(m_options.mode));
 }
 
 void GameLoop::run(std::function<bool()> shouldRun, std::function<void(float)> onTick) {
-    TLOG_INFO("loop", "Game loop started at {} Hz", m_tickRate);
+    switch (m_options.mode) {
+    case RunMode::RealTime:
+        TLOG_INFO("loop", "Game loop started at {} Hz", m_tickRate);
+        break;
+    case RunMode::Scaled:
+        TLOG_INFO("loop", "Game loop started at {} Hz, {}x real time", m_tickRate, m_options.timeScale);
+        break;
+    case RunMode::Batch:
+        TLOG_INFO("loop", "Game loop started at {} Hz, unthrottled", m_tickRate);
+        break;
+    }
+    if (m_options.maxTicks != 0) {
+        TLOG_INFO("loop", "Stopping after {} ticks ({:.1f}s of simulation)", m_options.maxTicks,
+                  static_cast<double>(m_options.maxTicks) * m_dt);
+    }
+
+    m_runStartTick = m_currentTick;
+    m_intervalStartTick = m_currentTick;
+    m_intervalTimer.reset();
+    Timer wallTimer;
+
+    if (m_options.mode == RunMode::Batch) {
+        runBatch(shouldRun, onTick);
+    } else {
+        runPaced(shouldRun, onTick);
+    }
+
+    // The last, partial metrics interval, so short runs report too.
+    if (m_currentTick != m_intervalStartTick) {
+        logMetrics();
+    }
+    double wallSeconds = wallTimer.elapsedSeconds();
+    auto ticks = m_currentTick - m_runStartTick;
+    TLOG_INFO("loop", "Game loop stopped at tick {} after {} ticks: {:.1f}s simulated in {:.1f}s ({:.0f} ticks/s)",
+              m_currentTick, ticks, static_cast<double>(ticks) * m_dt, wallSeconds,
+              wallSeconds > 0.0 ? static_cast<double>(ticks) / wallSeconds : 0.0);
+}
+
+void GameLoop::runBatch(const std::function<bool()> &shouldRun, const std::function<void(float)> &onTick) {
+    while (!tickLimitReached() && shouldRun()) {
+        runTick(onTick);
+        if (m_intervalTimer.elapsedSeconds() >= METRICS_LOG_INTERVAL) {
+            logMetrics();
+            m_metrics.maxTickDuration = 0.0;
+        }
+    }
+}
 
+void GameLoop::runPaced(const std::function<bool()> &shouldRun, const std::function<void(float)> &onTick) {
     Timer frameTimer;
     double accumulator = 0.0;
     double timeSinceMetricsLog = 0.0;
-    const auto fixedDtFloat = static_cast<float>(m_dt);
+    Timer::TimePoint lastTickStart;
+    bool hasLastTickStart = false;
 
-    while (shouldRun()) {
+    while (!tickLimitReached() && shouldRun()) {
         double elapsed = frameTimer.restart();
 
         // Death-spiral protection: clamp elapsed time so we don't try to
@@ -43,34 +159,30 @@ void GameLoop::run(std::function<bool()> shouldRun, std::function<void(float)> o
             elapsed = MAX_FRAME_TIME;
         }
 
+        // The accumulator is in wall-clock time: in Scaled mode a tick is
+        // due every dt / timeScale, while dt itself never changes.
         accumulator += elapsed;
         timeSinceMetricsLog += elapsed;
 
         // Also check shouldRun between ticks for responsive shutdown.
         // Without this, a signal or shutdown() call during the inner loop
         // would only take effect after all accumulated ticks are drained.
-        while (accumulator >= m_dt && shouldRun()) {
-            Timer tickTimer;
+        while (accumulator >= m_tickInterval && !tickLimitReached() && shouldRun()) {
+            double backlog = accumulator - m_tickInterval;
+            m_metrics.backlog.record(backlog);
+            m_intervalBacklog.record(backlog);
 
-            onTick(fixedDtFloat);
-            m_currentTick++;
-
-            double tickDuration = tickTimer.elapsedSeconds();
-
-            // Update metrics
-            m_metrics.totalTicks = m_currentTick;
-            m_metrics.lastTickDuration = tickDuration;
-            m_metrics.maxTickDuration = std::max(m_metrics.maxTickDuration, tickDuration);
-
-            if (m_currentTick == 1) {
-                m_metrics.averageTickDuration = tickDuration;
-            } else {
-                m_metrics.averageTickDuration =
-                    EMA_ALPHA * tickDuration + (1.0 - EMA_ALPHA) * m_metrics.averageTickDuration;
+            auto tickStart = Timer::Clock::now();
+            if (hasLastTickStart) {
+                double jitter = std::abs(toSeconds(tickStart - lastTickStart) - m_tickInterval);
+                m_metrics.tickStartJitter.record(jitter);
+                m_intervalTickStartJitter.record(jitter);
             }
-            m_metrics.load = (m_metrics.averageTickDuration / m_dt) * 100.0;
+            lastTickStart = tickStart;
+            hasLastTickStart = true;
 
-            accumulator -= m_dt;
+            runTick(onTick);
+            accumulator -= m_tickInterval;
         }
 
         // Log metrics periodically
@@ -80,17 +192,100 @@ void GameLoop::run(std::function<bool()> shouldRun, std::function<void(float)> o
             m_metrics.maxTickDuration = 0.0;
         }
 
-        // Sleep for the remaining time before the next tick is due.
-        // The accumulator holds the leftover time that didn't fill a full dt,
-        // so we need to wait (dt - accumulator) before the next tick fires.
-        double remainingSec = m_dt - accumulator;
-        if (remainingSec > 0.001) {
-            std::this_thread::sleep_for(
-                std::chrono::duration<double>(remainingSec));
+        // Wait for the next tick. The accumulator holds the leftover time that
+        // didn't fill a full dt as of frameTimer's start, so the next tick is
+        // due (dt - accumulator) after that instant. Waiting on the absolute
+        // time point also absorbs the time spent running this frame's ticks.
+        double remainingSec = m_tickInterval - accumulator;
+        if (remainingSec > 0.0 && !tickLimitReached()) {
+            waitUntil(frameTimer.startTime() + toClockDuration(remainingSec));
+        }
+    }
+}
+
+void GameLoop::runTick(const std::function<void(float)> &onTick) {
+    Timer tickTimer;
+    for (auto *arena : m_arenas) {
+        arena->reset();
+    }
+    {
+        PROFILE_ZONE("tick");
+        onTick(static_cast<float>(m_dt));
+    }
+    PROFILE_FRAME();
+    m_currentTick++;
+
+    double tickDuration = tickTimer.elapsedSeconds();
+
+    // Update metrics
+    m_metrics.totalTicks = m_currentTick;
+    m_metrics.lastTickDuration = tickDuration;
+    m_metrics.maxTickDuration = std::max(m_metrics.maxTickDuration, tickDuration);
+    m_metrics.tickDurations.record(tickDuration);
+    m_intervalTickDurations.record(tickDuration);
+
+    if (!m_arenas.empty()) {
+        std::size_t arenaBytes = 0;
+        for (const auto *arena : m_arenas) {
+            arenaBytes += arena->used();
+        }
+        m_metrics.arenaBytes = arenaBytes;
+        m_metrics.arenaHighWater = std::max(m_metrics.arenaHighWater, arenaBytes);
+    }
+
+    if (m_currentTick == 1) {
+        m_metrics.averageTickDuration = tickDuration;
+    } else {
+        m_metrics.averageTickDuration = EMA_ALPHA * tickDuration + (1.0 - EMA_ALPHA) * m_metrics.averageTickDuration;
+    }
+    m_metrics.load = (m_metrics.averageTickDuration / m_tickInterval) * 100.0;
+}
+
+bool GameLoop::tickLimitReached() const noexcept {
+    return m_options.maxTicks != 0 && m_currentTick - m_runStartTick >= m_options.maxTicks;
+}
+
+void GameLoop::waitUntil(Timer::TimePoint deadline) {
+    using Clock = Timer::Clock;
+    if (Clock::now() >= deadline) {
+        return;
+    }
+
+    PROFILE_ZONE("sleep");
+    if (m_pacing == TickPacing::Hybrid) {
+        auto sleepTarget = deadline - toClockDuration(m_spinWindow);
+        if (Clock::now() < sleepTarget) {
+            std::this_thread::sleep_until(sleepTarget);
+            adaptSpinWindow(toSeconds(Clock::now() - sleepTarget));
+        }
+        // Yield rather than busy-spin so other runnable threads (simulation
+        // workers, the log writer) keep the core if they need it.
+        while (Clock::now() < deadline) {
+            std::this_thread::yield();
         }
+    } else {
+        std::this_thread::sleep_until(deadline);
     }
 
-    TLOG_INFO("loop", "Game loop stopped after {} ticks", m_currentTick);
+    double oversleep = toSeconds(Clock::now() - deadline);
+    m_metrics.oversleep.record(oversleep);
+    m_intervalOversleep.record(oversleep);
+}
+
+void GameLoop::adaptSpinWindow(double wakeError) {
+    double maxWindow = std::min(MAX_SPIN_WINDOW, m_tickInterval * 0.5);
+    double target = std::clamp(wakeError * SPIN_WINDOW_MARGIN, MIN_SPIN_WINDOW, maxWindow);
+    if (target > m_spinWindow) {
+        // A late wake-up means the window was too small: widen it at once.
+        m_spinWindow = target;
+    } else {
+        m_spinWindow += (target - m_spinWindow) * SPIN_WINDOW_DECAY;
+    }
+    m_metrics.spinWindow = m_spinWindow;
+}
+
+void GameLoop::resetEachTick(FrameArena &arena) {
+    m_arenas.push_back(&arena);
 }
 
 uint64_t GameLoop::currentTick() const noexcept {
@@ -105,13 +300,71 @@ const TickMetrics& GameLoop::metrics() const noexcept {
     return m_metrics;
 }
 
+TickPacing GameLoop::pacing() const noexcept {
+    return m_pacing;
+}
+
+const RunOptions &GameLoop::runOptions() const noexcept {
+    return m_options;
+}
+
+double GameLoop::tickBudget() const noexcept {
+    return m_options.mode == RunMode::Batch ? 0.0 : m_tickInterval;
+}
+
 void GameLoop::logMetrics() {
+    double interval = m_intervalTimer.restart();
+    auto ticks = static_cast<double>(m_currentTick - m_intervalStartTick);
+    m_metrics.ticksPerSecond = interval > 0.0 ? ticks / interval : 0.0;
+    m_intervalStartTick = m_currentTick;
+
+    m_metrics.recentTickDurations = m_intervalTickDurations.summary();
+    m_metrics.recentOversleep = m_intervalOversleep.summary();
+    m_metrics.recentBacklog = m_intervalBacklog.summary();
+    m_metrics.recentTickStartJitter = m_intervalTickStartJitter.summary();
+    m_intervalTickDurations.reset();
+    m_intervalOversleep.reset();
+    m_intervalBacklog.reset();
+    m_intervalTickStartJitter.reset();
+
+    const auto& tick = m_metrics.recentTickDurations;
     TLOG_DEBUG("loop",
-               "tick={} avg={:.3f}ms max={:.3f}ms load={:.1f}%",
+               "tick={} avg={:.3f}ms max={:.3f}ms load={:.1f}% rate={:.1f} ticks/s",
                m_currentTick,
                m_metrics.averageTickDuration * 1000.0,
                m_metrics.maxTickDuration * 1000.0,
-               m_metrics.load);
+               m_metrics.load,
+               m_metrics.ticksPerSecond);
+    TLOG_DEBUG("loop",
+               "tick ms p50={:.3f} p90={:.3f} p99={:.3f} p999={:.3f} max={:.3f} | "
+               "oversleep ms p99={:.3f} max={:.3f} | backlog ms p99={:.3f} max={:.3f}",
+               tick.p50 * 1000.0,
+               tick.p90 * 1000.0,
+               tick.p99 * 1000.0,
+               tick.p999 * 1000.0,
+               tick.max * 1000.0,
+               m_metrics.recentOversleep.p99 * 1000.0,
+               m_metrics.recentOversleep.max * 1000.0,
+               m_metrics.recentBacklog.p99 * 1000.0,
+               m_metrics.recentBacklog.max * 1000.0);
+    TLOG_DEBUG("loop",
+               "tick start jitter ms p50={:.3f} p99={:.3f} max={:.3f} | spin window {:.3f}ms",
+               m_metrics.recentTickStartJitter.p50 * 1000.0,
+               m_metrics.recentTickStartJitter.p99 * 1000.0,
+               m_metrics.recentTickStartJitter.max * 1000.0,
+               m_spinWindow * 1000.0);
+    if (!m_arenas.empty()) {
+        TLOG_DEBUG("loop", "frame arenas: last tick {} KiB, high water {} KiB", m_metrics.arenaBytes / 1024,
+                   m_metrics.arenaHighWater / 1024);
+    }
+
+    // Dropped log lines are otherwise invisible; report them at most once
+    // per metrics interval.
+    auto logDrops = asyncLogStats().dropped;
+    if (logDrops > m_reportedLogDrops) {
+        TLOG_WARN("loop", "Async logger dropped {} messages (total {})", logDrops - m_reportedLogDrops, logDrops);
+        m_reportedLogDrops = logDrops;
+    }
 }
 
 } // namespace void_crew::server
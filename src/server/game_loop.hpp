@@ -2,11 +2,42 @@
 
 #include <cstdint>
 #include <functional>
+#include <optional>
+#include <string_view>
+#include <vector>
 
+#include "frame_arena.hpp"
+#include "latency_histogram.hpp"
 #include "timer.hpp"
 
 namespace void_crew::server {
 
+/// How GameLoop waits for the next tick deadline.
+enum class TickPacing {
+    Sleep,  // sleep until the deadline; cheapest, wakes up late by the OS timer slack
+    Hybrid, // sleep until just before the deadline, then yield-spin the rest
+};
+
+/// Parses "sleep" or "hybrid". Returns nullopt otherwise.
+std::optional<TickPacing> parseTickPacing(std::string_view name);
+
+/// How simulation time maps to wall-clock time in GameLoop::run().
+enum class RunMode {
+    RealTime, // one tick per dt of wall time
+    Scaled,   // timeScale ticks per dt of wall time, paced like RealTime
+    Batch,    // ticks back to back with no waiting, as fast as the CPU allows
+};
+
+/// Parses "realtime", "scaled" or "batch". Returns nullopt otherwise.
+std::optional<RunMode> parseRunMode(std::string_view name);
+std::string_view runModeName(RunMode mode) noexcept;
+
+struct RunOptions {
+    RunMode mode = RunMode::RealTime;
+    double timeScale = 1.0; // Scaled only: simulated seconds per wall-clock second
+    uint64_t maxTicks = 0;  // run() returns after this many ticks; 0 = until shouldRun is false
+};
+
 /// Performance metrics for the game loop, updated every tick.
 struct TickMetrics {
     uint64_t totalTicks = 0;
@@ -14,13 +45,39 @@ struct TickMetrics {
     double averageTickDuration = 0.0;  // exponential moving average, seconds
     double maxTickDuration = 0.0;      // seconds, reset each logging interval
     double load = 0.0;                 // avgTickDuration / dt * 100 (percentage)
+
+    // Distributions since the loop started. Averages hide the p99 tail that
+    // players feel as rubber-banding, so alert on these instead.
+    LatencyHistogram tickDurations;   // onTick wall time
+    LatencyHistogram oversleep;       // wake-up time minus the next tick's deadline
+    LatencyHistogram backlog;         // simulation time still owed when a tick starts, beyond that tick
+    LatencyHistogram tickStartJitter; // |interval between consecutive tick starts - dt|
+
+    // The same series over the most recent metrics interval only.
+    LatencySummary recentTickDurations;
+    LatencySummary recentOversleep;
+    LatencySummary recentBacklog;
+    LatencySummary recentTickStartJitter;
+
+    double spinWindow = 0.0;     // Hybrid pacing: current spin window before each deadline, seconds
+    double ticksPerSecond = 0.0; // wall-clock tick rate over the last metrics interval
+
+    // Frame arenas registered with resetEachTick(), summed over all of them.
+    std::size_t arenaBytes = 0;     // bytes the last tick allocated
+    std::size_t arenaHighWater = 0; // most bytes any tick allocated
 };
 
 /// Fixed-timestep game loop using the accumulator pattern.
 ///
 /// The loop measures real elapsed time, accumulates it, and runs simulation
 /// ticks at a fixed interval (1/tickRate seconds). Between ticks the server
-/// thread sleeps to avoid busy-waiting.
+/// thread waits for the next tick's absolute steady_clock deadline, so sleep
+/// errors never accumulate into drift.
+///
+/// Hybrid pacing (the default) sleeps until spinWindow before the deadline and
+/// yield-spins the remainder. The window adapts to the measured wake-up error
+/// of the coarse sleep: it grows at once after a late wake-up and decays slowly
+/// while the OS wakes us on time, so the loop spins no longer than it has to.
 ///
 /// Death-spiral protection: if real time exceeds MAX_FRAME_TIME per outer
 /// iteration, the surplus is discarded so the simulation slows down instead
@@ -28,27 +85,75 @@ struct TickMetrics {
 ///
 /// Reference: Glenn Fiedler, "Fix Your Timestep!"
 /// https://gafferongames.com/post/fix_your_timestep/
+///
+/// The run mode only changes how fast ticks come, never dt: Scaled runs the
+/// same schedule with a wall-clock tick interval of dt / timeScale, and Batch
+/// skips the waiting altogether, for soak tests, AI tuning, pre-warming a
+/// world or replays. Every tick is measured the same way in every mode.
+/// The wall-clock series (backlog, oversleep, start jitter) are measured
+/// against the wall-clock tick interval and are not recorded in Batch mode;
+/// load is the share of that interval spent ticking (Batch: of dt).
 class GameLoop {
 public:
     /// @param tickRate  Simulation ticks per second (clamped to [1, 300]).
-    explicit GameLoop(uint32_t tickRate);
+    /// @param pacing    How to wait between ticks.
+    /// @param options   Run mode and tick limit.
+    /// Throws std::invalid_argument if options.timeScale is not positive.
+    explicit GameLoop(uint32_t tickRate, TickPacing pacing = TickPacing::Hybrid, RunOptions options = {});
 
-    /// Run the loop until @p shouldRun returns false.
-    /// @p onTick is called once per fixed-step simulation tick with the
-    /// constant delta time in seconds.
+    /// Run the loop until @p shouldRun returns false or options.maxTicks
+    /// ticks have run. @p onTick is called once per fixed-step simulation
+    /// tick with the constant delta time in seconds.
     void run(std::function<bool()> shouldRun, std::function<void(float)> onTick);
 
+    /// Resets @p arena at the start of every tick, so it holds exactly that
+    /// tick's transient data, and reports its usage in TickMetrics. The arena
+    /// must outlive the loop.
+    void resetEachTick(FrameArena &arena);
+
     uint64_t currentTick() const noexcept;
     float fixedDt() const noexcept;
     const TickMetrics& metrics() const noexcept;
+    TickPacing pacing() const noexcept;
+    const RunOptions &runOptions() const noexcept;
+
+    /// Wall-clock seconds a tick may take without falling behind: dt, or
+    /// dt / timeScale in scaled mode. 0 in batch mode, which has no budget.
+    double tickBudget() const noexcept;
 
 private:
+    void runPaced(const std::function<bool()> &shouldRun, const std::function<void(float)> &onTick);
+    void runBatch(const std::function<bool()> &shouldRun, const std::function<void(float)> &onTick);
+
+    /// Runs one tick and records its duration, arena usage and load.
+    void runTick(const std::function<void(float)> &onTick);
+    bool tickLimitReached() const noexcept;
+
+    /// Blocks until @p deadline according to the pacing mode.
+    void waitUntil(Timer::TimePoint deadline);
+    void adaptSpinWindow(double wakeError);
     void logMetrics();
 
     uint32_t m_tickRate;
     double m_dt;             // 1.0 / tickRate  (seconds, double for accumulator precision)
+    TickPacing m_pacing;
+    RunOptions m_options;
+    double m_tickInterval;   // wall-clock seconds between ticks: dt / timeScale in Scaled mode, else dt
+    double m_spinWindow;     // seconds, Hybrid pacing only
     uint64_t m_currentTick = 0;
+    uint64_t m_runStartTick = 0; // currentTick when run() was entered, for maxTicks
     TickMetrics m_metrics;
+    uint64_t m_reportedLogDrops = 0;
+    uint64_t m_intervalStartTick = 0; // currentTick at the start of the metrics interval
+    Timer m_intervalTimer;
+    std::vector<FrameArena *> m_arenas;
+
+    // Per-interval histograms, summarized into m_metrics.recent* and reset
+    // by logMetrics().
+    LatencyHistogram m_intervalTickDurations;
+    LatencyHistogram m_intervalOversleep;
+    LatencyHistogram m_intervalBacklog;
+    LatencyHistogram m_intervalTickStartJitter;
 
     /// Maximum elapsed time accepted per outer-loop iteration (seconds).
     /// Anything above this is clamped, causing the simulation to slow down
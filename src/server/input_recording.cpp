@@ -0,0 +1,239 @@
+#include "input_recording.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+
+#include <fmt/format.h>
+
+#include "logging.hpp"
+
+namespace void_crew::server {
+
+namespace {
+
+constexpr std::array<char, 8> MAGIC{'V', 'C', 'R', 'E', 'P', 'L', 'A', 'Y'};
+constexpr std::size_t FLUSH_THRESHOLD = 64 * 1024; // bytes buffered before a write
+
+template <typename T>
+void appendLittleEndian(std::vector<std::byte> &out, T value) {
+    for (std::size_t i = 0; i < sizeof(T); ++i) {
+        out.push_back(static_cast<std::byte>((value >> (8 * i)) & 0xFF));
+    }
+}
+
+/// Bounds-checked cursor over a whole recording file.
+class Reader {
+public:
+    explicit Reader(std::span<const std::byte> data) : m_data(data) {}
+
+    template <typename T>
+    std::optional<T> read() noexcept {
+        if (remaining() < sizeof(T)) {
+            return std::nullopt;
+        }
+        T value = 0;
+        for (std::size_t i = 0; i < sizeof(T); ++i) {
+            value |= static_cast<T>(std::to_integer<T>(m_data[m_offset + i]) << (8 * i));
+        }
+        m_offset += sizeof(T);
+        return value;
+    }
+
+    std::optional<std::span<const std::byte>> bytes(std::size_t count) noexcept {
+        if (remaining() < count) {
+            return std::nullopt;
+        }
+        auto span = m_data.subspan(m_offset, count);
+        m_offset += count;
+        return span;
+    }
+
+    std::size_t remaining() const noexcept {
+        return m_data.size() - m_offset;
+    }
+
+private:
+    std::span<const std::byte> m_data;
+    std::size_t m_offset = 0;
+};
+
+RecordingHeader readHeader(Reader &reader, const std::string &path) {
+    auto magic = reader.bytes(MAGIC.size());
+    if (!magic || std::memcmp(magic->data(), MAGIC.data(), MAGIC.size()) != 0) {
+        throw std::runtime_error(fmt::format("'{}' is not an input recording", path));
+    }
+    auto version = reader.read<uint32_t>();
+    if (version && *version != RECORDING_FORMAT_VERSION) {
+        throw std::runtime_error(fmt::format("recording '{}' has format version {}, expected {}", path, *version,
+                                             RECORDING_FORMAT_VERSION));
+    }
+
+    RecordingHeader header;
+    auto engineLength = reader.read<uint16_t>();
+    auto engineVersion = engineLength ? reader.bytes(*engineLength) : std::nullopt;
+    auto tickRate = reader.read<uint32_t>();
+    auto worldSeed = reader.read<uint64_t>();
+    auto maxCommands = reader.read<uint32_t>();
+    if (!version || !engineVersion || !tickRate || !worldSeed || !maxCommands) {
+        throw std::runtime_error(fmt::format("recording '{}' is truncated inside its header", path));
+    }
+    header.engineVersion.assign(reinterpret_cast<const char *>(engineVersion->data()), engineVersion->size());
+    header.tickRate = *tickRate;
+    header.worldSeed = *worldSeed;
+    header.maxClientCommandsPerTick = *maxCommands;
+    return header;
+}
+
+/// Appends one tick to @p recording; false if the data ends inside it.
+bool readTick(Reader &reader, InputRecording &recording) {
+    auto tick = reader.read<uint64_t>();
+    auto stateHash = reader.read<uint64_t>();
+    auto count = reader.read<uint32_t>();
+    if (!tick || !stateHash || !count) {
+        return false;
+    }
+
+    auto first = recording.commands.size();
+    for (uint32_t i = 0; i < *count; ++i) {
+        ClientCommand command;
+        auto client = reader.read<uint32_t>();
+        auto sequence = reader.read<uint32_t>();
+        auto type = reader.read<uint16_t>();
+        auto payloadSize = reader.read<uint8_t>();
+        if (!client || !sequence || !type || !payloadSize || *payloadSize > ClientCommand::MAX_PAYLOAD) {
+            recording.commands.resize(first);
+            return false;
+        }
+        auto payload = reader.bytes(*payloadSize);
+        if (!payload) {
+            recording.commands.resize(first);
+            return false;
+        }
+        command.client = *client;
+        command.sequence = *sequence;
+        command.tick = *tick;
+        command.type = *type;
+        command.payloadSize = *payloadSize;
+        std::copy(payload->begin(), payload->end(), command.payload.begin());
+        recording.commands.push_back(command);
+    }
+
+    recording.ticks.push_back({.tick = *tick, .stateHash = *stateHash, .firstCommand = first, .commandCount = *count});
+    return true;
+}
+
+} // namespace
+
+std::span<const ClientCommand> InputRecording::commandsOf(const RecordedTick &tick) const noexcept {
+    return std::span<const ClientCommand>(commands).subspan(tick.firstCommand, tick.commandCount);
+}
+
+InputRecording loadRecording(const std::string &path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        throw std::runtime_error(fmt::format("cannot open recording '{}'", path));
+    }
+    std::vector<char> file{std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+    Reader reader(std::as_bytes(std::span<const char>(file)));
+
+    InputRecording recording;
+    recording.header = readHeader(reader, path);
+    while (reader.remaining() > 0) {
+        if (!readTick(reader, recording)) {
+            TLOG_WARN("replay", "Recording '{}' is truncated after {} complete ticks", path, recording.ticks.size());
+            break;
+        }
+        const auto &last = recording.ticks.back();
+        if (recording.ticks.size() > 1 && last.tick != recording.ticks[recording.ticks.size() - 2].tick + 1) {
+            throw std::runtime_error(fmt::format("recording '{}' skips from tick {} to {}", path,
+                                                 recording.ticks[recording.ticks.size() - 2].tick, last.tick));
+        }
+    }
+    return recording;
+}
+
+InputRecorder::InputRecorder(const std::string &path, const RecordingHeader &header)
+    : m_path(path),
+      m_out(path, std::ios::binary | std::ios::trunc) {
+    if (!m_out) {
+        throw std::runtime_error(fmt::format("cannot create recording '{}'", path));
+    }
+    m_buffer.reserve(FLUSH_THRESHOLD + 1024);
+
+    auto engineLength = std::min<std::size_t>(header.engineVersion.size(), std::numeric_limits<uint16_t>::max());
+    m_buffer.insert(m_buffer.end(), reinterpret_cast<const std::byte *>(MAGIC.data()),
+                    reinterpret_cast<const std::byte *>(MAGIC.data()) + MAGIC.size());
+    appendLittleEndian(m_buffer, RECORDING_FORMAT_VERSION);
+    appendLittleEndian(m_buffer, static_cast<uint16_t>(engineLength));
+    auto engine = std::as_bytes(std::span(header.engineVersion.data(), engineLength));
+    m_buffer.insert(m_buffer.end(), engine.begin(), engine.end());
+    appendLittleEndian(m_buffer, header.tickRate);
+    appendLittleEndian(m_buffer, header.worldSeed);
+    appendLittleEndian(m_buffer, header.maxClientCommandsPerTick);
+    flush();
+}
+
+InputRecorder::~InputRecorder() {
+    flush();
+}
+
+void InputRecorder::record(uint64_t tick, std::span<const ClientCommand> commands, uint64_t stateHash) {
+    if (!m_good) {
+        return;
+    }
+    appendLittleEndian(m_buffer, tick);
+    appendLittleEndian(m_buffer, stateHash);
+    appendLittleEndian(m_buffer, static_cast<uint32_t>(commands.size()));
+    for (const auto &command : commands) {
+        auto payloadSize = std::min<std::size_t>(command.payloadSize, ClientCommand::MAX_PAYLOAD);
+        appendLittleEndian(m_buffer, command.client);
+        appendLittleEndian(m_buffer, command.sequence);
+        appendLittleEndian(m_buffer, command.type);
+        appendLittleEndian(m_buffer, static_cast<uint8_t>(payloadSize));
+        m_buffer.insert(m_buffer.end(), command.payload.begin(),
+                        command.payload.begin() + static_cast<std::ptrdiff_t>(payloadSize));
+    }
+    ++m_ticks;
+    m_commands += commands.size();
+
+    if (m_buffer.size() >= FLUSH_THRESHOLD) {
+        flush();
+    }
+}
+
+void InputRecorder::flush() {
+    if (!m_good || m_buffer.empty()) {
+        m_buffer.clear();
+        return;
+    }
+    m_out.write(reinterpret_cast<const char *>(m_buffer.data()), static_cast<std::streamsize>(m_buffer.size()));
+    m_out.flush();
+    m_buffer.clear();
+    if (!m_out) {
+        m_good = false;
+        TLOG_ERROR("replay", "Writing recording '{}' failed after {} ticks; recording stopped", m_path, m_ticks);
+    }
+}
+
+const std::string &InputRecorder::path() const noexcept {
+    return m_path;
+}
+
+uint64_t InputRecorder::ticks() const noexcept {
+    return m_ticks;
+}
+
+uint64_t InputRecorder::commands() const noexcept {
+    return m_commands;
+}
+
+bool InputRecorder::good() const noexcept {
+    return m_good;
+}
+
+} // namespace void_crew::server
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "command_queue.hpp"
+
+namespace void_crew::server {
+
+/// Bumped whenever the file layout or the state hash changes; older files
+/// are rejected.
+constexpr uint32_t RECORDING_FORMAT_VERSION = 2;
+
+/// Everything besides the commands that the simulation's outcome depends on.
+struct RecordingHeader {
+    std::string engineVersion; // informational; a replay on another build may diverge
+    uint32_t tickRate = 0;
+    uint64_t worldSeed = 0;
+    uint32_t maxClientCommandsPerTick = 0;
+};
+
+/// One simulated tick of a recording.
+struct RecordedTick {
+    uint64_t tick = 0;
+    uint64_t stateHash = 0;       // WorldChecksum of the world after the tick ran
+    std::size_t firstCommand = 0; // index into InputRecording::commands
+    std::size_t commandCount = 0;
+};
+
+/// A recording loaded into memory for replay.
+struct InputRecording {
+    RecordingHeader header;
+    std::vector<RecordedTick> ticks;     // consecutive, in tick order
+    std::vector<ClientCommand> commands; // all ticks' commands back to back, stamped with their tick
+
+    /// The commands applied in @p tick, in the order the server drained them.
+    std::span<const ClientCommand> commandsOf(const RecordedTick &tick) const noexcept;
+};
+
+/// Reads a file written by InputRecorder.
+///
+/// Throws std::runtime_error if the file cannot be opened, is not a
+/// recording, has another format version or is cut off inside the header.
+/// A recording cut off inside a tick (the server crashed while writing) is
+/// loaded up to the last complete tick, with a warning.
+InputRecording loadRecording(const std::string &path);
+
+/// Writes every tick's drained commands and resulting state hash to a file,
+/// so the session can be replayed with `server --replay`.
+///
+/// Layout, all integers little-endian:
+///   header: "VCREPLAY", u32 format version, u16 length + engine version,
+///           u32 tick rate, u64 world seed, u32 max commands per client per tick
+///   per tick: u64 tick, u64 state hash, u32 command count, then per command
+///             u32 client, u32 sequence, u16 type, u8 payload size, payload
+///
+/// Commands are written field by field rather than as raw structs, so the
+/// file does not depend on padding or the host's byte order. Output is
+/// buffered and goes to disk in blocks; a write error is logged once and
+/// stops the recording without disturbing the server.
+///
+/// Game thread only.
+class InputRecorder {
+public:
+    /// Creates or truncates @p path and writes the header.
+    /// Throws std::runtime_error if the file cannot be opened.
+    InputRecorder(const std::string &path, const RecordingHeader &header);
+    ~InputRecorder();
+
+    InputRecorder(const InputRecorder &) = delete;
+    InputRecorder &operator=(const InputRecorder &) = delete;
+    InputRecorder(InputRecorder &&) = delete;
+    InputRecorder &operator=(InputRecorder &&) = delete;
+
+    /// Appends one tick. Ticks must be recorded in order, every one of them.
+    void record(uint64_t tick, std::span<const ClientCommand> commands, uint64_t stateHash);
+
+    /// Writes buffered ticks to the file.
+    void flush();
+
+    const std::string &path() const noexcept;
+    uint64_t ticks() const noexcept;
+    uint64_t commands() const noexcept;
+
+    /// False once a write failed; later ticks are dropped.
+    bool good() const noexcept;
+
+private:
+    std::string m_path;
+    std::ofstream m_out;
+    std::vector<std::byte> m_buffer;
+    uint64_t m_ticks = 0;
+    uint64_t m_commands = 0;
+    bool m_good = true;
+};
+
+} // namespace void_crew::server
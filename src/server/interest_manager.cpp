@@ -0,0 +1,278 @@
+#include "interest_manager.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <unordered_set>
+
+namespace void_crew::server {
+
+namespace {
+
+/// Door hops from the viewer's compartment that are still seen in full.
+constexpr std::size_t FULL_DETAIL_HOPS = 1;
+
+float snap(float value) noexcept {
+    return std::round(value / COARSE_POSITION_STEP) * COARSE_POSITION_STEP;
+}
+
+} // namespace
+
+InterestManager::InterestManager(entt::registry &registry)
+    : m_registry(registry) {
+    m_registry.on_construct<NetworkId>().connect<&InterestManager::onReplicated>(*this);
+    m_registry.on_destroy<NetworkId>().connect<&InterestManager::onUnreplicated>(*this);
+    m_registry.on_construct<InCompartment>().connect<&InterestManager::onCompartmentSet>(*this);
+    m_registry.on_update<InCompartment>().connect<&InterestManager::onCompartmentSet>(*this);
+    m_registry.on_destroy<InCompartment>().connect<&InterestManager::onCompartmentRemoved>(*this);
+    m_registry.on_construct<Door>().connect<&InterestManager::onDoorChanged>(*this);
+    m_registry.on_update<Door>().connect<&InterestManager::onDoorChanged>(*this);
+    m_registry.on_destroy<Door>().connect<&InterestManager::onDoorChanged>(*this);
+
+    for (auto [entity, id] : m_registry.view<const NetworkId>().each()) {
+        onReplicated(m_registry, entity);
+    }
+}
+
+InterestManager::~InterestManager() {
+    m_registry.on_construct<NetworkId>().disconnect(*this);
+    m_registry.on_destroy<NetworkId>().disconnect(*this);
+    m_registry.on_construct<InCompartment>().disconnect(*this);
+    m_registry.on_update<InCompartment>().disconnect(*this);
+    m_registry.on_destroy<InCompartment>().disconnect(*this);
+    m_registry.on_construct<Door>().disconnect(*this);
+    m_registry.on_update<Door>().disconnect(*this);
+    m_registry.on_destroy<Door>().disconnect(*this);
+}
+
+void InterestManager::setViewer(ConnectionId client, entt::entity viewer) {
+    auto it = std::find_if(m_viewers.begin(), m_viewers.end(), [&](const auto &v) { return v.first == client; });
+    if (it != m_viewers.end()) {
+        it->second = viewer;
+    } else {
+        m_viewers.emplace_back(client, viewer);
+    }
+}
+
+void InterestManager::removeViewer(ConnectionId client) {
+    std::erase_if(m_viewers, [&](const auto &v) { return v.first == client; });
+}
+
+std::size_t InterestManager::viewerCount() const noexcept {
+    return m_viewers.size();
+}
+
+DetailTier InterestManager::tier(ConnectionId client, entt::entity entity) {
+    auto slot = m_slots.find(entity);
+    if (slot == m_slots.end()) {
+        return DetailTier::None;
+    }
+    if (!slot->second.inside) {
+        return DetailTier::Coarse;
+    }
+    auto from = viewerCompartment(client);
+    if (!from) {
+        return DetailTier::None;
+    }
+    for (const auto &visible : visibleFrom(*from)) {
+        if (visible.id == slot->second.compartment) {
+            return visible.tier;
+        }
+    }
+    return DetailTier::None;
+}
+
+void InterestManager::buildViews(uint64_t tick, std::vector<ClientView> &views) {
+    views.resize(m_viewers.size());
+    for (std::size_t i = 0; i < m_viewers.size(); ++i) {
+        auto &view = views[i];
+        view.client = m_viewers[i].first;
+        view.state.tick = tick;
+        view.state.entities.clear();
+        view.relevance.clear();
+
+        const auto *eye = m_registry.valid(m_viewers[i].second)
+                              ? m_registry.try_get<Transform>(m_viewers[i].second)
+                              : nullptr;
+        view.hasViewpoint = eye != nullptr;
+        view.viewpoint = eye != nullptr ? eye->position : glm::vec3(0.0f);
+
+        if (auto from = viewerCompartment(view.client)) {
+            for (const auto &visible : visibleFrom(*from)) {
+                for (auto entity : members(visible.id)) {
+                    append(entity, visible.tier, view);
+                }
+            }
+        }
+        for (auto entity : m_outside) {
+            append(entity, DetailTier::Coarse, view);
+        }
+        sortById(view);
+    }
+}
+
+std::span<const entt::entity> InterestManager::members(CompartmentId compartment) const {
+    auto it = m_members.find(compartment);
+    if (it == m_members.end()) {
+        return {};
+    }
+    return it->second;
+}
+
+void InterestManager::onReplicated(entt::registry &registry, entt::entity entity) {
+    std::optional<CompartmentId> compartment;
+    if (const auto *in = registry.try_get<InCompartment>(entity)) {
+        compartment = in->id;
+    }
+    reindex(entity, true, compartment);
+}
+
+void InterestManager::onUnreplicated(entt::registry &, entt::entity entity) {
+    unindex(entity);
+}
+
+void InterestManager::onCompartmentSet(entt::registry &registry, entt::entity entity) {
+    reindex(entity, registry.all_of<NetworkId>(entity), registry.get<InCompartment>(entity).id);
+}
+
+void InterestManager::onCompartmentRemoved(entt::registry &registry, entt::entity entity) {
+    // Called before the component goes away, so pass the new state explicitly.
+    reindex(entity, registry.all_of<NetworkId>(entity), std::nullopt);
+}
+
+void InterestManager::onDoorChanged(entt::registry &, entt::entity) {
+    // Doors change rarely; rebuild the graph lazily on the next query. On
+    // destroy the door is still in the registry, so rebuilding here would see it.
+    m_graphDirty = true;
+}
+
+void InterestManager::reindex(entt::entity entity, bool replicated, std::optional<CompartmentId> compartment) {
+    unindex(entity);
+    if (!replicated) {
+        return;
+    }
+    Slot slot;
+    slot.inside = compartment.has_value();
+    if (slot.inside) {
+        slot.compartment = *compartment;
+        auto &members = m_members[*compartment];
+        slot.index = members.size();
+        members.push_back(entity);
+    } else {
+        slot.index = m_outside.size();
+        m_outside.push_back(entity);
+    }
+    m_slots[entity] = slot;
+}
+
+void InterestManager::unindex(entt::entity entity) {
+    auto it = m_slots.find(entity);
+    if (it == m_slots.end()) {
+        return;
+    }
+    auto &list = it->second.inside ? m_members[it->second.compartment] : m_outside;
+    auto index = it->second.index;
+    if (index + 1 != list.size()) {
+        list[index] = list.back();
+        m_slots[list[index]].index = index;
+    }
+    list.pop_back();
+    m_slots.erase(it);
+}
+
+const std::vector<InterestManager::VisibleCompartment> &InterestManager::visibleFrom(CompartmentId compartment) {
+    if (m_graphDirty) {
+        rebuildGraph();
+    }
+    auto [it, inserted] = m_visibility.try_emplace(compartment);
+    if (!inserted) {
+        return it->second;
+    }
+
+    // Breadth-first over open doors: hop count decides the tier.
+    auto &visible = it->second;
+    visible.push_back({compartment, DetailTier::Full});
+    std::unordered_set<CompartmentId> seen{compartment};
+    std::size_t levelBegin = 0;
+    for (std::size_t hops = 1; levelBegin < visible.size(); ++hops) {
+        std::size_t levelEnd = visible.size();
+        for (std::size_t i = levelBegin; i < levelEnd; ++i) {
+            auto doors = m_openDoors.find(visible[i].id);
+            if (doors == m_openDoors.end()) {
+                continue;
+            }
+            for (auto next : doors->second) {
+                if (seen.insert(next).second) {
+                    visible.push_back({next, hops <= FULL_DETAIL_HOPS ? DetailTier::Full : DetailTier::Coarse});
+                }
+            }
+        }
+        levelBegin = levelEnd;
+    }
+    return visible;
+}
+
+void InterestManager::rebuildGraph() {
+    m_openDoors.clear();
+    m_visibility.clear();
+    for (auto [entity, door] : m_registry.view<const Door>().each()) {
+        if (door.open && door.first != door.second) {
+            m_openDoors[door.first].push_back(door.second);
+            m_openDoors[door.second].push_back(door.first);
+        }
+    }
+    m_graphDirty = false;
+}
+
+std::optional<CompartmentId> InterestManager::viewerCompartment(ConnectionId client) const {
+    auto it = std::find_if(m_viewers.begin(), m_viewers.end(), [&](const auto &v) { return v.first == client; });
+    if (it == m_viewers.end() || !m_registry.valid(it->second)) {
+        return std::nullopt;
+    }
+    if (const auto *in = m_registry.try_get<InCompartment>(it->second)) {
+        return in->id;
+    }
+    return std::nullopt;
+}
+
+void InterestManager::append(entt::entity entity, DetailTier tier, ClientView &view) const {
+    const auto *transform = m_registry.try_get<Transform>(entity);
+    if (transform == nullptr) {
+        return; // same rule as captureWorldState: nothing to place without a transform
+    }
+    auto &out = view.state.entities.emplace_back();
+    out.id = m_registry.get<NetworkId>(entity).value;
+    if (tier == DetailTier::Coarse) {
+        out.position = {snap(transform->position.x), snap(transform->position.y), snap(transform->position.z)};
+        view.relevance.push_back(COARSE_RELEVANCE);
+        return;
+    }
+    out.position = transform->position;
+    out.rotation = transform->rotation;
+    if (const auto *velocity = m_registry.try_get<Velocity>(entity)) {
+        out.linearVelocity = velocity->linear;
+        out.angularVelocity = velocity->angular;
+    }
+    view.relevance.push_back(1.0f);
+}
+
+void InterestManager::sortById(ClientView &view) {
+    auto &entities = view.state.entities;
+    m_order.resize(entities.size());
+    for (std::size_t i = 0; i < m_order.size(); ++i) {
+        m_order[i] = i;
+    }
+    std::sort(m_order.begin(), m_order.end(),
+              [&entities](std::size_t lhs, std::size_t rhs) { return entities[lhs].id < entities[rhs].id; });
+
+    // Relevance stays index-aligned with the entities it weighs.
+    m_sortedEntities.clear();
+    m_sortedRelevance.clear();
+    for (auto index : m_order) {
+        m_sortedEntities.push_back(entities[index]);
+        m_sortedRelevance.push_back(view.relevance[index]);
+    }
+    std::swap(entities, m_sortedEntities);
+    std::swap(view.relevance, m_sortedRelevance);
+}
+
+} // namespace void_crew::server
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <entt/entt.hpp>
+
+#include "components.hpp"
+#include "delta_snapshot.hpp"
+#include "snapshot_replicator.hpp"
+#include "udp_transport.hpp"
+
+namespace void_crew::server {
+
+/// How much a client learns about an entity.
+enum class DetailTier : uint8_t {
+    None,   // not replicated to this client
+    Coarse, // position snapped to COARSE_POSITION_STEP; no orientation or velocity
+    Full,
+};
+
+/// Grid coarse positions snap to, in metres. Coarse entities are only resent
+/// when they cross a grid line, which is most of the saving.
+constexpr float COARSE_POSITION_STEP = 0.5f;
+
+/// Scheduling weight of a coarse entity relative to a full one, so that under
+/// a tight snapshot budget the compartments around a client update first.
+constexpr float COARSE_RELEVANCE = 0.25f;
+
+/// Compartment-based area of interest.
+///
+/// Keeps a membership index (compartment -> replicated entities) and a
+/// visibility graph of compartments joined by open doors, both maintained
+/// from registry signals on NetworkId, InCompartment and Door. Each client
+/// sees the world from its viewer entity's compartment:
+/// - Full: that compartment and the ones behind an open door from it;
+/// - Coarse: compartments further away but reachable through open doors, and
+///   replicated entities outside any compartment;
+/// - None: compartments sealed off by closed doors and bulkheads.
+///
+/// buildViews() visits only members of visible compartments, so a client
+/// costs O(visible) rather than O(world). Visibility per compartment is
+/// cached and recomputed only after a door changes. Game thread only.
+class InterestManager {
+public:
+    explicit InterestManager(entt::registry &registry);
+    ~InterestManager();
+
+    InterestManager(const InterestManager &) = delete;
+    InterestManager &operator=(const InterestManager &) = delete;
+    InterestManager(InterestManager &&) = delete;
+    InterestManager &operator=(InterestManager &&) = delete;
+
+    /// Views the world for @p client from @p viewer's compartment. A viewer
+    /// outside every compartment (or destroyed) sees only the coarse outside.
+    void setViewer(ConnectionId client, entt::entity viewer);
+    void removeViewer(ConnectionId client);
+    std::size_t viewerCount() const noexcept;
+
+    /// What @p client currently learns about @p entity.
+    DetailTier tier(ConnectionId client, entt::entity entity);
+
+    /// Fills @p views with one view per viewer, sorted by id as WorldState
+    /// requires, with per-entity relevance and the viewer's position for the
+    /// snapshot scheduler. Reuses the storage already in @p views.
+    void buildViews(uint64_t tick, std::vector<ClientView> &views);
+
+    /// Replicated entities in @p compartment, in no particular order.
+    std::span<const entt::entity> members(CompartmentId compartment) const;
+
+private:
+    struct Slot {
+        bool inside = false; // in m_members[compartment], else in m_outside
+        CompartmentId compartment = 0;
+        std::size_t index = 0;
+    };
+
+    struct VisibleCompartment {
+        CompartmentId id = 0;
+        DetailTier tier = DetailTier::None;
+    };
+
+    void onReplicated(entt::registry &registry, entt::entity entity);
+    void onUnreplicated(entt::registry &registry, entt::entity entity);
+    void onCompartmentSet(entt::registry &registry, entt::entity entity);
+    void onCompartmentRemoved(entt::registry &registry, entt::entity entity);
+    void onDoorChanged(entt::registry &registry, entt::entity entity);
+
+    /// Moves @p entity to the list matching its new state.
+    void reindex(entt::entity entity, bool replicated, std::optional<CompartmentId> compartment);
+    void unindex(entt::entity entity);
+
+    const std::vector<VisibleCompartment> &visibleFrom(CompartmentId compartment);
+    void rebuildGraph();
+
+    std::optional<CompartmentId> viewerCompartment(ConnectionId client) const;
+    void append(entt::entity entity, DetailTier tier, ClientView &view) const;
+    void sortById(ClientView &view);
+
+    entt::registry &m_registry;
+
+    std::unordered_map<CompartmentId, std::vector<entt::entity>> m_members;
+    std::vector<entt::entity> m_outside;
+    std::unordered_map<entt::entity, Slot> m_slots;
+
+    std::unordered_map<CompartmentId, std::vector<CompartmentId>> m_openDoors; // adjacency, both directions
+    std::unordered_map<CompartmentId, std::vector<VisibleCompartment>> m_visibility;
+    bool m_graphDirty = true;
+
+    std::vector<std::pair<ConnectionId, entt::entity>> m_viewers;
+
+    // Scratch for sortById().
+    std::vector<std::size_t> m_order;
+    std::vector<EntityState> m_sortedEntities;
+    std::vector<float> m_sortedRelevance;
+};
+
+} // namespace void_crew::server
@@ -1,12 +1,48 @@
 #include <cstdlib>
 
 #include "command_line.hpp"
+#include "input_recording.hpp"
 #include "logging.hpp"
+#include "profiler.hpp"
 #include "server.hpp"
 #include "server_config.hpp"
 #include "signal_handler.hpp"
 #include "version.hpp"
 
+namespace {
+
+// Headless replay: no network, so it runs beside a live server on the same
+// port, and, unless --mode asks otherwise, no sleeping.
+// Exits with failure if the state ever diverged from the recording, so a
+// regression run can gate on it.
+int runReplay(void_crew::server::ServerConfig config, const void_crew::server::CommandLineArgs &args) {
+    auto recording = void_crew::server::loadRecording(args.replayFile);
+    if (!args.runMode) {
+        config.runMode = void_crew::server::RunMode::Batch;
+    }
+    config.tickRate = recording.header.tickRate;
+    config.worldSeed = recording.header.worldSeed;
+    config.maxClientCommandsPerTick = recording.header.maxClientCommandsPerTick;
+    config.recordFile.clear();
+    config.headless = true;
+
+    void_crew::server::Server server(std::move(config));
+    auto report = server.replay(recording);
+
+    LOG_INFO("Replayed {} ticks in {:.2f}s: {:.0f} ticks/s, tick p50 {:.3f}ms p99 {:.3f}ms max {:.3f}ms",
+             report.ticks, report.seconds, report.ticksPerSecond, report.tickDurations.p50 * 1000.0,
+             report.tickDurations.p99 * 1000.0, report.tickDurations.max * 1000.0);
+    if (report.firstDivergedTick) {
+        LOG_ERROR("Replay diverged from the recording at tick {}; final state hash {:016x}",
+                  *report.firstDivergedTick, report.finalHash);
+        return EXIT_FAILURE;
+    }
+    LOG_INFO("Replay matched the recording; final state hash {:016x}", report.finalHash);
+    return EXIT_SUCCESS;
+}
+
+} // namespace
+
 int main(int argc, char *argv[]) {
     try {
         auto args = void_crew::server::parseCommandLine(argc, argv);
@@ -19,7 +55,15 @@ int main(int argc, char *argv[]) {
         void_crew::server::installSignalHandlers();
 
         auto config = void_crew::server::loadConfig(*args);
+        if (config.logMode == void_crew::server::LogMode::Async) {
+            void_crew::enableAsyncLogging({.queueSize = config.logQueueSize, .overflow = config.logOverflow});
+        }
         spdlog::set_level(spdlog::level::from_str(config.logLevel));
+        void_crew::setProfilingEnabled(config.profiling);
+
+        if (!args->replayFile.empty()) {
+            return runReplay(std::move(config), *args);
+        }
 
         void_crew::server::Server server(std::move(config));
         server.run();
@@ -0,0 +1,152 @@
+#include "network_service.hpp"
+
+#include <utility>
+
+#include "logging.hpp"
+#include "profiler.hpp"
+#include "protocol.hpp"
+
+namespace void_crew::server {
+
+NetworkService::NetworkService(const TransportConfig &config, CommandQueue &commands, ReplicationConfig replication)
+    : m_commands(commands),
+      m_transport(config,
+                  {
+                      .onConnect = [this](ConnectionId id, Endpoint endpoint) { onConnect(id, endpoint); },
+                      .onDisconnect = [this](ConnectionId id) { onDisconnect(id); },
+                      .onMessage = [this](ConnectionId id, std::span<const std::byte> message,
+                                          Delivery) { onMessage(id, message); },
+                  }),
+      m_replicator(replication) {
+    m_producers.reserve(config.maxConnections);
+    TLOG_INFO("net", "Listening on UDP {}", m_transport.localEndpoint().toString());
+}
+
+NetworkService::~NetworkService() {
+    stop();
+}
+
+void NetworkService::start() {
+    if (m_running.exchange(true, std::memory_order_acq_rel)) {
+        return;
+    }
+    m_thread = std::thread([this]() { run(); });
+}
+
+void NetworkService::stop() {
+    m_running.store(false, std::memory_order_release);
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+}
+
+Endpoint NetworkService::localEndpoint() const noexcept {
+    return m_transport.localEndpoint();
+}
+
+std::size_t NetworkService::connectionCount() const noexcept {
+    return m_connectionCount.load(std::memory_order_relaxed);
+}
+
+void NetworkService::publishWorldState(WorldState &state) {
+    std::lock_guard lock(m_worldMutex);
+    std::swap(m_publishedWorld, state);
+    m_worldPublished = true;
+}
+
+void NetworkService::publishViews(std::vector<ClientView> &views) {
+    std::lock_guard lock(m_worldMutex);
+    std::swap(m_publishedViews, views);
+    m_viewsPublished = true;
+}
+
+TransportStats NetworkService::stats() const {
+    std::lock_guard lock(m_statsMutex);
+    return m_stats;
+}
+
+ReplicationStats NetworkService::replicationStats() const {
+    std::lock_guard lock(m_statsMutex);
+    return m_replicationStats;
+}
+
+void NetworkService::run() {
+    while (m_running.load(std::memory_order_acquire)) {
+        m_transport.waitReadable(POLL_TIMEOUT);
+        {
+            PROFILE_ZONE("net.receive");
+            m_transport.receive();
+        }
+        bool fresh = false;
+        {
+            std::lock_guard lock(m_worldMutex);
+            // Pushing swaps evicted history slots back for the game loop to reuse.
+            if (m_worldPublished) {
+                m_replicator.pushState(m_publishedWorld);
+                m_worldPublished = false;
+                fresh = true;
+            }
+            if (m_viewsPublished) {
+                for (auto &view : m_publishedViews) {
+                    m_replicator.pushView(view);
+                }
+                m_viewsPublished = false;
+                fresh = true;
+            }
+        }
+        if (fresh) {
+            PROFILE_ZONE("net.snapshots");
+            m_replicator.sendSnapshots(m_transport);
+        }
+        {
+            PROFILE_ZONE("net.flush");
+            m_transport.flush();
+        }
+
+        std::lock_guard lock(m_statsMutex);
+        m_stats = m_transport.stats();
+        m_replicationStats = m_replicator.stats();
+    }
+}
+
+void NetworkService::onConnect(ConnectionId id, Endpoint endpoint) {
+    m_producers.emplace(id, m_commands.producer(id));
+    m_replicator.addClient(id);
+    m_connectionCount.store(m_transport.connectionCount(), std::memory_order_relaxed);
+    TLOG_INFO("net", "Client {} connected from {}", id, endpoint.toString());
+}
+
+void NetworkService::onDisconnect(ConnectionId id) {
+    if (auto it = m_producers.find(id); it != m_producers.end()) {
+        if (it->second.dropped() > 0) {
+            TLOG_INFO("net", "Client {} had {} commands dropped by the flood cap", id, it->second.dropped());
+        }
+        m_producers.erase(it);
+    }
+    m_replicator.removeClient(id);
+    m_connectionCount.store(m_transport.connectionCount(), std::memory_order_relaxed);
+    TLOG_INFO("net", "Client {} disconnected", id);
+}
+
+void NetworkService::onMessage(ConnectionId id, std::span<const std::byte> message) {
+    auto type = messageType(message);
+    if (type == MessageType::Command) {
+        auto command = decodeCommand(message);
+        auto it = m_producers.find(id);
+        if (command && it != m_producers.end()) {
+            it->second.push(*command);
+            return;
+        }
+    } else if (type == MessageType::SnapshotAck) {
+        if (auto tick = decodeSnapshotAck(message)) {
+            m_replicator.onAck(id, *tick);
+            return;
+        }
+    }
+
+    if (m_invalidMessages++ == 0) {
+        TLOG_WARN("net", "Dropping malformed message from client {}", id);
+    }
+}
+
+} // namespace void_crew::server
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "command_queue.hpp"
+#include "delta_snapshot.hpp"
+#include "snapshot_replicator.hpp"
+#include "udp_transport.hpp"
+
+namespace void_crew::server {
+
+/// Runs the server's UdpTransport on a dedicated network thread.
+///
+/// The thread waits for datagrams, receives them in batches, decodes client
+/// commands and pushes them into the CommandQueue through one CommandProducer
+/// per connection, then sends delta snapshots of the latest published world
+/// state and flushes. The game loop never touches the socket; it drains the
+/// queue at the start of each tick and publishes its state at the end.
+class NetworkService {
+public:
+    /// Binds the socket immediately so a taken port fails at startup.
+    /// Throws std::runtime_error if the socket cannot be bound.
+    NetworkService(const TransportConfig &config, CommandQueue &commands, ReplicationConfig replication = {});
+    ~NetworkService();
+
+    NetworkService(const NetworkService &) = delete;
+    NetworkService &operator=(const NetworkService &) = delete;
+    NetworkService(NetworkService &&) = delete;
+    NetworkService &operator=(NetworkService &&) = delete;
+
+    void start();
+
+    /// Stops and joins the network thread. Idempotent.
+    void stop();
+
+    Endpoint localEndpoint() const noexcept;
+    std::size_t connectionCount() const noexcept;
+
+    /// Hands the world state for the tick just simulated to the network
+    /// thread, which sends it to every client on its next iteration. @p state
+    /// receives an older state whose buffers can be reused; a state not yet
+    /// sent is replaced, so a slow network thread skips ticks instead of
+    /// falling behind.
+    void publishWorldState(WorldState &state);
+
+    /// Per-client counterpart of publishWorldState(): each client with a view
+    /// is sent that instead of the shared state. @p views receives older
+    /// views whose buffers can be reused.
+    void publishViews(std::vector<ClientView> &views);
+
+    /// Transport counters as of the network thread's last iteration.
+    TransportStats stats() const;
+
+    /// Snapshot counters as of the network thread's last iteration.
+    ReplicationStats replicationStats() const;
+
+private:
+    /// Upper bound on how long the thread sleeps in the socket; also how
+    /// quickly stop() is noticed.
+    static constexpr std::chrono::milliseconds POLL_TIMEOUT{1};
+
+    void run();
+    void onConnect(ConnectionId id, Endpoint endpoint);
+    void onDisconnect(ConnectionId id);
+    void onMessage(ConnectionId id, std::span<const std::byte> message);
+
+    CommandQueue &m_commands;
+    UdpTransport m_transport;
+    std::unordered_map<ConnectionId, CommandProducer> m_producers; // network thread only
+    SnapshotReplicator m_replicator;                                // network thread only
+
+    std::atomic<bool> m_running{false};
+    std::atomic<std::size_t> m_connectionCount{0};
+    uint64_t m_invalidMessages = 0;
+
+    std::mutex m_worldMutex;
+    WorldState m_publishedWorld;
+    std::vector<ClientView> m_publishedViews;
+    bool m_worldPublished = false;
+    bool m_viewsPublished = false;
+
+    mutable std::mutex m_statsMutex;
+    TransportStats m_stats;
+    ReplicationStats m_replicationStats;
+
+    std::thread m_thread;
+};
+
+} // namespace void_crew::server
@@ -0,0 +1,42 @@
+#include "packet_pool.hpp"
+
+namespace void_crew::server {
+
+PacketPool::PacketPool(std::size_t capacity)
+    : m_capacity(capacity),
+      m_buffers(std::make_unique<PacketBuffer[]>(capacity)) {
+    m_free.reserve(capacity);
+    for (std::size_t i = capacity; i > 0; --i) {
+        m_free.push_back(&m_buffers[i - 1]);
+    }
+}
+
+PacketBuffer *PacketPool::acquire() noexcept {
+    if (m_free.empty()) {
+        ++m_exhausted;
+        return nullptr;
+    }
+    auto *buffer = m_free.back();
+    m_free.pop_back();
+    buffer->size = 0;
+    return buffer;
+}
+
+void PacketPool::release(PacketBuffer *buffer) noexcept {
+    // Capacity was reserved up front, so this never reallocates.
+    m_free.push_back(buffer);
+}
+
+std::size_t PacketPool::capacity() const noexcept {
+    return m_capacity;
+}
+
+std::size_t PacketPool::available() const noexcept {
+    return m_free.size();
+}
+
+uint64_t PacketPool::exhaustedCount() const noexcept {
+    return m_exhausted;
+}
+
+} // namespace void_crew::server
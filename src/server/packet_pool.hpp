@@ -0,0 +1,51 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace void_crew::server {
+
+/// Largest datagram the transport sends. Stays under the common 1280-byte
+/// IPv6 minimum MTU minus headers so packets are never fragmented.
+constexpr std::size_t MAX_PACKET_SIZE = 1200;
+
+struct PacketBuffer {
+    std::array<std::byte, MAX_PACKET_SIZE> data;
+    std::size_t size = 0;
+};
+
+/// Fixed set of packet buffers allocated once up front.
+///
+/// acquire()/release() are a pointer push/pop on a free list, so the
+/// transport's steady state does no heap allocation per packet. When the pool
+/// runs dry acquire() returns nullptr and the caller drops the packet; the
+/// exhaustion count shows whether the pool is sized too small.
+/// Not thread-safe: each transport owns its pool.
+class PacketPool {
+public:
+    explicit PacketPool(std::size_t capacity);
+
+    PacketPool(const PacketPool &) = delete;
+    PacketPool &operator=(const PacketPool &) = delete;
+    PacketPool(PacketPool &&) = delete;
+    PacketPool &operator=(PacketPool &&) = delete;
+
+    /// Returns an empty buffer, or nullptr when every buffer is in use.
+    PacketBuffer *acquire() noexcept;
+    void release(PacketBuffer *buffer) noexcept;
+
+    std::size_t capacity() const noexcept;
+    std::size_t available() const noexcept;
+    uint64_t exhaustedCount() const noexcept;
+
+private:
+    std::size_t m_capacity;
+    std::unique_ptr<PacketBuffer[]> m_buffers;
+    std::vector<PacketBuffer *> m_free;
+    uint64_t m_exhausted = 0;
+};
+
+} // namespace void_crew::server
@@ -0,0 +1,439 @@
+#include "power_grid.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include "logging.hpp"
+
+namespace void_crew::server {
+
+PowerGrid::PowerGrid(entt::registry &registry) : m_registry(registry) {
+    m_registry.on_construct<PowerSource>().connect<&PowerGrid::onSource>(*this);
+    m_registry.on_update<PowerSource>().connect<&PowerGrid::onSource>(*this);
+    m_registry.on_destroy<PowerSource>().connect<&PowerGrid::onSourceRemoved>(*this);
+    m_registry.on_construct<PowerLink>().connect<&PowerGrid::onLink>(*this);
+    m_registry.on_update<PowerLink>().connect<&PowerGrid::onLink>(*this);
+    m_registry.on_destroy<PowerLink>().connect<&PowerGrid::onLinkRemoved>(*this);
+    m_registry.on_construct<PowerConsumer>().connect<&PowerGrid::onConsumer>(*this);
+    m_registry.on_update<PowerConsumer>().connect<&PowerGrid::onConsumer>(*this);
+    m_registry.on_destroy<PowerConsumer>().connect<&PowerGrid::onConsumerRemoved>(*this);
+
+    // Any order will do: every change is applied incrementally.
+    for (auto entity : m_registry.view<PowerSource>()) {
+        onSource(m_registry, entity);
+    }
+    for (auto entity : m_registry.view<PowerLink>()) {
+        onLink(m_registry, entity);
+    }
+    for (auto entity : m_registry.view<PowerConsumer>()) {
+        onConsumer(m_registry, entity);
+    }
+}
+
+PowerGrid::~PowerGrid() {
+    m_registry.on_construct<PowerSource>().disconnect(*this);
+    m_registry.on_update<PowerSource>().disconnect(*this);
+    m_registry.on_destroy<PowerSource>().disconnect(*this);
+    m_registry.on_construct<PowerLink>().disconnect(*this);
+    m_registry.on_update<PowerLink>().disconnect(*this);
+    m_registry.on_destroy<PowerLink>().disconnect(*this);
+    m_registry.on_construct<PowerConsumer>().disconnect(*this);
+    m_registry.on_update<PowerConsumer>().disconnect(*this);
+    m_registry.on_destroy<PowerConsumer>().disconnect(*this);
+}
+
+void PowerGrid::update() {
+    m_stats.propagated = m_propagated;
+    m_stats.passes = 0;
+    m_propagated = 0;
+    if (m_dirty.empty()) {
+        m_suspects.clear(); // load moved only within unfed fragments
+        return;
+    }
+
+    while (true) {
+        ++m_stats.passes;
+        bool unshed = false;
+        for (auto source : m_dirty) {
+            if (m_nodes[source].dirty && m_nodes[source].source) {
+                unshed = shedClasses(source) || unshed;
+            }
+        }
+
+        // Serving more classes raises the load on every breaker of the grid.
+        const auto &candidates = unshed ? m_breakers : m_suspects;
+        m_overloaded.clear();
+        for (auto breaker : candidates) {
+            const auto &node = m_nodes[breaker];
+            if (node.breakerSlot != NONE && connected(breaker) && node.root != NONE && m_nodes[node.root].dirty &&
+                served(breaker) > node.rating) {
+                m_overloaded.push_back(breaker);
+            }
+        }
+        m_suspects.clear();
+        if (m_overloaded.empty()) {
+            break;
+        }
+
+        // Deepest first: a trip downstream may already relieve the breakers above it.
+        std::sort(m_overloaded.begin(), m_overloaded.end());
+        m_overloaded.erase(std::unique(m_overloaded.begin(), m_overloaded.end()), m_overloaded.end());
+        std::sort(m_overloaded.begin(), m_overloaded.end(),
+                  [this](uint32_t lhs, uint32_t rhs) { return depth(lhs) > depth(rhs); });
+        for (auto breaker : m_overloaded) {
+            if (connected(breaker) && served(breaker) > m_nodes[breaker].rating) {
+                trip(breaker);
+            }
+        }
+    }
+
+    for (auto source : m_dirty) {
+        m_nodes[source].dirty = false;
+    }
+    m_dirty.clear();
+    m_suspects.clear();
+}
+
+void PowerGrid::reset(entt::entity breaker) {
+    auto index = findNode(breaker);
+    if (index == NONE || !m_nodes[index].tripped) {
+        return;
+    }
+    relink(index, [&] { m_nodes[index].tripped = false; });
+    --m_stats.tripped;
+}
+
+bool PowerGrid::isEnergized(entt::entity entity) const {
+    auto index = findNode(entity);
+    return index != NONE && m_nodes[index].root != NONE;
+}
+
+bool PowerGrid::isPowered(entt::entity consumer) const {
+    auto index = findNode(consumer);
+    if (index == NONE || !m_nodes[index].consumer || m_nodes[index].root == NONE) {
+        return false;
+    }
+    return m_nodes[index].priority >= m_nodes[m_nodes[index].root].shedBelow;
+}
+
+bool PowerGrid::isTripped(entt::entity breaker) const {
+    auto index = findNode(breaker);
+    return index != NONE && m_nodes[index].tripped;
+}
+
+float PowerGrid::load(entt::entity entity) const {
+    auto index = findNode(entity);
+    return index == NONE ? 0.0f : served(index);
+}
+
+PowerGridStats PowerGrid::stats() const noexcept {
+    auto stats = m_stats;
+    stats.nodes = m_indices.size();
+    stats.breakers = m_breakers.size();
+    return stats;
+}
+
+void PowerGrid::onSource(entt::registry &registry, entt::entity entity) {
+    auto capacity = std::max(registry.get<PowerSource>(entity).capacity, 0.0f);
+    auto index = nodeOf(entity);
+    if (!m_nodes[index].source) {
+        ++m_stats.sources;
+    }
+    relink(index, [&] {
+        m_nodes[index].source = true;
+        m_nodes[index].capacity = capacity;
+    });
+    markDirty(index);
+}
+
+void PowerGrid::onSourceRemoved(entt::registry &, entt::entity entity) {
+    auto index = findNode(entity);
+    if (index == NONE || !m_nodes[index].source) {
+        return;
+    }
+    --m_stats.sources;
+    relink(index, [&] {
+        m_nodes[index].source = false;
+        m_nodes[index].capacity = 0.0f;
+        m_nodes[index].shedBelow = 0;
+    });
+    releaseIfUnused(index);
+}
+
+void PowerGrid::onLink(entt::registry &registry, entt::entity entity) {
+    const auto &link = registry.get<PowerLink>(entity);
+    auto index = nodeOf(entity);
+    auto upstream = link.upstream == entt::null ? NONE : nodeOf(link.upstream);
+    if (upstream != NONE && wouldCycle(index, upstream)) {
+        TLOG_WARN("power", "Power link of entity {} to {} would close a loop; left disconnected",
+                  entt::to_integral(entity), entt::to_integral(link.upstream));
+        upstream = NONE;
+    }
+
+    auto previous = m_nodes[index].parent;
+    relink(index, [&] {
+        setParent(index, upstream);
+        auto &node = m_nodes[index];
+        node.link = true;
+        node.closed = link.closed;
+        node.rating = link.rating;
+    });
+    trackBreaker(index);
+    if (m_nodes[index].root != NONE) {
+        markDirty(m_nodes[index].root); // the rating may have dropped
+        suspect(index);
+    }
+    if (previous != NONE && previous != upstream) {
+        releaseIfUnused(previous);
+    }
+}
+
+void PowerGrid::onLinkRemoved(entt::registry &, entt::entity entity) {
+    auto index = findNode(entity);
+    if (index == NONE || !m_nodes[index].link) {
+        return;
+    }
+    auto previous = m_nodes[index].parent;
+    if (m_nodes[index].tripped) {
+        --m_stats.tripped;
+    }
+    relink(index, [&] {
+        setParent(index, NONE);
+        auto &node = m_nodes[index];
+        node.link = false;
+        node.closed = false;
+        node.tripped = false;
+        node.rating = std::numeric_limits<float>::infinity();
+    });
+    trackBreaker(index);
+    releaseIfUnused(index);
+    if (previous != NONE) {
+        releaseIfUnused(previous);
+    }
+}
+
+void PowerGrid::onConsumer(entt::registry &registry, entt::entity entity) {
+    const auto &consumer = registry.get<PowerConsumer>(entity);
+    auto index = nodeOf(entity);
+    auto priority = std::min<std::size_t>(consumer.priority, POWER_PRIORITIES - 1);
+    Demand own{};
+    own[priority] = std::max(consumer.demand, 0.0f);
+    m_nodes[index].consumer = true;
+    m_nodes[index].priority = static_cast<uint8_t>(priority);
+    setOwn(index, own);
+}
+
+void PowerGrid::onConsumerRemoved(entt::registry &, entt::entity entity) {
+    auto index = findNode(entity);
+    if (index == NONE || !m_nodes[index].consumer) {
+        return;
+    }
+    m_nodes[index].consumer = false;
+    setOwn(index, {});
+    releaseIfUnused(index);
+}
+
+uint32_t PowerGrid::nodeOf(entt::entity entity) {
+    auto [it, inserted] = m_indices.try_emplace(entity, NONE);
+    if (!inserted) {
+        return it->second;
+    }
+    if (m_free.empty()) {
+        it->second = static_cast<uint32_t>(m_nodes.size());
+        m_nodes.emplace_back();
+    } else {
+        it->second = m_free.back();
+        m_free.pop_back();
+    }
+    m_nodes[it->second].entity = entity;
+    return it->second;
+}
+
+uint32_t PowerGrid::findNode(entt::entity entity) const {
+    auto it = m_indices.find(entity);
+    return it == m_indices.end() ? NONE : it->second;
+}
+
+void PowerGrid::releaseIfUnused(uint32_t index) {
+    auto &node = m_nodes[index];
+    if (node.source || node.link || node.consumer || !node.children.empty()) {
+        return;
+    }
+    m_indices.erase(node.entity);
+    node = Node{};
+    m_free.push_back(index);
+}
+
+void PowerGrid::setParent(uint32_t index, uint32_t parent) {
+    auto previous = m_nodes[index].parent;
+    if (previous == parent) {
+        return;
+    }
+    if (previous != NONE) {
+        auto &siblings = m_nodes[previous].children;
+        auto it = std::find(siblings.begin(), siblings.end(), index);
+        *it = siblings.back();
+        siblings.pop_back();
+    }
+    if (parent != NONE) {
+        m_nodes[parent].children.push_back(index);
+    }
+    m_nodes[index].parent = parent;
+}
+
+bool PowerGrid::connected(uint32_t index) const noexcept {
+    const auto &node = m_nodes[index];
+    return node.link && node.closed && !node.tripped && !node.source && node.parent != NONE;
+}
+
+bool PowerGrid::wouldCycle(uint32_t index, uint32_t upstream) const noexcept {
+    for (auto node = upstream; node != NONE; node = m_nodes[node].parent) {
+        if (node == index) {
+            return true;
+        }
+    }
+    return false;
+}
+
+template <typename F>
+void PowerGrid::relink(uint32_t index, F &&change) {
+    if (connected(index)) {
+        addUp(index, m_nodes[index].subtree, -1.0f);
+    }
+    change();
+    if (connected(index)) {
+        addUp(index, m_nodes[index].subtree, 1.0f);
+        energize(index, m_nodes[m_nodes[index].parent].root);
+    } else {
+        energize(index, m_nodes[index].source ? index : NONE);
+    }
+}
+
+void PowerGrid::addUp(uint32_t index, const Demand &delta, float sign) {
+    bool rises = std::any_of(delta.begin(), delta.end(), [sign](float d) { return sign * d > 0.0f; });
+    auto node = index;
+    if (rises) {
+        suspect(node);
+    }
+    while (connected(node)) {
+        node = m_nodes[node].parent;
+        if (rises) {
+            suspect(node);
+        }
+        for (std::size_t priority = 0; priority < POWER_PRIORITIES; ++priority) {
+            m_nodes[node].subtree[priority] += sign * delta[priority];
+        }
+        ++m_propagated;
+    }
+    if (m_nodes[node].source) {
+        markDirty(node);
+    }
+}
+
+void PowerGrid::energize(uint32_t index, uint32_t root) {
+    // Connected descendants always share their ancestor's root, so an
+    // unchanged root means an unchanged subtree.
+    if (m_nodes[index].root == root) {
+        return;
+    }
+    m_stack.clear();
+    m_stack.push_back(index);
+    while (!m_stack.empty()) {
+        auto node = m_stack.back();
+        m_stack.pop_back();
+        m_nodes[node].root = root;
+        ++m_propagated;
+        if (root != NONE) {
+            suspect(node);
+        }
+        for (auto child : m_nodes[node].children) {
+            if (connected(child)) {
+                m_stack.push_back(child);
+            }
+        }
+    }
+}
+
+void PowerGrid::setOwn(uint32_t index, const Demand &own) {
+    auto &node = m_nodes[index];
+    Demand delta{};
+    for (std::size_t priority = 0; priority < POWER_PRIORITIES; ++priority) {
+        delta[priority] = own[priority] - node.own[priority];
+        node.subtree[priority] += delta[priority];
+    }
+    node.own = own;
+    addUp(index, delta, 1.0f);
+}
+
+void PowerGrid::markDirty(uint32_t source) {
+    if (!m_nodes[source].dirty) {
+        m_nodes[source].dirty = true;
+        m_dirty.push_back(source);
+    }
+}
+
+void PowerGrid::trackBreaker(uint32_t index) {
+    auto &node = m_nodes[index];
+    bool breaker = node.link && std::isfinite(node.rating);
+    if (breaker && node.breakerSlot == NONE) {
+        node.breakerSlot = static_cast<uint32_t>(m_breakers.size());
+        m_breakers.push_back(index);
+    } else if (!breaker && node.breakerSlot != NONE) {
+        auto last = m_breakers.back();
+        m_breakers[node.breakerSlot] = last;
+        m_nodes[last].breakerSlot = node.breakerSlot;
+        m_breakers.pop_back();
+        node.breakerSlot = NONE;
+    }
+}
+
+void PowerGrid::suspect(uint32_t index) {
+    if (m_nodes[index].breakerSlot != NONE) {
+        m_suspects.push_back(index);
+    }
+}
+
+float PowerGrid::served(uint32_t index) const noexcept {
+    const auto &node = m_nodes[index];
+    if (node.root == NONE) {
+        return 0.0f;
+    }
+    float total = 0.0f;
+    for (std::size_t priority = m_nodes[node.root].shedBelow; priority < POWER_PRIORITIES; ++priority) {
+        total += node.subtree[priority];
+    }
+    return total;
+}
+
+bool PowerGrid::shedClasses(uint32_t source) {
+    auto &node = m_nodes[source];
+    float total = 0.0f;
+    auto shedBelow = POWER_PRIORITIES;
+    for (auto priority = POWER_PRIORITIES; priority-- > 0;) {
+        if (total + node.subtree[priority] > node.capacity) {
+            break;
+        }
+        total += node.subtree[priority];
+        shedBelow = priority;
+    }
+    bool unshed = shedBelow < node.shedBelow;
+    node.shedBelow = static_cast<uint8_t>(shedBelow);
+    return unshed;
+}
+
+void PowerGrid::trip(uint32_t breaker) {
+    relink(breaker, [&] { m_nodes[breaker].tripped = true; });
+    ++m_stats.tripped;
+    ++m_stats.trips;
+    TLOG_DEBUG("power", "Breaker {} tripped", entt::to_integral(m_nodes[breaker].entity));
+}
+
+uint32_t PowerGrid::depth(uint32_t index) const noexcept {
+    uint32_t depth = 0;
+    for (auto node = index; connected(node); node = m_nodes[node].parent) {
+        ++depth;
+    }
+    return depth;
+}
+
+} // namespace void_crew::server
@@ -0,0 +1,175 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+#include <entt/entt.hpp>
+
+namespace void_crew::server {
+
+/// Consumer priority classes; a higher class is shed later. 0 is lighting
+/// and the like, POWER_PRIORITIES - 1 is life support.
+constexpr std::size_t POWER_PRIORITIES = 4;
+
+/// A generator or battery bank: the root of a grid. Its own PowerLink, if
+/// any, is ignored.
+struct PowerSource {
+    float capacity = 0.0f; // W; zero for a wrecked generator
+};
+
+/// The conductor from an entity towards its source: a cable, a switch or a
+/// breaker. Entities with only a PowerLink are junctions. A breaker (finite
+/// rating) trips when the load it carries exceeds the rating and stays open
+/// until PowerGrid::reset(). Flip switches and rewire with registry.patch().
+struct PowerLink {
+    entt::entity upstream = entt::null;
+    float rating = std::numeric_limits<float>::infinity(); // W
+    bool closed = true;
+};
+
+struct PowerConsumer {
+    float demand = 0.0f;  // W
+    uint8_t priority = 0; // clamped to POWER_PRIORITIES - 1
+};
+
+struct PowerGridStats {
+    std::size_t nodes = 0;
+    std::size_t sources = 0;
+    std::size_t breakers = 0;
+    std::size_t tripped = 0;    // breakers open right now
+    std::size_t propagated = 0; // nodes walked by changes before the last update()
+    std::size_t passes = 0;     // shedding / breaker rounds in the last update()
+    uint64_t trips = 0;         // since construction
+};
+
+/// Power distribution over the entities with PowerSource, PowerLink and
+/// PowerConsumer components.
+///
+/// The grid is a forest: every PowerLink points upstream and each tree is fed
+/// by the PowerSource at its root. Every node keeps the consumer demand of its
+/// connected subtree, summed per priority class, and the source it is
+/// energized from. Both are maintained from registry signals: a demand change
+/// walks up to the source, a switch flip or a cut walks the ancestors and then
+/// only the subtree it connects or disconnects. Nothing is recomputed for the
+/// whole ship.
+///
+/// update() resolves the grids whose load changed since the last call. A
+/// source sheds whole priority classes, lowest first, until the rest fits its
+/// capacity. Breakers carrying more than their rating then trip, deepest
+/// first. Only breakers whose load rose are checked: those above a change and
+/// those it energized, or every breaker of a grid whose source un-sheds. The
+/// load a trip drops can let the source serve more, which can overload
+/// further breakers; the cascade settles within the same update(). A source
+/// un-sheds at most POWER_PRIORITIES times, so that costs at most
+/// POWER_PRIORITIES scans of its breakers plus the trips themselves.
+///
+/// Queries reflect the last update(). Game thread only.
+class PowerGrid {
+public:
+    explicit PowerGrid(entt::registry &registry);
+    ~PowerGrid();
+
+    PowerGrid(const PowerGrid &) = delete;
+    PowerGrid &operator=(const PowerGrid &) = delete;
+    PowerGrid(PowerGrid &&) = delete;
+    PowerGrid &operator=(PowerGrid &&) = delete;
+
+    /// Sheds load and trips breakers in every grid changed since the last call.
+    void update();
+
+    /// Re-closes a tripped breaker; it trips again next update() if still
+    /// overloaded. Does nothing for entities that are not tripped.
+    void reset(entt::entity breaker);
+
+    /// Connected to a source through closed links, whether shed or not.
+    bool isEnergized(entt::entity entity) const;
+
+    /// A consumer that is energized and not shed.
+    bool isPowered(entt::entity consumer) const;
+
+    bool isTripped(entt::entity breaker) const;
+
+    /// Demand served through @p entity in W: what a link carries or a
+    /// source delivers.
+    float load(entt::entity entity) const;
+
+    PowerGridStats stats() const noexcept;
+
+private:
+    static constexpr uint32_t NONE = UINT32_MAX;
+
+    using Demand = std::array<float, POWER_PRIORITIES>;
+
+    struct Node {
+        entt::entity entity = entt::null;
+        uint32_t parent = NONE;          // upstream node while the PowerLink exists, open or not
+        std::vector<uint32_t> children;  // nodes whose parent this is
+        uint32_t root = NONE;            // energizing source; itself for a source
+        uint32_t breakerSlot = NONE;     // index in m_breakers
+        Demand own{};                    // this node's consumer demand
+        Demand subtree{};                // own plus that of connected children
+        float capacity = 0.0f;           // sources
+        float rating = std::numeric_limits<float>::infinity();
+        uint8_t priority = 0;            // consumers
+        uint8_t shedBelow = 0;           // sources: classes below this are shed
+        bool source = false;
+        bool link = false;
+        bool consumer = false;
+        bool closed = false;
+        bool tripped = false;
+        bool dirty = false;              // sources queued in m_dirty
+    };
+
+    void onSource(entt::registry &registry, entt::entity entity);
+    void onSourceRemoved(entt::registry &registry, entt::entity entity);
+    void onLink(entt::registry &registry, entt::entity entity);
+    void onLinkRemoved(entt::registry &registry, entt::entity entity);
+    void onConsumer(entt::registry &registry, entt::entity entity);
+    void onConsumerRemoved(entt::registry &registry, entt::entity entity);
+
+    uint32_t nodeOf(entt::entity entity);
+    uint32_t findNode(entt::entity entity) const;
+    void releaseIfUnused(uint32_t index);
+
+    void setParent(uint32_t index, uint32_t parent);
+    bool connected(uint32_t index) const noexcept;
+    bool wouldCycle(uint32_t index, uint32_t upstream) const noexcept;
+
+    /// Applies @p change to a node's link, moving its subtree's demand and
+    /// energized state from the old upstream to the new one.
+    template <typename F>
+    void relink(uint32_t index, F &&change);
+
+    void addUp(uint32_t index, const Demand &delta, float sign);
+    void energize(uint32_t index, uint32_t root);
+    void setOwn(uint32_t index, const Demand &own);
+    void markDirty(uint32_t source);
+    void trackBreaker(uint32_t index);
+    void suspect(uint32_t index);
+
+    float served(uint32_t index) const noexcept;
+    bool shedClasses(uint32_t source);
+    void trip(uint32_t breaker);
+    uint32_t depth(uint32_t index) const noexcept;
+
+    entt::registry &m_registry;
+
+    std::vector<Node> m_nodes;
+    std::vector<uint32_t> m_free;
+    std::unordered_map<entt::entity, uint32_t> m_indices;
+
+    std::vector<uint32_t> m_breakers; // nodes with a finite rating
+    std::vector<uint32_t> m_dirty;    // sources whose load changed
+    std::vector<uint32_t> m_suspects; // breakers whose load rose
+    std::vector<uint32_t> m_stack;    // scratch for energize()
+    std::vector<uint32_t> m_overloaded;
+
+    std::size_t m_propagated = 0;
+    PowerGridStats m_stats;
+};
+
+} // namespace void_crew::server
@@ -0,0 +1,140 @@
+#include "protocol.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace void_crew::server {
+
+namespace {
+
+constexpr std::size_t COMMAND_HEADER_SIZE = 8;
+constexpr std::size_t SNAPSHOT_ACK_SIZE = 9;
+
+constexpr uint8_t FRAGMENT_HAS_BASELINE = 0x01;
+constexpr uint8_t FRAGMENT_COMPRESSED = 0x02;
+
+template <typename T>
+void writeLittleEndian(std::byte *out, T value) noexcept {
+    for (std::size_t i = 0; i < sizeof(T); ++i) {
+        out[i] = static_cast<std::byte>((value >> (8 * i)) & 0xFF);
+    }
+}
+
+template <typename T>
+T readLittleEndian(const std::byte *in) noexcept {
+    T value = 0;
+    for (std::size_t i = 0; i < sizeof(T); ++i) {
+        value |= static_cast<T>(std::to_integer<T>(in[i]) << (8 * i));
+    }
+    return value;
+}
+
+bool hasType(std::span<const std::byte> message, MessageType type) noexcept {
+    return !message.empty() && std::to_integer<uint8_t>(message[0]) == static_cast<uint8_t>(type);
+}
+
+} // namespace
+
+std::optional<MessageType> messageType(std::span<const std::byte> message) noexcept {
+    if (message.empty()) {
+        return std::nullopt;
+    }
+    auto type = std::to_integer<uint8_t>(message[0]);
+    if (type < static_cast<uint8_t>(MessageType::Command) || type > static_cast<uint8_t>(MessageType::SnapshotAck)) {
+        return std::nullopt;
+    }
+    return static_cast<MessageType>(type);
+}
+
+std::size_t encodeCommand(const ClientCommand &command, std::span<std::byte> out) noexcept {
+    std::size_t payloadSize = std::min<std::size_t>(command.payloadSize, ClientCommand::MAX_PAYLOAD);
+    std::size_t size = COMMAND_HEADER_SIZE + payloadSize;
+    if (out.size() < size) {
+        return 0;
+    }
+
+    out[0] = static_cast<std::byte>(MessageType::Command);
+    for (int i = 0; i < 4; ++i) {
+        out[1 + i] = static_cast<std::byte>((command.sequence >> (8 * i)) & 0xFF);
+    }
+    out[5] = static_cast<std::byte>(command.type & 0xFF);
+    out[6] = static_cast<std::byte>(command.type >> 8);
+    out[7] = static_cast<std::byte>(payloadSize);
+    std::memcpy(out.data() + COMMAND_HEADER_SIZE, command.payload.data(), payloadSize);
+    return size;
+}
+
+std::optional<ClientCommand> decodeCommand(std::span<const std::byte> message) noexcept {
+    if (message.size() < COMMAND_HEADER_SIZE ||
+        std::to_integer<uint8_t>(message[0]) != static_cast<uint8_t>(MessageType::Command)) {
+        return std::nullopt;
+    }
+
+    ClientCommand command;
+    for (int i = 0; i < 4; ++i) {
+        command.sequence |= std::to_integer<uint32_t>(message[1 + i]) << (8 * i);
+    }
+    command.type = static_cast<uint16_t>(std::to_integer<uint16_t>(message[5]) |
+                                         (std::to_integer<uint16_t>(message[6]) << 8));
+    command.payloadSize = std::to_integer<uint8_t>(message[7]);
+    if (command.payloadSize > ClientCommand::MAX_PAYLOAD ||
+        message.size() != COMMAND_HEADER_SIZE + command.payloadSize) {
+        return std::nullopt;
+    }
+    std::memcpy(command.payload.data(), message.data() + COMMAND_HEADER_SIZE, command.payloadSize);
+    return command;
+}
+
+std::size_t encodeSnapshotFragmentHeader(const SnapshotFragmentHeader &header, std::span<std::byte> out) noexcept {
+    if (out.size() < SNAPSHOT_FRAGMENT_HEADER_SIZE) {
+        return 0;
+    }
+    uint8_t flags = (header.hasBaseline ? FRAGMENT_HAS_BASELINE : 0) | (header.compressed ? FRAGMENT_COMPRESSED : 0);
+
+    out[0] = static_cast<std::byte>(MessageType::SnapshotFragment);
+    writeLittleEndian(out.data() + 1, header.tick);
+    writeLittleEndian(out.data() + 9, header.baselineTick);
+    out[17] = static_cast<std::byte>(flags);
+    out[18] = static_cast<std::byte>(header.index);
+    out[19] = static_cast<std::byte>(header.count);
+    writeLittleEndian(out.data() + 20, header.rawSize);
+    return SNAPSHOT_FRAGMENT_HEADER_SIZE;
+}
+
+std::optional<SnapshotFragmentHeader> decodeSnapshotFragmentHeader(std::span<const std::byte> message) noexcept {
+    if (message.size() < SNAPSHOT_FRAGMENT_HEADER_SIZE || !hasType(message, MessageType::SnapshotFragment)) {
+        return std::nullopt;
+    }
+
+    SnapshotFragmentHeader header;
+    header.tick = readLittleEndian<uint64_t>(message.data() + 1);
+    header.baselineTick = readLittleEndian<uint64_t>(message.data() + 9);
+    auto flags = std::to_integer<uint8_t>(message[17]);
+    header.hasBaseline = (flags & FRAGMENT_HAS_BASELINE) != 0;
+    header.compressed = (flags & FRAGMENT_COMPRESSED) != 0;
+    header.index = std::to_integer<uint8_t>(message[18]);
+    header.count = std::to_integer<uint8_t>(message[19]);
+    header.rawSize = readLittleEndian<uint32_t>(message.data() + 20);
+    if (header.count == 0 || header.index >= header.count) {
+        return std::nullopt;
+    }
+    return header;
+}
+
+std::size_t encodeSnapshotAck(uint64_t tick, std::span<std::byte> out) noexcept {
+    if (out.size() < SNAPSHOT_ACK_SIZE) {
+        return 0;
+    }
+    out[0] = static_cast<std::byte>(MessageType::SnapshotAck);
+    writeLittleEndian(out.data() + 1, tick);
+    return SNAPSHOT_ACK_SIZE;
+}
+
+std::optional<uint64_t> decodeSnapshotAck(std::span<const std::byte> message) noexcept {
+    if (message.size() != SNAPSHOT_ACK_SIZE || !hasType(message, MessageType::SnapshotAck)) {
+        return std::nullopt;
+    }
+    return readLittleEndian<uint64_t>(message.data() + 1);
+}
+
+} // namespace void_crew::server
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+
+#include "command_queue.hpp"
+
+namespace void_crew::server {
+
+/// First byte of every transport message; selects the decoder.
+enum class MessageType : uint8_t {
+    Command = 1,          // client -> server input, see encodeCommand()
+    SnapshotFragment = 2, // server -> client delta snapshot piece, see SnapshotFragmentHeader
+    SnapshotAck = 3,      // client -> server, newest snapshot tick the client decoded
+};
+
+/// Type of a received message, or nullopt if it is empty or unknown.
+std::optional<MessageType> messageType(std::span<const std::byte> message) noexcept;
+
+/// Encoded size of a command: [u8 type][u32 sequence][u16 command type]
+/// [u8 payload size][payload], little-endian.
+constexpr std::size_t commandMessageSize(const ClientCommand &command) noexcept {
+    return 8 + std::min<std::size_t>(command.payloadSize, ClientCommand::MAX_PAYLOAD);
+}
+
+/// Serializes @p command into @p out. Returns the bytes written, or 0 if
+/// @p out is too small. The client id and tick are not sent: the server
+/// assigns both.
+std::size_t encodeCommand(const ClientCommand &command, std::span<std::byte> out) noexcept;
+
+/// Parses a Command message. Returns nullopt for any other message type or a
+/// malformed one.
+std::optional<ClientCommand> decodeCommand(std::span<const std::byte> message) noexcept;
+
+/// Header of one piece of a delta snapshot. A snapshot larger than one
+/// message is split into @c count fragments of equal size (the last may be
+/// shorter); the payload follows the header directly.
+struct SnapshotFragmentHeader {
+    uint64_t tick = 0;
+    uint64_t baselineTick = 0; // only meaningful with hasBaseline
+    bool hasBaseline = false;  // false: delta against an empty world
+    bool compressed = false;   // payload is LZ4 and rawSize is its decoded size
+    uint8_t index = 0;
+    uint8_t count = 1;
+    uint32_t rawSize = 0; // bytes of the whole delta before compression
+};
+
+/// [u8 type][u64 tick][u64 baseline][u8 flags][u8 index][u8 count][u32 raw size]
+constexpr std::size_t SNAPSHOT_FRAGMENT_HEADER_SIZE = 24;
+
+/// Writes the header into the first SNAPSHOT_FRAGMENT_HEADER_SIZE bytes of
+/// @p out. Returns the bytes written, or 0 if @p out is too small.
+std::size_t encodeSnapshotFragmentHeader(const SnapshotFragmentHeader &header, std::span<std::byte> out) noexcept;
+
+/// Parses a SnapshotFragment header; the payload is the rest of @p message.
+std::optional<SnapshotFragmentHeader> decodeSnapshotFragmentHeader(std::span<const std::byte> message) noexcept;
+
+/// SnapshotAck: [u8 type][u64 tick]. Returns bytes written or 0.
+std::size_t encodeSnapshotAck(uint64_t tick, std::span<std::byte> out) noexcept;
+std::optional<uint64_t> decodeSnapshotAck(std::span<const std::byte> message) noexcept;
+
+} // namespace void_crew::server
@@ -0,0 +1,207 @@
+#include "reliable_channel.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace void_crew::server {
+
+namespace {
+
+constexpr double RTT_SMOOTHING = 0.1;
+constexpr double RESEND_RTT_FACTOR = 1.5;
+constexpr unsigned ACK_BITS = 32;
+
+void writeU16(std::byte *out, uint16_t value) noexcept {
+    out[0] = static_cast<std::byte>(value & 0xFF);
+    out[1] = static_cast<std::byte>(value >> 8);
+}
+
+void writeU32(std::byte *out, uint32_t value) noexcept {
+    for (int i = 0; i < 4; ++i) {
+        out[i] = static_cast<std::byte>((value >> (8 * i)) & 0xFF);
+    }
+}
+
+uint16_t readU16(const std::byte *in) noexcept {
+    return static_cast<uint16_t>(std::to_integer<uint16_t>(in[0]) | (std::to_integer<uint16_t>(in[1]) << 8));
+}
+
+uint32_t readU32(const std::byte *in) noexcept {
+    uint32_t value = 0;
+    for (int i = 0; i < 4; ++i) {
+        value |= std::to_integer<uint32_t>(in[i]) << (8 * i);
+    }
+    return value;
+}
+
+} // namespace
+
+void writePacketHeader(std::span<std::byte> out, const PacketHeader &header) noexcept {
+    writeU16(out.data(), header.protocolId);
+    writeU16(out.data() + 2, header.sequence);
+    writeU16(out.data() + 4, header.ack);
+    writeU32(out.data() + 6, header.ackBits);
+    out[10] = static_cast<std::byte>(header.messageCount);
+}
+
+std::optional<PacketHeader> readPacketHeader(std::span<const std::byte> in) noexcept {
+    if (in.size() < PACKET_HEADER_SIZE) {
+        return std::nullopt;
+    }
+    PacketHeader header;
+    header.protocolId = readU16(in.data());
+    header.sequence = readU16(in.data() + 2);
+    header.ack = readU16(in.data() + 4);
+    header.ackBits = readU32(in.data() + 6);
+    header.messageCount = std::to_integer<uint8_t>(in[10]);
+    return header;
+}
+
+bool ReliableChannel::queueReliable(std::span<const std::byte> message) {
+    if (message.size() > MAX_MESSAGE_SIZE || static_cast<uint16_t>(m_nextSendId - m_oldestUnacked) >= MESSAGE_WINDOW) {
+        return false;
+    }
+
+    auto &slot = m_sendWindow[m_nextSendId % MESSAGE_WINDOW];
+    slot.id = m_nextSendId;
+    slot.pending = true;
+    slot.lastSent = -1.0;
+    slot.size = static_cast<uint16_t>(message.size());
+    std::memcpy(slot.data.data(), message.data(), message.size());
+    ++m_nextSendId;
+    return true;
+}
+
+bool ReliableChannel::hasDueReliable(double now) const noexcept {
+    for (uint16_t id = m_oldestUnacked; id != m_nextSendId; ++id) {
+        const auto &message = m_sendWindow[id % MESSAGE_WINDOW];
+        if (message.pending && isDue(message, now)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+PacketHeader ReliableChannel::beginPacket(double now) noexcept {
+    ++m_localSequence;
+
+    // Reusing the slot forgets whatever packet it held; if that one was never
+    // acked its reliable messages are resent by their own timers.
+    auto &packet = m_sentPackets[m_localSequence % PACKET_HISTORY];
+    packet.sequence = m_localSequence;
+    packet.valid = true;
+    packet.acked = false;
+    packet.sentTime = now;
+    packet.messageCount = 0;
+
+    m_ackPending = false;
+
+    PacketHeader header;
+    header.sequence = m_localSequence;
+    header.ack = m_remoteSequence;
+    header.ackBits = m_receivedBits;
+    return header;
+}
+
+bool ReliableChannel::onPacketReceived(const PacketHeader &header, double now) noexcept {
+    if (!m_hasRemoteSequence) {
+        m_hasRemoteSequence = true;
+        m_remoteSequence = header.sequence;
+        m_receivedBits = 0;
+    } else if (sequenceNewer(header.sequence, m_remoteSequence)) {
+        auto shift = static_cast<uint16_t>(header.sequence - m_remoteSequence);
+        if (shift <= ACK_BITS) {
+            // The previous newest becomes bit (shift - 1); older bits move up with it.
+            uint64_t bits = (uint64_t{m_receivedBits} << 1 | 1) << (shift - 1);
+            m_receivedBits = static_cast<uint32_t>(bits);
+        } else {
+            m_receivedBits = 0; // everything we had fell out of the window
+        }
+        m_remoteSequence = header.sequence;
+    } else {
+        auto age = static_cast<uint16_t>(m_remoteSequence - header.sequence);
+        if (age == 0 || age > ACK_BITS) {
+            return false;
+        }
+        uint32_t mask = uint32_t{1} << (age - 1);
+        if ((m_receivedBits & mask) != 0) {
+            return false;
+        }
+        m_receivedBits |= mask;
+    }
+    m_ackPending = true;
+
+    onPacketAcked(header.ack, now);
+    for (unsigned i = 0; i < ACK_BITS; ++i) {
+        if ((header.ackBits & (uint32_t{1} << i)) != 0) {
+            onPacketAcked(static_cast<uint16_t>(header.ack - 1 - i), now);
+        }
+    }
+
+    while (m_oldestUnacked != m_nextSendId && !m_sendWindow[m_oldestUnacked % MESSAGE_WINDOW].pending) {
+        ++m_oldestUnacked;
+    }
+    return true;
+}
+
+void ReliableChannel::receiveReliable(uint16_t id, std::span<const std::byte> message) noexcept {
+    if (static_cast<uint16_t>(id - m_nextReceiveId) >= MESSAGE_WINDOW || message.size() > MAX_MESSAGE_SIZE) {
+        return; // already delivered, or too far ahead to buffer
+    }
+
+    auto &slot = m_receiveWindow[id % MESSAGE_WINDOW];
+    if (slot.pending && slot.id == id) {
+        return; // duplicate of a buffered message
+    }
+    slot.id = id;
+    slot.pending = true;
+    slot.size = static_cast<uint16_t>(message.size());
+    std::memcpy(slot.data.data(), message.data(), message.size());
+}
+
+bool ReliableChannel::ackPending() const noexcept {
+    return m_ackPending;
+}
+
+double ReliableChannel::rtt() const noexcept {
+    return m_rtt;
+}
+
+std::size_t ReliableChannel::unackedReliable() const noexcept {
+    std::size_t count = 0;
+    for (uint16_t id = m_oldestUnacked; id != m_nextSendId; ++id) {
+        count += m_sendWindow[id % MESSAGE_WINDOW].pending ? 1 : 0;
+    }
+    return count;
+}
+
+uint64_t ReliableChannel::resentMessages() const noexcept {
+    return m_resentMessages;
+}
+
+bool ReliableChannel::isDue(const Message &message, double now) const noexcept {
+    return message.lastSent < 0.0 || now - message.lastSent >= resendInterval();
+}
+
+double ReliableChannel::resendInterval() const noexcept {
+    return std::max(MIN_RESEND_INTERVAL, m_rtt * RESEND_RTT_FACTOR);
+}
+
+void ReliableChannel::onPacketAcked(uint16_t sequence, double now) noexcept {
+    auto &packet = m_sentPackets[sequence % PACKET_HISTORY];
+    if (!packet.valid || packet.acked || packet.sequence != sequence) {
+        return;
+    }
+    packet.acked = true;
+    m_rtt += (now - packet.sentTime - m_rtt) * RTT_SMOOTHING;
+
+    for (uint8_t i = 0; i < packet.messageCount; ++i) {
+        auto id = packet.messageIds[i];
+        auto &message = m_sendWindow[id % MESSAGE_WINDOW];
+        if (message.pending && message.id == id) {
+            message.pending = false;
+        }
+    }
+}
+
+} // namespace void_crew::server
@@ -0,0 +1,169 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+
+namespace void_crew::server {
+
+/// Identifies Void Crew datagrams; anything else is dropped unparsed.
+constexpr uint16_t PROTOCOL_ID = 0x5643; // "VC"
+
+/// Wire header at the start of every datagram (little-endian, 11 bytes).
+struct PacketHeader {
+    uint16_t protocolId = PROTOCOL_ID;
+    uint16_t sequence = 0; // per-connection packet counter, wraps
+    uint16_t ack = 0;      // newest sequence received from the peer
+    uint32_t ackBits = 0;  // bit i set: sequence (ack - 1 - i) was received too
+    uint8_t messageCount = 0;
+};
+
+constexpr std::size_t PACKET_HEADER_SIZE = 11;
+
+/// Writes @p header into the first PACKET_HEADER_SIZE bytes of @p out.
+void writePacketHeader(std::span<std::byte> out, const PacketHeader &header) noexcept;
+
+/// Parses a header. Returns nullopt if @p in is too short.
+std::optional<PacketHeader> readPacketHeader(std::span<const std::byte> in) noexcept;
+
+/// True if sequence @p a is newer than @p b, accounting for 16-bit wrap.
+constexpr bool sequenceNewer(uint16_t a, uint16_t b) noexcept {
+    return static_cast<int16_t>(static_cast<uint16_t>(a - b)) > 0;
+}
+
+/// Per-connection acks and reliable, ordered message delivery over UDP.
+///
+/// Every outgoing packet carries a sequence number plus the peer's newest
+/// sequence and a 32-bit history of earlier ones, so a single arriving packet
+/// acknowledges up to 33 of ours (Glenn Fiedler's "Reliable Ordered Messages").
+/// Reliable messages ride inside ordinary packets and are resent until a
+/// packet carrying them is acked; the receiver reorders and de-duplicates
+/// them by message id. Unreliable traffic only uses the sequence/ack fields.
+///
+/// All storage is fixed-size rings sized by the constants below; nothing is
+/// allocated after construction. Time is passed in by the caller (seconds on
+/// any monotonic clock) so the channel can be driven deterministically.
+class ReliableChannel {
+public:
+    static constexpr std::size_t MAX_MESSAGE_SIZE = 256;       // reliable payload limit
+    static constexpr std::size_t MESSAGE_WINDOW = 64;          // reliable messages in flight / buffered
+    static constexpr std::size_t PACKET_HISTORY = 256;         // sent packets remembered for acks
+    static constexpr std::size_t MAX_MESSAGES_PER_PACKET = 16; // reliable messages in one packet
+    static constexpr double MIN_RESEND_INTERVAL = 0.05;        // seconds
+    static constexpr double INITIAL_RTT = 0.1;                 // seconds, until the first ack
+
+    /// Queues a reliable message. Returns false if it is larger than
+    /// MAX_MESSAGE_SIZE or MESSAGE_WINDOW messages are already unacked.
+    bool queueReliable(std::span<const std::byte> message);
+
+    /// True if a reliable message is due for (re)sending at @p now.
+    bool hasDueReliable(double now) const noexcept;
+
+    /// Starts an outgoing packet: assigns its sequence and fills the ack
+    /// fields. Every packet built must start with this call.
+    PacketHeader beginPacket(double now) noexcept;
+
+    /// Offers each reliable message that is due at @p now to @p write, oldest
+    /// first, and attaches the ones written to the packet from the last
+    /// beginPacket(). @p write(id, payload) returns false when the packet is
+    /// full, which stops the scan.
+    template <typename WriteFn>
+    void writeDueReliable(double now, WriteFn &&write) {
+        auto &packet = m_sentPackets[m_localSequence % PACKET_HISTORY];
+        for (uint16_t id = m_oldestUnacked; id != m_nextSendId; ++id) {
+            if (packet.messageCount == MAX_MESSAGES_PER_PACKET) {
+                break;
+            }
+            auto &message = m_sendWindow[id % MESSAGE_WINDOW];
+            if (!message.pending || !isDue(message, now)) {
+                continue;
+            }
+            if (!write(id, std::span<const std::byte>(message.data.data(), message.size))) {
+                break;
+            }
+            if (message.lastSent >= 0.0) {
+                ++m_resentMessages;
+            }
+            message.lastSent = now;
+            packet.messageIds[packet.messageCount++] = id;
+        }
+    }
+
+    /// Processes the header of an arriving packet: applies its acks and
+    /// records its sequence for our own acks. Returns false for duplicates
+    /// and packets too old to track; the caller should drop those.
+    bool onPacketReceived(const PacketHeader &header, double now) noexcept;
+
+    /// Buffers a reliable message received from the peer. Messages already
+    /// delivered or outside the window are ignored.
+    void receiveReliable(uint16_t id, std::span<const std::byte> message) noexcept;
+
+    /// Hands buffered reliable messages to @p deliver(payload) in id order,
+    /// stopping at the first gap.
+    template <typename DeliverFn>
+    void deliverReliable(DeliverFn &&deliver) {
+        for (;;) {
+            auto &message = m_receiveWindow[m_nextReceiveId % MESSAGE_WINDOW];
+            if (!message.pending || message.id != m_nextReceiveId) {
+                return;
+            }
+            message.pending = false;
+            ++m_nextReceiveId;
+            deliver(std::span<const std::byte>(message.data.data(), message.size));
+        }
+    }
+
+    /// True once a packet has arrived that our next packet has not acked yet.
+    bool ackPending() const noexcept;
+
+    /// Smoothed round-trip time, seconds.
+    double rtt() const noexcept;
+
+    /// Reliable messages queued but not yet acked.
+    std::size_t unackedReliable() const noexcept;
+
+    uint64_t resentMessages() const noexcept;
+
+private:
+    struct SentPacket {
+        uint16_t sequence = 0;
+        bool valid = false;
+        bool acked = false;
+        double sentTime = 0.0;
+        uint8_t messageCount = 0;
+        std::array<uint16_t, MAX_MESSAGES_PER_PACKET> messageIds{};
+    };
+
+    struct Message {
+        uint16_t id = 0;
+        bool pending = false;
+        double lastSent = -1.0; // < 0: never sent
+        uint16_t size = 0;
+        std::array<std::byte, MAX_MESSAGE_SIZE> data{};
+    };
+
+    bool isDue(const Message &message, double now) const noexcept;
+    double resendInterval() const noexcept;
+    void onPacketAcked(uint16_t sequence, double now) noexcept;
+
+    // Outgoing
+    uint16_t m_localSequence = 0; // sequence of the last packet started
+    std::array<SentPacket, PACKET_HISTORY> m_sentPackets{};
+    std::array<Message, MESSAGE_WINDOW> m_sendWindow{};
+    uint16_t m_nextSendId = 0;
+    uint16_t m_oldestUnacked = 0;
+    uint64_t m_resentMessages = 0;
+    double m_rtt = INITIAL_RTT;
+
+    // Incoming
+    bool m_hasRemoteSequence = false;
+    bool m_ackPending = false;
+    uint16_t m_remoteSequence = 0;
+    uint32_t m_receivedBits = 0;
+    std::array<Message, MESSAGE_WINDOW> m_receiveWindow{};
+    uint16_t m_nextReceiveId = 0;
+};
+
+} // namespace void_crew::server
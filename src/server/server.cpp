@@ -1,15 +1,66 @@
 #include "server.hpp"
 
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <iterator>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include "components.hpp"
 #include "logging.hpp"
+#include "profiler.hpp"
 #include "signal_handler.hpp"
+#include "version.hpp"
 
 namespace void_crew::server {
 
+namespace {
+
+constexpr double SLOW_TICK_REPORT_INTERVAL = 1.0; // seconds
+constexpr std::size_t SLOW_TICK_REPORT_SYSTEMS = 3;
+
+} // namespace
+
 Server::Server(ServerConfig config)
     : m_config(std::move(config)),
-      m_gameLoop(m_config.tickRate) {
-    TLOG_INFO("server", "Server '{}' initialized on port {}", m_config.name, m_config.port);
+      m_interest(m_registry),
+      m_spatial(m_registry),
+      m_layout(m_registry),
+      m_checksum(m_registry),
+      m_commands(m_config.maxClientCommandsPerTick),
+      m_systems(m_config.workerThreads),
+      m_atmosphereSync(m_registry, m_atmosphere),
+      m_power(m_registry),
+      m_gameLoop(m_config.tickRate, m_config.tickPacing,
+                 {.mode = m_config.runMode, .timeScale = m_config.timeScale, .maxTicks = m_config.maxTicks}) {
+    if (m_config.worldSeed == 0) {
+        std::random_device device;
+        m_config.worldSeed = (uint64_t{device()} << 32) | device();
+    }
+    if (m_config.headless) {
+        TLOG_INFO("server", "Server '{}' initialized headless", m_config.name);
+    } else {
+        m_network.emplace(TransportConfig{.local = Endpoint::any(m_config.port), .maxConnections = m_config.maxPlayers},
+                          m_commands,
+                          ReplicationConfig{.compress = m_config.snapshotCompression,
+                                            .budgetBytes = m_config.snapshotBudget});
+        TLOG_INFO("server", "Server '{}' initialized on port {}", m_config.name, m_config.port);
+    }
     TLOG_INFO("server", "Max players: {}, Tick rate: {} Hz", m_config.maxPlayers, m_config.tickRate);
+    TLOG_INFO("server", "Simulation workers: {}", m_systems.workerCount());
+    TLOG_INFO("server", "World seed: {}", m_config.worldSeed);
+    m_registry.ctx().emplace<TickInput>();
+    trackChecksum();
+
+    m_gameLoop.resetEachTick(m_tickArena);
+    for (std::size_t i = 0; i < m_systems.workerArenas().size(); ++i) {
+        m_gameLoop.resetEachTick(m_systems.workerArenas()[i]);
+    }
 }
 
 Server::~Server() {
@@ -19,7 +70,18 @@ Server::~Server() {
 }
 
 void Server::run() {
+    if (!m_config.recordFile.empty()) {
+        m_recorder = std::make_unique<InputRecorder>(
+            m_config.recordFile, RecordingHeader{.engineVersion = std::string(engineVersion()),
+                                                 .tickRate = m_config.tickRate,
+                                                 .worldSeed = m_config.worldSeed,
+                                                 .maxClientCommandsPerTick = m_config.maxClientCommandsPerTick});
+        TLOG_INFO("server", "Recording client input to '{}'", m_config.recordFile);
+    }
     m_running.store(true, std::memory_order_release);
+    if (m_network) {
+        m_network->start();
+    }
     TLOG_INFO("server", "Server started");
 
     m_gameLoop.run(
@@ -29,10 +91,20 @@ void Server::run() {
         [this](float dt) { tick(dt); });
 
     m_running.store(false, std::memory_order_release);
+    if (m_network) {
+        m_network->stop();
+    }
+    if (m_recorder) {
+        m_recorder->flush();
+        TLOG_INFO("server", "Recorded {} ticks with {} commands to '{}'", m_recorder->ticks(), m_recorder->commands(),
+                  m_recorder->path());
+        m_recorder.reset();
+    }
 
     if (wasSignalReceived()) {
         TLOG_INFO("server", "Received shutdown signal");
     }
+    writeProfileTrace();
     TLOG_INFO("server", "Server stopped");
 }
 
@@ -41,9 +113,164 @@ void Server::shutdown() {
     m_running.store(false, std::memory_order_release);
 }
 
+ReplayReport Server::replay(const InputRecording &recording) {
+    const auto &header = recording.header;
+    if (header.tickRate != m_config.tickRate || header.worldSeed != m_config.worldSeed) {
+        throw std::invalid_argument(fmt::format("replay: recording has tick rate {} and seed {}, server has {} and {}",
+                                                header.tickRate, header.worldSeed, m_config.tickRate,
+                                                m_config.worldSeed));
+    }
+    if (header.engineVersion != engineVersion()) {
+        TLOG_WARN("replay", "Recording made by version {}, replaying on {}; state hashes may differ",
+                  header.engineVersion, engineVersion());
+    }
+
+    TLOG_INFO("replay", "Replaying {} ticks with {} commands", recording.ticks.size(), recording.commands.size());
+    m_running.store(true, std::memory_order_release);
+
+    ReplayReport report;
+    LatencyHistogram tickDurations;
+    Timer total;
+    m_gameLoop.run(
+        [&]() {
+            return report.ticks < recording.ticks.size() && m_running.load(std::memory_order_acquire) &&
+                   !wasSignalReceived();
+        },
+        [&](float dt) {
+            const auto &recorded = recording.ticks[report.ticks];
+            Timer tickTimer;
+            step(recorded.tick, recording.commandsOf(recorded), dt);
+            tickDurations.record(tickTimer.elapsedSeconds());
+
+            report.finalHash = m_checksum.hash();
+            if (report.finalHash != recorded.stateHash && !report.firstDivergedTick) {
+                report.firstDivergedTick = recorded.tick;
+                TLOG_WARN("replay", "Tick {}: state hash {:016x} differs from the recorded {:016x}", recorded.tick,
+                          report.finalHash, recorded.stateHash);
+            }
+            ++report.ticks;
+        });
+    report.seconds = total.elapsedSeconds();
+    report.ticksPerSecond = report.seconds > 0.0 ? static_cast<double>(report.ticks) / report.seconds : 0.0;
+    report.tickDurations = tickDurations.summary();
+
+    m_running.store(false, std::memory_order_release);
+    writeProfileTrace();
+    return report;
+}
+
 void Server::tick(float dt) {
-    // TODO(#0): update ECS systems (1.5)
-    static_cast<void>(dt);
+    auto tick = m_gameLoop.currentTick();
+    std::span<const ClientCommand> commands;
+    {
+        PROFILE_ZONE("commands");
+        commands = m_commands.drain(tick);
+    }
+    step(tick, commands, dt);
+}
+
+void Server::step(uint64_t tick, std::span<const ClientCommand> commands, float dt) {
+    Timer tickTimer;
+    m_registry.ctx().get<TickInput>() = {tick, commands};
+    m_systems.update(m_registry, dt);
+    {
+        PROFILE_ZONE("motion");
+        m_layout.integrateMotion(m_gameLoop.fixedDt());
+    }
+    {
+        PROFILE_ZONE("power");
+        m_power.update();
+    }
+    {
+        PROFILE_ZONE("atmosphere");
+        m_atmosphereSync.update();
+        m_atmosphere.step(m_gameLoop.fixedDt());
+    }
+    {
+        PROFILE_ZONE("layout");
+        m_layout.update();
+    }
+    {
+        PROFILE_ZONE("checksum");
+        m_checksum.update();
+    }
+    if (m_network) {
+        PROFILE_ZONE("snapshot");
+        m_interest.buildViews(tick, m_views);
+        m_network->publishViews(m_views);
+        // Connections without a viewer (not spawned yet, tools) get the whole world.
+        if (m_network->connectionCount() > m_interest.viewerCount()) {
+            captureWorldState(m_registry, tick, m_worldState);
+            m_network->publishWorldState(m_worldState);
+        }
+    }
+    if (m_recorder) {
+        PROFILE_ZONE("record");
+        m_recorder->record(tick, commands, m_checksum.hash());
+    }
+
+    // Against the wall-clock interval, not dt: a scaled run has less time per
+    // tick than it simulates, and a batch run has no budget at all.
+    double elapsed = tickTimer.elapsedSeconds();
+    double budget = m_gameLoop.tickBudget();
+    if (budget > 0.0 && elapsed > budget) {
+        reportSlowTick(tick, elapsed, budget);
+    }
+}
+
+void Server::trackChecksum() {
+    m_checksum.track<NetworkId>("network_id");
+    m_checksum.track<Transform>("transform");
+    m_checksum.track<Velocity>("velocity");
+    m_checksum.track<InCompartment>("compartment");
+    m_checksum.track<Door>("door", [](const Door &door) {
+        return std::array<uint32_t, 3>{door.first, door.second, door.open ? 1u : 0u};
+    });
+    m_checksum.track<PowerSource>("power_source");
+    m_checksum.track<PowerLink>("power_link", [](const PowerLink &link) {
+        return std::array<uint32_t, 3>{entt::to_integral(link.upstream), std::bit_cast<uint32_t>(link.rating),
+                                       link.closed ? 1u : 0u};
+    });
+    m_checksum.track<PowerConsumer>("power_consumer", [](const PowerConsumer &consumer) {
+        return std::array<uint32_t, 2>{std::bit_cast<uint32_t>(consumer.demand), consumer.priority};
+    });
+}
+
+void Server::reportSlowTick(uint64_t tick, double elapsed, double budget) {
+    if (m_slowTickReported && m_sinceSlowTickReport.elapsedSeconds() < SLOW_TICK_REPORT_INTERVAL) {
+        ++m_suppressedSlowTicks;
+        return;
+    }
+
+    std::pmr::vector<SystemScheduler::SystemId> ids(m_systems.systemCount(), &m_tickArena);
+    std::iota(ids.begin(), ids.end(), SystemScheduler::SystemId{0});
+    auto shown = std::min(ids.size(), SLOW_TICK_REPORT_SYSTEMS);
+    std::partial_sort(ids.begin(), ids.begin() + static_cast<std::ptrdiff_t>(shown), ids.end(),
+                      [this](auto lhs, auto rhs) { return m_systems.lastDuration(lhs) > m_systems.lastDuration(rhs); });
+
+    fmt::memory_buffer slowest;
+    for (std::size_t i = 0; i < shown; ++i) {
+        fmt::format_to(std::back_inserter(slowest), "{}{} {:.2f}ms", i == 0 ? "" : ", ", m_systems.systemName(ids[i]),
+                       m_systems.lastDuration(ids[i]) * 1000.0);
+    }
+
+    TLOG_WARN("server", "Slow tick {}: {:.2f}ms of {:.2f}ms budget; slowest systems: {} ({} unreported since last)",
+              tick, elapsed * 1000.0, budget * 1000.0, fmt::to_string(slowest), m_suppressedSlowTicks);
+
+    m_slowTickReported = true;
+    m_suppressedSlowTicks = 0;
+    m_sinceSlowTickReport.reset();
+}
+
+void Server::writeProfileTrace() const {
+    if (m_config.profileTraceFile.empty()) {
+        return;
+    }
+    if (profileRing().writeChromeTrace(m_config.profileTraceFile)) {
+        TLOG_INFO("server", "Profile trace written to '{}'", m_config.profileTraceFile);
+    } else {
+        TLOG_ERROR("server", "Failed to write profile trace '{}'", m_config.profileTraceFile);
+    }
 }
 
 bool Server::isRunning() const noexcept {
@@ -62,4 +289,44 @@ const GameLoop &Server::gameLoop() const noexcept {
     return m_gameLoop;
 }
 
+SystemScheduler &Server::systems() noexcept {
+    return m_systems;
+}
+
+CommandQueue &Server::commands() noexcept {
+    return m_commands;
+}
+
+NetworkService *Server::network() noexcept {
+    return m_network ? &*m_network : nullptr;
+}
+
+InterestManager &Server::interest() noexcept {
+    return m_interest;
+}
+
+SpatialIndex &Server::spatial() noexcept {
+    return m_spatial;
+}
+
+ComponentLayout &Server::layout() noexcept {
+    return m_layout;
+}
+
+WorldChecksum &Server::checksum() noexcept {
+    return m_checksum;
+}
+
+Atmosphere &Server::atmosphere() noexcept {
+    return m_atmosphere;
+}
+
+PowerGrid &Server::power() noexcept {
+    return m_power;
+}
+
+FrameArena &Server::tickArena() noexcept {
+    return m_tickArena;
+}
+
 } // namespace void_crew::server
@@ -1,14 +1,39 @@
 #pragma once
 
 #include <atomic>
+#include <memory>
+#include <optional>
+#include <span>
 
 #include <entt/entt.hpp>
 
+#include "atmosphere.hpp"
+#include "command_queue.hpp"
+#include "component_layout.hpp"
+#include "delta_snapshot.hpp"
 #include "game_loop.hpp"
+#include "input_recording.hpp"
+#include "interest_manager.hpp"
+#include "network_service.hpp"
+#include "power_grid.hpp"
+#include "spatial_index.hpp"
 #include "server_config.hpp"
+#include "system_scheduler.hpp"
+#include "timer.hpp"
+#include "world_checksum.hpp"
 
 namespace void_crew::server {
 
+/// Outcome of Server::replay().
+struct ReplayReport {
+    uint64_t ticks = 0;
+    double seconds = 0.0; // wall time for all ticks
+    double ticksPerSecond = 0.0;
+    LatencySummary tickDurations; // simulation only, state hashing excluded
+    uint64_t finalHash = 0;
+    std::optional<uint64_t> firstDivergedTick; // first tick whose state hash differs from the recording
+};
+
 class Server {
 public:
     explicit Server(ServerConfig config);
@@ -22,18 +47,92 @@ public:
     void run();
     void shutdown();
 
+    /// Runs the ticks of @p recording on the game loop, each fed the recorded
+    /// commands instead of the network's; the network is not started. The
+    /// loop's run mode paces them: Batch replays as fast as the CPU allows.
+    /// After every tick the state hash is compared with the recorded one.
+    /// Stops early on shutdown() or a signal.
+    /// Throws std::invalid_argument if the config's tick rate or world seed
+    /// differs from the recording's.
+    ReplayReport replay(const InputRecording &recording);
+
     bool isRunning() const noexcept;
     entt::registry &registry() noexcept;
     const ServerConfig &config() const noexcept;
     const GameLoop &gameLoop() const noexcept;
+    SystemScheduler &systems() noexcept;
+
+    /// Inbound client commands. Network threads create one producer per
+    /// connection; Server::tick drains the queue before running systems.
+    CommandQueue &commands() noexcept;
+
+    /// UDP endpoint; receives on its own thread while run() is active.
+    /// Null for a headless server (ServerConfig::headless).
+    NetworkService *network() noexcept;
+
+    /// Which entities each client is sent. Game code registers a viewer per
+    /// connection once its player exists; until then the client gets the
+    /// unfiltered world.
+    InterestManager &interest() noexcept;
+
+    /// Proximity queries over entity positions, kept current from registry
+    /// signals; for hearing, perception and similar per-tick lookups.
+    SpatialIndex &spatial() noexcept;
+
+    /// Owning group over Transform and Velocity, re-sorted by compartment
+    /// between ticks, and SoA packing for batch loops over it; moves the
+    /// members by their velocity every tick.
+    ComponentLayout &layout() noexcept;
+
+    /// Hash of the simulation state, updated every tick after the systems
+    /// and zones ran; recorded and checked by replays to find desyncs.
+    WorldChecksum &checksum() noexcept;
+
+    /// Gas diffusion between compartments; stepped every tick, but only the
+    /// parts of the ship out of equilibrium cost anything. CompartmentVolume
+    /// and Door entities are fed into it each tick; vents and breaches are
+    /// added through this directly.
+    Atmosphere &atmosphere() noexcept;
+
+    /// Power distribution over PowerSource / PowerLink / PowerConsumer
+    /// entities; shedding and breaker trips resolve once per tick.
+    PowerGrid &power() noexcept;
+
+    /// Scratch memory for the current tick, reset by the game loop before
+    /// each one. Game-loop thread only; systems use systems().workerArena().
+    FrameArena &tickArena() noexcept;
 
 private:
     void tick(float dt);
+    void step(uint64_t tick, std::span<const ClientCommand> commands, float dt);
+    void trackChecksum();
+    void reportSlowTick(uint64_t tick, double elapsed, double budget);
+    void writeProfileTrace() const;
 
     ServerConfig m_config;
     std::atomic<bool> m_running{false};
     entt::registry m_registry;
-    GameLoop m_gameLoop;
+    InterestManager m_interest; // listens to m_registry
+    SpatialIndex m_spatial;     // same
+    ComponentLayout m_layout;   // same
+    WorldChecksum m_checksum;   // same
+    CommandQueue m_commands;
+    std::optional<NetworkService> m_network; // feeds m_commands; must be destroyed first; empty when headless
+    SystemScheduler m_systems;
+    Atmosphere m_atmosphere;
+    AtmosphereSync m_atmosphereSync; // feeds m_atmosphere; listens to m_registry
+    PowerGrid m_power;              // listens to m_registry
+    FrameArena m_tickArena;
+    GameLoop m_gameLoop;            // resets m_tickArena and m_systems' worker arenas
+    WorldState m_worldState;        // scratch for the per-tick capture, recycled by the network thread
+    std::vector<ClientView> m_views; // same, per client
+    std::unique_ptr<InputRecorder> m_recorder; // while run() is active, if recordFile is set
+
+    // Rate limit for slow-tick warnings; a struggling server would otherwise
+    // log one per tick.
+    Timer m_sinceSlowTickReport;
+    uint64_t m_suppressedSlowTicks = 0;
+    bool m_slowTickReported = false;
 };
 
 } // namespace void_crew::server
@@ -2,6 +2,7 @@
 
 #include <filesystem>
 #include <stdexcept>
+#include <string_view>
 
 #include <toml++/toml.hpp>
 
@@ -11,6 +12,16 @@ namespace void_crew::server {
 
 namespace {
 
+LogMode parseLogMode(std::string_view name) {
+    if (name == "sync") {
+        return LogMode::Sync;
+    }
+    if (name == "async") {
+        return LogMode::Async;
+    }
+    throw std::runtime_error(fmt::format("invalid [logging] mode '{}', expected 'sync' or 'async'", name));
+}
+
 ServerConfig parseToml(const std::string &path) {
     auto tbl = toml::parse_file(path);
     ServerConfig cfg;
@@ -21,10 +32,77 @@ ServerConfig parseToml(const std::string &path) {
         cfg.maxPlayers =
             static_cast<uint32_t>((*server)["max_players"].value_or(static_cast<int64_t>(cfg.maxPlayers)));
         cfg.tickRate = static_cast<uint32_t>((*server)["tick_rate"].value_or(static_cast<int64_t>(cfg.tickRate)));
+        if (auto pacing = (*server)["pacing"].value<std::string>()) {
+            auto parsed = parseTickPacing(*pacing);
+            if (!parsed) {
+                throw std::runtime_error(
+                    fmt::format("invalid [server] pacing '{}', expected 'sleep' or 'hybrid'", *pacing));
+            }
+            cfg.tickPacing = *parsed;
+        }
+        if (auto mode = (*server)["run_mode"].value<std::string>()) {
+            auto parsed = parseRunMode(*mode);
+            if (!parsed) {
+                throw std::runtime_error(fmt::format(
+                    "invalid [server] run_mode '{}', expected 'realtime', 'scaled' or 'batch'", *mode));
+            }
+            cfg.runMode = *parsed;
+        }
+        cfg.timeScale = (*server)["time_scale"].value_or(cfg.timeScale);
+        if (!(cfg.timeScale > 0.0)) {
+            throw std::runtime_error(fmt::format("invalid [server] time_scale {}, expected a positive number",
+                                                 cfg.timeScale));
+        }
+        auto maxTicks = (*server)["max_ticks"].value_or(static_cast<int64_t>(cfg.maxTicks));
+        if (maxTicks < 0) {
+            throw std::runtime_error(fmt::format("invalid [server] max_ticks {}, expected 0 or more", maxTicks));
+        }
+        cfg.maxTicks = static_cast<uint64_t>(maxTicks);
+        cfg.workerThreads =
+            static_cast<uint32_t>((*server)["worker_threads"].value_or(static_cast<int64_t>(cfg.workerThreads)));
+        cfg.maxClientCommandsPerTick = static_cast<uint32_t>((*server)["max_client_commands_per_tick"].value_or(
+            static_cast<int64_t>(cfg.maxClientCommandsPerTick)));
+        cfg.worldSeed = static_cast<uint64_t>((*server)["seed"].value_or(static_cast<int64_t>(cfg.worldSeed)));
+    }
+
+    if (auto network = tbl["network"].as_table()) {
+        cfg.snapshotCompression = (*network)["snapshot_compression"].value_or(cfg.snapshotCompression);
+        auto budget = (*network)["snapshot_budget"].value_or(static_cast<int64_t>(cfg.snapshotBudget));
+        if (budget < static_cast<int64_t>(MIN_SNAPSHOT_BUDGET)) {
+            throw std::runtime_error(fmt::format("invalid [network] snapshot_budget {}, expected at least {}", budget,
+                                                 MIN_SNAPSHOT_BUDGET));
+        }
+        cfg.snapshotBudget = static_cast<std::size_t>(budget);
     }
 
     if (auto logging = tbl["logging"].as_table()) {
         cfg.logLevel = (*logging)["level"].value_or(cfg.logLevel);
+        if (auto mode = (*logging)["mode"].value<std::string>()) {
+            cfg.logMode = parseLogMode(*mode);
+        }
+        auto queueSize = (*logging)["queue_size"].value_or(static_cast<int64_t>(cfg.logQueueSize));
+        if (queueSize <= 0 || queueSize > static_cast<int64_t>(MAX_LOG_QUEUE_SIZE)) {
+            throw std::runtime_error(fmt::format("invalid [logging] queue_size {}, expected 1 to {}", queueSize,
+                                                 MAX_LOG_QUEUE_SIZE));
+        }
+        cfg.logQueueSize = static_cast<std::size_t>(queueSize);
+        if (auto overflow = (*logging)["overflow"].value<std::string>()) {
+            auto policy = parseLogOverflowPolicy(*overflow);
+            if (!policy) {
+                throw std::runtime_error(fmt::format(
+                    "invalid [logging] overflow '{}', expected 'drop', 'block' or 'drop_lowest_level'", *overflow));
+            }
+            cfg.logOverflow = *policy;
+        }
+    }
+
+    if (auto profiling = tbl["profiling"].as_table()) {
+        cfg.profiling = (*profiling)["enabled"].value_or(cfg.profiling);
+        cfg.profileTraceFile = (*profiling)["trace_file"].value_or(cfg.profileTraceFile);
+    }
+
+    if (auto recording = tbl["recording"].as_table()) {
+        cfg.recordFile = (*recording)["file"].value_or(cfg.recordFile);
     }
 
     return cfg;
@@ -50,6 +128,18 @@ ServerConfig loadConfig(const CommandLineArgs &args) {
     if (args.port.has_value()) {
         cfg.port = *args.port;
     }
+    if (!args.recordFile.empty()) {
+        cfg.recordFile = args.recordFile;
+    }
+    if (args.runMode.has_value()) {
+        cfg.runMode = *args.runMode;
+    }
+    if (args.timeScale.has_value()) {
+        cfg.timeScale = *args.timeScale;
+    }
+    if (args.maxTicks.has_value()) {
+        cfg.maxTicks = *args.maxTicks;
+    }
 
     return cfg;
 }
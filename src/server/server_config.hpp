@@ -1,21 +1,46 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <string>
 
+#include "async_log_sink.hpp"
 #include "command_line.hpp"
+#include "command_queue.hpp"
+#include "game_loop.hpp"
+#include "snapshot_scheduler.hpp"
 
 namespace void_crew::server {
 
 constexpr uint32_t DEFAULT_MAX_PLAYERS = 12;
 constexpr uint32_t DEFAULT_TICK_RATE = 60;
+constexpr std::size_t DEFAULT_LOG_QUEUE_SIZE = 8192;
+constexpr std::size_t MAX_LOG_QUEUE_SIZE = std::size_t{1} << 20; // slots hold whole messages; keep the ring bounded
+
+enum class LogMode { Sync, Async };
 
 struct ServerConfig {
     std::string name = "Void Crew Server";
     uint16_t port = DEFAULT_PORT;
     uint32_t maxPlayers = DEFAULT_MAX_PLAYERS;
     uint32_t tickRate = DEFAULT_TICK_RATE;
+    TickPacing tickPacing = TickPacing::Hybrid;
+    RunMode runMode = RunMode::RealTime;
+    double timeScale = 1.0; // scaled run mode: simulated seconds per real second
+    uint64_t maxTicks = 0;  // stop after this many ticks; 0 = run until shut down
+    uint32_t workerThreads = 0; // 0 = hardware concurrency
+    uint32_t maxClientCommandsPerTick = DEFAULT_MAX_CLIENT_COMMANDS_PER_TICK; // flood cap per client
+    uint64_t worldSeed = 0; // procedural generation seed; 0 = pick one at startup
+    bool snapshotCompression = true; // LZ4 on delta snapshots when it makes them smaller
+    std::size_t snapshotBudget = DEFAULT_SNAPSHOT_BUDGET; // bytes per client per tick, adapts down under loss
     std::string logLevel = "info";
+    LogMode logMode = LogMode::Async;
+    std::size_t logQueueSize = DEFAULT_LOG_QUEUE_SIZE;
+    LogOverflowPolicy logOverflow = LogOverflowPolicy::DropLowestLevel;
+    bool profiling = true;        // record profiler zones into the in-process ring
+    std::string profileTraceFile; // Chrome trace written on shutdown; empty = none
+    std::string recordFile;       // client input recorded for --replay; empty = none
+    bool headless = false;        // no network: nothing bound, no snapshots; replays and tests
 };
 
 // Loads config from a TOML file, then applies CLI overrides.
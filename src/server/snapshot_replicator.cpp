@@ -0,0 +1,305 @@
+#include "snapshot_replicator.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#include <lz4.h>
+
+namespace void_crew::server {
+
+namespace {
+
+// Refuse absurd sizes from a corrupt or hostile header before allocating.
+constexpr uint32_t MAX_RAW_SNAPSHOT_BYTES = 16 * 1024 * 1024;
+
+/// True if two fragments describe the same encoded snapshot.
+bool sameSnapshot(const SnapshotFragmentHeader &a, const SnapshotFragmentHeader &b) noexcept {
+    return a.tick == b.tick && a.count == b.count && a.hasBaseline == b.hasBaseline &&
+           (!a.hasBaseline || a.baselineTick == b.baselineTick) && a.compressed == b.compressed &&
+           a.rawSize == b.rawSize;
+}
+
+/// Adapts UdpTransport to SnapshotLink.
+class TransportLink final : public SnapshotLink {
+public:
+    explicit TransportLink(UdpTransport &transport)
+        : m_transport(transport) {}
+
+    bool send(ConnectionId id, std::span<const std::byte> message) override {
+        return m_transport.sendUnreliable(id, message);
+    }
+
+    double rtt(ConnectionId id) const override {
+        return m_transport.rtt(id);
+    }
+
+private:
+    UdpTransport &m_transport;
+};
+
+} // namespace
+
+SnapshotReplicator::Client::Client(std::size_t budgetBytes)
+    : bandwidth(std::min(MIN_SNAPSHOT_BUDGET, budgetBytes), budgetBytes) {}
+
+SnapshotReplicator::SnapshotReplicator(ReplicationConfig config)
+    : m_config(config) {}
+
+void SnapshotReplicator::addClient(ConnectionId id) {
+    m_clients.try_emplace(id, m_config.budgetBytes);
+}
+
+void SnapshotReplicator::removeClient(ConnectionId id) {
+    m_clients.erase(id);
+}
+
+void SnapshotReplicator::onAck(ConnectionId id, uint64_t tick) {
+    auto it = m_clients.find(id);
+    if (it == m_clients.end() || !m_latestTick || tick > *m_latestTick) {
+        return;
+    }
+    auto &client = it->second;
+    client.bandwidth.onAcked(tick);
+    if (!client.hasAck || tick > client.ackedTick) {
+        client.hasAck = true;
+        client.ackedTick = tick;
+    }
+}
+
+std::optional<uint64_t> SnapshotReplicator::ackedTick(ConnectionId id) const {
+    auto it = m_clients.find(id);
+    if (it == m_clients.end() || !it->second.hasAck) {
+        return std::nullopt;
+    }
+    return it->second.ackedTick;
+}
+
+std::size_t SnapshotReplicator::budget(ConnectionId id) const {
+    auto it = m_clients.find(id);
+    return it != m_clients.end() ? it->second.bandwidth.budget() : 0;
+}
+
+void SnapshotReplicator::pushState(WorldState &state) {
+    m_latestTick = std::max(m_latestTick.value_or(0), state.tick);
+    std::swap(m_world, state);
+    m_hasWorld = true;
+}
+
+void SnapshotReplicator::pushView(ClientView &view) {
+    auto it = m_clients.find(view.client);
+    if (it == m_clients.end()) {
+        return;
+    }
+    auto &client = it->second;
+    m_latestTick = std::max(m_latestTick.value_or(0), view.state.tick);
+    std::swap(client.view, view);
+    client.hasView = true;
+}
+
+void SnapshotReplicator::sendSnapshots(UdpTransport &transport) {
+    TransportLink link(transport);
+    sendSnapshots(link);
+}
+
+void SnapshotReplicator::sendSnapshots(SnapshotLink &link) {
+    if (!m_latestTick) {
+        return;
+    }
+    auto tick = *m_latestTick;
+
+    for (auto &[id, client] : m_clients) {
+        const WorldState *target = nullptr;
+        ViewContext context;
+        if (client.hasView && client.view.state.tick == tick) {
+            target = &client.view.state;
+            context = {client.view.relevance, client.view.viewpoint, client.view.hasViewpoint};
+        } else if (m_hasWorld && m_world.tick == tick) {
+            target = &m_world;
+        }
+        if (target == nullptr) {
+            continue;
+        }
+
+        client.bandwidth.update(link.rtt(id));
+        const auto *baseline = client.hasAck ? client.sent.find(client.ackedTick) : nullptr;
+        auto scheduled = client.priorities.schedule(baseline, client.sent.latest(), *target, context,
+                                                    client.bandwidth.budget(), m_next);
+        m_stats.deferredUpdates += scheduled.deferred;
+        m_stats.overBudget += scheduled.overBudget ? 1 : 0;
+
+        auto delta = encode(baseline, m_next);
+        if (delta.bytes.size() > MAX_SNAPSHOT_BYTES) {
+            ++m_stats.oversized;
+            continue;
+        }
+        sendFragments(link, id, tick, delta);
+        client.sent.swapIn(m_next);
+        client.bandwidth.onSent(tick);
+        ++m_stats.snapshotsSent;
+        m_stats.fullSnapshots += delta.hasBaseline ? 0 : 1;
+    }
+}
+
+ReplicationStats SnapshotReplicator::stats() const noexcept {
+    return m_stats;
+}
+
+SnapshotReplicator::EncodedDelta SnapshotReplicator::encode(const WorldState *baseline, const WorldState &current) {
+    auto raw = encodeDelta(baseline, current, m_writer);
+    m_stats.deltaBytes += raw.size();
+
+    EncodedDelta encoded;
+    encoded.hasBaseline = baseline != nullptr;
+    encoded.baselineTick = encoded.hasBaseline ? baseline->tick : 0;
+    encoded.rawSize = static_cast<uint32_t>(raw.size());
+    encoded.bytes = std::as_bytes(raw);
+
+    if (m_config.compress) {
+        m_compressed.resize(static_cast<std::size_t>(LZ4_compressBound(static_cast<int>(raw.size()))));
+        int compressedSize = LZ4_compress_default(reinterpret_cast<const char *>(raw.data()), m_compressed.data(),
+                                                  static_cast<int>(raw.size()), static_cast<int>(m_compressed.size()));
+        // Small or noisy deltas can grow under LZ4; send those as they are.
+        if (compressedSize > 0 && static_cast<std::size_t>(compressedSize) < raw.size()) {
+            encoded.compressed = true;
+            encoded.bytes = std::as_bytes(std::span(m_compressed).first(static_cast<std::size_t>(compressedSize)));
+        }
+    }
+    return encoded;
+}
+
+void SnapshotReplicator::sendFragments(SnapshotLink &link, ConnectionId id, uint64_t tick,
+                                       const EncodedDelta &delta) {
+    auto size = delta.bytes.size();
+    auto count = std::max<std::size_t>(1, (size + SNAPSHOT_FRAGMENT_PAYLOAD - 1) / SNAPSHOT_FRAGMENT_PAYLOAD);
+
+    SnapshotFragmentHeader header;
+    header.tick = tick;
+    header.baselineTick = delta.baselineTick;
+    header.hasBaseline = delta.hasBaseline;
+    header.compressed = delta.compressed;
+    header.count = static_cast<uint8_t>(count);
+    header.rawSize = delta.rawSize;
+
+    for (std::size_t i = 0; i < count; ++i) {
+        header.index = static_cast<uint8_t>(i);
+        auto offset = i * SNAPSHOT_FRAGMENT_PAYLOAD;
+        auto chunk = std::min(SNAPSHOT_FRAGMENT_PAYLOAD, size - offset);
+
+        encodeSnapshotFragmentHeader(header, m_message);
+        std::memcpy(m_message.data() + SNAPSHOT_FRAGMENT_HEADER_SIZE, delta.bytes.data() + offset, chunk);
+        if (link.send(id, std::span(m_message).first(SNAPSHOT_FRAGMENT_HEADER_SIZE + chunk))) {
+            ++m_stats.fragmentsSent;
+            m_stats.payloadBytes += chunk;
+        } else {
+            ++m_stats.sendFailures;
+        }
+    }
+}
+
+bool SnapshotReceiver::onFragment(std::span<const std::byte> message) {
+    auto header = decodeSnapshotFragmentHeader(message);
+    if (!header || header->rawSize > MAX_RAW_SNAPSHOT_BYTES) {
+        ++m_stats.corrupt;
+        return false;
+    }
+    const auto *newest = m_history.latest();
+    if (newest != nullptr && header->tick <= newest->tick) {
+        return false; // late fragment of a snapshot already superseded
+    }
+
+    if (!m_assembling || header->tick > m_header.tick) {
+        if (m_assembling) {
+            ++m_stats.incomplete;
+        }
+        reset(*header);
+    } else if (header->tick < m_header.tick) {
+        return false;
+    } else if (!sameSnapshot(*header, m_header)) {
+        // Fragments of one tick that disagree on how it was encoded: neither
+        // half can be trusted, so drop what was assembled so far.
+        ++m_stats.corrupt;
+        m_assembling = false;
+        return false;
+    }
+
+    auto payload = message.subspan(SNAPSHOT_FRAGMENT_HEADER_SIZE);
+    bool last = header->index + 1 == header->count;
+    if (payload.size() > SNAPSHOT_FRAGMENT_PAYLOAD || (!last && payload.size() != SNAPSHOT_FRAGMENT_PAYLOAD)) {
+        ++m_stats.corrupt;
+        return false;
+    }
+    if (m_haveFragment[header->index]) {
+        return false;
+    }
+
+    m_haveFragment[header->index] = true;
+    ++m_fragmentsReceived;
+    std::memcpy(m_assembly.data() + header->index * SNAPSHOT_FRAGMENT_PAYLOAD, payload.data(), payload.size());
+    if (last) {
+        m_assembledSize = header->index * SNAPSHOT_FRAGMENT_PAYLOAD + payload.size();
+    }
+
+    if (m_fragmentsReceived < m_header.count) {
+        return false;
+    }
+    m_assembling = false;
+    return complete();
+}
+
+const WorldState *SnapshotReceiver::latest() const noexcept {
+    return m_history.latest();
+}
+
+std::optional<uint64_t> SnapshotReceiver::takeAck() noexcept {
+    auto ack = m_pendingAck;
+    m_pendingAck.reset();
+    return ack;
+}
+
+SnapshotReceiverStats SnapshotReceiver::stats() const noexcept {
+    return m_stats;
+}
+
+bool SnapshotReceiver::complete() {
+    std::span<const uint8_t> delta(reinterpret_cast<const uint8_t *>(m_assembly.data()), m_assembledSize);
+    if (m_header.compressed) {
+        m_decompressed.resize(m_header.rawSize);
+        int size = LZ4_decompress_safe(reinterpret_cast<const char *>(m_assembly.data()), m_decompressed.data(),
+                                       static_cast<int>(m_assembledSize), static_cast<int>(m_decompressed.size()));
+        if (size != static_cast<int>(m_header.rawSize)) {
+            ++m_stats.corrupt;
+            return false;
+        }
+        delta = {reinterpret_cast<const uint8_t *>(m_decompressed.data()), m_decompressed.size()};
+    }
+
+    const WorldState *baseline = nullptr;
+    if (m_header.hasBaseline) {
+        baseline = m_history.find(m_header.baselineTick);
+        if (baseline == nullptr) {
+            ++m_stats.missingBaseline;
+            return false;
+        }
+    }
+    if (!decodeDelta(baseline, delta, m_decoded)) {
+        ++m_stats.corrupt;
+        return false;
+    }
+
+    m_decoded.tick = m_header.tick;
+    m_history.swapIn(m_decoded);
+    m_pendingAck = m_header.tick;
+    ++m_stats.decoded;
+    return true;
+}
+
+void SnapshotReceiver::reset(const SnapshotFragmentHeader &header) {
+    m_header = header;
+    m_assembling = true;
+    m_fragmentsReceived = 0;
+    m_assembledSize = 0;
+    m_haveFragment.fill(false);
+    m_assembly.resize(header.count * SNAPSHOT_FRAGMENT_PAYLOAD);
+}
+
+} // namespace void_crew::server
@@ -0,0 +1,196 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "bit_stream.hpp"
+#include "delta_snapshot.hpp"
+#include "protocol.hpp"
+#include "snapshot_scheduler.hpp"
+#include "udp_transport.hpp"
+
+namespace void_crew::server {
+
+/// Snapshot payload bytes carried by one SnapshotFragment message.
+constexpr std::size_t SNAPSHOT_FRAGMENT_PAYLOAD = UdpTransport::MAX_MESSAGE_SIZE - SNAPSHOT_FRAGMENT_HEADER_SIZE;
+
+/// Largest snapshot that can be sent, after compression.
+constexpr std::size_t MAX_SNAPSHOT_BYTES = SNAPSHOT_FRAGMENT_PAYLOAD * 255;
+
+/// The part of the world one client is allowed to see at one tick, built by
+/// the interest manager on the game thread.
+struct ClientView {
+    ConnectionId client = 0;
+    WorldState state;
+    std::vector<float> relevance; // per entity in state, 0-1; empty = all 1
+    glm::vec3 viewpoint{0.0f};    // where the client's viewer stands
+    bool hasViewpoint = false;
+};
+
+struct ReplicationConfig {
+    bool compress = true;                              // LZ4 when it makes a snapshot smaller
+    std::size_t budgetBytes = DEFAULT_SNAPSHOT_BUDGET; // per client per tick, before compression
+};
+
+/// Where snapshot fragments go: the UdpTransport in the server, a simulated
+/// link in tests.
+class SnapshotLink {
+public:
+    virtual ~SnapshotLink() = default;
+
+    virtual bool send(ConnectionId id, std::span<const std::byte> message) = 0;
+
+    /// Smoothed round-trip time to @p id in seconds.
+    virtual double rtt(ConnectionId id) const = 0;
+};
+
+struct ReplicationStats {
+    uint64_t snapshotsSent = 0;
+    uint64_t fullSnapshots = 0;   // sent without a baseline (new client or ack too old)
+    uint64_t deltaBytes = 0;      // encoded delta bytes before compression
+    uint64_t payloadBytes = 0;    // bytes actually sent, after compression
+    uint64_t fragmentsSent = 0;
+    uint64_t deferredUpdates = 0; // entity updates left for a later tick by the budget
+    uint64_t overBudget = 0;      // snapshots whose unacked updates alone exceeded the budget
+    uint64_t oversized = 0;       // snapshots over MAX_SNAPSHOT_BYTES, not sent
+    uint64_t sendFailures = 0;    // fragments the transport refused
+};
+
+/// Sends every client a delta against the newest snapshot it acknowledged.
+///
+/// Each client has a target state: its own view from pushView(), or the
+/// shared world from pushState() until it has one. Within the client's
+/// byte budget a PriorityAccumulator picks which differences from the
+/// target go out this tick; what was actually sent is kept in a per-client
+/// SnapshotHistory and encoded with encodeDelta() against the client's last
+/// acked tick (or against nothing if there is no ack or it has left the
+/// history). The result is optionally LZ4-compressed, split into fragments
+/// and sent unreliably. A lost fragment loses that snapshot only: the next
+/// one is still a delta against a tick the client is known to have.
+///
+/// Budgets adapt to loss and RTT per client (BandwidthEstimator), starting
+/// from and never exceeding ReplicationConfig::budgetBytes. Runs on the
+/// network thread.
+class SnapshotReplicator {
+public:
+    explicit SnapshotReplicator(ReplicationConfig config = {});
+
+    void addClient(ConnectionId id);
+    void removeClient(ConnectionId id);
+
+    /// Records that @p id decoded the snapshot for @p tick. Older or unknown
+    /// ticks are ignored.
+    void onAck(ConnectionId id, uint64_t tick);
+
+    /// The newest tick @p id acknowledged, if any.
+    std::optional<uint64_t> ackedTick(ConnectionId id) const;
+
+    /// Current byte budget of @p id, 0 for unknown clients.
+    std::size_t budget(ConnectionId id) const;
+
+    /// Stores @p state as the newest shared world; @p state receives the
+    /// previous one, whose buffers the caller can reuse.
+    void pushState(WorldState &state);
+
+    /// Stores @p view as the newest view of client @p view.client; @p view
+    /// receives the previous one. Ignored for unknown clients.
+    void pushView(ClientView &view);
+
+    /// Schedules and encodes the newest state (or view) for every client and
+    /// hands it to @p link. Clients with neither for the newest tick are
+    /// skipped.
+    void sendSnapshots(SnapshotLink &link);
+    void sendSnapshots(UdpTransport &transport);
+
+    ReplicationStats stats() const noexcept;
+
+private:
+    struct Client {
+        explicit Client(std::size_t budgetBytes);
+
+        bool hasAck = false;
+        uint64_t ackedTick = 0;
+        bool hasView = false;
+        ClientView view;
+        SnapshotHistory sent; // what this client was actually sent, by tick
+        PriorityAccumulator priorities;
+        BandwidthEstimator bandwidth;
+    };
+
+    struct EncodedDelta {
+        bool hasBaseline = false;
+        uint64_t baselineTick = 0;
+        bool compressed = false;
+        uint32_t rawSize = 0;
+        std::span<const std::byte> bytes;
+    };
+
+    EncodedDelta encode(const WorldState *baseline, const WorldState &current);
+    void sendFragments(SnapshotLink &link, ConnectionId id, uint64_t tick, const EncodedDelta &delta);
+
+    ReplicationConfig m_config;
+    std::unordered_map<ConnectionId, Client> m_clients;
+    WorldState m_world;
+    bool m_hasWorld = false;
+    std::optional<uint64_t> m_latestTick; // newest tick pushed, shared or view
+
+    // Scratch reused across sends.
+    WorldState m_next;
+    BitWriter m_writer;
+    std::vector<char> m_compressed;
+    std::array<std::byte, UdpTransport::MAX_MESSAGE_SIZE> m_message{};
+
+    ReplicationStats m_stats;
+};
+
+struct SnapshotReceiverStats {
+    uint64_t decoded = 0;
+    uint64_t missingBaseline = 0; // baseline no longer (or never) held
+    uint64_t corrupt = 0;         // bad fragments, failed decompression or decode
+    uint64_t incomplete = 0;      // snapshots abandoned for a newer one
+};
+
+/// Client side of SnapshotReplicator: reassembles fragments, decompresses,
+/// applies the delta to the acknowledged baseline and keeps its own history
+/// for later baselines. Used by test clients and tools; the game client will
+/// share it once it has networking.
+class SnapshotReceiver {
+public:
+    /// Handles one SnapshotFragment message. Returns true if it completed a
+    /// snapshot, which is then latest().
+    bool onFragment(std::span<const std::byte> message);
+
+    const WorldState *latest() const noexcept;
+
+    /// The tick to acknowledge, once per decoded snapshot.
+    std::optional<uint64_t> takeAck() noexcept;
+
+    SnapshotReceiverStats stats() const noexcept;
+
+private:
+    bool complete();
+    void reset(const SnapshotFragmentHeader &header);
+
+    SnapshotHistory m_history;
+    WorldState m_decoded;
+
+    SnapshotFragmentHeader m_header;
+    bool m_assembling = false;
+    std::size_t m_fragmentsReceived = 0;
+    std::size_t m_assembledSize = 0;
+    std::array<bool, 256> m_haveFragment{};
+    std::vector<std::byte> m_assembly;
+    std::vector<char> m_decompressed;
+
+    std::optional<uint64_t> m_pendingAck;
+    SnapshotReceiverStats m_stats;
+};
+
+} // namespace void_crew::server
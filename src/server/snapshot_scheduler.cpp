@@ -0,0 +1,216 @@
+#include "snapshot_scheduler.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include <glm/gtc/quaternion.hpp>
+
+namespace void_crew::server {
+
+namespace {
+
+/// Calls @p f(lhs, rhs) for every id in either sorted list; the side that
+/// lacks the id gets nullptr.
+template <typename F>
+void forEachPair(const std::vector<EntityState> &lhs, const std::vector<EntityState> &rhs, F &&f) {
+    std::size_t l = 0;
+    std::size_t r = 0;
+    while (l < lhs.size() || r < rhs.size()) {
+        if (r == rhs.size() || (l < lhs.size() && lhs[l].id < rhs[r].id)) {
+            f(&lhs[l++], nullptr);
+        } else if (l == lhs.size() || rhs[r].id < lhs[l].id) {
+            f(nullptr, &rhs[r++]);
+        } else {
+            f(&lhs[l++], &rhs[r++]);
+        }
+    }
+}
+
+/// Rough "how different does it look": metres moved, plus rotation and
+/// velocity changes scaled to comparable units.
+float changeMagnitude(const EntityState &from, const EntityState &to) noexcept {
+    float moved = glm::length(to.position - from.position);
+    float turned = 1.0f - std::abs(glm::dot(from.rotation, to.rotation)); // 0 same, 1 opposite
+    float accelerated = glm::length(to.linearVelocity - from.linearVelocity) +
+                        glm::length(to.angularVelocity - from.angularVelocity);
+    return moved + 4.0f * turned + 0.25f * accelerated;
+}
+
+} // namespace
+
+BandwidthEstimator::BandwidthEstimator(std::size_t minBytes, std::size_t maxBytes)
+    : m_minBytes(std::min(minBytes, maxBytes)),
+      m_maxBytes(maxBytes),
+      m_budget(maxBytes) {}
+
+void BandwidthEstimator::onSent(uint64_t tick) noexcept {
+    if (m_size == m_ring.size()) {
+        // No acks for a whole ring: the oldest is as good as lost.
+        settle(m_ring[m_head]);
+        m_head = (m_head + 1) % m_ring.size();
+        --m_size;
+    }
+    m_ring[(m_head + m_size) % m_ring.size()] = {tick, false};
+    ++m_size;
+}
+
+void BandwidthEstimator::onAcked(uint64_t tick) noexcept {
+    for (std::size_t i = 0; i < m_size; ++i) {
+        auto &sent = m_ring[(m_head + i) % m_ring.size()];
+        if (sent.tick == tick) {
+            sent.acked = true;
+            break;
+        }
+    }
+    if (!m_hasAck || tick > m_newestAck) {
+        m_newestAck = tick;
+        m_hasAck = true;
+    }
+}
+
+void BandwidthEstimator::update(double rtt) noexcept {
+    while (m_size > 0 && m_hasAck && m_ring[m_head].tick <= m_newestAck) {
+        settle(m_ring[m_head]);
+        m_head = (m_head + 1) % m_ring.size();
+        --m_size;
+    }
+
+    if (rtt > 0.0) {
+        m_minRtt = m_minRtt > 0.0 ? std::min(m_minRtt, rtt) : rtt;
+        m_maxWindowRtt = std::max(m_maxWindowRtt, rtt);
+    }
+    if (m_windowSettled < WINDOW) {
+        return;
+    }
+
+    m_lossRate = static_cast<double>(m_windowLost) / static_cast<double>(m_windowSettled);
+    bool queueing = m_minRtt > 0.0 && m_maxWindowRtt > m_minRtt * RTT_INFLATION + RTT_SLACK;
+    if (m_lossRate > LOSS_THRESHOLD || queueing) {
+        m_budget = std::max(m_minBytes, static_cast<std::size_t>(static_cast<double>(m_budget) * DECREASE_FACTOR));
+    } else {
+        auto step = static_cast<std::size_t>(static_cast<double>(m_budget) * INCREASE_FRACTION);
+        m_budget = std::min(m_maxBytes, m_budget + std::max<std::size_t>(1, step));
+    }
+    m_windowSettled = 0;
+    m_windowLost = 0;
+    m_maxWindowRtt = 0.0;
+}
+
+std::size_t BandwidthEstimator::budget() const noexcept {
+    return m_budget;
+}
+
+double BandwidthEstimator::lossRate() const noexcept {
+    return m_lossRate;
+}
+
+void BandwidthEstimator::settle(const SentTick &sent) noexcept {
+    ++m_windowSettled;
+    m_windowLost += sent.acked ? 0 : 1;
+}
+
+PriorityAccumulator::Result PriorityAccumulator::schedule(const WorldState *baseline, const WorldState *sent,
+                                                          const WorldState &target, const ViewContext &context,
+                                                          std::size_t budgetBytes, WorldState &out) {
+    static const std::vector<EntityState> NO_ENTITIES;
+    const auto &base = baseline != nullptr ? baseline->entities : NO_ENTITIES;
+    const auto &have = sent != nullptr ? sent->entities : NO_ENTITIES;
+    const auto &want = target.entities;
+
+    // Updates sent but not acked are repeated in every delta until acked.
+    std::size_t inFlightBits = 1; // end-of-list bit
+    forEachPair(base, have, [&](const EntityState *b, const EntityState *h) {
+        inFlightBits += estimateEntryBits(b, h);
+    });
+
+    // Accumulate priority for everything the client has wrong.
+    m_candidates.clear();
+    std::size_t previous = 0;
+    forEachPair(have, want, [&](const EntityState *h, const EntityState *w) {
+        if (h != nullptr && w != nullptr && *h == *w) {
+            return;
+        }
+        Candidate candidate;
+        candidate.id = w != nullptr ? w->id : h->id;
+        candidate.sent = h;
+        candidate.target = w;
+        candidate.bits = estimateEntryBits(h, w);
+
+        float relevance = 1.0f;
+        if (w != nullptr && !context.relevance.empty()) {
+            relevance = context.relevance[static_cast<std::size_t>(w - want.data())];
+        }
+        float falloff = 1.0f;
+        if (context.hasViewpoint) {
+            auto distance = glm::length((w != nullptr ? w->position : h->position) - context.viewpoint);
+            falloff = 1.0f / (1.0f + distance / DISTANCE_FALLOFF);
+        }
+        float magnitude = (h != nullptr && w != nullptr) ? changeMagnitude(*h, *w) : SPAWN_MAGNITUDE;
+
+        while (previous < m_priorities.size() && m_priorities[previous].first < candidate.id) {
+            ++previous;
+        }
+        float accumulated = previous < m_priorities.size() && m_priorities[previous].first == candidate.id
+                                ? m_priorities[previous].second
+                                : 0.0f;
+        candidate.priority = accumulated + relevance * falloff * (1.0f + magnitude);
+        m_candidates.push_back(candidate);
+    });
+
+    // Greedy fill, highest priority first; smaller entries still fit after a big one does not.
+    Result result;
+    std::size_t budgetBits = budgetBytes * 8;
+    result.overBudget = inFlightBits > budgetBits;
+    std::size_t remaining = result.overBudget ? 0 : budgetBits - inFlightBits;
+
+    m_order.resize(m_candidates.size());
+    for (std::size_t i = 0; i < m_order.size(); ++i) {
+        m_order[i] = i;
+    }
+    std::sort(m_order.begin(), m_order.end(), [this](std::size_t lhs, std::size_t rhs) {
+        return m_candidates[lhs].priority > m_candidates[rhs].priority;
+    });
+    for (auto index : m_order) {
+        auto &candidate = m_candidates[index];
+        if (candidate.bits <= remaining) {
+            candidate.selected = true;
+            remaining -= candidate.bits;
+            ++result.selected;
+        } else {
+            ++result.deferred;
+        }
+    }
+
+    // Unsent entities carry their priority over; sent ones start again from zero.
+    m_nextPriorities.clear();
+    for (const auto &candidate : m_candidates) {
+        if (!candidate.selected) {
+            m_nextPriorities.emplace_back(candidate.id, candidate.priority);
+        }
+    }
+    std::swap(m_priorities, m_nextPriorities);
+
+    out.tick = target.tick;
+    out.entities.clear();
+    std::size_t next = 0;
+    forEachPair(have, want, [&](const EntityState *h, const EntityState *w) {
+        if (h != nullptr && w != nullptr && *h == *w) {
+            out.entities.push_back(*w);
+            return;
+        }
+        const auto &candidate = m_candidates[next++];
+        const auto *chosen = candidate.selected ? w : h;
+        if (chosen != nullptr) {
+            out.entities.push_back(*chosen);
+        }
+    });
+    return result;
+}
+
+float PriorityAccumulator::priority(uint32_t id) const noexcept {
+    auto it = std::lower_bound(m_priorities.begin(), m_priorities.end(), id,
+                               [](const auto &entry, uint32_t value) { return entry.first < value; });
+    return it != m_priorities.end() && it->first == id ? it->second : 0.0f;
+}
+
+} // namespace void_crew::server
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "delta_snapshot.hpp"
+
+namespace void_crew::server {
+
+/// Default cap on one client's snapshot per tick, in delta bytes before
+/// compression: about 2 Mbit/s at 60 Hz.
+constexpr std::size_t DEFAULT_SNAPSHOT_BUDGET = 4096;
+
+/// Floor the adaptive budget never goes below; fits in one fragment.
+constexpr std::size_t MIN_SNAPSHOT_BUDGET = 512;
+
+/// Adapts a client's snapshot budget to loss and RTT, additive increase and
+/// multiplicative decrease.
+///
+/// Every snapshot the client decodes is acked, so a sent tick that is older
+/// than the newest ack and was never acked counts as lost: the estimate
+/// needs no clock and is not skewed by acks still in flight. Each window of
+/// WINDOW settled snapshots the budget shrinks if loss or queueing delay
+/// (RTT above its minimum) suggests congestion, and grows otherwise.
+class BandwidthEstimator {
+public:
+    static constexpr std::size_t WINDOW = 32;          // settled snapshots per decision
+    static constexpr double LOSS_THRESHOLD = 0.05;     // loss above this is congestion
+    static constexpr double RTT_INFLATION = 2.0;       // RTT over min * this is congestion
+    static constexpr double RTT_SLACK = 0.02;          // seconds of jitter always tolerated
+    static constexpr double DECREASE_FACTOR = 0.75;
+    static constexpr double INCREASE_FRACTION = 0.125; // of the budget, per clean window
+
+    BandwidthEstimator(std::size_t minBytes, std::size_t maxBytes);
+
+    void onSent(uint64_t tick) noexcept;
+    void onAcked(uint64_t tick) noexcept;
+
+    /// Settles snapshots the acks have overtaken and adjusts the budget.
+    /// @p rtt is the current smoothed round-trip time in seconds.
+    void update(double rtt) noexcept;
+
+    std::size_t budget() const noexcept;
+
+    /// Loss rate of the last completed window.
+    double lossRate() const noexcept;
+
+private:
+    struct SentTick {
+        uint64_t tick = 0;
+        bool acked = false;
+    };
+
+    void settle(const SentTick &sent) noexcept;
+
+    std::size_t m_minBytes;
+    std::size_t m_maxBytes;
+    std::size_t m_budget;
+
+    std::array<SentTick, 256> m_ring{};
+    std::size_t m_head = 0;
+    std::size_t m_size = 0;
+    uint64_t m_newestAck = 0;
+    bool m_hasAck = false;
+
+    std::size_t m_windowSettled = 0;
+    std::size_t m_windowLost = 0;
+    double m_minRtt = 0.0;
+    double m_maxWindowRtt = 0.0;
+    double m_lossRate = 0.0;
+};
+
+/// What the scheduler knows about the client's point of view.
+struct ViewContext {
+    std::span<const float> relevance; // per target entity; empty = all 1
+    glm::vec3 viewpoint{0.0f};
+    bool hasViewpoint = false;
+};
+
+/// Per-client priority accumulator.
+///
+/// Every tick an entity differs between what the client was last sent and
+/// the target state, its priority grows by relevance x distance falloff x
+/// change magnitude. schedule() then fills the byte budget greedily in
+/// priority order; chosen entities reset to zero, the rest keep
+/// accumulating, so under a tight budget nearby and fast-changing entities
+/// update often while distant idle ones still arrive eventually.
+class PriorityAccumulator {
+public:
+    static constexpr float DISTANCE_FALLOFF = 10.0f; // metres at which weight halves
+    static constexpr float SPAWN_MAGNITUDE = 10.0f;  // appearing or vanishing entities
+
+    struct Result {
+        std::size_t selected = 0;
+        std::size_t deferred = 0;
+        bool overBudget = false; // updates already in flight alone exceeded the budget
+    };
+
+    /// Builds @p out from @p sent (the client's latest sent state; nullptr
+    /// for none) with the highest-priority differences from @p target
+    /// applied, so that a delta of @p out against @p baseline stays within
+    /// about @p budgetBytes. Updates sent but not yet acked stay in @p out
+    /// and count against the budget first.
+    Result schedule(const WorldState *baseline, const WorldState *sent, const WorldState &target,
+                    const ViewContext &context, std::size_t budgetBytes, WorldState &out);
+
+    /// Accumulated priority of entity @p id, 0 if it is up to date.
+    float priority(uint32_t id) const noexcept;
+
+private:
+    struct Candidate {
+        uint32_t id = 0;
+        const EntityState *sent = nullptr;   // nullptr: not on the client yet
+        const EntityState *target = nullptr; // nullptr: to be removed
+        std::size_t bits = 0;
+        float priority = 0.0f;
+        bool selected = false;
+    };
+
+    std::vector<std::pair<uint32_t, float>> m_priorities; // sorted by id
+    std::vector<std::pair<uint32_t, float>> m_nextPriorities;
+    std::vector<Candidate> m_candidates;
+    std::vector<std::size_t> m_order;
+};
+
+} // namespace void_crew::server
@@ -0,0 +1,258 @@
+#include "spatial_index.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+namespace void_crew::server {
+
+namespace {
+
+// Cell coordinates are packed 21 bits per axis into one key. At the default
+// cell size that spans +-4000 km; positions further out share the edge cells.
+constexpr int CELL_BITS = 21;
+constexpr int MIN_CELL = -(1 << (CELL_BITS - 1));
+constexpr int MAX_CELL = (1 << (CELL_BITS - 1)) - 1;
+constexpr uint64_t CELL_MASK = (uint64_t{1} << CELL_BITS) - 1;
+
+bool inRange(const glm::ivec3 &cell) noexcept {
+    return cell.x >= MIN_CELL && cell.x <= MAX_CELL && cell.y >= MIN_CELL && cell.y <= MAX_CELL &&
+           cell.z >= MIN_CELL && cell.z <= MAX_CELL;
+}
+
+uint64_t packCell(const glm::ivec3 &cell) noexcept {
+    auto axis = [](int v) { return static_cast<uint64_t>(v - MIN_CELL) & CELL_MASK; };
+    return axis(cell.x) | (axis(cell.y) << CELL_BITS) | (axis(cell.z) << (2 * CELL_BITS));
+}
+
+glm::ivec3 unpackCell(uint64_t key) noexcept {
+    auto axis = [key](int shift) { return static_cast<int>((key >> shift) & CELL_MASK) + MIN_CELL; };
+    return {axis(0), axis(CELL_BITS), axis(2 * CELL_BITS)};
+}
+
+int clampCell(float scaled) noexcept {
+    auto cell = std::floor(scaled);
+    if (!(cell >= static_cast<float>(MIN_CELL))) { // also NaN
+        return MIN_CELL;
+    }
+    if (cell > static_cast<float>(MAX_CELL)) {
+        return MAX_CELL;
+    }
+    return static_cast<int>(cell);
+}
+
+int chebyshev(const glm::ivec3 &a, const glm::ivec3 &b) noexcept {
+    return std::max({std::abs(a.x - b.x), std::abs(a.y - b.y), std::abs(a.z - b.z)});
+}
+
+float distance2(const glm::vec3 &a, const glm::vec3 &b) noexcept {
+    auto d = a - b;
+    return glm::dot(d, d);
+}
+
+} // namespace
+
+SpatialIndex::SpatialIndex(entt::registry &registry, float cellSize)
+    : m_registry(registry),
+      m_cellSize(cellSize),
+      m_inverseCellSize(1.0f / cellSize) {
+    m_registry.on_construct<Transform>().connect<&SpatialIndex::onMoved>(*this);
+    m_registry.on_update<Transform>().connect<&SpatialIndex::onMoved>(*this);
+    m_registry.on_destroy<Transform>().connect<&SpatialIndex::onRemoved>(*this);
+
+    for (auto [entity, transform] : m_registry.view<const Transform>().each()) {
+        place(entity, transform.position);
+    }
+}
+
+SpatialIndex::~SpatialIndex() {
+    m_registry.on_construct<Transform>().disconnect(*this);
+    m_registry.on_update<Transform>().disconnect(*this);
+    m_registry.on_destroy<Transform>().disconnect(*this);
+}
+
+void SpatialIndex::refresh(entt::entity entity) {
+    const auto *transform = m_registry.valid(entity) ? m_registry.try_get<Transform>(entity) : nullptr;
+    if (transform != nullptr) {
+        place(entity, transform->position);
+    } else {
+        unplace(entity);
+    }
+}
+
+template <typename F>
+void SpatialIndex::forEachCell(const glm::ivec3 &from, const glm::ivec3 &to, F &&f) const {
+    auto extent = glm::max(to - from + 1, glm::ivec3(0));
+    auto volume = static_cast<uint64_t>(extent.x) * static_cast<uint64_t>(extent.y) * static_cast<uint64_t>(extent.z);
+    if (volume > m_cells.size()) {
+        // Huge query, sparse world: cheaper to filter the occupied cells.
+        for (const auto &[key, entries] : m_cells) {
+            auto cell = unpackCell(key);
+            if (glm::all(glm::greaterThanEqual(cell, from)) && glm::all(glm::lessThanEqual(cell, to))) {
+                f(entries);
+            }
+        }
+        return;
+    }
+    for (int x = from.x; x <= to.x; ++x) {
+        for (int y = from.y; y <= to.y; ++y) {
+            for (int z = from.z; z <= to.z; ++z) {
+                if (auto it = m_cells.find(packCell({x, y, z})); it != m_cells.end()) {
+                    f(it->second);
+                }
+            }
+        }
+    }
+}
+
+void SpatialIndex::radius(const glm::vec3 &center, float radius, std::vector<entt::entity> &out) const {
+    out.clear();
+    if (!(radius >= 0.0f)) {
+        return;
+    }
+    auto reach = glm::vec3(radius);
+    float radius2 = radius * radius;
+    forEachCell(cellOf(center - reach), cellOf(center + reach), [&](const std::vector<Entry> &entries) {
+        for (const auto &entry : entries) {
+            if (distance2(entry.position, center) <= radius2) {
+                out.push_back(entry.entity);
+            }
+        }
+    });
+}
+
+void SpatialIndex::box(const Aabb &box, std::vector<entt::entity> &out) const {
+    out.clear();
+    forEachCell(cellOf(box.min), cellOf(box.max), [&](const std::vector<Entry> &entries) {
+        for (const auto &entry : entries) {
+            if (glm::all(glm::greaterThanEqual(entry.position, box.min)) &&
+                glm::all(glm::lessThanEqual(entry.position, box.max))) {
+                out.push_back(entry.entity);
+            }
+        }
+    });
+}
+
+void SpatialIndex::nearest(const glm::vec3 &center, std::size_t k, std::vector<entt::entity> &out) const {
+    out.clear();
+    m_best.clear();
+    if (k == 0) {
+        return;
+    }
+
+    auto heapLess = [](const auto &lhs, const auto &rhs) { return lhs.first < rhs.first; };
+    auto consider = [&](const std::vector<Entry> &entries) {
+        for (const auto &entry : entries) {
+            float d2 = distance2(entry.position, center);
+            if (m_best.size() < k) {
+                m_best.emplace_back(d2, entry.entity);
+                std::push_heap(m_best.begin(), m_best.end(), heapLess);
+            } else if (d2 < m_best.front().first) {
+                std::pop_heap(m_best.begin(), m_best.end(), heapLess);
+                m_best.back() = {d2, entry.entity};
+                std::push_heap(m_best.begin(), m_best.end(), heapLess);
+            }
+        }
+    };
+
+    // Search shells of cells around the centre's cell, nearest first. After
+    // shell r every unvisited entity is at least r cells away, so once the
+    // k-th best is closer than that the answer is final.
+    auto origin = cellOf(center);
+    for (int r = 0;; ++r) {
+        auto side = static_cast<uint64_t>(2 * r + 1);
+        if (side * side * side >= m_cells.size()) {
+            // The cube outgrew the occupied cells: finish with one pass over them.
+            for (const auto &[key, entries] : m_cells) {
+                if (chebyshev(unpackCell(key), origin) >= r) {
+                    consider(entries);
+                }
+            }
+            break;
+        }
+        for (int dx = -r; dx <= r; ++dx) {
+            for (int dy = -r; dy <= r; ++dy) {
+                bool edge = std::abs(dx) == r || std::abs(dy) == r;
+                for (int dz = -r; dz <= r; dz += edge || r == 0 ? 1 : 2 * r) {
+                    glm::ivec3 cell = origin + glm::ivec3(dx, dy, dz);
+                    if (!inRange(cell)) {
+                        continue;
+                    }
+                    if (auto it = m_cells.find(packCell(cell)); it != m_cells.end()) {
+                        consider(it->second);
+                    }
+                }
+            }
+        }
+        float reach = static_cast<float>(r) * m_cellSize;
+        if (m_best.size() == k && m_best.front().first <= reach * reach) {
+            break;
+        }
+    }
+
+    std::sort_heap(m_best.begin(), m_best.end(), heapLess);
+    for (const auto &[d2, entity] : m_best) {
+        out.push_back(entity);
+    }
+}
+
+std::size_t SpatialIndex::size() const noexcept {
+    return m_slots.size();
+}
+
+std::size_t SpatialIndex::cellCount() const noexcept {
+    return m_cells.size();
+}
+
+float SpatialIndex::cellSize() const noexcept {
+    return m_cellSize;
+}
+
+void SpatialIndex::onMoved(entt::registry &registry, entt::entity entity) {
+    place(entity, registry.get<Transform>(entity).position);
+}
+
+void SpatialIndex::onRemoved(entt::registry &, entt::entity entity) {
+    unplace(entity);
+}
+
+void SpatialIndex::place(entt::entity entity, const glm::vec3 &position) {
+    auto key = packCell(cellOf(position));
+    if (auto slot = m_slots.find(entity); slot != m_slots.end()) {
+        if (slot->second.cell == key) {
+            // Most moves stay inside the cell: just update the cached position.
+            m_cells[key][slot->second.index].position = position;
+            return;
+        }
+        unplace(entity);
+    }
+    auto &cell = m_cells[key];
+    m_slots[entity] = {key, cell.size()};
+    cell.push_back({entity, position});
+}
+
+void SpatialIndex::unplace(entt::entity entity) {
+    auto slot = m_slots.find(entity);
+    if (slot == m_slots.end()) {
+        return;
+    }
+    auto cell = m_cells.find(slot->second.cell);
+    auto &entries = cell->second;
+    auto index = slot->second.index;
+    if (index + 1 != entries.size()) {
+        entries[index] = entries.back();
+        m_slots[entries[index].entity].index = index;
+    }
+    entries.pop_back();
+    if (entries.empty()) {
+        m_cells.erase(cell);
+    }
+    m_slots.erase(slot);
+}
+
+glm::ivec3 SpatialIndex::cellOf(const glm::vec3 &position) const noexcept {
+    auto scaled = position * m_inverseCellSize;
+    return {clampCell(scaled.x), clampCell(scaled.y), clampCell(scaled.z)};
+}
+
+} // namespace void_crew::server
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <entt/entt.hpp>
+#include <glm/glm.hpp>
+
+#include "components.hpp"
+
+namespace void_crew::server {
+
+/// Default grid cell edge in metres: about a compartment, so a hearing or
+/// vision radius of a few cells touches a few dozen buckets.
+constexpr float DEFAULT_SPATIAL_CELL_SIZE = 4.0f;
+
+/// Axis-aligned box, inclusive on both ends.
+struct Aabb {
+    glm::vec3 min{0.0f};
+    glm::vec3 max{0.0f};
+};
+
+/// Uniform hash grid over the positions of every entity with a Transform.
+///
+/// Kept up to date from registry signals on Transform, so only entities that
+/// actually moved cost anything per tick; nothing is rebuilt. Each cell
+/// stores positions next to entities, so queries touch neither the registry
+/// nor the Transform pool. Move entities with registry.patch() or replace()
+/// so the index sees it; code that writes a Transform in place must call
+/// refresh() afterwards.
+///
+/// Queries fill @p out, reusing its storage. Radius and box queries return
+/// entities in no particular order; nearest() returns them closest first.
+/// Game thread only.
+class SpatialIndex {
+public:
+    explicit SpatialIndex(entt::registry &registry, float cellSize = DEFAULT_SPATIAL_CELL_SIZE);
+    ~SpatialIndex();
+
+    SpatialIndex(const SpatialIndex &) = delete;
+    SpatialIndex &operator=(const SpatialIndex &) = delete;
+    SpatialIndex(SpatialIndex &&) = delete;
+    SpatialIndex &operator=(SpatialIndex &&) = delete;
+
+    /// Re-reads @p entity's Transform after an in-place write.
+    void refresh(entt::entity entity);
+
+    /// Entities within @p radius of @p center, boundary included.
+    void radius(const glm::vec3 &center, float radius, std::vector<entt::entity> &out) const;
+
+    /// Entities inside @p box, boundary included.
+    void box(const Aabb &box, std::vector<entt::entity> &out) const;
+
+    /// Up to @p k entities closest to @p center, nearest first; ties in no
+    /// particular order.
+    void nearest(const glm::vec3 &center, std::size_t k, std::vector<entt::entity> &out) const;
+
+    std::size_t size() const noexcept;
+    std::size_t cellCount() const noexcept;
+    float cellSize() const noexcept;
+
+private:
+    using CellKey = uint64_t;
+
+    struct Entry {
+        entt::entity entity = entt::null;
+        glm::vec3 position{0.0f};
+    };
+
+    struct Slot {
+        CellKey cell = 0;
+        std::size_t index = 0;
+    };
+
+    void onMoved(entt::registry &registry, entt::entity entity);
+    void onRemoved(entt::registry &registry, entt::entity entity);
+
+    void place(entt::entity entity, const glm::vec3 &position);
+    void unplace(entt::entity entity);
+
+    glm::ivec3 cellOf(const glm::vec3 &position) const noexcept;
+
+    /// Calls @p f(entries) for every non-empty cell overlapping [@p from, @p to].
+    template <typename F>
+    void forEachCell(const glm::ivec3 &from, const glm::ivec3 &to, F &&f) const;
+
+    entt::registry &m_registry;
+    float m_cellSize;
+    float m_inverseCellSize;
+
+    std::unordered_map<CellKey, std::vector<Entry>> m_cells;
+    std::unordered_map<entt::entity, Slot> m_slots;
+
+    // Scratch for nearest(): (squared distance, entity) max-heap of the best k.
+    mutable std::vector<std::pair<float, entt::entity>> m_best;
+};
+
+} // namespace void_crew::server
@@ -0,0 +1,259 @@
+#include "system_scheduler.hpp"
+
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+#include <fmt/format.h>
+
+#include "logging.hpp"
+#include "profiler.hpp"
+#include "timer.hpp"
+
+namespace void_crew::server {
+
+namespace {
+
+std::size_t resolveWorkerCount(uint32_t requested) {
+    if (requested != 0) {
+        return requested;
+    }
+    return std::max(1U, std::thread::hardware_concurrency());
+}
+
+} // namespace
+
+bool SystemAccess::conflictsWith(const SystemAccess &other) const noexcept {
+    if (m_exclusive || other.m_exclusive) {
+        return true;
+    }
+    return overlaps(m_writes, other.m_writes) || overlaps(m_writes, other.m_reads) ||
+           overlaps(m_reads, other.m_writes);
+}
+
+bool SystemAccess::writesListenedPool(entt::registry &registry) const {
+    return std::any_of(m_writes.begin(), m_writes.end(),
+                       [&registry](const Component &component) { return component.listened(registry); });
+}
+
+void SystemAccess::prepare(entt::registry &registry) const {
+    for (const auto &component : m_reads) {
+        component.assure(registry);
+    }
+    for (const auto &component : m_writes) {
+        component.assure(registry);
+    }
+}
+
+bool SystemAccess::overlaps(const std::vector<Component> &lhs, const std::vector<Component> &rhs) noexcept {
+    // Systems touch a handful of pools each, so a nested scan beats any set.
+    return std::any_of(lhs.begin(), lhs.end(), [&rhs](const Component &a) {
+        return std::any_of(rhs.begin(), rhs.end(), [&a](const Component &b) { return a.id == b.id; });
+    });
+}
+
+SystemScheduler::SystemScheduler(uint32_t workerThreads)
+    : m_executor(resolveWorkerCount(workerThreads)), m_workerArenas(m_executor.num_workers() + 1) {
+    TLOG_DEBUG("systems", "System scheduler started with {} worker threads", m_executor.num_workers());
+}
+
+SystemScheduler::SystemId SystemScheduler::addSystem(std::string name, SystemAccess access, SystemFn fn,
+                                                     uint32_t rateDivisor) {
+    if (rateDivisor == 0) {
+        throw std::invalid_argument(fmt::format("system '{}': rate divisor must be positive", name));
+    }
+    auto id = static_cast<SystemId>(m_systems.size());
+    auto phase = pickPhase(rateDivisor);
+    TLOG_DEBUG("systems", "Registered system '{}' (id {}, every {} ticks, phase {})", name, id, rateDivisor, phase);
+    const char *profileName = internProfileName(name);
+    m_systems.push_back({std::move(name), std::move(access), std::move(fn), profileName, rateDivisor, phase});
+    m_graphDirty = true;
+    return id;
+}
+
+void SystemScheduler::setEnabled(SystemId id, bool enabled) {
+    if (id >= m_systems.size()) {
+        throw std::out_of_range(fmt::format("unknown system id {}", id));
+    }
+    m_systems[id].enabled = enabled;
+}
+
+bool SystemScheduler::isEnabled(SystemId id) const {
+    return systemAt(id).enabled;
+}
+
+uint32_t SystemScheduler::rateDivisor(SystemId id) const {
+    return systemAt(id).rateDivisor;
+}
+
+uint32_t SystemScheduler::phase(SystemId id) const {
+    return systemAt(id).phase;
+}
+
+void SystemScheduler::update(entt::registry &registry, float dt) {
+    if (m_systems.empty()) {
+        return;
+    }
+
+    if (m_graphDirty || m_registry != &registry || listenersChanged(registry)) {
+        rebuildGraph(registry);
+    }
+
+    System *lone = nullptr;
+    std::size_t due = 0;
+    for (auto &system : m_systems) {
+        // Time spent disabled is not owed to the system when it comes back.
+        system.pendingDt = system.enabled ? system.pendingDt + dt : 0.0f;
+        system.due = system.enabled && m_updates % system.rateDivisor == system.phase;
+        if (system.due) {
+            lone = &system;
+            ++due;
+        } else {
+            system.lastDuration = 0.0;
+        }
+    }
+    ++m_updates;
+
+    if (due == 1) {
+        // Waking a worker costs more than running a lone system inline.
+        runSystem(*lone);
+    } else if (due > 1) {
+        m_executor.run(m_taskflow).wait();
+    }
+
+    if (m_failure) {
+        auto failure = std::exchange(m_failure, nullptr);
+        std::rethrow_exception(failure);
+    }
+}
+
+std::size_t SystemScheduler::systemCount() const noexcept {
+    return m_systems.size();
+}
+
+std::size_t SystemScheduler::workerCount() const noexcept {
+    return m_executor.num_workers();
+}
+
+FrameArena &SystemScheduler::workerArena() noexcept {
+    int worker = m_executor.this_worker_id();
+    return m_workerArenas[worker < 0 ? m_workerArenas.size() - 1 : static_cast<std::size_t>(worker)];
+}
+
+FrameArenaSet &SystemScheduler::workerArenas() noexcept {
+    return m_workerArenas;
+}
+
+const std::string &SystemScheduler::systemName(SystemId id) const {
+    return systemAt(id).name;
+}
+
+double SystemScheduler::lastDuration(SystemId id) const {
+    return systemAt(id).lastDuration;
+}
+
+const LatencyHistogram &SystemScheduler::durations(SystemId id) const {
+    return systemAt(id).durations;
+}
+
+const SystemScheduler::System &SystemScheduler::systemAt(SystemId id) const {
+    if (id >= m_systems.size()) {
+        throw std::out_of_range(fmt::format("unknown system id {}", id));
+    }
+    return m_systems[id];
+}
+
+uint32_t SystemScheduler::pickPhase(uint32_t rateDivisor) const {
+    if (rateDivisor == 1) {
+        return 0;
+    }
+    // Two slow systems share a tick once every lcm(divisors) updates if their
+    // phases agree modulo the gcd, and never otherwise. Take the phase that
+    // shares the fewest ticks with the slow systems already registered.
+    uint32_t best = 0;
+    double bestOverlap = 0.0;
+    for (uint32_t phase = 0; phase < rateDivisor; ++phase) {
+        double overlap = 0.0;
+        for (const auto &system : m_systems) {
+            if (system.rateDivisor == 1) {
+                continue;
+            }
+            auto gcd = std::gcd(rateDivisor, system.rateDivisor);
+            if (phase % gcd == system.phase % gcd) {
+                overlap += 1.0 / static_cast<double>(std::lcm<uint64_t>(rateDivisor, system.rateDivisor));
+            }
+        }
+        if (phase == 0 || overlap < bestOverlap) {
+            best = phase;
+            bestOverlap = overlap;
+        }
+    }
+    return best;
+}
+
+bool SystemScheduler::listenersChanged(entt::registry &registry) const {
+    return std::any_of(m_systems.begin(), m_systems.end(), [&registry](const System &system) {
+        return system.access.writesListenedPool(registry) != system.writesListened;
+    });
+}
+
+void SystemScheduler::rebuildGraph(entt::registry &registry) {
+    m_taskflow.clear();
+    m_registry = &registry;
+
+    std::vector<tf::Task> tasks;
+    tasks.reserve(m_systems.size());
+    std::size_t edges = 0;
+
+    for (std::size_t i = 0; i < m_systems.size(); ++i) {
+        auto &system = m_systems[i];
+        system.access.prepare(registry);
+        system.writesListened = system.access.writesListenedPool(registry);
+
+        auto task = m_taskflow.emplace([this, &system]() { runSystem(system); }).name(system.name);
+
+        // Depending on every earlier conflicting system (not just the nearest)
+        // keeps the ordering correct when the chain passes through a
+        // non-conflicting neighbour. Taskflow tolerates the redundant edges.
+        // Listeners on different pools may share state, so two writers of
+        // listened pools are ordered even when their pools are disjoint.
+        for (std::size_t j = 0; j < i; ++j) {
+            if (m_systems[j].access.conflictsWith(system.access) ||
+                (m_systems[j].writesListened && system.writesListened)) {
+                tasks[j].precede(task);
+                ++edges;
+            }
+        }
+        tasks.push_back(task);
+    }
+
+    m_graphDirty = false;
+    TLOG_DEBUG("systems", "Rebuilt system graph: {} systems, {} dependencies", m_systems.size(), edges);
+}
+
+void SystemScheduler::runSystem(System &system) {
+    if (!system.due) {
+        return;
+    }
+
+    PROFILE_ZONE_NAMED(system.profileName);
+    Timer timer;
+    try {
+        system.fn(*m_registry, std::exchange(system.pendingDt, 0.0f));
+    } catch (...) {
+        // Exceptions must not escape a worker thread; hand the first one back
+        // to update() so it surfaces on the game loop thread.
+        std::lock_guard lock(m_failureMutex);
+        if (!m_failure) {
+            m_failure = std::current_exception();
+        }
+    }
+
+    // Each system runs on one task per update, so its own fields need no lock.
+    system.lastDuration = timer.elapsedSeconds();
+    system.durations.record(system.lastDuration);
+}
+
+} // namespace void_crew::server
@@ -0,0 +1,205 @@
+#pragma once
+
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <entt/entt.hpp>
+#include <taskflow/taskflow.hpp>
+
+#include "frame_arena.hpp"
+#include "latency_histogram.hpp"
+
+namespace void_crew::server {
+
+/// Declares which component pools a system touches.
+///
+/// Two systems conflict when one writes a pool the other reads or writes, or
+/// when either is exclusive. Conflicting systems run in registration order;
+/// everything else may run in parallel.
+///
+/// Writes also reach the registry's on_update listeners, which run on the
+/// writing thread and may share state across pools (ComponentLayout,
+/// WorldChecksum). SystemScheduler therefore also orders any two systems that
+/// both write pools with listeners; see writesListenedPool().
+class SystemAccess {
+public:
+    template <typename... Components>
+    SystemAccess &reads() {
+        (addComponent<Components>(m_reads), ...);
+        return *this;
+    }
+
+    template <typename... Components>
+    SystemAccess &writes() {
+        (addComponent<Components>(m_writes), ...);
+        return *this;
+    }
+
+    /// Marks the system as touching the registry structurally (creating or
+    /// destroying entities, adding or removing components). Exclusive systems
+    /// never overlap with any other system.
+    SystemAccess &exclusive() noexcept {
+        m_exclusive = true;
+        return *this;
+    }
+
+    bool conflictsWith(const SystemAccess &other) const noexcept;
+
+    /// True if a pool this system writes has on_update listeners in
+    /// @p registry. Structural changes fire the other signals, but those
+    /// systems are exclusive already.
+    bool writesListenedPool(entt::registry &registry) const;
+
+    /// Creates every declared pool up front. EnTT creates pools lazily on the
+    /// first view, which is a structural change and not safe from workers.
+    void prepare(entt::registry &registry) const;
+
+private:
+    using PoolFactory = void (*)(entt::registry &);
+    using ListenerProbe = bool (*)(entt::registry &);
+
+    struct Component {
+        entt::id_type id;
+        PoolFactory assure;
+        ListenerProbe listened;
+    };
+
+    template <typename Component>
+    static void assurePool(entt::registry &registry) {
+        static_cast<void>(registry.storage<Component>());
+    }
+
+    template <typename Component>
+    static bool hasUpdateListeners(entt::registry &registry) {
+        return !registry.on_update<Component>().empty();
+    }
+
+    template <typename Type>
+    static void addComponent(std::vector<Component> &into) {
+        into.push_back({entt::type_hash<Type>::value(), &assurePool<Type>, &hasUpdateListeners<Type>});
+    }
+
+    static bool overlaps(const std::vector<Component> &lhs, const std::vector<Component> &rhs) noexcept;
+
+    std::vector<Component> m_reads;
+    std::vector<Component> m_writes;
+    bool m_exclusive = false;
+};
+
+/// Runs ECS systems once per tick on a work-stealing thread pool.
+///
+/// Systems declare their component access when registered. Before the first
+/// update after any registration the scheduler builds a dependency graph:
+/// a system depends on every earlier conflicting system, so registration order
+/// is the tie-breaker for writers. Non-conflicting systems run concurrently.
+/// Writers of pools with on_update listeners count as conflicting with each
+/// other, so listeners never run on two threads at once. The graph is rebuilt
+/// when a written pool gains or loses its last listener.
+///
+/// Systems that need not run every tick (needs, atmosphere, the event
+/// generator) declare a rate divisor and run on every Nth update only, with
+/// dt covering the whole interval. Each gets a phase chosen so slow systems
+/// land on different ticks wherever their divisors allow, which keeps their
+/// cost from piling up on one tick. A tick with nothing due skips the pool.
+///
+/// Every run is wrapped in a profiler zone named after the system and timed,
+/// so a slow tick can be attributed to the system that caused it.
+///
+/// Each worker, and the game loop thread, has a frame arena of its own for
+/// scratch data a system needs during its run (see workerArena()).
+///
+/// update() must be called from a single thread (the game loop thread).
+class SystemScheduler {
+public:
+    using SystemId = uint32_t;
+    using SystemFn = std::function<void(entt::registry &, float)>;
+
+    /// @param workerThreads  Worker pool size; 0 selects hardware concurrency.
+    explicit SystemScheduler(uint32_t workerThreads = 0);
+
+    SystemScheduler(const SystemScheduler &) = delete;
+    SystemScheduler(SystemScheduler &&) = delete;
+    SystemScheduler &operator=(const SystemScheduler &) = delete;
+    SystemScheduler &operator=(SystemScheduler &&) = delete;
+
+    /// Registers a system. Takes effect from the next update().
+    ///
+    /// @param rateDivisor  Run on one update in this many, with the dt of all
+    ///                     of them summed. Throws std::invalid_argument if 0.
+    SystemId addSystem(std::string name, SystemAccess access, SystemFn fn, uint32_t rateDivisor = 1);
+
+    /// Disabled systems keep their place in the graph but are skipped.
+    void setEnabled(SystemId id, bool enabled);
+    bool isEnabled(SystemId id) const;
+
+    uint32_t rateDivisor(SystemId id) const;
+
+    /// Updates on which the system runs, counted modulo its divisor.
+    uint32_t phase(SystemId id) const;
+
+    /// Runs all enabled systems once and blocks until they finish.
+    void update(entt::registry &registry, float dt);
+
+    std::size_t systemCount() const noexcept;
+    std::size_t workerCount() const noexcept;
+
+    /// Frame arena of the calling thread: a worker's own, or the game loop
+    /// thread's when called outside the pool. Valid for the current tick only;
+    /// register workerArenas() with GameLoop::resetEachTick().
+    FrameArena &workerArena() noexcept;
+
+    /// One arena per worker plus one for the game loop thread (the last).
+    FrameArenaSet &workerArenas() noexcept;
+
+    const std::string &systemName(SystemId id) const;
+
+    /// Wall time of the system's run in the last update(), in seconds.
+    /// Zero if it has not run yet or did not run in that update.
+    double lastDuration(SystemId id) const;
+
+    /// Wall time of every run since registration.
+    const LatencyHistogram &durations(SystemId id) const;
+
+private:
+    struct System {
+        std::string name;
+        SystemAccess access;
+        SystemFn fn;
+        const char *profileName = nullptr; // interned copy of name for profiler zones
+        uint32_t rateDivisor = 1;
+        uint32_t phase = 0;
+        bool enabled = true;
+        bool due = false;       // runs in the current update
+        float pendingDt = 0.0f; // time since its last run
+        bool writesListened = false; // as of the last graph build
+        double lastDuration = 0.0;
+        LatencyHistogram durations;
+    };
+
+    const System &systemAt(SystemId id) const;
+    uint32_t pickPhase(uint32_t rateDivisor) const;
+
+    bool listenersChanged(entt::registry &registry) const;
+    void rebuildGraph(entt::registry &registry);
+    void runSystem(System &system);
+
+    std::vector<System> m_systems;
+    tf::Executor m_executor;
+    FrameArenaSet m_workerArenas; // sized from m_executor
+    tf::Taskflow m_taskflow;
+    bool m_graphDirty = true;
+    uint64_t m_updates = 0;
+
+    // Registry whose pools the graph was prepared for. Tasks read it during
+    // update().
+    entt::registry *m_registry = nullptr;
+
+    std::mutex m_failureMutex;
+    std::exception_ptr m_failure;
+};
+
+} // namespace void_crew::server
@@ -0,0 +1,101 @@
+#include "time_slicer.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace void_crew::server {
+
+namespace {
+
+constexpr double COST_SMOOTHING = 0.1; // weight of the newest cost sample
+constexpr double ORDER_SLACK = 1.5;    // order this many times the estimate up front
+
+} // namespace
+
+TimeSlicer::TimeSlicer(TimeSlicerConfig config) : m_config(config) {}
+
+void TimeSlicer::setFocus(std::span<const glm::vec3> points) {
+    m_focus.assign(points.begin(), points.end());
+}
+
+float TimeSlicer::pendingDt(entt::entity entity) const {
+    auto it = m_slots.find(entity);
+    return it == m_slots.end() ? 0.0f : it->second.pendingDt;
+}
+
+const TimeSlicerConfig &TimeSlicer::config() const noexcept {
+    return m_config;
+}
+
+TimeSlicerStats TimeSlicer::stats() const noexcept {
+    return m_stats;
+}
+
+void TimeSlicer::begin() {
+    ++m_updates;
+    m_candidates.clear();
+}
+
+void TimeSlicer::consider(entt::entity entity, float dt, const glm::vec3 *position) {
+    auto &slot = m_slots[entity];
+    slot.pendingDt += dt;
+    slot.seen = m_updates;
+
+    float weight = 1.0f;
+    if (position != nullptr && !m_focus.empty()) {
+        float nearest = std::numeric_limits<float>::max();
+        for (const auto &point : m_focus) {
+            auto d = *position - point;
+            nearest = std::min(nearest, glm::dot(d, d));
+        }
+        float falloff = m_config.falloffDistance / (m_config.falloffDistance + std::sqrt(nearest));
+        weight += (m_config.nearWeight - 1.0f) * falloff;
+    }
+    m_candidates.push_back({entity, &slot, slot.pendingDt * weight});
+}
+
+std::size_t TimeSlicer::order(std::size_t from) {
+    auto byUrgency = [](const Candidate &lhs, const Candidate &rhs) { return lhs.urgency > rhs.urgency; };
+    auto first = m_candidates.begin() + static_cast<std::ptrdiff_t>(from);
+
+    // Only the head that fits the budget needs to be in order. Guess its size
+    // from the measured cost; if the guess falls short the rest is ordered too.
+    std::size_t expected = m_candidates.size() - from;
+    if (from == 0 && m_stats.costPerEntity > 0.0) {
+        auto fits = static_cast<std::size_t>(std::ceil(m_config.budgetSeconds / m_stats.costPerEntity * ORDER_SLACK));
+        expected = std::min(expected, std::max({fits, m_config.minPerUpdate, std::size_t{1}}));
+    }
+    auto middle = first + static_cast<std::ptrdiff_t>(expected);
+    if (middle != m_candidates.end()) {
+        std::nth_element(first, middle, m_candidates.end(), byUrgency);
+    }
+    std::sort(first, middle, byUrgency);
+    return from + expected;
+}
+
+void TimeSlicer::finish(std::size_t processed, double scanSeconds, double seconds) {
+    if (processed > 0) {
+        double cost = (seconds - scanSeconds) / static_cast<double>(processed);
+        m_stats.costPerEntity = m_stats.costPerEntity == 0.0
+                                    ? cost
+                                    : m_stats.costPerEntity + COST_SMOOTHING * (cost - m_stats.costPerEntity);
+    }
+
+    float maxPending = 0.0f;
+    for (std::size_t i = processed; i < m_candidates.size(); ++i) {
+        maxPending = std::max(maxPending, m_candidates[i].slot->pendingDt);
+    }
+
+    // Entities that left the view (destroyed, lost the component) are forgotten.
+    if (m_slots.size() > m_candidates.size()) {
+        std::erase_if(m_slots, [this](const auto &entry) { return entry.second.seen != m_updates; });
+    }
+
+    m_stats.considered = m_candidates.size();
+    m_stats.processed = processed;
+    m_stats.maxPendingDt = maxPending;
+    m_stats.lastSeconds = seconds;
+}
+
+} // namespace void_crew::server
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+#include <entt/entt.hpp>
+#include <glm/glm.hpp>
+
+#include "components.hpp"
+#include "timer.hpp"
+
+namespace void_crew::server {
+
+struct TimeSlicerConfig {
+    double budgetSeconds = 0.002;  // per update(), candidate scan included
+    std::size_t minPerUpdate = 1;  // processed even when the budget is gone
+    float nearWeight = 8.0f;       // urgency multiplier right next to a focus point
+    float falloffDistance = 15.0f; // metres at which the extra urgency halves
+};
+
+struct TimeSlicerStats {
+    std::size_t considered = 0; // entities in the view
+    std::size_t processed = 0;  // updated in the last update()
+    float maxPendingDt = 0.0f;  // oldest backlog left behind, seconds
+    double lastSeconds = 0.0;   // wall time of the last update()
+    double costPerEntity = 0.0; // smoothed seconds per processed entity
+};
+
+/// Amortizes expensive per-entity work (behaviour trees, perception) over
+/// ticks under a wall-clock budget.
+///
+/// Every entity in the view owes the time since it was last processed. Its
+/// urgency is that debt times a weight that grows towards the focus points
+/// (players): nearby creatures are processed every few ticks, distant ones
+/// whenever their debt outgrows the rest, so the whole set rotates and no one
+/// starves. Each update() processes entities in order of urgency until the
+/// budget runs out, passing each the accumulated dt, so tick cost stays flat
+/// as a GM swarm grows and only the update rate per creature drops.
+///
+/// Ordering costs O(n) plus a sort of the few expected to fit the budget,
+/// estimated from the measured cost per entity. Game thread only, or one
+/// slicer per system.
+class TimeSlicer {
+public:
+    explicit TimeSlicer(TimeSlicerConfig config = {});
+
+    /// Points urgency is measured from, usually player positions. Copied.
+    void setFocus(std::span<const glm::vec3> points);
+
+    /// Calls @p fn(entity, dt) for the most urgent entities of
+    /// registry.view<Component...>() within the budget; @p dt is the time
+    /// since that entity was last processed. Entities without a Transform
+    /// get the base urgency.
+    template <typename... Component, typename Fn>
+    void update(entt::registry &registry, float dt, Fn &&fn);
+
+    /// Time @p entity has been waiting, 0 if it is unknown.
+    float pendingDt(entt::entity entity) const;
+
+    const TimeSlicerConfig &config() const noexcept;
+    TimeSlicerStats stats() const noexcept;
+
+private:
+    struct Slot {
+        float pendingDt = 0.0f;
+        uint64_t seen = 0; // update that last saw the entity
+    };
+
+    struct Candidate {
+        entt::entity entity = entt::null;
+        Slot *slot = nullptr; // unordered_map nodes are stable
+        float urgency = 0.0f;
+    };
+
+    void begin();
+    void consider(entt::entity entity, float dt, const glm::vec3 *position);
+    std::size_t order(std::size_t from);
+    void finish(std::size_t processed, double scanSeconds, double seconds);
+
+    TimeSlicerConfig m_config;
+    std::vector<glm::vec3> m_focus;
+
+    std::unordered_map<entt::entity, Slot> m_slots;
+    std::vector<Candidate> m_candidates;
+    uint64_t m_updates = 0;
+
+    TimeSlicerStats m_stats;
+};
+
+template <typename... Component, typename Fn>
+void TimeSlicer::update(entt::registry &registry, float dt, Fn &&fn) {
+    Timer timer;
+    begin();
+    for (auto entity : registry.view<Component...>()) {
+        const auto *transform = registry.try_get<Transform>(entity);
+        consider(entity, dt, transform != nullptr ? &transform->position : nullptr);
+    }
+
+    std::size_t processed = 0;
+    std::size_t ordered = order(0);
+    double scanned = timer.elapsedSeconds();
+    while (processed < m_candidates.size()) {
+        if (processed >= m_config.minPerUpdate && timer.elapsedSeconds() >= m_config.budgetSeconds) {
+            break;
+        }
+        if (processed == ordered) {
+            ordered = order(ordered); // the estimate fell short: order the rest
+        }
+        auto &candidate = m_candidates[processed++];
+        float owed = candidate.slot->pendingDt;
+        candidate.slot->pendingDt = 0.0f;
+        if (registry.valid(candidate.entity)) { // an earlier fn may have destroyed it
+            fn(candidate.entity, owed);
+        }
+    }
+    finish(processed, scanned, timer.elapsedSeconds());
+}
+
+} // namespace void_crew::server
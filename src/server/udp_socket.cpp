@@ -0,0 +1,270 @@
+#include "udp_socket.hpp"
+
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+
+#include <fmt/format.h>
+
+#ifdef _WIN32
+#include <mutex>
+
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace void_crew::server {
+
+namespace {
+
+#ifdef _WIN32
+using NativeSocket = SOCKET;
+using AddressLength = int;
+const std::intptr_t INVALID_NATIVE_SOCKET = static_cast<std::intptr_t>(INVALID_SOCKET);
+
+void initializeSockets() {
+    static std::once_flag s_once;
+    std::call_once(s_once, []() {
+        WSADATA data;
+        if (WSAStartup(MAKEWORD(2, 2), &data) != 0) {
+            throw std::runtime_error("UDP socket: WSAStartup failed");
+        }
+    });
+}
+
+int lastSocketError() {
+    return WSAGetLastError();
+}
+
+std::string socketErrorText(int error) {
+    return fmt::format("WSA error {}", error);
+}
+
+void closeSocket(NativeSocket socket) {
+    ::closesocket(socket);
+}
+
+bool setNonBlocking(NativeSocket socket) {
+    u_long enabled = 1;
+    return ::ioctlsocket(socket, FIONBIO, &enabled) == 0;
+}
+#else
+using NativeSocket = int;
+using AddressLength = socklen_t;
+constexpr std::intptr_t INVALID_NATIVE_SOCKET = -1;
+
+void initializeSockets() {}
+
+int lastSocketError() {
+    return errno;
+}
+
+std::string socketErrorText(int error) {
+    return std::strerror(error);
+}
+
+void closeSocket(NativeSocket socket) {
+    ::close(socket);
+}
+
+bool setNonBlocking(NativeSocket socket) {
+    int flags = ::fcntl(socket, F_GETFL, 0);
+    return flags >= 0 && ::fcntl(socket, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+#endif
+
+NativeSocket native(std::intptr_t socket) {
+    return static_cast<NativeSocket>(socket);
+}
+
+sockaddr_in toSockaddr(Endpoint endpoint) {
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(endpoint.address);
+    addr.sin_port = htons(endpoint.port);
+    return addr;
+}
+
+Endpoint fromSockaddr(const sockaddr_in &addr) {
+    return {ntohl(addr.sin_addr.s_addr), ntohs(addr.sin_port)};
+}
+
+std::runtime_error socketError(const std::string &what) {
+    return std::runtime_error(fmt::format("UDP socket: {} failed: {}", what, socketErrorText(lastSocketError())));
+}
+
+} // namespace
+
+Endpoint Endpoint::any(uint16_t port) noexcept {
+    return {INADDR_ANY, port};
+}
+
+Endpoint Endpoint::loopback(uint16_t port) noexcept {
+    return {INADDR_LOOPBACK, port};
+}
+
+std::string Endpoint::toString() const {
+    return fmt::format("{}.{}.{}.{}:{}", (address >> 24) & 0xFF, (address >> 16) & 0xFF, (address >> 8) & 0xFF,
+                       address & 0xFF, port);
+}
+
+struct UdpSocket::Batch {
+    std::array<sockaddr_in, MAX_BATCH> addresses{};
+#ifdef __linux__
+    std::array<iovec, MAX_BATCH> vectors{};
+    std::array<mmsghdr, MAX_BATCH> headers{};
+#endif
+};
+
+UdpSocket::UdpSocket(Endpoint local, int bufferBytes)
+    : m_socket(INVALID_NATIVE_SOCKET),
+      m_batch(std::make_unique<Batch>()) {
+    initializeSockets();
+
+    auto socket = ::socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (static_cast<std::intptr_t>(socket) == INVALID_NATIVE_SOCKET) {
+        throw socketError("socket()");
+    }
+    m_socket = static_cast<std::intptr_t>(socket);
+
+    if (!setNonBlocking(socket)) {
+        auto error = socketError("enabling non-blocking mode");
+        closeSocket(socket);
+        throw error;
+    }
+
+    // Large kernel buffers absorb a whole tick's worth of client packets
+    // between drains. The kernel may clamp these; that is not an error.
+    ::setsockopt(socket, SOL_SOCKET, SO_RCVBUF, reinterpret_cast<const char *>(&bufferBytes), sizeof(bufferBytes));
+    ::setsockopt(socket, SOL_SOCKET, SO_SNDBUF, reinterpret_cast<const char *>(&bufferBytes), sizeof(bufferBytes));
+
+    auto addr = toSockaddr(local);
+    if (::bind(socket, reinterpret_cast<const sockaddr *>(&addr), sizeof(addr)) != 0) {
+        auto error = socketError(fmt::format("bind({})", local.toString()));
+        closeSocket(socket);
+        throw error;
+    }
+
+    sockaddr_in bound{};
+    AddressLength length = sizeof(bound);
+    ::getsockname(socket, reinterpret_cast<sockaddr *>(&bound), &length);
+    m_local = fromSockaddr(bound);
+}
+
+UdpSocket::~UdpSocket() {
+    if (m_socket != INVALID_NATIVE_SOCKET) {
+        closeSocket(native(m_socket));
+    }
+}
+
+Endpoint UdpSocket::localEndpoint() const noexcept {
+    return m_local;
+}
+
+std::size_t UdpSocket::receiveBatch(std::span<Datagram> datagrams) {
+    auto count = std::min(datagrams.size(), MAX_BATCH);
+    auto &batch = *m_batch;
+
+#ifdef __linux__
+    for (std::size_t i = 0; i < count; ++i) {
+        batch.vectors[i] = {datagrams[i].data, datagrams[i].capacity};
+        auto &header = batch.headers[i].msg_hdr;
+        header = {};
+        header.msg_name = &batch.addresses[i];
+        header.msg_namelen = sizeof(sockaddr_in);
+        header.msg_iov = &batch.vectors[i];
+        header.msg_iovlen = 1;
+    }
+
+    int received = ::recvmmsg(native(m_socket), batch.headers.data(), static_cast<unsigned>(count), MSG_DONTWAIT,
+                              nullptr);
+    if (received <= 0) {
+        return 0;
+    }
+    for (int i = 0; i < received; ++i) {
+        datagrams[i].size = batch.headers[i].msg_len;
+        datagrams[i].endpoint = fromSockaddr(batch.addresses[i]);
+    }
+    return static_cast<std::size_t>(received);
+#else
+    std::size_t received = 0;
+    while (received < count) {
+        auto &datagram = datagrams[received];
+        AddressLength length = sizeof(sockaddr_in);
+        auto bytes = ::recvfrom(native(m_socket), reinterpret_cast<char *>(datagram.data),
+                                static_cast<int>(datagram.capacity), 0,
+                                reinterpret_cast<sockaddr *>(&batch.addresses[received]), &length);
+        if (bytes < 0) {
+#ifdef _WIN32
+            // An ICMP port-unreachable for an earlier send surfaces here as
+            // WSAECONNRESET; it says nothing about the next datagram.
+            if (lastSocketError() == WSAECONNRESET) {
+                continue;
+            }
+#endif
+            break;
+        }
+        datagram.size = static_cast<std::size_t>(bytes);
+        datagram.endpoint = fromSockaddr(batch.addresses[received]);
+        ++received;
+    }
+    return received;
+#endif
+}
+
+std::size_t UdpSocket::sendBatch(std::span<const Datagram> datagrams) {
+    auto count = std::min(datagrams.size(), MAX_BATCH);
+    auto &batch = *m_batch;
+
+#ifdef __linux__
+    for (std::size_t i = 0; i < count; ++i) {
+        batch.addresses[i] = toSockaddr(datagrams[i].endpoint);
+        batch.vectors[i] = {datagrams[i].data, datagrams[i].size};
+        auto &header = batch.headers[i].msg_hdr;
+        header = {};
+        header.msg_name = &batch.addresses[i];
+        header.msg_namelen = sizeof(sockaddr_in);
+        header.msg_iov = &batch.vectors[i];
+        header.msg_iovlen = 1;
+    }
+
+    int sent = ::sendmmsg(native(m_socket), batch.headers.data(), static_cast<unsigned>(count), MSG_DONTWAIT);
+    return sent > 0 ? static_cast<std::size_t>(sent) : 0;
+#else
+    std::size_t sent = 0;
+    for (; sent < count; ++sent) {
+        const auto &datagram = datagrams[sent];
+        auto addr = toSockaddr(datagram.endpoint);
+        auto bytes = ::sendto(native(m_socket), reinterpret_cast<const char *>(datagram.data),
+                              static_cast<int>(datagram.size), 0, reinterpret_cast<const sockaddr *>(&addr),
+                              sizeof(addr));
+        if (bytes < 0) {
+            break;
+        }
+    }
+    return sent;
+#endif
+}
+
+bool UdpSocket::waitReadable(std::chrono::milliseconds timeout) const {
+#ifdef _WIN32
+    WSAPOLLFD descriptor{native(m_socket), POLLRDNORM, 0};
+    int ready = ::WSAPoll(&descriptor, 1, static_cast<int>(timeout.count()));
+    return ready > 0 && (descriptor.revents & POLLRDNORM) != 0;
+#else
+    pollfd descriptor{native(m_socket), POLLIN, 0};
+    int ready = ::poll(&descriptor, 1, static_cast<int>(timeout.count()));
+    return ready > 0 && (descriptor.revents & POLLIN) != 0;
+#endif
+}
+
+} // namespace void_crew::server
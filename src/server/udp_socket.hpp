@@ -0,0 +1,84 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <span>
+#include <string>
+
+namespace void_crew::server {
+
+/// IPv4 address and port, both in host byte order.
+struct Endpoint {
+    uint32_t address = 0;
+    uint16_t port = 0;
+
+    static Endpoint any(uint16_t port) noexcept;
+    static Endpoint loopback(uint16_t port) noexcept;
+
+    std::string toString() const;
+
+    bool operator==(const Endpoint &) const noexcept = default;
+};
+
+struct EndpointHash {
+    std::size_t operator()(const Endpoint &endpoint) const noexcept {
+        return std::hash<uint64_t>{}((uint64_t{endpoint.address} << 16) | endpoint.port);
+    }
+};
+
+/// One datagram in a batch. Points into caller-owned storage: for receives
+/// @c data / @c capacity describe the buffer and @c size / @c endpoint are
+/// filled in; for sends @c size bytes of @c data go to @c endpoint.
+struct Datagram {
+    std::byte *data = nullptr;
+    std::size_t capacity = 0;
+    std::size_t size = 0;
+    Endpoint endpoint;
+};
+
+/// Non-blocking IPv4 UDP socket with batched I/O.
+///
+/// On Linux a batch is a single recvmmsg/sendmmsg call; other platforms fall
+/// back to a recvfrom/sendto loop with the same interface. The message headers
+/// for a full batch are allocated once at construction, so batched calls do
+/// not allocate.
+class UdpSocket {
+public:
+    static constexpr std::size_t MAX_BATCH = 64;
+    static constexpr int DEFAULT_BUFFER_BYTES = 4 * 1024 * 1024;
+
+    /// Binds to @p local (port 0 picks an ephemeral port).
+    /// Throws std::runtime_error if the socket cannot be created or bound.
+    explicit UdpSocket(Endpoint local, int bufferBytes = DEFAULT_BUFFER_BYTES);
+    ~UdpSocket();
+
+    UdpSocket(const UdpSocket &) = delete;
+    UdpSocket &operator=(const UdpSocket &) = delete;
+    UdpSocket(UdpSocket &&) = delete;
+    UdpSocket &operator=(UdpSocket &&) = delete;
+
+    Endpoint localEndpoint() const noexcept;
+
+    /// Receives up to min(datagrams.size(), MAX_BATCH) pending datagrams
+    /// without blocking. Returns how many entries were filled.
+    std::size_t receiveBatch(std::span<Datagram> datagrams);
+
+    /// Sends up to MAX_BATCH datagrams. Returns how many were handed to the
+    /// kernel; stops early if the send buffer is full.
+    std::size_t sendBatch(std::span<const Datagram> datagrams);
+
+    /// Blocks until a datagram is readable or @p timeout expires.
+    bool waitReadable(std::chrono::milliseconds timeout) const;
+
+private:
+    struct Batch;
+
+    std::intptr_t m_socket; // int fd on POSIX, SOCKET on Windows
+    Endpoint m_local;
+    std::unique_ptr<Batch> m_batch;
+};
+
+} // namespace void_crew::server
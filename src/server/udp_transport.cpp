@@ -0,0 +1,396 @@
+#include "udp_transport.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace void_crew::server {
+
+namespace {
+
+// Message framing inside a packet:
+//   [u8 flags][u16 reliable id, if FLAG_RELIABLE][u16 size][size bytes]
+constexpr uint8_t FLAG_RELIABLE = 0x01;
+constexpr std::size_t UNRELIABLE_OVERHEAD = 3;
+constexpr std::size_t RELIABLE_OVERHEAD = 5;
+
+// messageCount is a u8; leave room for the reliable messages flush() adds.
+constexpr std::size_t MAX_UNRELIABLE_PER_PACKET = 255 - ReliableChannel::MAX_MESSAGES_PER_PACKET;
+
+// Bounds one receive() call so a flood cannot starve flush().
+constexpr std::size_t MAX_RECEIVE_BATCHES = 16;
+
+void writeU16(std::byte *out, uint16_t value) noexcept {
+    out[0] = static_cast<std::byte>(value & 0xFF);
+    out[1] = static_cast<std::byte>(value >> 8);
+}
+
+uint16_t readU16(const std::byte *in) noexcept {
+    return static_cast<uint16_t>(std::to_integer<uint16_t>(in[0]) | (std::to_integer<uint16_t>(in[1]) << 8));
+}
+
+} // namespace
+
+UdpTransport::UdpTransport(const TransportConfig &config, TransportCallbacks callbacks)
+    : m_config(config),
+      m_callbacks(std::move(callbacks)),
+      m_socket(config.local),
+      m_pool(config.poolSize),
+      m_receiveBuffers(UdpSocket::MAX_BATCH),
+      m_receiveBatch(UdpSocket::MAX_BATCH) {
+    for (std::size_t i = 0; i < m_receiveBatch.size(); ++i) {
+        m_receiveBatch[i].data = m_receiveBuffers[i].data.data();
+        m_receiveBatch[i].capacity = MAX_PACKET_SIZE;
+    }
+    m_sendBatch.reserve(UdpSocket::MAX_BATCH);
+    m_outgoing.reserve(config.poolSize);
+    m_closing.reserve(config.maxConnections);
+    m_connections.reserve(config.maxConnections);
+    m_byEndpoint.reserve(config.maxConnections);
+}
+
+UdpTransport::~UdpTransport() = default;
+
+Endpoint UdpTransport::localEndpoint() const noexcept {
+    return m_socket.localEndpoint();
+}
+
+std::optional<ConnectionId> UdpTransport::connect(Endpoint remote) {
+    if (auto it = m_byEndpoint.find(remote); it != m_byEndpoint.end()) {
+        return it->second;
+    }
+    if (m_connections.size() >= m_config.maxConnections) {
+        return std::nullopt;
+    }
+    return addConnection(remote)->id;
+}
+
+void UdpTransport::disconnect(ConnectionId id) {
+    if (auto *connection = find(id)) {
+        connection->closed = true;
+    }
+}
+
+bool UdpTransport::isConnected(ConnectionId id) const {
+    auto *connection = find(id);
+    return connection != nullptr && !connection->closed;
+}
+
+std::size_t UdpTransport::connectionCount() const noexcept {
+    return static_cast<std::size_t>(std::count_if(m_connections.begin(), m_connections.end(),
+                                                  [](const auto &entry) { return !entry.second->closed; }));
+}
+
+std::size_t UdpTransport::receive() {
+    double timestamp = now();
+    std::size_t received = 0;
+
+    for (std::size_t batch = 0; batch < MAX_RECEIVE_BATCHES; ++batch) {
+        auto count = m_socket.receiveBatch(m_receiveBatch);
+        if (count == 0) {
+            break;
+        }
+        ++m_stats.receiveCalls;
+        for (std::size_t i = 0; i < count; ++i) {
+            ++m_stats.packetsReceived;
+            m_stats.bytesReceived += m_receiveBatch[i].size;
+            handleDatagram(m_receiveBatch[i], timestamp);
+        }
+        received += count;
+        if (count < m_receiveBatch.size()) {
+            break; // socket drained
+        }
+    }
+
+    for (auto &[id, connection] : m_connections) {
+        if (!connection->closed && timestamp - connection->lastReceived > m_config.connectionTimeout) {
+            connection->closed = true;
+        }
+    }
+    removeClosed();
+    return received;
+}
+
+bool UdpTransport::waitReadable(std::chrono::milliseconds timeout) const {
+    return m_socket.waitReadable(timeout);
+}
+
+bool UdpTransport::sendUnreliable(ConnectionId id, std::span<const std::byte> message) {
+    auto *connection = find(id);
+    if (connection == nullptr || connection->closed) {
+        return false;
+    }
+    return appendUnreliable(*connection, message);
+}
+
+bool UdpTransport::sendReliable(ConnectionId id, std::span<const std::byte> message) {
+    auto *connection = find(id);
+    if (connection == nullptr || connection->closed) {
+        return false;
+    }
+    return connection->channel.queueReliable(message);
+}
+
+std::size_t UdpTransport::flush() {
+    double timestamp = now();
+    constexpr std::size_t MAX_RELIABLE_PACKETS =
+        ReliableChannel::MESSAGE_WINDOW / ReliableChannel::MAX_MESSAGES_PER_PACKET + 1;
+
+    for (auto &[id, connection] : m_connections) {
+        if (connection->closed) {
+            continue;
+        }
+        auto &channel = connection->channel;
+        bool keepalive = timestamp - connection->lastSent >= KEEPALIVE_INTERVAL;
+        if (connection->open == nullptr && !channel.ackPending() && !keepalive && !channel.hasDueReliable(timestamp)) {
+            continue;
+        }
+        if (!finalizePacket(*connection, timestamp)) {
+            continue;
+        }
+        // More reliable messages are due than fit in one packet.
+        for (std::size_t extra = 1; extra < MAX_RELIABLE_PACKETS && channel.hasDueReliable(timestamp); ++extra) {
+            if (!finalizePacket(*connection, timestamp)) {
+                break;
+            }
+        }
+    }
+
+    auto sent = sendQueued();
+    removeClosed();
+    return sent;
+}
+
+double UdpTransport::rtt(ConnectionId id) const {
+    auto *connection = find(id);
+    return connection != nullptr ? connection->channel.rtt() : 0.0;
+}
+
+TransportStats UdpTransport::stats() const {
+    auto stats = m_stats;
+    stats.poolExhausted = m_pool.exhaustedCount();
+    for (const auto &[id, connection] : m_connections) {
+        stats.resentMessages += connection->channel.resentMessages();
+    }
+    return stats;
+}
+
+UdpTransport::Connection *UdpTransport::find(ConnectionId id) const {
+    auto it = m_connections.find(id);
+    return it != m_connections.end() ? it->second.get() : nullptr;
+}
+
+UdpTransport::Connection *UdpTransport::addConnection(Endpoint endpoint) {
+    auto connection = std::make_unique<Connection>();
+    connection->id = m_nextConnectionId++;
+    connection->endpoint = endpoint;
+    connection->lastReceived = now();
+
+    auto *raw = connection.get();
+    m_byEndpoint.emplace(endpoint, raw->id);
+    m_connections.emplace(raw->id, std::move(connection));
+    return raw;
+}
+
+void UdpTransport::removeClosed() {
+    m_closing.clear();
+    for (const auto &[id, connection] : m_connections) {
+        if (connection->closed) {
+            m_closing.push_back(id);
+        }
+    }
+
+    for (auto id : m_closing) {
+        auto it = m_connections.find(id);
+        auto &connection = *it->second;
+        if (connection.open != nullptr) {
+            m_pool.release(connection.open);
+        }
+        m_stats.resentMessages += connection.channel.resentMessages();
+        m_byEndpoint.erase(connection.endpoint);
+        m_connections.erase(it);
+        if (m_callbacks.onDisconnect) {
+            m_callbacks.onDisconnect(id);
+        }
+    }
+}
+
+void UdpTransport::handleDatagram(const Datagram &datagram, double now) {
+    std::span<const std::byte> packet(datagram.data, datagram.size);
+    auto header = readPacketHeader(packet);
+    if (!header || header->protocolId != PROTOCOL_ID) {
+        ++m_stats.invalidPackets;
+        return;
+    }
+
+    Connection *connection = nullptr;
+    bool accepted = false;
+    if (auto it = m_byEndpoint.find(datagram.endpoint); it != m_byEndpoint.end()) {
+        connection = find(it->second);
+    } else if (m_config.acceptConnections && m_connections.size() < m_config.maxConnections) {
+        connection = addConnection(datagram.endpoint);
+        accepted = true;
+    } else {
+        ++m_stats.invalidPackets;
+        return;
+    }
+
+    if (connection->closed) {
+        return;
+    }
+    if (!connection->channel.onPacketReceived(*header, now)) {
+        ++m_stats.duplicatePackets;
+        return;
+    }
+    connection->lastReceived = now;
+
+    // Callbacks may disconnect() or connect(); connections are heap-allocated
+    // and only removed in removeClosed(), so the pointer stays valid here.
+    auto id = connection->id;
+    if (accepted && m_callbacks.onConnect) {
+        m_callbacks.onConnect(id, datagram.endpoint);
+    }
+
+    std::size_t offset = PACKET_HEADER_SIZE;
+    for (uint8_t i = 0; i < header->messageCount; ++i) {
+        if (offset + UNRELIABLE_OVERHEAD > packet.size()) {
+            ++m_stats.invalidPackets;
+            break;
+        }
+        bool reliable = (std::to_integer<uint8_t>(packet[offset]) & FLAG_RELIABLE) != 0;
+        if (reliable && offset + RELIABLE_OVERHEAD > packet.size()) {
+            ++m_stats.invalidPackets;
+            break;
+        }
+        uint16_t reliableId = reliable ? readU16(packet.data() + offset + 1) : 0;
+        offset += reliable ? 3 : 1;
+        std::size_t size = readU16(packet.data() + offset);
+        offset += 2;
+        if (offset + size > packet.size()) {
+            ++m_stats.invalidPackets;
+            break;
+        }
+
+        auto message = packet.subspan(offset, size);
+        offset += size;
+        if (reliable) {
+            connection->channel.receiveReliable(reliableId, message);
+        } else if (m_callbacks.onMessage) {
+            m_callbacks.onMessage(id, message, Delivery::Unreliable);
+        }
+    }
+
+    connection->channel.deliverReliable([&](std::span<const std::byte> message) {
+        if (m_callbacks.onMessage) {
+            m_callbacks.onMessage(id, message, Delivery::Reliable);
+        }
+    });
+}
+
+bool UdpTransport::appendUnreliable(Connection &connection, std::span<const std::byte> message) {
+    if (message.size() > MAX_MESSAGE_SIZE) {
+        return false;
+    }
+
+    auto *open = connection.open;
+    if (open != nullptr &&
+        (open->size + UNRELIABLE_OVERHEAD + message.size() > MAX_PACKET_SIZE ||
+         connection.openMessages >= MAX_UNRELIABLE_PER_PACKET)) {
+        finalizePacket(connection, now());
+        open = nullptr;
+    }
+    if (open == nullptr) {
+        open = m_pool.acquire();
+        if (open == nullptr) {
+            return false;
+        }
+        open->size = PACKET_HEADER_SIZE;
+        connection.open = open;
+    }
+
+    auto *out = open->data.data() + open->size;
+    out[0] = std::byte{0};
+    writeU16(out + 1, static_cast<uint16_t>(message.size()));
+    if (!message.empty()) {
+        std::memcpy(out + UNRELIABLE_OVERHEAD, message.data(), message.size());
+    }
+    open->size += UNRELIABLE_OVERHEAD + message.size();
+    ++connection.openMessages;
+    return true;
+}
+
+bool UdpTransport::finalizePacket(Connection &connection, double now) {
+    auto *buffer = connection.open;
+    connection.open = nullptr;
+    if (buffer == nullptr) {
+        buffer = m_pool.acquire();
+        if (buffer == nullptr) {
+            return false;
+        }
+        buffer->size = PACKET_HEADER_SIZE;
+    }
+
+    auto header = connection.channel.beginPacket(now);
+    std::size_t messageCount = connection.openMessages;
+    connection.channel.writeDueReliable(now, [&](uint16_t id, std::span<const std::byte> message) {
+        if (buffer->size + RELIABLE_OVERHEAD + message.size() > MAX_PACKET_SIZE) {
+            return false;
+        }
+        auto *out = buffer->data.data() + buffer->size;
+        out[0] = static_cast<std::byte>(FLAG_RELIABLE);
+        writeU16(out + 1, id);
+        writeU16(out + 3, static_cast<uint16_t>(message.size()));
+        if (!message.empty()) {
+            std::memcpy(out + RELIABLE_OVERHEAD, message.data(), message.size());
+        }
+        buffer->size += RELIABLE_OVERHEAD + message.size();
+        ++messageCount;
+        return true;
+    });
+
+    header.messageCount = static_cast<uint8_t>(messageCount);
+    writePacketHeader(buffer->data, header);
+    connection.openMessages = 0;
+    connection.lastSent = now;
+    m_outgoing.push_back({buffer, connection.endpoint});
+    return true;
+}
+
+std::size_t UdpTransport::sendQueued() {
+    std::size_t sent = 0;
+    std::size_t offset = 0;
+    while (offset < m_outgoing.size()) {
+        m_sendBatch.clear();
+        auto end = std::min(m_outgoing.size(), offset + UdpSocket::MAX_BATCH);
+        for (auto i = offset; i < end; ++i) {
+            auto &packet = m_outgoing[i];
+            m_sendBatch.push_back({packet.buffer->data.data(), MAX_PACKET_SIZE, packet.buffer->size, packet.endpoint});
+        }
+
+        auto count = m_socket.sendBatch(m_sendBatch);
+        ++m_stats.sendCalls;
+        for (std::size_t i = 0; i < count; ++i) {
+            m_stats.bytesSent += m_sendBatch[i].size;
+        }
+        sent += count;
+        offset += count;
+        if (count < m_sendBatch.size()) {
+            // The kernel refused this datagram (buffer full or unreachable);
+            // drop it rather than spin. Reliable messages in it are resent.
+            ++m_stats.sendFailures;
+            ++offset;
+        }
+    }
+
+    for (auto &packet : m_outgoing) {
+        m_pool.release(packet.buffer);
+    }
+    m_outgoing.clear();
+    m_stats.packetsSent += sent;
+    return sent;
+}
+
+double UdpTransport::now() const noexcept {
+    return m_clock.elapsedSeconds();
+}
+
+} // namespace void_crew::server
@@ -0,0 +1,171 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+#include "packet_pool.hpp"
+#include "reliable_channel.hpp"
+#include "timer.hpp"
+#include "udp_socket.hpp"
+
+namespace void_crew::server {
+
+using ConnectionId = uint32_t;
+
+enum class Delivery { Unreliable, Reliable };
+
+struct TransportConfig {
+    Endpoint local = Endpoint::any(0);
+    uint32_t maxConnections = 64;
+    bool acceptConnections = true;     // false for the client side: only connect() creates connections
+    std::size_t poolSize = 1024;       // preallocated outgoing packet buffers
+    double connectionTimeout = 10.0;   // seconds without a packet before a connection is dropped
+};
+
+/// Invoked from receive() (and flush() for disconnects). onConnect fires for
+/// connections accepted from new peers, not for ones opened with connect().
+struct TransportCallbacks {
+    std::function<void(ConnectionId, Endpoint)> onConnect;
+    std::function<void(ConnectionId)> onDisconnect;
+    std::function<void(ConnectionId, std::span<const std::byte>, Delivery)> onMessage;
+};
+
+struct TransportStats {
+    uint64_t packetsSent = 0;
+    uint64_t packetsReceived = 0;
+    uint64_t bytesSent = 0;
+    uint64_t bytesReceived = 0;
+    uint64_t sendCalls = 0;      // sendmmsg (or equivalent) calls
+    uint64_t receiveCalls = 0;   // recvmmsg (or equivalent) calls that returned data
+    uint64_t invalidPackets = 0; // wrong protocol id, truncated, or from an unknown peer when full
+    uint64_t duplicatePackets = 0;
+    uint64_t sendFailures = 0;   // datagrams the kernel refused
+    uint64_t poolExhausted = 0;  // packets dropped because every buffer was in use
+    uint64_t resentMessages = 0; // reliable messages sent more than once
+};
+
+/// Connection-oriented messaging over one UDP socket.
+///
+/// Messages (unreliable or reliable) are packed into datagrams of at most
+/// MAX_PACKET_SIZE bytes; each connection's packets carry the acks of a
+/// ReliableChannel. receive() drains the socket in recvmmsg batches into
+/// preallocated buffers and dispatches messages through TransportCallbacks;
+/// flush() finalizes every connection's pending packet, adds due reliable
+/// messages and bare acks, and sends everything with sendmmsg batches.
+///
+/// The same class serves both ends: the server accepts connections from new
+/// endpoints, a client calls connect(). Driven by one thread; not thread-safe.
+class UdpTransport {
+public:
+    /// Largest unreliable message; reliable ones are capped by
+    /// ReliableChannel::MAX_MESSAGE_SIZE.
+    static constexpr std::size_t MAX_MESSAGE_SIZE = MAX_PACKET_SIZE - PACKET_HEADER_SIZE - 3;
+
+    /// Idle connections still send a packet this often (seconds) so the peer
+    /// does not time them out.
+    static constexpr double KEEPALIVE_INTERVAL = 1.0;
+
+    /// Throws std::runtime_error if the socket cannot be bound.
+    UdpTransport(const TransportConfig &config, TransportCallbacks callbacks);
+    ~UdpTransport();
+
+    UdpTransport(const UdpTransport &) = delete;
+    UdpTransport &operator=(const UdpTransport &) = delete;
+    UdpTransport(UdpTransport &&) = delete;
+    UdpTransport &operator=(UdpTransport &&) = delete;
+
+    Endpoint localEndpoint() const noexcept;
+
+    /// Opens a connection to @p remote; the peer learns of it from the first
+    /// flush(). Returns nullopt when at capacity.
+    std::optional<ConnectionId> connect(Endpoint remote);
+
+    /// Forgets the connection locally (the peer times out). Safe to call from
+    /// callbacks: the connection is removed at the end of receive()/flush().
+    void disconnect(ConnectionId id);
+    bool isConnected(ConnectionId id) const;
+    std::size_t connectionCount() const noexcept;
+
+    /// Receives everything pending on the socket, dispatches it and drops
+    /// timed-out connections. Returns the number of datagrams received.
+    std::size_t receive();
+
+    /// Blocks until a datagram arrives or @p timeout expires.
+    bool waitReadable(std::chrono::milliseconds timeout) const;
+
+    /// Queues a message for the next flush(). Returns false if the connection
+    /// is unknown, the message cannot fit in a packet, or (reliable) the
+    /// reliable window is full.
+    bool sendUnreliable(ConnectionId id, std::span<const std::byte> message);
+    bool sendReliable(ConnectionId id, std::span<const std::byte> message);
+
+    /// Builds and sends all pending packets. Returns datagrams sent.
+    std::size_t flush();
+
+    /// Smoothed RTT of a connection, seconds; 0 for unknown ids.
+    double rtt(ConnectionId id) const;
+
+    TransportStats stats() const;
+
+private:
+    struct Connection {
+        ConnectionId id = 0;
+        Endpoint endpoint;
+        ReliableChannel channel;
+        PacketBuffer *open = nullptr; // unreliable messages waiting for flush()
+        uint8_t openMessages = 0;
+        double lastReceived = 0.0;
+        double lastSent = -1.0e9;     // forces a packet on the first flush()
+        bool closed = false;
+    };
+
+    struct OutgoingPacket {
+        PacketBuffer *buffer;
+        Endpoint endpoint;
+    };
+
+    Connection *find(ConnectionId id) const;
+    Connection *addConnection(Endpoint endpoint);
+    void removeClosed();
+
+    void handleDatagram(const Datagram &datagram, double now);
+
+    /// Appends a framed message to @p connection's open packet, queueing the
+    /// current one first if the message does not fit.
+    bool appendUnreliable(Connection &connection, std::span<const std::byte> message);
+
+    /// Completes @p connection's open packet (or a bare ack/keepalive packet)
+    /// with its header and due reliable messages, and queues it for sending.
+    /// Returns false if no buffer was available.
+    bool finalizePacket(Connection &connection, double now);
+    std::size_t sendQueued();
+
+    double now() const noexcept;
+
+    TransportConfig m_config;
+    TransportCallbacks m_callbacks;
+    UdpSocket m_socket;
+    PacketPool m_pool;
+    Timer m_clock;
+
+    std::unordered_map<ConnectionId, std::unique_ptr<Connection>> m_connections;
+    std::unordered_map<Endpoint, ConnectionId, EndpointHash> m_byEndpoint;
+    ConnectionId m_nextConnectionId = 1;
+
+    // Batch scratch, sized once so receive()/flush() never allocate.
+    std::vector<PacketBuffer> m_receiveBuffers;
+    std::vector<Datagram> m_receiveBatch;
+    std::vector<Datagram> m_sendBatch;
+    std::vector<OutgoingPacket> m_outgoing;
+    std::vector<ConnectionId> m_closing;
+
+    TransportStats m_stats;
+};
+
+} // namespace void_crew::server
@@ -0,0 +1,82 @@
+#include "world_checksum.hpp"
+
+#include <stdexcept>
+
+#include <fmt/format.h>
+
+#include "timer.hpp"
+
+namespace void_crew::server {
+
+WorldChecksum::WorldChecksum(entt::registry &registry) : m_registry(registry) {}
+
+WorldChecksum::~WorldChecksum() {
+    for (auto &pool : m_pools) {
+        pool->disconnect(m_registry, *pool);
+    }
+}
+
+uint64_t WorldChecksum::update() {
+    Timer timer;
+    m_stats.changedPools = 0;
+    m_stats.rehashedComponents = 0;
+
+    bool changed = false;
+    for (std::size_t i = 0; i < m_pools.size(); ++i) {
+        auto &pool = *m_pools[i];
+        if (!pool.touched) {
+            continue;
+        }
+        m_stats.rehashedComponents += pool.rehash(pool);
+        pool.changed.clear();
+        pool.whole = false;
+        pool.touched = false;
+        m_poolHashes[i] = pool.hash;
+        ++m_stats.changedPools;
+        changed = true;
+    }
+    if (changed) {
+        m_hash = XXH3_64bits(m_poolHashes.data(), m_poolHashes.size() * sizeof(uint64_t));
+    }
+
+    m_stats.lastUpdateSeconds = timer.elapsedSeconds();
+    return m_hash;
+}
+
+void WorldChecksum::invalidate() noexcept {
+    for (auto &pool : m_pools) {
+        pool->whole = true;
+        pool->touched = true;
+        pool->changed.clear();
+    }
+}
+
+uint64_t WorldChecksum::hash() const noexcept {
+    return m_hash;
+}
+
+std::size_t WorldChecksum::poolCount() const noexcept {
+    return m_pools.size();
+}
+
+std::string_view WorldChecksum::poolName(std::size_t pool) const {
+    if (pool >= m_pools.size()) {
+        throw std::out_of_range(fmt::format("world checksum: unknown pool {}", pool));
+    }
+    return m_pools[pool]->name;
+}
+
+uint64_t WorldChecksum::poolHash(std::size_t pool) const {
+    if (pool >= m_pools.size()) {
+        throw std::out_of_range(fmt::format("world checksum: unknown pool {}", pool));
+    }
+    return m_pools[pool]->hash;
+}
+
+WorldChecksumStats WorldChecksum::stats() const noexcept {
+    auto stats = m_stats;
+    stats.pools = m_pools.size();
+    return stats;
+}
+
+} // namespace void_crew::server
@@ -0,0 +1,200 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include <entt/entt.hpp>
+#include <xxhash.h>
+
+namespace void_crew::server {
+
+struct WorldChecksumStats {
+    std::size_t pools = 0;              // tracked component pools
+    std::size_t changedPools = 0;       // in the last update()
+    std::size_t rehashedComponents = 0; // same
+    double lastUpdateSeconds = 0.0;
+};
+
+/// 64-bit fingerprint of the simulation state, kept current per tick.
+///
+/// Each tracked component pool has its own hash: the sum (mod 2^64) of
+/// XXH3 over every component's bytes, seeded with its entity. The sum does
+/// not depend on the order of the pool, so sorting a pool (ComponentLayout,
+/// groups) leaves it unchanged. The world hash is XXH3 over the pool hashes
+/// in the order the pools were tracked.
+///
+/// Registry signals record which components changed, and update() rehashes
+/// only those, swapping each one's old term of the sum for the new one. A
+/// tick costs one XXH3 per changed component, and a pool where most
+/// components changed is rehashed whole. Components written without
+/// patch()/replace() are not seen: call invalidate() after such writes, as
+/// for SpatialIndex.
+///
+/// Two registries that went through the same operations (a live session and
+/// its replay) hash equal; use it to detect desyncs and to verify replays.
+///
+/// Game thread only.
+class WorldChecksum {
+public:
+    explicit WorldChecksum(entt::registry &registry);
+    ~WorldChecksum();
+
+    WorldChecksum(const WorldChecksum &) = delete;
+    WorldChecksum &operator=(const WorldChecksum &) = delete;
+    WorldChecksum(WorldChecksum &&) = delete;
+    WorldChecksum &operator=(WorldChecksum &&) = delete;
+
+    /// Adds T's pool, hashed as raw bytes. T must be trivially copyable and
+    /// have no padding, since padding bytes are not guaranteed to match;
+    /// track types with padding through a projection instead.
+    template <typename T>
+    void track(std::string_view name);
+
+    /// Adds T's pool, hashing @p project(component) for each component. The
+    /// projection returns a trivially copyable value without padding, e.g.
+    /// the fields of T widened to one integer type.
+    template <typename T, typename Projection>
+    void track(std::string_view name, Projection project);
+
+    /// Rehashes the components that changed since the last update and
+    /// returns the world hash.
+    uint64_t update();
+
+    /// Marks every pool changed, so the next update() rehashes them whole.
+    void invalidate() noexcept;
+
+    /// World hash as of the last update().
+    uint64_t hash() const noexcept;
+
+    std::size_t poolCount() const noexcept;
+    std::string_view poolName(std::size_t pool) const;
+    uint64_t poolHash(std::size_t pool) const;
+
+    WorldChecksumStats stats() const noexcept;
+
+private:
+    struct Pool {
+        std::string name;
+        uint64_t hash = 0;                         // sum of terms
+        std::vector<uint64_t> terms;               // by entity index; 0 = no component
+        std::vector<entt::entity> changed;         // constructed or updated since the last update()
+        bool whole = true;                         // rehash every component
+        bool touched = true;                       // hash changed since the last update()
+        std::function<std::size_t(Pool &)> rehash; // returns components hashed
+        void (*disconnect)(entt::registry &, Pool &) = nullptr;
+
+        void onChanged(entt::registry &, entt::entity entity) {
+            if (!whole) {
+                changed.push_back(entity);
+            }
+            touched = true;
+        }
+
+        void onDestroyed(entt::registry &, entt::entity entity) noexcept {
+            auto index = static_cast<std::size_t>(entt::to_entity(entity));
+            if (index < terms.size()) {
+                hash -= terms[index];
+                terms[index] = 0;
+            }
+            touched = true;
+        }
+
+        void setTerm(entt::entity entity, uint64_t term) {
+            auto index = static_cast<std::size_t>(entt::to_entity(entity));
+            if (index >= terms.size()) {
+                terms.resize(index + 1, 0);
+            }
+            hash += term - terms[index];
+            terms[index] = term;
+        }
+    };
+
+    template <typename T>
+    void addPool(std::string_view name, std::function<std::size_t(Pool &)> rehash);
+
+    template <typename T, typename Bytes>
+    static std::size_t rehashPool(entt::registry &registry, Pool &pool, Bytes bytes);
+
+    entt::registry &m_registry;
+    std::vector<std::unique_ptr<Pool>> m_pools; // stable addresses for the signal connections
+    std::vector<uint64_t> m_poolHashes;
+    uint64_t m_hash = 0;
+    WorldChecksumStats m_stats;
+};
+
+template <typename T, typename Bytes>
+std::size_t WorldChecksum::rehashPool(entt::registry &registry, Pool &pool, Bytes bytes) {
+    auto &storage = registry.storage<T>();
+    auto term = [&](entt::entity entity, const auto &...component) -> uint64_t {
+        if constexpr (sizeof...(component) == 0) {
+            auto id = entt::to_integral(entity);
+            return XXH3_64bits(&id, sizeof(id));
+        } else {
+            const auto &value = bytes(component...);
+            return XXH3_64bits_withSeed(&value, sizeof(value), entt::to_integral(entity));
+        }
+    };
+
+    if (!pool.whole && pool.changed.size() <= storage.size() / 2) {
+        for (auto entity : pool.changed) {
+            if (!storage.contains(entity)) {
+                continue; // destroyed since, and its term already dropped
+            }
+            if constexpr (std::is_empty_v<T>) {
+                pool.setTerm(entity, term(entity));
+            } else {
+                pool.setTerm(entity, term(entity, storage.get(entity)));
+            }
+        }
+        return pool.changed.size();
+    }
+
+    pool.hash = 0;
+    std::fill(pool.terms.begin(), pool.terms.end(), 0);
+    for (auto element : storage.each()) {
+        auto entity = std::get<0>(element);
+        pool.setTerm(entity, std::apply(term, element));
+    }
+    return storage.size();
+}
+
+template <typename T>
+void WorldChecksum::track(std::string_view name) {
+    static_assert(std::is_trivially_copyable_v<T>, "hashed as raw bytes: must be trivially copyable");
+    addPool<T>(name, [this](Pool &pool) {
+        return rehashPool<T>(m_registry, pool, [](const T &component) -> const T & { return component; });
+    });
+}
+
+template <typename T, typename Projection>
+void WorldChecksum::track(std::string_view name, Projection project) {
+    using Value = std::invoke_result_t<Projection, const T &>;
+    static_assert(std::is_trivially_copyable_v<Value>, "projection must return a trivially copyable value");
+    addPool<T>(name, [this, project](Pool &pool) { return rehashPool<T>(m_registry, pool, project); });
+}
+
+template <typename T>
+void WorldChecksum::addPool(std::string_view name, std::function<std::size_t(Pool &)> rehash) {
+    auto &pool = *m_pools.emplace_back(std::make_unique<Pool>());
+    pool.name = name;
+    pool.rehash = std::move(rehash);
+    pool.disconnect = [](entt::registry &registry, Pool &self) {
+        registry.on_construct<T>().disconnect(self);
+        registry.on_update<T>().disconnect(self);
+        registry.on_destroy<T>().disconnect(self);
+    };
+    m_registry.on_construct<T>().template connect<&Pool::onChanged>(pool);
+    m_registry.on_update<T>().template connect<&Pool::onChanged>(pool);
+    m_registry.on_destroy<T>().template connect<&Pool::onDestroyed>(pool);
+    m_poolHashes.push_back(0);
+}
+
+} // namespace void_crew::server
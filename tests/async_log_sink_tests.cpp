@@ -0,0 +1,193 @@
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+#include <spdlog/sinks/base_sink.h>
+#include <spdlog/sinks/stdout_color_sinks.h>
+
+#include "async_log_sink.hpp"
+#include "logging.hpp"
+
+using namespace void_crew;
+
+namespace {
+
+// Records payloads; while the gate is closed the writer thread stalls inside
+// log(), which lets tests fill the queue deterministically.
+class GatedSink : public spdlog::sinks::base_sink<std::mutex> {
+public:
+    std::atomic<bool> gateOpen{true};
+
+    std::vector<std::string> messages() {
+        std::lock_guard lock(mutex_);
+        return m_messages;
+    }
+
+protected:
+    void sink_it_(const spdlog::details::log_msg& msg) override {
+        while (!gateOpen.load()) {
+            std::this_thread::yield();
+        }
+        m_messages.emplace_back(msg.payload.data(), msg.payload.size());
+    }
+
+    void flush_() override {}
+
+private:
+    std::vector<std::string> m_messages;
+};
+
+struct AsyncFixture {
+    std::shared_ptr<GatedSink> inner = std::make_shared<GatedSink>();
+    std::shared_ptr<AsyncLogSink> sink;
+    std::shared_ptr<spdlog::logger> logger;
+
+    explicit AsyncFixture(AsyncLogOptions options) {
+        sink = std::make_shared<AsyncLogSink>(std::vector<spdlog::sink_ptr>{inner}, options);
+        logger = std::make_shared<spdlog::logger>("async_test", sink);
+        logger->set_level(spdlog::level::trace);
+    }
+};
+
+} // namespace
+
+TEST_CASE("parseLogOverflowPolicy: known and unknown names", "[common][logging]") {
+    REQUIRE(parseLogOverflowPolicy("drop") == LogOverflowPolicy::Drop);
+    REQUIRE(parseLogOverflowPolicy("block") == LogOverflowPolicy::Block);
+    REQUIRE(parseLogOverflowPolicy("drop_lowest_level") == LogOverflowPolicy::DropLowestLevel);
+    REQUIRE_FALSE(parseLogOverflowPolicy("overrun").has_value());
+}
+
+TEST_CASE("AsyncLogSink: queue size rounds up to a power of two", "[common][logging]") {
+    AsyncLogSink sink({}, {.queueSize = 100});
+    REQUIRE(sink.capacity() == 128);
+}
+
+TEST_CASE("AsyncLogSink: delivers messages in order after flush", "[common][logging]") {
+    AsyncFixture fx({.queueSize = 64, .overflow = LogOverflowPolicy::Block});
+    for (int i = 0; i < 200; ++i) {
+        fx.logger->info("msg {}", i);
+        if (i % 50 == 49) {
+            fx.logger->flush();
+        }
+    }
+    fx.logger->flush();
+
+    auto messages = fx.inner->messages();
+    REQUIRE(messages.size() == 200);
+    for (int i = 0; i < 200; ++i) {
+        REQUIRE(messages[i] == "msg " + std::to_string(i));
+    }
+    REQUIRE(fx.sink->stats().dropped == 0);
+}
+
+TEST_CASE("AsyncLogSink: drop policy discards new messages when full", "[common][logging]") {
+    AsyncFixture fx({.queueSize = 4, .overflow = LogOverflowPolicy::Drop});
+    fx.inner->gateOpen = false;
+
+    for (int i = 0; i < 10; ++i) {
+        fx.logger->info("msg {}", i);
+    }
+
+    auto stats = fx.sink->stats();
+    REQUIRE(stats.dropped == 6);
+    REQUIRE(stats.droppedByLevel[spdlog::level::info] == 6);
+
+    fx.inner->gateOpen = true;
+    fx.logger->flush();
+    auto messages = fx.inner->messages();
+    REQUIRE(messages == std::vector<std::string>{"msg 0", "msg 1", "msg 2", "msg 3"});
+}
+
+TEST_CASE("AsyncLogSink: drop-lowest-level keeps room for warnings", "[common][logging]") {
+    AsyncFixture fx({.queueSize = 4, .overflow = LogOverflowPolicy::DropLowestLevel});
+    fx.inner->gateOpen = false;
+
+    for (int i = 0; i < 5; ++i) {
+        fx.logger->info("info {}", i);
+    }
+    fx.logger->warn("warn 0");
+    fx.logger->warn("warn 1");
+
+    auto stats = fx.sink->stats();
+    REQUIRE(stats.droppedByLevel[spdlog::level::info] == 2);
+    REQUIRE(stats.droppedByLevel[spdlog::level::warn] == 1);
+    REQUIRE(stats.dropped == 3);
+
+    fx.inner->gateOpen = true;
+    fx.logger->flush();
+    auto messages = fx.inner->messages();
+    REQUIRE(messages == std::vector<std::string>{"info 0", "info 1", "info 2", "warn 0"});
+}
+
+TEST_CASE("AsyncLogSink: block policy waits instead of dropping", "[common][logging]") {
+    AsyncFixture fx({.queueSize = 4, .overflow = LogOverflowPolicy::Block});
+    fx.inner->gateOpen = false;
+
+    std::thread producer([&]() {
+        for (int i = 0; i < 10; ++i) {
+            fx.logger->info("msg {}", i);
+        }
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    REQUIRE(fx.sink->stats().blockedWaits > 0);
+
+    fx.inner->gateOpen = true;
+    producer.join();
+    fx.logger->flush();
+
+    REQUIRE(fx.inner->messages().size() == 10);
+    REQUIRE(fx.sink->stats().dropped == 0);
+}
+
+TEST_CASE("AsyncLogSink: concurrent producers lose nothing with room to spare", "[common][logging]") {
+    AsyncFixture fx({.queueSize = 4096});
+    constexpr int THREADS = 4;
+    constexpr int PER_THREAD = 500;
+
+    std::vector<std::thread> producers;
+    for (int t = 0; t < THREADS; ++t) {
+        producers.emplace_back([&, t]() {
+            for (int i = 0; i < PER_THREAD; ++i) {
+                fx.logger->info("t{} m{}", t, i);
+            }
+        });
+    }
+    for (auto& producer : producers) {
+        producer.join();
+    }
+    fx.logger->flush();
+
+    REQUIRE(fx.inner->messages().size() == THREADS * PER_THREAD);
+    REQUIRE(fx.sink->stats().dropped == 0);
+}
+
+TEST_CASE("enableAsyncLogging routes tagged logs through the writer thread", "[common][logging]") {
+    auto logDir = std::filesystem::temp_directory_path() / "void_crew_test_async";
+    auto logFile = logDir / "async.log";
+    std::error_code ec;
+    std::filesystem::remove_all(logDir, ec);
+
+    initLogging("info", logFile);
+    enableAsyncLogging({.queueSize = 256});
+    TLOG_INFO("async", "written by the background thread");
+    getLogger("async")->flush();
+
+    std::ifstream f(logFile);
+    std::string contents((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+    REQUIRE(contents.find("[async] written by the background thread") != std::string::npos);
+    REQUIRE(asyncLogStats().dropped == 0);
+
+    spdlog::drop_all();
+    spdlog::set_default_logger(
+        std::make_shared<spdlog::logger>("default", std::make_shared<spdlog::sinks::stdout_color_sink_mt>()));
+    refreshTagLoggers();
+}
@@ -0,0 +1,157 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include <entt/entt.hpp>
+
+#include "atmosphere.hpp"
+
+using namespace void_crew;
+using namespace void_crew::server;
+using Catch::Matchers::WithinRel;
+
+namespace {
+
+constexpr float DT = 1.0f / 60.0f;
+constexpr float ROOM = 30.0f; // m^3
+constexpr float DOOR = 2.0f;  // m^3/s
+
+float totalMoles(const Atmosphere &atmosphere, std::initializer_list<CompartmentId> compartments) {
+    float total = 0.0f;
+    for (auto id : compartments) {
+        for (auto gas : {Gas::Oxygen, Gas::Nitrogen, Gas::CarbonDioxide}) {
+            total += atmosphere.amount(id, gas);
+        }
+    }
+    return total;
+}
+
+void run(Atmosphere &atmosphere, int steps) {
+    for (int i = 0; i < steps; ++i) {
+        atmosphere.step(DT);
+    }
+}
+
+} // namespace
+
+TEST_CASE("Atmosphere: an open door equalizes pressure, conserves gas and then sleeps", "[server][atmosphere]") {
+    Atmosphere atmosphere;
+    atmosphere.addCompartment(1, ROOM, standardAir(ROOM));
+    atmosphere.addCompartment(2, ROOM, standardAir(ROOM / 2.0f)); // half an atmosphere
+    atmosphere.connect(1, 2, DOOR);
+    REQUIRE_THAT(atmosphere.pressure(1), WithinRel(101.325f, 0.001f));
+    float before = totalMoles(atmosphere, {1, 2});
+
+    run(atmosphere, 1);
+    REQUIRE(atmosphere.pressure(1) < 101.3f);
+    REQUIRE(atmosphere.pressure(2) > 50.7f);
+
+    run(atmosphere, 60 * 120);
+    REQUIRE_THAT(atmosphere.pressure(1), WithinRel(76.0f, 0.001f));
+    REQUIRE_THAT(atmosphere.pressure(2), WithinRel(atmosphere.pressure(1), 0.0001f));
+    REQUIRE_THAT(totalMoles(atmosphere, {1, 2}), WithinRel(before, 0.0001f));
+
+    // At rest nothing is solved.
+    REQUIRE_FALSE(atmosphere.isActive(1));
+    run(atmosphere, 1);
+    REQUIRE(atmosphere.stats().activeComponents == 0);
+    REQUIRE(atmosphere.stats().steppedCompartments == 0);
+}
+
+TEST_CASE("Atmosphere: closed links carry nothing; toggling one wakes only its component", "[server][atmosphere]") {
+    Atmosphere atmosphere;
+    for (CompartmentId id = 1; id <= 4; ++id) {
+        atmosphere.addCompartment(id, ROOM, standardAir(ROOM));
+    }
+    auto vent = atmosphere.connect(1, 2, DOOR, false);
+    atmosphere.connect(3, 4, DOOR);
+    run(atmosphere, 2);
+    REQUIRE(atmosphere.stats().components == 3);
+    REQUIRE(atmosphere.stats().activeComponents == 0);
+
+    // Scrubbers fail in 1: CO2 stays there while the vent is shut.
+    atmosphere.addGas(1, Gas::CarbonDioxide, 50.0f);
+    run(atmosphere, 60 * 60); // a minute: the time constant is ROOM / (2 * DOOR) = 7.5 s
+    REQUIRE_THAT(atmosphere.amount(2, Gas::CarbonDioxide), WithinRel(standardAir(ROOM)[2], 0.0001f));
+    REQUIRE(atmosphere.stats().activeComponents == 0);
+
+    atmosphere.setOpen(vent, true);
+    run(atmosphere, 1);
+    REQUIRE(atmosphere.stats().components == 2);
+    REQUIRE(atmosphere.stats().activeComponents == 1);
+    REQUIRE(atmosphere.stats().steppedCompartments == 2); // 3 and 4 stay asleep
+    REQUIRE(atmosphere.isActive(2));
+    REQUIRE_FALSE(atmosphere.isActive(3));
+    REQUIRE(atmosphere.amount(2, Gas::CarbonDioxide) > standardAir(ROOM)[2]);
+
+    atmosphere.setOpen(vent, false);
+    run(atmosphere, 1);
+    float trapped = atmosphere.amount(2, Gas::CarbonDioxide);
+    run(atmosphere, 600);
+    REQUIRE(atmosphere.amount(2, Gas::CarbonDioxide) == trapped);
+    REQUIRE(atmosphere.stats().rebuilds >= 3);
+}
+
+TEST_CASE("Atmosphere: a breach drains its side of a bulkhead into space", "[server][atmosphere]") {
+    Atmosphere atmosphere;
+    atmosphere.addCompartment(1, ROOM, standardAir(ROOM));
+    atmosphere.addCompartment(2, ROOM, standardAir(ROOM));
+    atmosphere.addCompartment(3, ROOM, standardAir(ROOM));
+    atmosphere.connect(1, 2, DOOR);
+    auto bulkhead = atmosphere.connect(2, 3, DOOR, false);
+    // A hole so large it needs substeps; it must still never go negative.
+    auto breach = atmosphere.connectToSpace(1, 5000.0f);
+
+    for (int i = 0; i < 60 * 120; ++i) {
+        atmosphere.step(DT);
+        REQUIRE(atmosphere.amount(1, Gas::Oxygen) >= 0.0f);
+        REQUIRE(atmosphere.pressure(1) <= atmosphere.pressure(2) + 0.001f);
+    }
+    REQUIRE(atmosphere.pressure(1) < 1.0f);
+    REQUIRE(atmosphere.pressure(2) < 1.0f);
+    REQUIRE_THAT(atmosphere.pressure(3), WithinRel(101.325f, 0.001f));
+
+    // Sealing the breach and opening the bulkhead repressurizes from 3.
+    atmosphere.setOpen(breach, false);
+    atmosphere.setOpen(bulkhead, true);
+    run(atmosphere, 60 * 300);
+    REQUIRE_THAT(atmosphere.pressure(1), WithinRel(atmosphere.pressure(3), 0.01f));
+    REQUIRE(atmosphere.pressure(3) < 40.0f);
+    REQUIRE(atmosphere.stats().activeComponents == 0);
+
+    REQUIRE_THROWS_AS(atmosphere.addCompartment(1, ROOM, {}), std::invalid_argument);
+    REQUIRE_THROWS_AS(atmosphere.connect(1, 9, DOOR), std::out_of_range);
+    REQUIRE_THROWS_AS(atmosphere.setOpen(42, true), std::out_of_range);
+}
+
+TEST_CASE("AtmosphereSync: compartments and doors come from the registry", "[server][atmosphere]") {
+    entt::registry registry;
+    Atmosphere atmosphere;
+    AtmosphereSync sync(registry, atmosphere);
+
+    auto door = registry.create();
+    registry.emplace<Door>(door, Door{1, 2, true});
+    registry.emplace<CompartmentVolume>(registry.create(), CompartmentVolume{1, ROOM});
+    sync.update();
+    REQUIRE(atmosphere.contains(1));
+    REQUIRE(sync.pendingDoors() == 1); // compartment 2 does not exist yet
+
+    registry.emplace<CompartmentVolume>(registry.create(), CompartmentVolume{2, ROOM});
+    sync.update();
+    REQUIRE(sync.pendingDoors() == 0);
+    REQUIRE(atmosphere.stats().compartments == 2);
+    REQUIRE(atmosphere.isOpen(0));
+
+    float before = atmosphere.amount(2, Gas::CarbonDioxide);
+    atmosphere.addGas(1, Gas::CarbonDioxide, 5.0f);
+    registry.patch<Door>(door, [](Door &d) { d.open = false; });
+    sync.update();
+    run(atmosphere, 120);
+    REQUIRE(atmosphere.amount(2, Gas::CarbonDioxide) == before);
+
+    registry.patch<Door>(door, [](Door &d) { d.open = true; });
+    sync.update();
+    run(atmosphere, 60 * 60); // a minute: the time constant is ROOM / (2 * DOOR) = 7.5 s
+    REQUIRE_THAT(atmosphere.amount(2, Gas::CarbonDioxide), WithinRel(atmosphere.amount(1, Gas::CarbonDioxide), 0.01f));
+
+    registry.destroy(door);
+    REQUIRE_FALSE(atmosphere.isOpen(0));
+}
@@ -0,0 +1,188 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+#include <glm/glm.hpp>
+
+#include "batch_kernels.hpp"
+
+using namespace void_crew;
+
+namespace {
+
+// Odd length so every vector path also runs its scalar tail.
+constexpr std::size_t COUNT = 1003;
+
+std::vector<SimdLevel> supportedLevels() {
+    std::vector<SimdLevel> levels;
+    for (auto level : {SimdLevel::Scalar, SimdLevel::Sse2, SimdLevel::Avx2}) {
+        if (level <= detectSimdLevel()) {
+            levels.push_back(level);
+        }
+    }
+    return levels;
+}
+
+std::vector<float> randomLane(std::minstd_rand &random, float range) {
+    std::uniform_real_distribution<float> value(-range, range);
+    std::vector<float> lane(COUNT);
+    for (auto &v : lane) {
+        v = value(random);
+    }
+    return lane;
+}
+
+} // namespace
+
+TEST_CASE("Batch kernels: integration matches glm on every SIMD level", "[common][simd]") {
+    std::minstd_rand random(5);
+    auto x = randomLane(random, 100.0f);
+    auto y = randomLane(random, 100.0f);
+    auto z = randomLane(random, 100.0f);
+    auto vx = randomLane(random, 10.0f);
+    auto vy = randomLane(random, 10.0f);
+    auto vz = randomLane(random, 10.0f);
+    constexpr float DT = 1.0f / 60.0f;
+
+    for (auto level : supportedLevels()) {
+        INFO(simdLevelName(level));
+        setSimdLevel(level);
+        auto px = x;
+        auto py = y;
+        auto pz = z;
+        integrate(px, vx, DT);
+        integrate(py, vy, DT);
+        integrate(pz, vz, DT);
+        for (std::size_t i = 0; i < COUNT; ++i) {
+            glm::vec3 expected = glm::vec3{x[i], y[i], z[i]} + glm::vec3{vx[i], vy[i], vz[i]} * DT;
+            REQUIRE(px[i] == expected.x);
+            REQUIRE(py[i] == expected.y);
+            REQUIRE(pz[i] == expected.z);
+        }
+    }
+    setSimdLevel(detectSimdLevel());
+
+    std::vector<float> shorter(COUNT - 1);
+    REQUIRE_THROWS_AS(integrate(x, shorter, DT), std::invalid_argument);
+    REQUIRE(parseSimdLevel("avx2") == SimdLevel::Avx2);
+    REQUIRE_FALSE(parseSimdLevel("avx512").has_value());
+}
+
+TEST_CASE("Batch kernels: distance and box culling match glm on every SIMD level", "[common][simd]") {
+    std::minstd_rand random(9);
+    auto x = randomLane(random, 50.0f);
+    auto y = randomLane(random, 50.0f);
+    auto z = randomLane(random, 50.0f);
+    // Exactly on the radius and on the box faces: both count.
+    x[10] = 20.0f, y[10] = 0.0f, z[10] = 0.0f;
+    PointLanes points{x, y, z};
+
+    std::vector<float> minX(COUNT), minY(COUNT), minZ(COUNT), maxX(COUNT), maxY(COUNT), maxZ(COUNT);
+    for (std::size_t i = 0; i < COUNT; ++i) {
+        minX[i] = x[i], minY[i] = y[i], minZ[i] = z[i];
+        maxX[i] = x[i] + 3.0f, maxY[i] = y[i] + 3.0f, maxZ[i] = z[i] + 3.0f;
+    }
+    minX[11] = 10.0f, minY[11] = -5.0f, minZ[11] = -5.0f;
+    BoxLanes boxes{minX, minY, minZ, maxX, maxY, maxZ};
+
+    const glm::vec3 center{0.0f};
+    constexpr float RADIUS = 20.0f;
+    const glm::vec3 queryMin{-10.0f, -5.0f, -5.0f};
+    const glm::vec3 queryMax{10.0f, 15.0f, 5.0f};
+
+    std::vector<uint32_t> nearExpected;
+    std::vector<uint32_t> boxExpected;
+    for (uint32_t i = 0; i < COUNT; ++i) {
+        glm::vec3 d = glm::vec3{x[i], y[i], z[i]} - center;
+        if (glm::dot(d, d) <= RADIUS * RADIUS) {
+            nearExpected.push_back(i);
+        }
+        glm::vec3 lo{minX[i], minY[i], minZ[i]};
+        glm::vec3 hi{maxX[i], maxY[i], maxZ[i]};
+        if (glm::all(glm::lessThanEqual(lo, queryMax)) && glm::all(glm::greaterThanEqual(hi, queryMin))) {
+            boxExpected.push_back(i);
+        }
+    }
+    REQUIRE(nearExpected.size() > 10);
+    REQUIRE(boxExpected.size() > 3);
+
+    std::vector<uint32_t> found;
+    for (auto level : supportedLevels()) {
+        INFO(simdLevelName(level));
+        setSimdLevel(level);
+        REQUIRE(withinDistance(points, center, RADIUS, found) == nearExpected.size());
+        REQUIRE(found == nearExpected);
+        REQUIRE(overlapping(boxes, queryMin, queryMax, found) == boxExpected.size());
+        REQUIRE(found == boxExpected);
+    }
+    setSimdLevel(detectSimdLevel());
+}
+
+TEST_CASE("Batch kernels: quantization matches std::round on every SIMD level", "[common][simd]") {
+    std::minstd_rand random(13);
+    auto values = randomLane(random, 1000.0f);
+    // Halves round away from zero; the largest float below a half does not.
+    std::vector<float> edges{0.25f, -0.25f, 0.75f, -0.75f, 1.25f, -1.25f, 0.0f, -0.0f, 0.24999999f, 1e12f, -1e12f};
+    std::copy(edges.begin(), edges.end(), values.begin());
+    constexpr float STEP = 0.5f;
+
+    std::vector<int32_t> expected(COUNT);
+    for (std::size_t i = 0; i < COUNT; ++i) {
+        float scaled = std::clamp(values[i] / STEP, -2147483520.0f, 2147483520.0f);
+        expected[i] = static_cast<int32_t>(std::round(scaled));
+    }
+    REQUIRE(expected[0] == 1);
+    REQUIRE(expected[1] == -1);
+    REQUIRE(expected[2] == 2);
+    REQUIRE(expected[8] == 0);
+
+    std::vector<int32_t> out(COUNT);
+    for (auto level : supportedLevels()) {
+        INFO(simdLevelName(level));
+        setSimdLevel(level);
+        quantize(values, STEP, out);
+        REQUIRE(out == expected);
+    }
+    setSimdLevel(detectSimdLevel());
+
+    std::vector<int32_t> shorter(COUNT - 1);
+    REQUIRE_THROWS_AS(quantize(values, STEP, shorter), std::invalid_argument);
+    if (detectSimdLevel() != SimdLevel::Avx2) {
+        REQUIRE_THROWS_AS(setSimdLevel(SimdLevel::Avx2), std::invalid_argument);
+    }
+}
+
+TEST_CASE("Batch kernels: NaN quantizes to 0 and infinities clamp on every SIMD level", "[common][simd]") {
+    constexpr float NAN_VALUE = std::numeric_limits<float>::quiet_NaN();
+    constexpr float INF = std::numeric_limits<float>::infinity();
+    // Odd length: the specials land in vector lanes and in the scalar tail.
+    std::vector<float> values(19, 1.0f);
+    for (std::size_t i : {0u, 5u, 9u, 18u}) {
+        values[i] = NAN_VALUE;
+    }
+    values[1] = INF;
+    values[17] = -INF;
+
+    std::vector<int32_t> out(values.size());
+    for (auto level : supportedLevels()) {
+        INFO(simdLevelName(level));
+        setSimdLevel(level);
+        quantize(values, 1.0f, out);
+        for (std::size_t i : {0u, 5u, 9u, 18u}) {
+            REQUIRE(out[i] == 0);
+        }
+        REQUIRE(out[1] == 2147483520);
+        REQUIRE(out[17] == -2147483520);
+        REQUIRE(out[2] == 1);
+
+        // 0 / 0 is NaN as well.
+        quantize(std::vector<float>(9, 0.0f), 0.0f, std::span(out).first(9));
+        REQUIRE(std::all_of(out.begin(), out.begin() + 9, [](int32_t v) { return v == 0; }));
+    }
+    setSimdLevel(detectSimdLevel());
+}
@@ -0,0 +1,140 @@
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <thread>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "command_queue.hpp"
+
+using namespace void_crew::server;
+
+namespace {
+
+ClientCommand makeCommand(uint32_t sequence, uint16_t type = 1) {
+    ClientCommand command;
+    command.sequence = sequence;
+    command.type = type;
+    return command;
+}
+
+} // namespace
+
+TEST_CASE("CommandQueue: drain returns pushed commands stamped with the tick", "[server][commands]") {
+    CommandQueue queue;
+    auto producer = queue.producer(7);
+
+    REQUIRE(producer.push(makeCommand(1)));
+    REQUIRE(producer.push(makeCommand(2)));
+
+    auto commands = queue.drain(42);
+    REQUIRE(commands.size() == 2);
+    for (const auto &command : commands) {
+        REQUIRE(command.client == 7);
+        REQUIRE(command.tick == 42);
+    }
+    REQUIRE(commands[0].sequence == 1);
+    REQUIRE(commands[1].sequence == 2);
+
+    REQUIRE(queue.drain(43).empty());
+}
+
+TEST_CASE("CommandQueue: producer overrides the client id", "[server][commands]") {
+    CommandQueue queue;
+    auto producer = queue.producer(3);
+
+    auto spoofed = makeCommand(1);
+    spoofed.client = 99;
+    producer.push(spoofed);
+
+    REQUIRE(queue.drain(0)[0].client == 3);
+}
+
+TEST_CASE("CommandQueue: flood cap limits commands per client per tick", "[server][commands]") {
+    CommandQueue queue(4);
+    auto flooder = queue.producer(1);
+    auto polite = queue.producer(2);
+
+    int accepted = 0;
+    for (uint32_t i = 0; i < 10; ++i) {
+        accepted += flooder.push(makeCommand(i)) ? 1 : 0;
+    }
+    REQUIRE(accepted == 4);
+    REQUIRE(flooder.dropped() == 6);
+    REQUIRE(polite.push(makeCommand(0)));
+    REQUIRE(queue.dropped() == 6);
+
+    REQUIRE(queue.drain(1).size() == 5);
+
+    // The next tick opens a fresh window.
+    REQUIRE(flooder.push(makeCommand(10)));
+    REQUIRE(queue.drain(2).size() == 1);
+}
+
+TEST_CASE("CommandQueue: oversized payload size is clamped", "[server][commands]") {
+    CommandQueue queue;
+    auto producer = queue.producer(1);
+    auto command = makeCommand(1);
+    command.payloadSize = 200;
+    producer.push(command);
+
+    REQUIRE(queue.drain(0)[0].payloadSize == ClientCommand::MAX_PAYLOAD);
+}
+
+TEST_CASE("CommandQueue: drains more than one dequeue batch", "[server][commands]") {
+    CommandQueue queue(1000);
+    std::vector<CommandProducer> producers;
+    for (ClientId client = 0; client < 3; ++client) {
+        producers.push_back(queue.producer(client));
+    }
+    for (uint32_t i = 0; i < 300; ++i) {
+        for (auto &producer : producers) {
+            REQUIRE(producer.push(makeCommand(i)));
+        }
+    }
+
+    REQUIRE(queue.sizeApprox() == 900);
+    REQUIRE(queue.drain(5).size() == 900);
+    REQUIRE(queue.sizeApprox() == 0);
+}
+
+TEST_CASE("CommandQueue: concurrent producers keep per-client order", "[server][commands]") {
+    constexpr ClientId CLIENTS = 4;
+    constexpr uint32_t PER_CLIENT = 2000;
+    CommandQueue queue(PER_CLIENT);
+    std::atomic<ClientId> finished{0};
+
+    std::vector<std::thread> threads;
+    for (ClientId client = 0; client < CLIENTS; ++client) {
+        threads.emplace_back([&queue, &finished, client]() {
+            auto producer = queue.producer(client);
+            for (uint32_t i = 0; i < PER_CLIENT; ++i) {
+                producer.push(makeCommand(i));
+            }
+            finished.fetch_add(1);
+        });
+    }
+
+    // Drain concurrently with the producers, as the game loop would.
+    std::map<ClientId, std::vector<uint32_t>> received;
+    uint64_t tick = 0;
+    bool done = false;
+    while (!done) {
+        done = finished.load() == CLIENTS;
+        for (const auto &command : queue.drain(tick++)) {
+            received[command.client].push_back(command.sequence);
+        }
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    // The cap equals the per-client total, so nothing is dropped.
+    REQUIRE(queue.dropped() == 0);
+    REQUIRE(received.size() == CLIENTS);
+    for (const auto &[client, sequences] : received) {
+        REQUIRE(sequences.size() == PER_CLIENT);
+        REQUIRE(std::is_sorted(sequences.begin(), sequences.end()));
+    }
+}
@@ -0,0 +1,168 @@
+#include <set>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include <entt/entt.hpp>
+
+#include "component_layout.hpp"
+
+using namespace void_crew;
+using namespace void_crew::server;
+using Catch::Matchers::WithinAbs;
+
+namespace {
+
+entt::entity spawnMover(entt::registry &registry, const glm::vec3 &position, const glm::vec3 &velocity) {
+    auto entity = registry.create();
+    registry.emplace<Transform>(entity, Transform{position});
+    registry.emplace<Velocity>(entity, Velocity{velocity});
+    return entity;
+}
+
+} // namespace
+
+TEST_CASE("ComponentLayout: the motion group holds exactly the entities with Transform and Velocity",
+          "[server][layout]") {
+    entt::registry registry;
+    ComponentLayout layout(registry);
+
+    std::vector<entt::entity> movers;
+    for (int i = 0; i < 20; ++i) {
+        auto still = registry.create();
+        registry.emplace<Transform>(still);
+        movers.push_back(spawnMover(registry, glm::vec3{static_cast<float>(i)}, glm::vec3{1.0f}));
+        registry.emplace<Velocity>(registry.create()); // velocity without a place: not a mover
+    }
+    REQUIRE(layout.motion().size() == 20);
+    REQUIRE(layout.stats().motionEntities == 20);
+
+    std::set<entt::entity> seen;
+    for (auto [entity, transform, velocity] : layout.motion().each()) {
+        seen.insert(entity);
+        REQUIRE(velocity.linear == glm::vec3{1.0f});
+    }
+    REQUIRE(seen == std::set<entt::entity>(movers.begin(), movers.end()));
+
+    registry.remove<Velocity>(movers[3]);
+    registry.destroy(movers[7]);
+    REQUIRE(layout.motion().size() == 18);
+    REQUIRE_FALSE(layout.motion().contains(movers[3]));
+}
+
+TEST_CASE("ComponentLayout: periodic sort puts each compartment's entities next to each other", "[server][layout]") {
+    entt::registry registry;
+    ComponentLayout layout(registry, ComponentLayoutConfig{.sortInterval = 4});
+
+    std::vector<entt::entity> movers;
+    for (int i = 0; i < 60; ++i) {
+        auto entity = spawnMover(registry, glm::vec3{static_cast<float>(i)}, glm::vec3{0.0f});
+        if (i % 7 != 0) {
+            registry.emplace<InCompartment>(entity, static_cast<CompartmentId>(i % 5));
+        }
+        movers.push_back(entity);
+    }
+
+    // Compartment of each entity in group order; -1 for outside.
+    auto order = [&] {
+        std::vector<long> keys;
+        for (auto entity : layout.motion()) {
+            const auto *in = registry.try_get<InCompartment>(entity);
+            keys.push_back(in == nullptr ? -1 : static_cast<long>(in->id));
+        }
+        return keys;
+    };
+    auto contiguous = [](const std::vector<long> &keys) {
+        std::set<long> finished;
+        for (std::size_t i = 1; i < keys.size(); ++i) {
+            if (keys[i] != keys[i - 1] && !finished.insert(keys[i - 1]).second) {
+                return false;
+            }
+        }
+        return !finished.contains(keys.back());
+    };
+    REQUIRE_FALSE(contiguous(order()));
+
+    for (int tick = 0; tick < 3; ++tick) {
+        layout.update();
+    }
+    REQUIRE(layout.stats().sorts == 0);
+    layout.update();
+    REQUIRE(layout.stats().sorts == 1);
+    REQUIRE(contiguous(order()));
+    for (int i = 0; i < 60; ++i) { // data moved with its entity
+        REQUIRE(registry.get<Transform>(movers[i]).position.x == static_cast<float>(i));
+    }
+
+    // Nothing changed: the next interval skips the sort.
+    for (int tick = 0; tick < 4; ++tick) {
+        layout.update();
+    }
+    REQUIRE(layout.stats().sorts == 1);
+
+    // A move between compartments is picked up at the next interval.
+    registry.replace<InCompartment>(movers[1], CompartmentId{4});
+    spawnMover(registry, glm::vec3{0.0f}, glm::vec3{0.0f});
+    for (int tick = 0; tick < 4; ++tick) {
+        layout.update();
+    }
+    REQUIRE(layout.stats().sorts == 2);
+    REQUIRE(contiguous(order()));
+}
+
+TEST_CASE("ComponentLayout: SoA lanes integrate like per-entity glm and write back", "[server][layout]") {
+    entt::registry registry;
+    ComponentLayout layout(registry);
+    std::vector<entt::entity> movers;
+    for (int i = 0; i < 37; ++i) {
+        float f = static_cast<float>(i);
+        movers.push_back(spawnMover(registry, {f, -f, 2.0f * f}, {0.5f * f, 1.0f, i % 3 == 0 ? 0.0f : -f}));
+    }
+    auto still = spawnMover(registry, {1.0f, 1.0f, 1.0f}, glm::vec3{0.0f});
+
+    int patched = 0;
+    struct Counter {
+        int *count;
+        void onUpdate(entt::registry &, entt::entity) { ++*count; }
+    } counter{&patched};
+    registry.on_update<Transform>().connect<&Counter::onUpdate>(counter);
+
+    constexpr float DT = 1.0f / 60.0f;
+    MotionSoA lanes;
+    layout.gather(lanes);
+    REQUIRE(lanes.size() == 38);
+    integratePositions(lanes, DT);
+    REQUIRE(layout.scatterPositions(lanes) == 37); // the entity at rest is not patched
+    REQUIRE(patched == 37);
+
+    for (int i = 0; i < 37; ++i) {
+        float f = static_cast<float>(i);
+        glm::vec3 expected = glm::vec3{f, -f, 2.0f * f} + glm::vec3{0.5f * f, 1.0f, i % 3 == 0 ? 0.0f : -f} * DT;
+        const auto &position = registry.get<Transform>(movers[i]).position;
+        for (int axis = 0; axis < 3; ++axis) {
+            REQUIRE_THAT(position[axis], WithinAbs(expected[axis], 1e-5f));
+        }
+    }
+    REQUIRE(registry.get<Transform>(still).position == glm::vec3{1.0f});
+
+    // Entities that left the group between gather and scatter are skipped.
+    layout.gather(lanes);
+    integratePositions(lanes, DT);
+    registry.destroy(movers[0]);
+    registry.remove<Velocity>(movers[1]);
+    REQUIRE(layout.scatterPositions(lanes) == 35);
+    registry.on_update<Transform>().disconnect(counter);
+}
+
+TEST_CASE("ComponentLayout: integrateMotion moves entities and patches only those that moved", "[server][layout]") {
+    entt::registry registry;
+    ComponentLayout layout(registry);
+    auto drifting = spawnMover(registry, {0.0f, 0.0f, 0.0f}, {2.0f, 0.0f, -1.0f});
+    auto resting = spawnMover(registry, {1.0f, 1.0f, 1.0f}, glm::vec3{0.0f});
+
+    REQUIRE(layout.integrateMotion(0.5f) == 1);
+    REQUIRE(layout.stats().integrated == 2);
+    REQUIRE(layout.stats().moved == 1);
+    REQUIRE(registry.get<Transform>(drifting).position == glm::vec3{1.0f, 0.0f, -0.5f});
+    REQUIRE(registry.get<Transform>(resting).position == glm::vec3{1.0f});
+}
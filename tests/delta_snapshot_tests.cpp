@@ -0,0 +1,154 @@
+#include <cmath>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+#include <entt/entt.hpp>
+
+#include "bit_stream.hpp"
+#include "components.hpp"
+#include "delta_snapshot.hpp"
+
+using namespace void_crew;
+
+namespace {
+
+EntityState entity(uint32_t id, float x) {
+    EntityState state;
+    state.id = id;
+    state.position = {x, 2.0f, 3.0f};
+    return state;
+}
+
+WorldState world(uint64_t tick, std::vector<EntityState> entities) {
+    return {tick, std::move(entities)};
+}
+
+WorldState roundTrip(const WorldState* baseline, const WorldState& current) {
+    BitWriter writer;
+    auto bytes = encodeDelta(baseline, current, writer);
+    WorldState decoded;
+    REQUIRE(decodeDelta(baseline, bytes, decoded));
+    return decoded;
+}
+
+} // namespace
+
+TEST_CASE("BitWriter/BitReader: mixed widths round-trip and overruns fail", "[snapshot][delta]") {
+    BitWriter writer;
+    writer.write(5, 3);
+    writer.writeBool(true);
+    writer.writeVarUint(9);
+    writer.writeVarUint(70000);
+    writer.writeFloat(-0.0f);
+    writer.write(0xABCDEF01u, 32);
+    auto bytes = writer.finish();
+    REQUIRE(bytes.size() == (writer.bitCount() + 7) / 8);
+
+    BitReader reader(bytes);
+    REQUIRE(reader.read(3) == 5);
+    REQUIRE(reader.readBool());
+    REQUIRE(reader.readVarUint() == 9);
+    REQUIRE(reader.readVarUint() == 70000);
+    REQUIRE(std::signbit(reader.readFloat()));
+    REQUIRE(reader.read(32) == 0xABCDEF01u);
+    REQUIRE_FALSE(reader.failed());
+
+    reader.read(16);
+    REQUIRE(reader.failed());
+}
+
+TEST_CASE("encodeDelta: full snapshot decodes without a baseline", "[snapshot][delta]") {
+    auto current = world(10, {entity(1, 1.0f), entity(4, 4.0f), entity(300, 7.0f)});
+    current.entities[1].rotation = {0.0f, 0.0f, 0.0f, 1.0f};
+    current.entities[2].linearVelocity = {0.5f, 0.0f, 0.0f};
+
+    auto decoded = roundTrip(nullptr, current);
+    REQUIRE(decoded.entities == current.entities);
+}
+
+TEST_CASE("encodeDelta: adds, removes and changes against a baseline", "[snapshot][delta]") {
+    auto baseline = world(10, {entity(1, 1.0f), entity(2, 2.0f), entity(3, 3.0f)});
+    auto current = world(11, {entity(1, 1.0f), entity(3, 3.5f), entity(9, 9.0f)});
+    current.entities[1].angularVelocity.y = 0.25f;
+
+    auto decoded = roundTrip(&baseline, current);
+    REQUIRE(decoded.entities == current.entities);
+}
+
+TEST_CASE("encodeDelta: unchanged world costs a single bit", "[snapshot][delta]") {
+    std::vector<EntityState> entities;
+    for (uint32_t id = 0; id < 1000; ++id) {
+        entities.push_back(entity(id, static_cast<float>(id)));
+    }
+    auto baseline = world(1, entities);
+    auto current = world(2, entities);
+
+    BitWriter writer;
+    auto full = encodeDelta(nullptr, current, writer).size();
+    REQUIRE(encodeDelta(&baseline, current, writer).size() == 1);
+
+    current.entities[500].position.x += 1.0f;
+    auto oneChange = encodeDelta(&baseline, current, writer).size();
+    REQUIRE(oneChange < 16);
+    REQUIRE(oneChange < full / 100);
+}
+
+TEST_CASE("decodeDelta: truncated data or a mismatched baseline fails", "[snapshot][delta]") {
+    auto baseline = world(1, {entity(1, 1.0f), entity(2, 2.0f)});
+    auto current = world(2, {entity(2, 5.0f)});
+
+    BitWriter writer;
+    auto bytes = encodeDelta(&baseline, current, writer);
+    std::vector<uint8_t> copy(bytes.begin(), bytes.end());
+
+    WorldState decoded;
+    REQUIRE_FALSE(decodeDelta(&baseline, std::span(copy).first(copy.size() - 1), decoded));
+
+    // Removing entity 1 needs a baseline that has it.
+    auto other = world(1, {entity(2, 2.0f)});
+    REQUIRE_FALSE(decodeDelta(&other, copy, decoded));
+}
+
+TEST_CASE("captureWorldState: replicated entities sorted by id", "[snapshot][delta]") {
+    entt::registry registry;
+    for (uint32_t id : {7u, 3u, 5u}) {
+        auto e = registry.create();
+        registry.emplace<NetworkId>(e, id);
+        registry.emplace<Transform>(e, Transform{{static_cast<float>(id), 0.0f, 0.0f}});
+        if (id == 5) {
+            registry.emplace<Velocity>(e, Velocity{{1.0f, 0.0f, 0.0f}, {}});
+        }
+    }
+    registry.emplace<Transform>(registry.create()); // local only
+
+    WorldState state;
+    captureWorldState(registry, 42, state);
+    REQUIRE(state.tick == 42);
+    REQUIRE(state.entities.size() == 3);
+    REQUIRE(state.entities[0].id == 3);
+    REQUIRE(state.entities[1].id == 5);
+    REQUIRE(state.entities[1].linearVelocity.x == 1.0f);
+    REQUIRE(state.entities[2].id == 7);
+    REQUIRE(state.entities[2].position.x == 7.0f);
+}
+
+TEST_CASE("SnapshotHistory: finds stored ticks until they are evicted", "[snapshot][delta]") {
+    SnapshotHistory history(4);
+    REQUIRE(history.latest() == nullptr);
+
+    for (uint64_t tick = 1; tick <= 6; ++tick) {
+        WorldState state = world(tick, {entity(1, static_cast<float>(tick))});
+        history.swapIn(state);
+        if (tick > 4) {
+            REQUIRE(state.tick == tick - 4); // evicted slot handed back
+        }
+    }
+
+    REQUIRE(history.latest()->tick == 6);
+    REQUIRE(history.find(6) != nullptr);
+    REQUIRE(history.find(3)->entities[0].position.x == 3.0f);
+    REQUIRE(history.find(2) == nullptr);
+    REQUIRE(history.find(10) == nullptr);
+}
@@ -0,0 +1,93 @@
+#include <cstdint>
+#include <memory_resource>
+#include <numeric>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "frame_arena.hpp"
+
+using namespace void_crew;
+
+TEST_CASE("FrameArena: pmr containers allocate from it and reset reuses the memory", "[common][arena]") {
+    FrameArena arena(4096);
+
+    std::pmr::vector<int> values(&arena);
+    values.resize(100);
+    std::iota(values.begin(), values.end(), 0);
+    REQUIRE(values[99] == 99);
+    REQUIRE(arena.used() >= 100 * sizeof(int));
+    auto *first = values.data();
+    REQUIRE(reinterpret_cast<std::uintptr_t>(first) % alignof(int) == 0);
+
+    // Over-aligned requests are honoured.
+    void *wide = arena.allocate(64, 64);
+    REQUIRE(reinterpret_cast<std::uintptr_t>(wide) % 64 == 0);
+    values = std::pmr::vector<int>(&arena);
+
+    arena.reset();
+    REQUIRE(arena.used() == 0);
+    REQUIRE(arena.generation() == 1);
+
+    // The next tick gets the same memory again.
+    std::pmr::vector<int> again(100, 0, &arena);
+    REQUIRE(arena.stats().chunks == 1);
+    REQUIRE(arena.stats().overflows == 0);
+    REQUIRE(arena.stats().staleReleases == 0);
+    static_cast<void>(again);
+}
+
+TEST_CASE("FrameArena: a tick that overflows grows the arena once", "[common][arena]") {
+    FrameArena arena(4096);
+
+    for (int tick = 0; tick < 3; ++tick) {
+        arena.reset();
+        std::vector<void *> blocks;
+        for (int i = 0; i < 40; ++i) {
+            blocks.push_back(arena.allocate(1000, 8));
+        }
+        REQUIRE(arena.used() >= 40 * 1000);
+    }
+    auto stats = arena.stats();
+    // Only the first tick overflowed; reset() merged its chunks into one that fits.
+    REQUIRE(stats.overflows > 0);
+    REQUIRE(stats.chunks == 1);
+    REQUIRE(stats.capacity >= 40 * 1000);
+    REQUIRE(stats.highWater >= 40 * 1000);
+    REQUIRE(stats.highWater <= stats.capacity);
+
+    auto overflows = stats.overflows;
+    arena.reset();
+    static_cast<void>(arena.allocate(1000, 8));
+    REQUIRE(arena.stats().overflows == overflows);
+    REQUIRE(arena.highWater() == stats.highWater); // survives resets
+
+    FrameArenaSet workers(3, 1024);
+    REQUIRE(workers.size() == 3);
+    static_cast<void>(workers[0].allocate(100, 8));
+    static_cast<void>(workers[2].allocate(200, 8));
+    REQUIRE(workers.used() >= 300);
+    REQUIRE(workers[1].used() == 0);
+}
+
+TEST_CASE("FrameArena: memory released after its tick is reported in checked builds", "[common][arena]") {
+    FrameArena arena(4096);
+
+    // Released within the tick: fine.
+    {
+        std::pmr::vector<int> local(10, 0, &arena);
+    }
+    REQUIRE(arena.stats().staleReleases == 0);
+
+    // A block kept past reset() is caught when it is finally released.
+    void *kept = arena.allocate(64, 8);
+    arena.reset();
+    std::pmr::vector<int> next(10, 0, &arena);
+    arena.deallocate(kept, 64, 8);
+    REQUIRE(arena.stats().staleReleases == (FrameArena::CHECKED ? 1u : 0u));
+
+    // The current tick's memory is not mistaken for stale.
+    next.clear();
+    next.shrink_to_fit();
+    REQUIRE(arena.stats().staleReleases == (FrameArena::CHECKED ? 1u : 0u));
+}
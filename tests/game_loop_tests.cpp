@@ -1,5 +1,6 @@
 #include <atomic>
 #include <cmath>
+#include <stdexcept>
 #include <thread>
 #include <vector>
 
@@ -94,6 +95,70 @@ TEST_CASE("GameLoop: metrics are populated after ticks", "[server][loop]") {
     REQUIRE(m.load >= 0.0);
 }
 
+TEST_CASE("GameLoop: latency histograms record every tick", "[server][loop]") {
+    GameLoop loop(200);
+    int ticks = 0;
+
+    loop.run(
+        [&]() { return ticks < 40; },
+        [&](float) {
+            ticks++;
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        });
+
+    const auto& m = loop.metrics();
+    REQUIRE(m.tickDurations.count() == 40);
+    REQUIRE(m.backlog.count() == 40);
+    REQUIRE(m.oversleep.count() > 0);
+
+    auto summary = m.tickDurations.summary();
+    REQUIRE(summary.p50 >= 150e-6);
+    REQUIRE(summary.p50 <= summary.p99);
+    REQUIRE(summary.p99 <= summary.max);
+}
+
+TEST_CASE("parseTickPacing: known and unknown names", "[server][loop]") {
+    REQUIRE(parseTickPacing("sleep") == TickPacing::Sleep);
+    REQUIRE(parseTickPacing("hybrid") == TickPacing::Hybrid);
+    REQUIRE_FALSE(parseTickPacing("spin").has_value());
+}
+
+TEST_CASE("GameLoop: hybrid pacing is the default", "[server][loop]") {
+    GameLoop loop(60);
+    REQUIRE(loop.pacing() == TickPacing::Hybrid);
+    REQUIRE(loop.metrics().spinWindow > 0.0);
+}
+
+TEST_CASE("GameLoop: tick start jitter is recorded between ticks", "[server][loop]") {
+    for (auto pacing : {TickPacing::Sleep, TickPacing::Hybrid}) {
+        GameLoop loop(100, pacing);
+        int ticks = 0;
+
+        loop.run(
+            [&]() { return ticks < 30; },
+            [&](float) { ticks++; });
+
+        const auto& m = loop.metrics();
+        REQUIRE(m.tickStartJitter.count() == 29);
+        REQUIRE(m.oversleep.count() > 0);
+        // Deadlines are absolute, so even late wake-ups must not add up:
+        // a start is never more than a full tick off schedule.
+        REQUIRE(m.tickStartJitter.max() < 0.01);
+    }
+}
+
+TEST_CASE("GameLoop: hybrid spin window stays within bounds", "[server][loop]") {
+    GameLoop loop(200, TickPacing::Hybrid);
+    int ticks = 0;
+
+    loop.run(
+        [&]() { return ticks < 40; },
+        [&](float) { ticks++; });
+
+    REQUIRE(loop.metrics().spinWindow >= 0.0001);
+    REQUIRE(loop.metrics().spinWindow <= 0.0025);
+}
+
 TEST_CASE("GameLoop: metrics load is reasonable for trivial ticks", "[server][loop]") {
     GameLoop loop(60);
     int ticks = 0;
@@ -160,3 +225,112 @@ TEST_CASE("GameLoop: tick count approximates real time", "[server][loop]") {
     REQUIRE(loop.currentTick() >= expected / 2);
     REQUIRE(loop.currentTick() <= expected * 3);
 }
+
+// --- Frame arenas ---
+
+TEST_CASE("GameLoop: registered frame arenas are reset before every tick", "[server][loop]") {
+    GameLoop loop(1000);
+    void_crew::FrameArena first;
+    void_crew::FrameArena second;
+    loop.resetEachTick(first);
+    loop.resetEachTick(second);
+    int ticks = 0;
+    bool startedEmpty = true;
+
+    loop.run(
+        [&]() { return ticks < 5; },
+        [&](float) {
+            startedEmpty = startedEmpty && first.used() == 0 && second.used() == 0;
+            ticks++;
+            static_cast<void>(first.allocate(ticks * 100, 8));
+            static_cast<void>(second.allocate(50, 8));
+        });
+
+    REQUIRE(startedEmpty);
+    REQUIRE(first.generation() == 5);
+    const auto& m = loop.metrics();
+    REQUIRE(m.arenaBytes >= 550);
+    REQUIRE(m.arenaHighWater >= 550);
+    REQUIRE(m.arenaHighWater >= m.arenaBytes);
+}
+
+// --- Run modes ---
+
+TEST_CASE("GameLoop: batch mode runs a fixed number of ticks without waiting", "[server][loop]") {
+    // Ten simulated seconds; real time would take that long.
+    GameLoop loop(60, TickPacing::Hybrid, {.mode = RunMode::Batch, .maxTicks = 600});
+    int ticks = 0;
+    float lastDt = 0.0f;
+
+    auto start = std::chrono::steady_clock::now();
+    loop.run([]() { return true; },
+             [&](float dt) {
+                 ticks++;
+                 lastDt = dt;
+             });
+    auto wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    REQUIRE(ticks == 600);
+    REQUIRE(loop.currentTick() == 600);
+    REQUIRE(wall < 2.0);
+    REQUIRE_THAT(lastDt, WithinRel(1.0f / 60.0f, 0.001f));
+
+    const auto& m = loop.metrics();
+    REQUIRE(m.totalTicks == 600);
+    REQUIRE(m.tickDurations.count() == 600);
+    REQUIRE(m.recentTickDurations.count == 600);
+    REQUIRE(m.oversleep.count() == 0);
+    REQUIRE(m.backlog.count() == 0);
+    REQUIRE(m.tickStartJitter.count() == 0);
+    REQUIRE(m.ticksPerSecond > 300.0);
+}
+
+TEST_CASE("GameLoop: scaled mode ticks faster than real time with the same dt", "[server][loop]") {
+    constexpr int TARGET_TICKS = 40;
+    constexpr double SCALE = 4.0;
+    GameLoop loop(50, TickPacing::Hybrid, {.mode = RunMode::Scaled, .timeScale = SCALE, .maxTicks = TARGET_TICKS});
+    std::vector<float> receivedDts;
+
+    auto start = std::chrono::steady_clock::now();
+    loop.run([]() { return true; }, [&](float dt) { receivedDts.push_back(dt); });
+    auto wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // 40 ticks at 50 Hz are 0.8 s of simulation: 0.2 s of wall time at 4x.
+    REQUIRE(receivedDts.size() == TARGET_TICKS);
+    for (float dt : receivedDts) {
+        REQUIRE_THAT(dt, WithinRel(1.0f / 50.0f, 0.001f));
+    }
+    REQUIRE(wall > 0.15);
+    REQUIRE(wall < 0.6);
+
+    // Jitter and load are measured against the 5 ms wall-clock interval, not dt.
+    const auto& m = loop.metrics();
+    REQUIRE(m.tickStartJitter.count() == TARGET_TICKS - 1);
+    REQUIRE(m.tickStartJitter.max() < 0.005);
+    REQUIRE(m.backlog.count() == TARGET_TICKS);
+    REQUIRE(m.ticksPerSecond > 100.0);
+    REQUIRE(loop.runOptions().mode == RunMode::Scaled);
+}
+
+TEST_CASE("GameLoop: tick budget is the wall-clock interval; batch mode has none", "[server][loop]") {
+    REQUIRE_THAT(GameLoop(50).tickBudget(), WithinRel(0.02, 1e-9));
+    REQUIRE_THAT(GameLoop(50, TickPacing::Hybrid, {.mode = RunMode::Scaled, .timeScale = 4.0}).tickBudget(),
+                 WithinRel(0.005, 1e-9));
+    REQUIRE(GameLoop(50, TickPacing::Hybrid, {.mode = RunMode::Batch}).tickBudget() == 0.0);
+}
+
+TEST_CASE("parseRunMode: names round-trip; non-positive time scale throws", "[server][loop]") {
+    for (auto mode : {RunMode::RealTime, RunMode::Scaled, RunMode::Batch}) {
+        REQUIRE(parseRunMode(runModeName(mode)) == mode);
+    }
+    REQUIRE_FALSE(parseRunMode("fast").has_value());
+
+    REQUIRE_THROWS_AS(GameLoop(60, TickPacing::Hybrid, {.mode = RunMode::Scaled, .timeScale = 0.0}),
+                      std::invalid_argument);
+    REQUIRE_THROWS_AS(GameLoop(60, TickPacing::Hybrid, {.timeScale = -1.0}), std::invalid_argument);
+
+    // A tick limit applies in real time too.
+    GameLoop limited(1000, TickPacing::Hybrid, {.maxTicks = 3});
+    limited.run([]() { return true; }, [](float) {});
+    REQUIRE(limited.currentTick() == 3);
+}
@@ -0,0 +1,125 @@
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "input_recording.hpp"
+
+using namespace void_crew::server;
+
+namespace {
+
+std::string tempPath(const char *name) {
+    return (std::filesystem::temp_directory_path() / name).string();
+}
+
+ClientCommand command(ClientId client, uint32_t sequence, uint8_t payloadSize) {
+    ClientCommand c;
+    c.client = client;
+    c.sequence = sequence;
+    c.type = static_cast<uint16_t>(0x100 + sequence);
+    c.payloadSize = payloadSize;
+    for (uint8_t i = 0; i < payloadSize; ++i) {
+        c.payload[i] = static_cast<std::byte>(sequence + i);
+    }
+    return c;
+}
+
+RecordingHeader header() {
+    return {.engineVersion = "1.2.3-test", .tickRate = 60, .worldSeed = 0xDEADBEEFCAFEF00DULL,
+            .maxClientCommandsPerTick = 16};
+}
+
+void writeBytes(const std::string &path, const std::vector<char> &bytes) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+}
+
+std::vector<char> readBytes(const std::string &path) {
+    std::ifstream in(path, std::ios::binary);
+    return {std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+}
+
+} // namespace
+
+TEST_CASE("InputRecorder: ticks, commands and hashes round-trip", "[server][replay]") {
+    auto path = tempPath("void_crew_test_recording.vcr");
+    std::vector<ClientCommand> first{command(1, 10, 0), command(2, 4, ClientCommand::MAX_PAYLOAD)};
+    std::vector<ClientCommand> third{command(1, 11, 5)};
+    {
+        InputRecorder recorder(path, header());
+        recorder.record(0, first, 0x1111);
+        recorder.record(1, {}, 0x2222);
+        recorder.record(2, third, 0x3333);
+        REQUIRE(recorder.ticks() == 3);
+        REQUIRE(recorder.commands() == 3);
+        REQUIRE(recorder.good());
+    }
+
+    auto recording = loadRecording(path);
+    REQUIRE(recording.header.engineVersion == "1.2.3-test");
+    REQUIRE(recording.header.tickRate == 60);
+    REQUIRE(recording.header.worldSeed == 0xDEADBEEFCAFEF00DULL);
+    REQUIRE(recording.header.maxClientCommandsPerTick == 16);
+    REQUIRE(recording.ticks.size() == 3);
+    REQUIRE(recording.ticks[1].stateHash == 0x2222);
+    REQUIRE(recording.commandsOf(recording.ticks[1]).empty());
+
+    auto commands = recording.commandsOf(recording.ticks[0]);
+    REQUIRE(commands.size() == 2);
+    REQUIRE(commands[1].client == 2);
+    REQUIRE(commands[1].sequence == 4);
+    REQUIRE(commands[1].type == 0x104);
+    REQUIRE(commands[1].payloadSize == ClientCommand::MAX_PAYLOAD);
+    REQUIRE(commands[1].payload == first[1].payload);
+
+    auto last = recording.commandsOf(recording.ticks[2]);
+    REQUIRE(last.size() == 1);
+    REQUIRE(last[0].tick == 2); // stamped like CommandQueue::drain() does
+    REQUIRE(last[0].payload == third[0].payload);
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("loadRecording: a tick cut off mid-write is dropped", "[server][replay]") {
+    auto path = tempPath("void_crew_test_truncated.vcr");
+    {
+        InputRecorder recorder(path, header());
+        recorder.record(0, std::vector{command(1, 1, 8)}, 1);
+        recorder.record(1, std::vector{command(1, 2, 8)}, 2);
+    }
+    auto bytes = readBytes(path);
+    bytes.resize(bytes.size() - 3);
+    writeBytes(path, bytes);
+
+    auto recording = loadRecording(path);
+    REQUIRE(recording.ticks.size() == 1);
+    REQUIRE(recording.commands.size() == 1);
+    REQUIRE(recording.commands[0].sequence == 1);
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("loadRecording: missing, foreign and truncated files throw", "[server][replay]") {
+    auto path = tempPath("void_crew_test_bad.vcr");
+    REQUIRE_THROWS_AS(loadRecording(tempPath("void_crew_test_missing.vcr")), std::runtime_error);
+
+    writeBytes(path, {'N', 'O', 'T', 'A', 'R', 'E', 'C', 'O', 'R', 'D', 'I', 'N', 'G'});
+    REQUIRE_THROWS_AS(loadRecording(path), std::runtime_error);
+
+    {
+        InputRecorder recorder(path, header());
+    }
+    auto bytes = readBytes(path);
+    auto wrongVersion = bytes;
+    wrongVersion[8] = static_cast<char>(RECORDING_FORMAT_VERSION + 1);
+    writeBytes(path, wrongVersion);
+    REQUIRE_THROWS_AS(loadRecording(path), std::runtime_error);
+
+    bytes.resize(bytes.size() - 1);
+    writeBytes(path, bytes);
+    REQUIRE_THROWS_AS(loadRecording(path), std::runtime_error);
+    std::filesystem::remove(path);
+}
@@ -0,0 +1,133 @@
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+#include <entt/entt.hpp>
+
+#include "components.hpp"
+#include "interest_manager.hpp"
+
+using namespace void_crew;
+using namespace void_crew::server;
+
+namespace {
+
+entt::entity spawn(entt::registry &registry, uint32_t id, std::optional<CompartmentId> compartment,
+                   glm::vec3 position = {1.2f, 0.0f, 0.0f}) {
+    auto entity = registry.create();
+    registry.emplace<NetworkId>(entity, id);
+    registry.emplace<Transform>(entity, Transform{position});
+    registry.emplace<Velocity>(entity, Velocity{{1.0f, 0.0f, 0.0f}, {}});
+    if (compartment) {
+        registry.emplace<InCompartment>(entity, *compartment);
+    }
+    return entity;
+}
+
+entt::entity door(entt::registry &registry, CompartmentId first, CompartmentId second, bool open) {
+    auto entity = registry.create();
+    registry.emplace<Door>(entity, first, second, open);
+    return entity;
+}
+
+std::vector<uint32_t> ids(const WorldState &state) {
+    std::vector<uint32_t> out;
+    for (const auto &entity : state.entities) {
+        out.push_back(entity.id);
+    }
+    return out;
+}
+
+} // namespace
+
+// Corridor of compartments 1 - 2 - 3 - 4; the viewer stands in 1.
+TEST_CASE("InterestManager: tiers follow open doors and stop at closed ones", "[server][interest]") {
+    entt::registry registry;
+    InterestManager interest(registry);
+
+    auto viewer = spawn(registry, 100, 1);
+    auto near = spawn(registry, 2, 2);
+    auto far = spawn(registry, 3, 3);
+    auto sealed = spawn(registry, 4, 4);
+    auto outside = spawn(registry, 5, std::nullopt);
+    door(registry, 1, 2, true);
+    door(registry, 2, 3, true);
+    auto bulkhead = door(registry, 3, 4, false);
+    interest.setViewer(7, viewer);
+
+    REQUIRE(interest.tier(7, viewer) == DetailTier::Full);
+    REQUIRE(interest.tier(7, near) == DetailTier::Full);
+    REQUIRE(interest.tier(7, far) == DetailTier::Coarse);
+    REQUIRE(interest.tier(7, sealed) == DetailTier::None);
+    REQUIRE(interest.tier(7, outside) == DetailTier::Coarse);
+    REQUIRE(interest.tier(8, near) == DetailTier::None); // no viewer for this client
+
+    registry.patch<Door>(bulkhead, [](Door &d) { d.open = true; });
+    REQUIRE(interest.tier(7, sealed) == DetailTier::Coarse);
+
+    registry.destroy(bulkhead);
+    REQUIRE(interest.tier(7, sealed) == DetailTier::None);
+
+    registry.patch<Door>(door(registry, 1, 3, true), [](Door &) {});
+    REQUIRE(interest.tier(7, far) == DetailTier::Full);
+}
+
+TEST_CASE("InterestManager: membership index follows moves and removals", "[server][interest]") {
+    entt::registry registry;
+    auto early = spawn(registry, 1, 5); // exists before the manager
+    InterestManager interest(registry);
+    auto late = spawn(registry, 2, 5);
+    auto local = registry.create();
+    registry.emplace<InCompartment>(local, 5u); // not replicated
+
+    REQUIRE(interest.members(5).size() == 2);
+
+    registry.replace<InCompartment>(early, 6u);
+    REQUIRE(interest.members(5).size() == 1);
+    REQUIRE(interest.members(5)[0] == late);
+    REQUIRE(interest.members(6).size() == 1);
+
+    registry.remove<InCompartment>(late);
+    REQUIRE(interest.members(5).empty());
+
+    registry.destroy(early);
+    REQUIRE(interest.members(6).empty());
+    REQUIRE(interest.members(42).empty());
+}
+
+TEST_CASE("InterestManager: views hold visible entities only, coarse ones snapped", "[server][interest]") {
+    entt::registry registry;
+    InterestManager interest(registry);
+
+    auto first = spawn(registry, 10, 1);
+    auto second = spawn(registry, 20, 3);
+    spawn(registry, 11, 1, {0.3f, 0.0f, 0.0f});
+    spawn(registry, 30, 3, {1.3f, 2.6f, -0.2f});
+    spawn(registry, 40, 9); // sealed off
+    door(registry, 1, 2, true);
+    door(registry, 2, 3, true);
+    interest.setViewer(1, first);
+    interest.setViewer(2, second);
+
+    std::vector<ClientView> views;
+    interest.buildViews(77, views);
+    REQUIRE(views.size() == 2);
+    REQUIRE(views[0].client == 1);
+    REQUIRE(views[0].state.tick == 77);
+    REQUIRE(ids(views[0].state) == std::vector<uint32_t>{10, 11, 20, 30});
+    REQUIRE(ids(views[1].state) == std::vector<uint32_t>{10, 11, 20, 30});
+
+    const auto &fromFirst = views[0].state.entities;
+    REQUIRE(fromFirst[1].position.x == 0.3f); // same compartment: exact
+    REQUIRE(fromFirst[1].linearVelocity.x == 1.0f);
+    REQUIRE(fromFirst[3].position == glm::vec3{1.5f, 2.5f, 0.0f}); // two doors away: coarse
+    REQUIRE(fromFirst[3].linearVelocity == glm::vec3{0.0f});
+    REQUIRE(views[0].relevance == std::vector<float>{1.0f, 1.0f, COARSE_RELEVANCE, COARSE_RELEVANCE});
+    REQUIRE(views[0].hasViewpoint);
+
+    interest.removeViewer(2);
+    interest.buildViews(78, views);
+    REQUIRE(views.size() == 1);
+    REQUIRE(interest.viewerCount() == 1);
+}
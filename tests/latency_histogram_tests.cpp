@@ -0,0 +1,98 @@
+#include <cstdint>
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+
+#include "latency_histogram.hpp"
+
+using namespace void_crew;
+using Catch::Matchers::WithinAbs;
+using Catch::Matchers::WithinRel;
+
+TEST_CASE("LatencyHistogram: empty histogram reports zeros", "[common][histogram]") {
+    LatencyHistogram h;
+    REQUIRE(h.count() == 0);
+    REQUIRE(h.percentile(0.99) == 0.0);
+    REQUIRE(h.max() == 0.0);
+    REQUIRE(h.mean() == 0.0);
+
+    auto s = h.summary();
+    REQUIRE(s.count == 0);
+    REQUIRE(s.p99 == 0.0);
+}
+
+TEST_CASE("LatencyHistogram: small values are exact", "[common][histogram]") {
+    LatencyHistogram h;
+    for (uint64_t ns = 1; ns <= 100; ++ns) {
+        h.recordNanoseconds(ns);
+    }
+    REQUIRE(h.count() == 100);
+    REQUIRE_THAT(h.percentile(0.50), WithinAbs(50e-9, 1e-15));
+    REQUIRE_THAT(h.percentile(0.99), WithinAbs(99e-9, 1e-15));
+    REQUIRE_THAT(h.percentile(1.0), WithinAbs(100e-9, 1e-15));
+}
+
+TEST_CASE("LatencyHistogram: large values stay within relative precision", "[common][histogram]") {
+    LatencyHistogram h;
+    // 1..1000 microseconds, one sample each
+    for (int us = 1; us <= 1000; ++us) {
+        h.record(us * 1e-6);
+    }
+
+    auto s = h.summary();
+    REQUIRE(s.count == 1000);
+    REQUIRE_THAT(s.p50, WithinRel(500e-6, 0.02));
+    REQUIRE_THAT(s.p90, WithinRel(900e-6, 0.02));
+    REQUIRE_THAT(s.p99, WithinRel(990e-6, 0.02));
+    REQUIRE_THAT(s.p999, WithinRel(999e-6, 0.02));
+    REQUIRE_THAT(s.max, WithinRel(1000e-6, 1e-9));
+}
+
+TEST_CASE("LatencyHistogram: tail is visible when the average is not", "[common][histogram]") {
+    LatencyHistogram h;
+    for (int i = 0; i < 990; ++i) {
+        h.record(0.001);
+    }
+    for (int i = 0; i < 10; ++i) {
+        h.record(0.050);
+    }
+
+    REQUIRE_THAT(h.percentile(0.50), WithinRel(0.001, 0.02));
+    REQUIRE_THAT(h.percentile(0.995), WithinRel(0.050, 0.02));
+    REQUIRE_THAT(h.mean(), WithinRel(0.00149, 0.01));
+}
+
+TEST_CASE("LatencyHistogram: percentiles never exceed the recorded max", "[common][histogram]") {
+    LatencyHistogram h;
+    h.recordNanoseconds(1'000'001);
+    REQUIRE(h.percentile(1.0) <= h.max());
+    REQUIRE_THAT(h.max(), WithinAbs(0.001000001, 1e-12));
+}
+
+TEST_CASE("LatencyHistogram: negative and huge values are clamped", "[common][histogram]") {
+    LatencyHistogram h;
+    h.record(-1.0);
+    h.record(1e9);
+    REQUIRE(h.count() == 2);
+    REQUIRE(h.percentile(0.0) == 0.0);
+    REQUIRE_THAT(h.max(), WithinRel(static_cast<double>(LatencyHistogram::MAX_TRACKABLE_NS) / 1e9, 1e-9));
+}
+
+TEST_CASE("LatencyHistogram: merge and reset", "[common][histogram]") {
+    LatencyHistogram a;
+    LatencyHistogram b;
+    for (int i = 0; i < 50; ++i) {
+        a.record(0.001);
+        b.record(0.003);
+    }
+
+    a.merge(b);
+    REQUIRE(a.count() == 100);
+    REQUIRE_THAT(a.max(), WithinRel(0.003, 1e-6));
+    REQUIRE_THAT(a.percentile(0.25), WithinRel(0.001, 0.02));
+    REQUIRE_THAT(a.percentile(0.75), WithinRel(0.003, 0.02));
+
+    a.reset();
+    REQUIRE(a.count() == 0);
+    REQUIRE(a.percentile(0.5) == 0.0);
+}
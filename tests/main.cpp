@@ -3,6 +3,7 @@
 
 #include <filesystem>
 #include <fstream>
+#include <memory>
 #include <string>
 #include <string_view>
 
@@ -63,6 +64,12 @@ static void resetDefaultLogger() {
     spdlog::set_default_logger(
         std::make_shared<spdlog::logger>("default",
             std::make_shared<spdlog::sinks::stdout_color_sink_mt>()));
+    void_crew::refreshTagLoggers();
+}
+
+static std::string readFile(const std::filesystem::path& path) {
+    std::ifstream f(path);
+    return std::string((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
 }
 
 TEST_CASE("initLogging creates log file and writes to it", "[logging]") {
@@ -169,3 +176,99 @@ TEST_CASE("getLogger returns same instance for same tag", "[logging]") {
     REQUIRE(a.get() == b.get());
     resetDefaultLogger();
 }
+
+// One call site reused across re-initializations; its cached logger must follow.
+static void logFromFixedCallSite(int value) {
+    TLOG_INFO("cached", "call site value {}", value);
+}
+
+TEST_CASE("TLOG call site follows logger re-initialization", "[logging]") {
+    auto logDir = std::filesystem::temp_directory_path() / "void_crew_test_reinit";
+    std::error_code ec;
+    std::filesystem::remove_all(logDir, ec);
+
+    void_crew::initLogging("info", logDir / "first.log");
+    logFromFixedCallSite(1);
+    void_crew::getLogger("cached")->flush();
+
+    void_crew::initLogging("info", logDir / "second.log");
+    logFromFixedCallSite(2);
+    void_crew::getLogger("cached")->flush();
+
+    auto first = readFile(logDir / "first.log");
+    auto second = readFile(logDir / "second.log");
+    REQUIRE(first.find("call site value 1") != std::string::npos);
+    REQUIRE(first.find("call site value 2") == std::string::npos);
+    REQUIRE(second.find("[cached] call site value 2") != std::string::npos);
+
+    resetDefaultLogger();
+}
+
+TEST_CASE("refreshTagLoggers releases loggers two generations old", "[logging]") {
+    void_crew::initLogging();
+    std::weak_ptr<spdlog::logger> old = void_crew::getLogger("test_retire");
+    void_crew::refreshTagLoggers();
+    REQUIRE_FALSE(old.expired()); // a call site may still be using it
+    void_crew::refreshTagLoggers();
+    REQUIRE(old.expired());
+    resetDefaultLogger();
+}
+
+TEST_CASE("resolveTagLogger records keep the generation they were resolved in", "[logging]") {
+    void_crew::initLogging();
+    const auto* first = void_crew::detail::resolveTagLogger("test_pair");
+    REQUIRE(first->generation == void_crew::detail::g_tagLoggerGeneration.load());
+    REQUIRE(first->logger == void_crew::getLogger("test_pair").get());
+    REQUIRE(void_crew::detail::resolveTagLogger("test_pair") == first);
+
+    void_crew::refreshTagLoggers();
+    void_crew::refreshTagLoggers();
+    // The logger is gone, but the record still names its own generation, so
+    // a call site that cached it re-resolves instead of using it.
+    REQUIRE(first->generation != void_crew::detail::g_tagLoggerGeneration.load());
+    const auto* second = void_crew::detail::resolveTagLogger("test_pair");
+    REQUIRE(second != first);
+    REQUIRE(second->generation == void_crew::detail::g_tagLoggerGeneration.load());
+    REQUIRE(second->logger == void_crew::getLogger("test_pair").get());
+    resetDefaultLogger();
+}
+
+TEST_CASE("TLOG does not evaluate arguments when filtered", "[logging]") {
+    auto logDir = std::filesystem::temp_directory_path() / "void_crew_test_lazy";
+    std::error_code ec;
+    std::filesystem::remove_all(logDir, ec);
+
+    void_crew::initLogging("warn", logDir / "lazy.log");
+    int evaluations = 0;
+    auto expensive = [&]() {
+        evaluations++;
+        return 42;
+    };
+
+    TLOG_INFO("lazy", "filtered {}", expensive());
+    REQUIRE(evaluations == 0);
+
+    TLOG_WARN("lazy", "emitted {}", expensive());
+    REQUIRE(evaluations == 1);
+
+    resetDefaultLogger();
+}
+
+TEST_CASE("TLOG respects runtime level changes", "[logging]") {
+    auto logDir = std::filesystem::temp_directory_path() / "void_crew_test_runtime_level";
+    auto logFile = logDir / "runtime.log";
+    std::error_code ec;
+    std::filesystem::remove_all(logDir, ec);
+
+    void_crew::initLogging("info", logFile);
+    TLOG_INFO("runtime", "before level change");
+    spdlog::set_level(spdlog::level::warn);
+    TLOG_INFO("runtime", "after level change");
+    void_crew::getLogger("runtime")->flush();
+
+    auto contents = readFile(logFile);
+    REQUIRE(contents.find("before level change") != std::string::npos);
+    REQUIRE(contents.find("after level change") == std::string::npos);
+
+    resetDefaultLogger();
+}
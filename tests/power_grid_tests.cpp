@@ -0,0 +1,154 @@
+#include <limits>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include <entt/entt.hpp>
+
+#include "power_grid.hpp"
+
+using namespace void_crew::server;
+using Catch::Matchers::WithinAbs;
+
+namespace {
+
+constexpr uint8_t LIGHTS = 0;
+constexpr uint8_t LIFE_SUPPORT = POWER_PRIORITIES - 1;
+
+entt::entity generator(entt::registry &registry, float capacity) {
+    auto entity = registry.create();
+    registry.emplace<PowerSource>(entity, PowerSource{capacity});
+    return entity;
+}
+
+entt::entity junction(entt::registry &registry, entt::entity upstream,
+                      float rating = std::numeric_limits<float>::infinity()) {
+    auto entity = registry.create();
+    registry.emplace<PowerLink>(entity, PowerLink{upstream, rating, true});
+    return entity;
+}
+
+entt::entity consumer(entt::registry &registry, entt::entity upstream, float demand, uint8_t priority) {
+    auto entity = junction(registry, upstream);
+    registry.emplace<PowerConsumer>(entity, PowerConsumer{demand, priority});
+    return entity;
+}
+
+} // namespace
+
+TEST_CASE("PowerGrid: a switch flip moves only its own subtree", "[server][power]") {
+    entt::registry registry;
+    PowerGrid grid(registry);
+    auto reactor = generator(registry, 1e6f);
+
+    // Two decks of 100 consumers each behind their own switch.
+    auto bow = junction(registry, reactor);
+    auto stern = junction(registry, reactor);
+    std::vector<entt::entity> bowLoads;
+    for (int i = 0; i < 100; ++i) {
+        bowLoads.push_back(consumer(registry, bow, 100.0f, LIGHTS));
+        consumer(registry, stern, 50.0f, LIGHTS);
+    }
+    grid.update();
+    REQUIRE(grid.isPowered(bowLoads.front()));
+    REQUIRE_THAT(grid.load(reactor), WithinAbs(15'000.0f, 0.01f));
+    REQUIRE_THAT(grid.load(bow), WithinAbs(10'000.0f, 0.01f));
+
+    registry.patch<PowerLink>(bow, [](PowerLink &link) { link.closed = false; });
+    grid.update();
+    REQUIRE_FALSE(grid.isEnergized(bow));
+    REQUIRE_FALSE(grid.isPowered(bowLoads.back()));
+    REQUIRE_THAT(grid.load(reactor), WithinAbs(5'000.0f, 0.01f));
+    // The switch, its 100 consumers and the reactor above it; nothing astern.
+    REQUIRE(grid.stats().propagated <= 102);
+
+    // A demand change walks up to the source only.
+    registry.patch<PowerLink>(bow, [](PowerLink &link) { link.closed = true; });
+    grid.update();
+    registry.patch<PowerConsumer>(bowLoads[7], [](PowerConsumer &c) { c.demand = 1100.0f; });
+    grid.update();
+    REQUIRE(grid.stats().propagated == 2);
+    REQUIRE_THAT(grid.load(reactor), WithinAbs(16'000.0f, 0.01f));
+
+    // Destroying the switch cuts everything behind it.
+    registry.destroy(bow);
+    grid.update();
+    REQUIRE_FALSE(grid.isPowered(bowLoads.front()));
+    REQUIRE_THAT(grid.load(reactor), WithinAbs(5'000.0f, 0.01f));
+}
+
+TEST_CASE("PowerGrid: a damaged generator sheds the lowest priorities first", "[server][power]") {
+    entt::registry registry;
+    PowerGrid grid(registry);
+    auto reactor = generator(registry, 1000.0f);
+    auto lights = consumer(registry, reactor, 300.0f, LIGHTS);
+    auto turret = consumer(registry, reactor, 400.0f, 1);
+    auto scrubbers = consumer(registry, reactor, 200.0f, LIFE_SUPPORT);
+    grid.update();
+    REQUIRE(grid.isPowered(lights));
+    REQUIRE_THAT(grid.load(reactor), WithinAbs(900.0f, 0.01f));
+
+    registry.patch<PowerSource>(reactor, [](PowerSource &source) { source.capacity = 650.0f; });
+    grid.update();
+    REQUIRE_FALSE(grid.isPowered(lights));
+    REQUIRE(grid.isEnergized(lights));
+    REQUIRE(grid.isPowered(turret));
+    REQUIRE(grid.isPowered(scrubbers));
+    REQUIRE_THAT(grid.load(reactor), WithinAbs(600.0f, 0.01f));
+
+    // Whole classes go: lights would fit on their own, but not after the turret.
+    registry.patch<PowerSource>(reactor, [](PowerSource &source) { source.capacity = 550.0f; });
+    grid.update();
+    REQUIRE_FALSE(grid.isPowered(lights));
+    REQUIRE_FALSE(grid.isPowered(turret));
+    REQUIRE(grid.isPowered(scrubbers));
+
+    registry.patch<PowerSource>(reactor, [](PowerSource &source) { source.capacity = 1000.0f; });
+    grid.update();
+    REQUIRE(grid.isPowered(lights));
+    REQUIRE(grid.isPowered(turret));
+}
+
+TEST_CASE("PowerGrid: breaker trips cascade within one update", "[server][power]") {
+    entt::registry registry;
+    PowerGrid grid(registry);
+    auto reactor = generator(registry, 800.0f);
+    auto engineering = junction(registry, reactor, 500.0f);
+    auto habitat = junction(registry, reactor, 450.0f);
+    auto drive = consumer(registry, engineering, 400.0f, 1);
+    auto lights = consumer(registry, habitat, 300.0f, LIGHTS);
+    auto scrubbers = consumer(registry, habitat, 200.0f, LIFE_SUPPORT);
+    grid.update();
+    REQUIRE_FALSE(grid.isPowered(lights)); // shed: the habitat breaker carries 200 W
+    REQUIRE(grid.isPowered(scrubbers));
+    REQUIRE(grid.stats().trips == 0);
+
+    // The drive surges past its breaker. What it drops lets the reactor take
+    // the lights back, which overloads the habitat breaker in turn.
+    registry.patch<PowerConsumer>(drive, [](PowerConsumer &c) { c.demand = 600.0f; });
+    grid.update();
+    REQUIRE(grid.isTripped(engineering));
+    REQUIRE_FALSE(grid.isPowered(drive));
+    REQUIRE(grid.isTripped(habitat));
+    REQUIRE_FALSE(grid.isPowered(scrubbers));
+    REQUIRE(grid.stats().trips == 2);
+    REQUIRE(grid.stats().tripped == 2);
+    REQUIRE(grid.stats().passes >= 2);
+    REQUIRE_THAT(grid.load(reactor), WithinAbs(0.0f, 0.01f));
+
+    // Switching the lights off and resetting brings the habitat back alone.
+    registry.patch<PowerLink>(lights, [](PowerLink &link) { link.closed = false; });
+    grid.reset(habitat);
+    grid.update();
+    REQUIRE_FALSE(grid.isTripped(habitat));
+    REQUIRE(grid.isPowered(scrubbers));
+    REQUIRE(grid.isTripped(engineering));
+    REQUIRE(grid.stats().tripped == 1);
+    REQUIRE_THAT(grid.load(habitat), WithinAbs(200.0f, 0.01f));
+
+    // Feeding the habitat from its own consumer would close a loop: refused.
+    registry.patch<PowerLink>(habitat, [&](PowerLink &link) { link.upstream = scrubbers; });
+    grid.update();
+    REQUIRE_FALSE(grid.isPowered(scrubbers));
+    REQUIRE_THAT(grid.load(reactor), WithinAbs(0.0f, 0.01f));
+}
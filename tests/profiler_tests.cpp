@@ -0,0 +1,175 @@
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "profiler.hpp"
+
+using namespace void_crew;
+
+namespace {
+
+std::vector<ProfileEvent> eventsNamed(const std::vector<ProfileEvent>& events, const char* name) {
+    std::vector<ProfileEvent> matching;
+    std::copy_if(events.begin(), events.end(), std::back_inserter(matching),
+                 [name](const ProfileEvent& e) { return e.name != nullptr && std::strcmp(e.name, name) == 0; });
+    return matching;
+}
+
+} // namespace
+
+TEST_CASE("ProfileRing: snapshot returns recorded events oldest first", "[common][profiler]") {
+    ProfileRing ring;
+    ring.record("a", 100, 10, ProfileEventKind::Zone);
+    ring.record("b", 200, 0, ProfileEventKind::Frame);
+
+    auto events = ring.snapshot();
+    REQUIRE(events.size() == 2);
+    REQUIRE(std::string(events[0].name) == "a");
+    REQUIRE(events[0].startNs == 100);
+    REQUIRE(events[0].durationNs == 10);
+    REQUIRE(events[0].kind == ProfileEventKind::Zone);
+    REQUIRE(events[0].threadId == profileThreadId());
+    REQUIRE(events[1].kind == ProfileEventKind::Frame);
+}
+
+TEST_CASE("ProfileRing: keeps only the most recent CAPACITY events", "[common][profiler]") {
+    ProfileRing ring;
+    const auto total = ProfileRing::CAPACITY + 10;
+    for (uint64_t i = 0; i < total; ++i) {
+        ring.record("z", i, 1, ProfileEventKind::Zone);
+    }
+
+    auto events = ring.snapshot();
+    REQUIRE(events.size() == ProfileRing::CAPACITY);
+    REQUIRE(events.front().startNs == 10);
+    REQUIRE(events.back().startNs == total - 1);
+}
+
+TEST_CASE("ProfileRing: clear hides earlier events", "[common][profiler]") {
+    ProfileRing ring;
+    ring.record("old", 1, 1, ProfileEventKind::Zone);
+    ring.clear();
+    ring.record("new", 2, 1, ProfileEventKind::Zone);
+
+    auto events = ring.snapshot();
+    REQUIRE(events.size() == 1);
+    REQUIRE(std::string(events[0].name) == "new");
+}
+
+TEST_CASE("ProfileRing: concurrent writers lose nothing below capacity", "[common][profiler]") {
+    ProfileRing ring;
+    constexpr int THREADS = 4;
+    constexpr int PER_THREAD = 1000;
+
+    std::vector<std::thread> writers;
+    for (int t = 0; t < THREADS; ++t) {
+        writers.emplace_back([&ring]() {
+            for (int i = 0; i < PER_THREAD; ++i) {
+                ring.record("w", profileNowNs(), 1, ProfileEventKind::Zone);
+            }
+        });
+    }
+    for (auto& writer : writers) {
+        writer.join();
+    }
+
+    auto events = ring.snapshot();
+    REQUIRE(events.size() == THREADS * PER_THREAD);
+
+    std::vector<uint32_t> threads;
+    for (const auto& e : events) {
+        threads.push_back(e.threadId);
+    }
+    std::sort(threads.begin(), threads.end());
+    threads.erase(std::unique(threads.begin(), threads.end()), threads.end());
+    REQUIRE(threads.size() == THREADS);
+}
+
+TEST_CASE("ProfileRing: writes Chrome trace JSON", "[common][profiler]") {
+    ProfileRing ring;
+    ring.record("physics", 5000, 2500, ProfileEventKind::Zone);
+    ring.record("frame", 8000, 0, ProfileEventKind::Frame);
+    ring.record("say \"hi\"", 9000, 1000, ProfileEventKind::Zone);
+
+    std::ostringstream out;
+    ring.writeChromeTrace(out);
+    auto json = out.str();
+
+    REQUIRE(json.find("\"traceEvents\":[") != std::string::npos);
+    REQUIRE(json.find("{\"name\":\"physics\",\"ph\":\"X\",\"ts\":0.000,\"dur\":2.500,\"pid\":1") != std::string::npos);
+    REQUIRE(json.find("{\"name\":\"frame\",\"ph\":\"i\",\"s\":\"g\",\"ts\":3.000") != std::string::npos);
+    REQUIRE(json.find("\"say \\\"hi\\\"\"") != std::string::npos);
+    REQUIRE(json.rfind("]}") != std::string::npos);
+}
+
+TEST_CASE("ProfileRing: writes trace file and creates directories", "[common][profiler]") {
+    auto dir = std::filesystem::temp_directory_path() / "void_crew_test_profile";
+    std::error_code ec;
+    std::filesystem::remove_all(dir, ec);
+
+    ProfileRing ring;
+    ring.record("tick", 0, 1000, ProfileEventKind::Zone);
+    REQUIRE(ring.writeChromeTrace(dir / "nested" / "trace.json"));
+
+    std::ifstream f(dir / "nested" / "trace.json");
+    std::string contents((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+    REQUIRE(contents.find("\"name\":\"tick\"") != std::string::npos);
+
+    std::filesystem::remove_all(dir, ec);
+}
+
+TEST_CASE("internProfileName: returns one stable pointer per name", "[common][profiler]") {
+    std::string name = "atmosphere";
+    const char* first = internProfileName(name);
+    name = "changed";
+    const char* second = internProfileName("atmosphere");
+
+    REQUIRE(first == second);
+    REQUIRE(std::string(first) == "atmosphere");
+    REQUIRE(internProfileName("power") != first);
+}
+
+#ifndef VOID_CREW_TRACY
+TEST_CASE("PROFILE_ZONE and PROFILE_FRAME record into the global ring", "[common][profiler]") {
+    profileRing().clear();
+    {
+        PROFILE_ZONE("outer_zone_test");
+        {
+            PROFILE_ZONE_NAMED(internProfileName("inner_zone_test"));
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+    PROFILE_FRAME();
+
+    auto events = profileRing().snapshot();
+    auto outer = eventsNamed(events, "outer_zone_test");
+    auto inner = eventsNamed(events, "inner_zone_test");
+    REQUIRE(outer.size() == 1);
+    REQUIRE(inner.size() == 1);
+    REQUIRE(inner[0].durationNs >= 1'000'000);
+    REQUIRE(outer[0].startNs <= inner[0].startNs);
+    REQUIRE(outer[0].durationNs >= inner[0].durationNs);
+    REQUIRE(eventsNamed(events, "frame").size() == 1);
+}
+
+TEST_CASE("setProfilingEnabled(false) stops recording", "[common][profiler]") {
+    profileRing().clear();
+    setProfilingEnabled(false);
+    {
+        PROFILE_ZONE("disabled_zone_test");
+    }
+    PROFILE_FRAME();
+    setProfilingEnabled(true);
+
+    REQUIRE(profileRing().snapshot().empty());
+}
+#endif
@@ -6,9 +6,12 @@
 #include <catch2/catch_test_macros.hpp>
 
 #include "command_line.hpp"
+#include "components.hpp"
+#include "server.hpp"
 #include "server_config.hpp"
 #include "signal_handler.hpp"
 
+using namespace void_crew;
 using namespace void_crew::server;
 
 // Helper: convert string args to argc/argv
@@ -55,6 +58,30 @@ TEST_CASE("parseCommandLine: combined flags", "[server][cli]") {
     REQUIRE(args->configPath == "other.toml");
 }
 
+TEST_CASE("parseCommandLine: --record and --replay set their files", "[server][cli]") {
+    auto args = parse({"server", "--record", "session.vcr"});
+    REQUIRE(args.has_value());
+    REQUIRE(args->recordFile == "session.vcr");
+    REQUIRE(args->replayFile.empty());
+
+    args = parse({"server", "--replay", "session.vcr"});
+    REQUIRE(args->replayFile == "session.vcr");
+    REQUIRE_THROWS_AS(parse({"server", "--replay"}), std::runtime_error);
+}
+
+TEST_CASE("parseCommandLine: run mode, time scale and tick limit", "[server][cli]") {
+    auto args = parse({"server", "--mode", "scaled", "--time-scale", "4", "--ticks", "36000"});
+    REQUIRE(args.has_value());
+    REQUIRE(args->runMode == RunMode::Scaled);
+    REQUIRE(*args->timeScale == 4.0);
+    REQUIRE(*args->maxTicks == 36000);
+
+    REQUIRE_FALSE(parse({"server"})->runMode.has_value());
+    REQUIRE_THROWS_AS(parse({"server", "--mode", "fast"}), std::runtime_error);
+    REQUIRE_THROWS_AS(parse({"server", "--time-scale", "0"}), std::runtime_error);
+    REQUIRE_THROWS_AS(parse({"server", "--ticks", "-5"}), std::runtime_error);
+}
+
 TEST_CASE("parseCommandLine: --help returns nullopt", "[server][cli]") {
     auto args = parse({"server", "--help"});
     REQUIRE_FALSE(args.has_value());
@@ -104,6 +131,10 @@ TEST_CASE("loadConfig: missing file uses defaults", "[server][config]") {
     REQUIRE(cfg.tickRate == DEFAULT_TICK_RATE);
     REQUIRE(cfg.name == "Void Crew Server");
     REQUIRE(cfg.logLevel == "info");
+    REQUIRE(cfg.workerThreads == 0);
+    REQUIRE(cfg.tickPacing == TickPacing::Hybrid);
+    REQUIRE(cfg.logMode == LogMode::Async);
+    REQUIRE(cfg.logOverflow == void_crew::LogOverflowPolicy::DropLowestLevel);
 }
 
 TEST_CASE("loadConfig: reads values from TOML", "[server][config]") {
@@ -129,6 +160,100 @@ TEST_CASE("loadConfig: partial TOML uses defaults for missing keys", "[server][c
     REQUIRE(cfg.maxPlayers == DEFAULT_MAX_PLAYERS);
 }
 
+TEST_CASE("loadConfig: reads tick pacing", "[server][config]") {
+    TempConfigFile file("[server]\npacing = \"sleep\"\n", "pacing.toml");
+    CommandLineArgs args;
+    args.configPath = file.path();
+    REQUIRE(loadConfig(args).tickPacing == TickPacing::Sleep);
+
+    TempConfigFile bad("[server]\npacing = \"busy\"\n", "bad_pacing.toml");
+    args.configPath = bad.path();
+    REQUIRE_THROWS_AS(loadConfig(args), std::runtime_error);
+}
+
+TEST_CASE("loadConfig: reads worker_threads", "[server][config]") {
+    TempConfigFile file("[server]\nworker_threads = 6\n");
+    CommandLineArgs args;
+    args.configPath = file.path();
+    auto cfg = loadConfig(args);
+    REQUIRE(cfg.workerThreads == 6);
+}
+
+TEST_CASE("loadConfig: reads client command flood cap", "[server][config]") {
+    TempConfigFile file("[server]\nmax_client_commands_per_tick = 8\n", "flood_cap.toml");
+    CommandLineArgs args;
+    args.configPath = file.path();
+    REQUIRE(loadConfig(args).maxClientCommandsPerTick == 8);
+}
+
+TEST_CASE("loadConfig: reads snapshot compression", "[server][config]") {
+    TempConfigFile file("[network]\nsnapshot_compression = false\n", "network.toml");
+    CommandLineArgs args;
+    args.configPath = file.path();
+    REQUIRE_FALSE(loadConfig(args).snapshotCompression);
+
+    args.configPath = "nonexistent_12345.toml";
+    REQUIRE(loadConfig(args).snapshotCompression);
+}
+
+TEST_CASE("loadConfig: reads and validates snapshot budget", "[server][config]") {
+    TempConfigFile file("[network]\nsnapshot_budget = 16384\n", "snapshot_budget.toml");
+    CommandLineArgs args;
+    args.configPath = file.path();
+    REQUIRE(loadConfig(args).snapshotBudget == 16384);
+
+    TempConfigFile tiny("[network]\nsnapshot_budget = 100\n", "snapshot_budget_tiny.toml");
+    args.configPath = tiny.path();
+    REQUIRE_THROWS_AS(loadConfig(args), std::runtime_error);
+
+    args.configPath = "nonexistent_12345.toml";
+    REQUIRE(loadConfig(args).snapshotBudget == DEFAULT_SNAPSHOT_BUDGET);
+}
+
+TEST_CASE("loadConfig: reads async logging options", "[server][config]") {
+    TempConfigFile file("[logging]\nmode = \"sync\"\nqueue_size = 1024\noverflow = \"block\"\n");
+    CommandLineArgs args;
+    args.configPath = file.path();
+    auto cfg = loadConfig(args);
+    REQUIRE(cfg.logMode == LogMode::Sync);
+    REQUIRE(cfg.logQueueSize == 1024);
+    REQUIRE(cfg.logOverflow == void_crew::LogOverflowPolicy::Block);
+}
+
+TEST_CASE("loadConfig: log queue size must be positive and bounded", "[server][config]") {
+    CommandLineArgs args;
+    for (const auto *size : {"0", "-1", "1048577"}) {
+        TempConfigFile file(std::string("[logging]\nqueue_size = ") + size + "\n", "bad_queue_size.toml");
+        args.configPath = file.path();
+        REQUIRE_THROWS_AS(loadConfig(args), std::runtime_error);
+    }
+
+    TempConfigFile largest("[logging]\nqueue_size = " + std::to_string(MAX_LOG_QUEUE_SIZE) + "\n",
+                           "max_queue_size.toml");
+    args.configPath = largest.path();
+    REQUIRE(loadConfig(args).logQueueSize == MAX_LOG_QUEUE_SIZE);
+}
+
+TEST_CASE("loadConfig: reads profiling options", "[server][config]") {
+    TempConfigFile file("[profiling]\nenabled = false\ntrace_file = \"logs/trace.json\"\n", "profiling.toml");
+    CommandLineArgs args;
+    args.configPath = file.path();
+    auto cfg = loadConfig(args);
+    REQUIRE_FALSE(cfg.profiling);
+    REQUIRE(cfg.profileTraceFile == "logs/trace.json");
+}
+
+TEST_CASE("loadConfig: invalid logging mode or overflow throws", "[server][config]") {
+    TempConfigFile badMode("[logging]\nmode = \"later\"\n", "bad_mode.toml");
+    CommandLineArgs args;
+    args.configPath = badMode.path();
+    REQUIRE_THROWS_AS(loadConfig(args), std::runtime_error);
+
+    TempConfigFile badOverflow("[logging]\noverflow = \"explode\"\n", "bad_overflow.toml");
+    args.configPath = badOverflow.path();
+    REQUIRE_THROWS_AS(loadConfig(args), std::runtime_error);
+}
+
 TEST_CASE("loadConfig: CLI --port overrides TOML", "[server][config]") {
     TempConfigFile file("[server]\nport = 30000\n");
     CommandLineArgs args;
@@ -162,3 +287,79 @@ TEST_CASE("wasSignalReceived: false before any signal", "[server][signal]") {
     // The default-initialized atomic is false, verified by the function
     REQUIRE_FALSE(wasSignalReceived());
 }
+
+// --- record and replay ---
+
+namespace {
+
+constexpr uint64_t REPLAY_TEST_TICKS = 30;
+
+ServerConfig headlessConfig() {
+    ServerConfig config;
+    config.headless = true;
+    config.runMode = RunMode::Batch;
+    config.maxTicks = REPLAY_TEST_TICKS;
+    config.workerThreads = 1;
+    config.worldSeed = 0x5EED;
+    config.profiling = false;
+    return config;
+}
+
+// A few moving entities and a system that steers them from the tick's
+// commands, so the recorded input decides the state the replay must reach.
+void populate(Server &server) {
+    server.systems().addSystem("steer", SystemAccess{}.writes<Velocity>(), [](entt::registry &registry, float) {
+        for (const auto &command : registry.ctx().get<TickInput>().commands) {
+            for (auto entity : registry.view<Velocity>()) {
+                registry.patch<Velocity>(entity, [&](Velocity &velocity) {
+                    velocity.linear.x = static_cast<float>(command.sequence);
+                });
+            }
+        }
+    });
+    auto &registry = server.registry();
+    for (uint32_t i = 0; i < 4; ++i) {
+        auto entity = registry.create();
+        registry.emplace<NetworkId>(entity, i + 1);
+        registry.emplace<Transform>(entity, Transform{.position = {static_cast<float>(i), 0.0f, 0.0f}});
+        registry.emplace<Velocity>(entity);
+    }
+}
+
+} // namespace
+
+TEST_CASE("Server: a headless recording replays to the same state hash", "[server][replay]") {
+    auto path = (std::filesystem::temp_directory_path() / "void_crew_test_server.vcr").string();
+    {
+        auto config = headlessConfig();
+        config.recordFile = path;
+        Server server(config);
+        REQUIRE(server.network() == nullptr);
+        populate(server);
+        auto producer = server.commands().producer(1);
+        REQUIRE(producer.push(ClientCommand{.sequence = 3}));
+        REQUIRE(producer.push(ClientCommand{.sequence = 5}));
+        server.run();
+    }
+
+    auto recording = loadRecording(path);
+    std::filesystem::remove(path);
+    REQUIRE(recording.ticks.size() == REPLAY_TEST_TICKS);
+    REQUIRE(recording.commands.size() == 2);
+    REQUIRE(recording.ticks.front().stateHash != recording.ticks.back().stateHash);
+
+    // Two headless servers side by side: neither binds a port.
+    Server replayed(headlessConfig());
+    Server tampered(headlessConfig());
+    populate(replayed);
+    populate(tampered);
+
+    auto report = replayed.replay(recording);
+    REQUIRE(report.ticks == REPLAY_TEST_TICKS);
+    REQUIRE_FALSE(report.firstDivergedTick);
+    REQUIRE(report.finalHash == recording.ticks.back().stateHash);
+
+    recording.commands.back().sequence = 4;
+    auto diverged = tampered.replay(recording);
+    REQUIRE(diverged.firstDivergedTick == recording.ticks.front().tick);
+}
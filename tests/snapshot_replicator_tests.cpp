@@ -0,0 +1,283 @@
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "delta_snapshot.hpp"
+#include "network_service.hpp"
+#include "protocol.hpp"
+#include "snapshot_replicator.hpp"
+#include "timer.hpp"
+#include "udp_transport.hpp"
+
+using namespace void_crew;
+using namespace void_crew::server;
+
+namespace {
+
+WorldState movingWorld(uint64_t tick, uint32_t count) {
+    WorldState state;
+    state.tick = tick;
+    for (uint32_t id = 1; id <= count; ++id) {
+        EntityState entity;
+        entity.id = id;
+        entity.position = {static_cast<float>(id), 0.0f, 0.0f};
+        state.entities.push_back(entity);
+    }
+    // One entity moves every tick; the rest stand still.
+    state.entities[0].position.y = static_cast<float>(tick);
+    return state;
+}
+
+/// A client transport feeding a SnapshotReceiver and acking what it decodes.
+struct TestClient {
+    explicit TestClient(Endpoint server)
+        : transport({.local = Endpoint::loopback(0), .acceptConnections = false},
+                    {.onConnect = {},
+                     .onDisconnect = {},
+                     .onMessage =
+                         [this](ConnectionId, std::span<const std::byte> message, Delivery) {
+                             if (!dropSnapshots) {
+                                 receiver.onFragment(message);
+                             }
+                         }}),
+          link(*transport.connect(server)) {}
+
+    void pump() {
+        transport.receive();
+        if (auto tick = receiver.takeAck()) {
+            std::array<std::byte, 16> ack{};
+            transport.sendUnreliable(link, std::span(ack).first(encodeSnapshotAck(*tick, ack)));
+        }
+        transport.flush();
+    }
+
+    UdpTransport transport;
+    ConnectionId link;
+    SnapshotReceiver receiver;
+    bool dropSnapshots = false;
+};
+
+/// Server transport with a replicator; registers every connecting client.
+struct TestServer {
+    explicit TestServer(bool compress = true, std::size_t budget = DEFAULT_SNAPSHOT_BUDGET)
+        : replicator({.compress = compress, .budgetBytes = budget}),
+          transport({.local = Endpoint::loopback(0), .maxConnections = 8},
+                    {.onConnect =
+                         [this](ConnectionId id, Endpoint) {
+                             replicator.addClient(id);
+                             clients.push_back(id);
+                         },
+                     .onDisconnect = {},
+                     .onMessage =
+                         [this](ConnectionId id, std::span<const std::byte> message, Delivery) {
+                             if (auto tick = decodeSnapshotAck(message)) {
+                                 replicator.onAck(id, *tick);
+                             }
+                         }}) {}
+
+    /// Publishes @p state, sends it and lets @p client decode and ack it.
+    void step(WorldState state, TestClient &client) {
+        replicator.pushState(state);
+        replicator.sendSnapshots(transport);
+        transport.flush();
+        for (int i = 0; i < 3; ++i) {
+            client.pump();
+            transport.receive();
+        }
+    }
+
+    SnapshotReplicator replicator;
+    UdpTransport transport;
+    std::vector<ConnectionId> clients;
+};
+
+void connect(TestServer &server, TestClient &client) {
+    Timer timer;
+    while (server.clients.empty() && timer.elapsedSeconds() < 2.0) {
+        client.pump();
+        server.transport.receive();
+    }
+    REQUIRE(server.clients.size() == 1);
+}
+
+} // namespace
+
+TEST_CASE("Protocol: snapshot fragment headers and acks round-trip", "[server][net][delta]") {
+    SnapshotFragmentHeader header;
+    header.tick = 0x0102030405060708;
+    header.baselineTick = 42;
+    header.hasBaseline = true;
+    header.compressed = true;
+    header.index = 2;
+    header.count = 3;
+    header.rawSize = 123456;
+
+    std::array<std::byte, SNAPSHOT_FRAGMENT_HEADER_SIZE> buffer{};
+    REQUIRE(encodeSnapshotFragmentHeader(header, buffer) == SNAPSHOT_FRAGMENT_HEADER_SIZE);
+    REQUIRE(messageType(buffer) == MessageType::SnapshotFragment);
+
+    auto decoded = decodeSnapshotFragmentHeader(buffer);
+    REQUIRE(decoded.has_value());
+    REQUIRE(decoded->tick == header.tick);
+    REQUIRE(decoded->baselineTick == 42);
+    REQUIRE(decoded->hasBaseline);
+    REQUIRE(decoded->compressed);
+    REQUIRE(decoded->index == 2);
+    REQUIRE(decoded->count == 3);
+    REQUIRE(decoded->rawSize == 123456);
+
+    buffer[18] = std::byte{3}; // index == count
+    REQUIRE_FALSE(decodeSnapshotFragmentHeader(buffer).has_value());
+
+    std::array<std::byte, 16> ack{};
+    auto size = encodeSnapshotAck(77, ack);
+    REQUIRE(messageType(std::span(ack).first(size)) == MessageType::SnapshotAck);
+    REQUIRE(decodeSnapshotAck(std::span(ack).first(size)) == 77u);
+    REQUIRE_FALSE(decodeSnapshotAck(std::span(ack).first(size - 1)).has_value());
+}
+
+TEST_CASE("SnapshotReplicator: acked baselines shrink snapshots to deltas", "[server][net][delta]") {
+    TestServer server(false);
+    TestClient client(server.transport.localEndpoint());
+    connect(server, client);
+    auto id = server.clients[0];
+
+    server.step(movingWorld(1, 200), client);
+    REQUIRE(client.receiver.latest() != nullptr);
+    REQUIRE(client.receiver.latest()->entities == movingWorld(1, 200).entities);
+    REQUIRE(server.replicator.ackedTick(id) == 1u);
+    auto fullBytes = server.replicator.stats().payloadBytes;
+
+    for (uint64_t tick = 2; tick <= 10; ++tick) {
+        server.step(movingWorld(tick, 200), client);
+        REQUIRE(client.receiver.latest()->tick == tick);
+        REQUIRE(client.receiver.latest()->entities == movingWorld(tick, 200).entities);
+    }
+
+    auto stats = server.replicator.stats();
+    REQUIRE(stats.snapshotsSent == 10);
+    REQUIRE(stats.fullSnapshots == 1);
+    REQUIRE(stats.payloadBytes - fullBytes < fullBytes / 10); // nine deltas cost less than a tenth of one full
+    REQUIRE(server.replicator.ackedTick(id) == 10u);
+    REQUIRE(client.receiver.stats().decoded == 10);
+}
+
+TEST_CASE("SnapshotReplicator: large snapshots fragment and LZ4 shrinks them", "[server][net][delta]") {
+    for (bool compress : {false, true}) {
+        TestServer server(compress, 64 * 1024); // room for the whole world in one snapshot
+        TestClient client(server.transport.localEndpoint());
+        connect(server, client);
+
+        auto world = movingWorld(1, 2000);
+        server.step(world, client);
+
+        auto stats = server.replicator.stats();
+        REQUIRE(client.receiver.latest() != nullptr);
+        REQUIRE(client.receiver.latest()->entities == movingWorld(1, 2000).entities);
+        if (compress) {
+            REQUIRE(stats.payloadBytes < stats.deltaBytes);
+        } else {
+            REQUIRE(stats.payloadBytes == stats.deltaBytes);
+            REQUIRE(stats.fragmentsSent > 1);
+        }
+    }
+}
+
+TEST_CASE("SnapshotReceiver: lost baseline and stale snapshots are not applied", "[server][net][delta]") {
+    TestServer server(false);
+    TestClient client(server.transport.localEndpoint());
+    connect(server, client);
+    auto id = server.clients[0];
+
+    server.step(movingWorld(1, 10), client);
+    REQUIRE(client.receiver.latest()->tick == 1);
+
+    // The client never sees tick 2, but an ack for it (spoofed or reordered
+    // from an old session) makes the server delta against it.
+    client.dropSnapshots = true;
+    server.step(movingWorld(2, 10), client);
+    client.dropSnapshots = false;
+    server.replicator.onAck(id, 2);
+    server.step(movingWorld(3, 10), client);
+    REQUIRE(client.receiver.stats().missingBaseline == 1);
+    REQUIRE(client.receiver.latest()->tick == 1);
+
+    // Acks beyond the newest state are ignored.
+    server.replicator.onAck(id, 99);
+    REQUIRE(server.replicator.ackedTick(id) == 2u);
+}
+
+TEST_CASE("SnapshotReceiver: fragments of one tick with different headers are rejected", "[server][net][delta]") {
+    SnapshotFragmentHeader header;
+    header.tick = 5;
+    header.count = 2;
+    header.rawSize = 2 * SNAPSHOT_FRAGMENT_PAYLOAD;
+    std::vector<std::byte> message(SNAPSHOT_FRAGMENT_HEADER_SIZE + SNAPSHOT_FRAGMENT_PAYLOAD);
+
+    SnapshotReceiver receiver;
+    encodeSnapshotFragmentHeader(header, message);
+    REQUIRE_FALSE(receiver.onFragment(message));
+
+    // Same tick and count, but compressed: stitching the two would decode garbage.
+    header.index = 1;
+    header.compressed = true;
+    encodeSnapshotFragmentHeader(header, message);
+    REQUIRE_FALSE(receiver.onFragment(message));
+    REQUIRE(receiver.stats().corrupt == 1);
+    REQUIRE(receiver.latest() == nullptr);
+}
+
+TEST_CASE("SnapshotReplicator: per-client views replace the shared world", "[server][net][delta]") {
+    TestServer server(false);
+    TestClient client(server.transport.localEndpoint());
+    connect(server, client);
+    auto id = server.clients[0];
+
+    server.step(movingWorld(1, 20), client);
+    REQUIRE(client.receiver.latest()->entities.size() == 20);
+
+    // From tick 2 the client only sees the first five entities; the rest are
+    // removed by a delta against what it was sent, not a new full snapshot.
+    for (uint64_t tick = 2; tick <= 4; ++tick) {
+        ClientView view;
+        view.client = id;
+        view.state = movingWorld(tick, 5);
+        server.replicator.pushView(view);
+        server.step(movingWorld(tick, 20), client);
+        REQUIRE(client.receiver.latest()->tick == tick);
+        REQUIRE(client.receiver.latest()->entities == movingWorld(tick, 5).entities);
+    }
+    REQUIRE(server.replicator.stats().fullSnapshots == 1);
+    REQUIRE(server.replicator.ackedTick(id) == 4u);
+
+    server.step(movingWorld(5, 20), client); // no view for tick 5: back to the shared world
+    REQUIRE(client.receiver.latest()->entities == movingWorld(5, 20).entities);
+    REQUIRE(server.replicator.stats().fullSnapshots == 1);
+}
+
+TEST_CASE("NetworkService: published world state reaches clients as deltas", "[server][net][delta]") {
+    CommandQueue queue;
+    NetworkService service({.local = Endpoint::loopback(0), .maxConnections = 4}, queue);
+    service.start();
+    TestClient client(service.localEndpoint());
+
+    Timer timer;
+    uint64_t tick = 0;
+    while ((client.receiver.stats().decoded < 20) && timer.elapsedSeconds() < 3.0) {
+        auto state = movingWorld(++tick, 50);
+        service.publishWorldState(state);
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        client.pump();
+    }
+    service.stop();
+
+    REQUIRE(client.receiver.stats().decoded >= 20);
+    REQUIRE(client.receiver.latest()->entities[0].position.y == static_cast<float>(client.receiver.latest()->tick));
+    auto stats = service.replicationStats();
+    REQUIRE(stats.fullSnapshots < stats.snapshotsSent);
+}
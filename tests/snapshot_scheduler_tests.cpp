@@ -0,0 +1,266 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <random>
+#include <span>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "delta_snapshot.hpp"
+#include "protocol.hpp"
+#include "snapshot_replicator.hpp"
+#include "snapshot_scheduler.hpp"
+
+using namespace void_crew;
+using namespace void_crew::server;
+
+namespace {
+
+constexpr ConnectionId CLIENT = 1;
+
+/// Entities spread along +x one metre apart, all moving every tick while
+/// @p moving, standing still otherwise.
+WorldState lineWorld(uint64_t tick, uint32_t count, bool moving = true) {
+    WorldState state;
+    state.tick = tick;
+    for (uint32_t id = 1; id <= count; ++id) {
+        EntityState entity;
+        entity.id = id;
+        entity.position = {static_cast<float>(id), moving ? 0.01f * static_cast<float>(tick) : 0.0f, 0.0f};
+        state.entities.push_back(entity);
+    }
+    return state;
+}
+
+/// One client behind a link with fixed latency (in ticks), seeded random
+/// loss and a byte cap per tick. Fragments go to a SnapshotReceiver; its
+/// acks come back to the replicator with the same latency.
+class SimulatedLink final : public SnapshotLink {
+public:
+    SimulatedLink(SnapshotReplicator &replicator, uint64_t latencyTicks, double loss,
+                  std::size_t bytesPerTick = SIZE_MAX, double rttSeconds = 0.05)
+        : m_replicator(replicator),
+          m_latency(latencyTicks),
+          m_loss(loss),
+          m_bytesPerTick(bytesPerTick),
+          m_rtt(rttSeconds) {}
+
+    bool send(ConnectionId, std::span<const std::byte> message) override {
+        if (auto header = decodeSnapshotFragmentHeader(message)) {
+            maxRawSize = std::max<std::size_t>(maxRawSize, header->rawSize);
+        }
+        m_sentThisTick += message.size();
+        if (m_sentThisTick > m_bytesPerTick || m_dice(m_random) < m_loss) {
+            ++dropped;
+            return true; // the sender cannot tell
+        }
+        m_inFlight.push_back({m_now + m_latency, {message.begin(), message.end()}});
+        return true;
+    }
+
+    double rtt(ConnectionId) const override { return m_rtt; }
+
+    /// Advances one tick: delivers due fragments and acks.
+    void advance() {
+        ++m_now;
+        m_sentThisTick = 0;
+        while (!m_inFlight.empty() && m_inFlight.front().due <= m_now) {
+            receiver.onFragment(m_inFlight.front().bytes);
+            m_inFlight.pop_front();
+        }
+        if (auto tick = receiver.takeAck()) {
+            m_acks.push_back({m_now + m_latency, *tick});
+        }
+        while (!m_acks.empty() && m_acks.front().due <= m_now) {
+            m_replicator.onAck(CLIENT, m_acks.front().tick);
+            m_acks.pop_front();
+        }
+    }
+
+    SnapshotReceiver receiver;
+    std::size_t maxRawSize = 0;
+    std::size_t dropped = 0;
+
+private:
+    struct Fragment {
+        uint64_t due = 0;
+        std::vector<std::byte> bytes;
+    };
+    struct Ack {
+        uint64_t due = 0;
+        uint64_t tick = 0;
+    };
+
+    SnapshotReplicator &m_replicator;
+    uint64_t m_latency;
+    double m_loss;
+    std::size_t m_bytesPerTick;
+    double m_rtt;
+    uint64_t m_now = 0;
+    std::size_t m_sentThisTick = 0;
+    std::deque<Fragment> m_inFlight;
+    std::deque<Ack> m_acks;
+    std::minstd_rand m_random{12345};
+    std::uniform_real_distribution<double> m_dice{0.0, 1.0};
+};
+
+/// Pushes @p state as the client's view seen from the origin, sends and
+/// advances the link.
+void step(SnapshotReplicator &replicator, SimulatedLink &link, WorldState state) {
+    ClientView view;
+    view.client = CLIENT;
+    view.state = std::move(state);
+    view.hasViewpoint = true;
+    replicator.pushView(view);
+    replicator.sendSnapshots(link);
+    link.advance();
+}
+
+} // namespace
+
+TEST_CASE("SnapshotScheduler: budget bounds snapshots and near entities update more often", "[server][net][budget]") {
+    constexpr std::size_t BUDGET = 1024;
+    constexpr uint32_t ENTITIES = 300;
+    SnapshotReplicator replicator({.compress = false, .budgetBytes = BUDGET});
+    replicator.addClient(CLIENT);
+    SimulatedLink link(replicator, 2, 0.0);
+
+    std::vector<uint32_t> updates(ENTITIES + 1, 0);
+    std::vector<float> lastSeen(ENTITIES + 1, -1.0f);
+    for (uint64_t tick = 1; tick <= 300; ++tick) {
+        step(replicator, link, lineWorld(tick, ENTITIES));
+        if (const auto *latest = link.receiver.latest()) {
+            for (const auto &entity : latest->entities) {
+                if (entity.position.y != lastSeen[entity.id]) {
+                    lastSeen[entity.id] = entity.position.y;
+                    ++updates[entity.id];
+                }
+            }
+        }
+    }
+
+    // The estimate ignores byte rounding and wide id gaps; a few bytes over is fine.
+    REQUIRE(link.maxRawSize <= BUDGET + BUDGET / 16);
+    REQUIRE(replicator.stats().deferredUpdates > 0);
+
+    uint32_t near = 0;
+    uint32_t far = 0;
+    for (uint32_t id = 1; id <= 30; ++id) {
+        near += updates[id];
+        far += updates[ENTITIES + 1 - id];
+        REQUIRE(updates[ENTITIES + 1 - id] > 1); // far entities still get through
+    }
+    REQUIRE(near > 2 * far);
+}
+
+TEST_CASE("SnapshotScheduler: a lossy, tight link converges once motion stops", "[server][net][budget]") {
+    constexpr uint32_t ENTITIES = 200;
+    SnapshotReplicator replicator({.compress = true, .budgetBytes = MIN_SNAPSHOT_BUDGET});
+    replicator.addClient(CLIENT);
+    SimulatedLink link(replicator, 3, 0.1);
+
+    uint64_t tick = 1;
+    for (; tick <= 60; ++tick) {
+        step(replicator, link, lineWorld(tick, ENTITIES));
+    }
+    for (; tick <= 400; ++tick) {
+        step(replicator, link, lineWorld(tick, ENTITIES, false));
+    }
+
+    REQUIRE(link.dropped > 0);
+    REQUIRE(link.receiver.latest() != nullptr);
+    REQUIRE(link.receiver.latest()->entities == lineWorld(tick, ENTITIES, false).entities);
+    REQUIRE(link.receiver.stats().missingBaseline == 0);
+}
+
+TEST_CASE("SnapshotScheduler: the budget backs off behind a bottleneck", "[server][net][budget]") {
+    constexpr std::size_t BUDGET = 8192;
+    SnapshotReplicator replicator({.compress = false, .budgetBytes = BUDGET});
+    replicator.addClient(CLIENT);
+    REQUIRE(replicator.budget(CLIENT) == BUDGET);
+    REQUIRE(replicator.budget(CLIENT + 1) == 0);
+
+    // A 2 KB/tick bottleneck drops whole snapshots whenever the budget overshoots it.
+    SimulatedLink link(replicator, 2, 0.0, 2048);
+    uint64_t tick = 1;
+    for (; tick <= 600; ++tick) {
+        step(replicator, link, lineWorld(tick, 1000));
+    }
+    REQUIRE(link.dropped > 0);
+    REQUIRE(replicator.budget(CLIENT) < BUDGET);
+    REQUIRE(replicator.budget(CLIENT) >= MIN_SNAPSHOT_BUDGET);
+}
+
+TEST_CASE("BandwidthEstimator: loss and RTT inflation shrink the budget, a clean link grows it",
+          "[server][net][budget]") {
+    BandwidthEstimator estimator(512, 4096);
+    REQUIRE(estimator.budget() == 4096);
+
+    uint64_t tick = 0;
+    auto run = [&](int ticks, int lossEvery, double rtt) {
+        for (int i = 0; i < ticks; ++i) {
+            estimator.onSent(++tick);
+            if (lossEvery == 0 || tick % lossEvery != 0) {
+                estimator.onAcked(tick);
+            }
+            estimator.update(rtt);
+        }
+    };
+
+    run(64, 5, 0.05); // 20% loss
+    REQUIRE(estimator.lossRate() > BandwidthEstimator::LOSS_THRESHOLD);
+    auto lossy = estimator.budget();
+    REQUIRE(lossy < 4096);
+
+    run(2000, 0, 0.05);
+    REQUIRE(estimator.lossRate() == 0.0);
+    REQUIRE(estimator.budget() == 4096);
+
+    run(64, 0, 0.3); // queueing: RTT six times its minimum
+    REQUIRE(estimator.budget() < 4096);
+
+    run(10000, 2, 0.05);
+    REQUIRE(estimator.budget() == 512);
+}
+
+TEST_CASE("PriorityAccumulator: deferred entities accumulate priority until sent", "[server][net][budget]") {
+    WorldState target = lineWorld(1, 3);
+    std::vector<float> relevance{1.0f, 0.5f, 0.1f};
+    ViewContext context{.relevance = relevance, .viewpoint = glm::vec3(0.0f), .hasViewpoint = false};
+
+    // Room for exactly one new entity per tick.
+    auto oneEntity = (estimateEntryBits(nullptr, &target.entities[0]) + 1 + 7) / 8;
+    PriorityAccumulator accumulator;
+    WorldState sent;
+    WorldState out;
+
+    auto result = accumulator.schedule(nullptr, nullptr, target, context, oneEntity, out);
+    REQUIRE(result.selected == 1);
+    REQUIRE(result.deferred == 2);
+    REQUIRE_FALSE(result.overBudget);
+    REQUIRE(out.entities.size() == 1);
+    REQUIRE(out.entities[0].id == 1); // most relevant first
+    REQUIRE(accumulator.priority(1) == 0.0f);
+    auto second = accumulator.priority(2);
+    auto third = accumulator.priority(3);
+    REQUIRE(second > third);
+    REQUIRE(third > 0.0f);
+
+    // Entity 1 is acked; the other two keep growing until each gets its turn.
+    sent = out;
+    result = accumulator.schedule(&sent, &sent, target, context, oneEntity, out);
+    REQUIRE(result.selected == 1);
+    REQUIRE(out.entities.size() == 2);
+    REQUIRE(out.entities[1].id == 2);
+    REQUIRE(accumulator.priority(2) == 0.0f);
+    REQUIRE(accumulator.priority(3) > third);
+
+    // Unacked, entity 2 is repeated against the old baseline and leaves no room.
+    auto previous = sent;
+    sent = out;
+    result = accumulator.schedule(&previous, &sent, target, context, oneEntity, out);
+    REQUIRE(result.selected == 0);
+    REQUIRE(out.entities.size() == 2);
+}
@@ -0,0 +1,106 @@
+#include <cstdint>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+#include <entt/entt.hpp>
+
+#include "components.hpp"
+#include "snapshot.hpp"
+
+using namespace void_crew;
+
+namespace {
+
+entt::entity spawn(entt::registry& registry, uint32_t id, float x) {
+    auto entity = registry.create();
+    registry.emplace<NetworkId>(entity, id);
+    registry.emplace<Transform>(entity, Transform{{x, 2.0f, 3.0f}, {0.0f, 0.0f, 0.0f, 1.0f}}); // rotation (w, x, y, z)
+    return entity;
+}
+
+} // namespace
+
+TEST_CASE("SnapshotBuilder: transforms and velocities read back in place", "[snapshot]") {
+    entt::registry registry;
+    spawn(registry, 10, 1.0f);
+    auto moving = spawn(registry, 11, 5.0f);
+    registry.emplace<Velocity>(moving, Velocity{{1.0f, 0.0f, 0.0f}, {0.0f, 0.5f, 0.0f}});
+
+    SnapshotBuilder builder;
+    auto bytes = builder.build(registry, 77);
+    REQUIRE_FALSE(bytes.empty());
+
+    const auto* snapshot = readSnapshot(bytes);
+    REQUIRE(snapshot != nullptr);
+    REQUIRE(snapshot->tick() == 77);
+    REQUIRE(snapshot->transforms()->size() == 2);
+    REQUIRE(snapshot->velocities()->size() == 1);
+
+    float xById[2] = {};
+    for (const auto* transform : *snapshot->transforms()) {
+        REQUIRE((transform->id() == 10 || transform->id() == 11));
+        xById[transform->id() - 10] = transform->position().x();
+        REQUIRE(transform->position().y() == 2.0f);
+        REQUIRE(transform->rotation().z() == 1.0f);
+        REQUIRE(transform->rotation().w() == 0.0f);
+    }
+    REQUIRE(xById[0] == 1.0f);
+    REQUIRE(xById[1] == 5.0f);
+
+    const auto* velocity = snapshot->velocities()->Get(0);
+    REQUIRE(velocity->id() == 11);
+    REQUIRE(velocity->linear().x() == 1.0f);
+    REQUIRE(velocity->angular().y() == 0.5f);
+}
+
+TEST_CASE("SnapshotBuilder: entities without NetworkId are not replicated", "[snapshot]") {
+    entt::registry registry;
+    spawn(registry, 1, 0.0f);
+    auto local = registry.create();
+    registry.emplace<Transform>(local);
+    registry.emplace<Velocity>(local);
+
+    SnapshotBuilder builder;
+    const auto* snapshot = readSnapshot(builder.build(registry, 1));
+    REQUIRE(snapshot != nullptr);
+    REQUIRE(snapshot->transforms()->size() == 1);
+    REQUIRE(snapshot->velocities()->size() == 0);
+}
+
+TEST_CASE("SnapshotBuilder: reuses its buffer across builds", "[snapshot]") {
+    entt::registry registry;
+    for (uint32_t id = 0; id < 100; ++id) {
+        spawn(registry, id, static_cast<float>(id));
+    }
+
+    SnapshotBuilder builder;
+    REQUIRE(builder.data().empty());
+    builder.reserve(1000);
+
+    auto first = builder.build(registry, 1);
+    auto firstSize = first.size();
+    auto second = builder.build(registry, 2);
+    REQUIRE(second.size() == firstSize);
+    REQUIRE(second.data() == first.data()); // same arena, same layout
+    REQUIRE(readSnapshot(builder.data())->tick() == 2);
+
+    registry.clear();
+    const auto* empty = readSnapshot(builder.build(registry, 3));
+    REQUIRE(empty != nullptr);
+    REQUIRE(empty->transforms()->size() == 0);
+}
+
+TEST_CASE("readSnapshot: rejects truncated and foreign buffers", "[snapshot]") {
+    entt::registry registry;
+    spawn(registry, 1, 0.0f);
+    SnapshotBuilder builder;
+    auto bytes = builder.build(registry, 5);
+
+    std::vector<uint8_t> copy(bytes.begin(), bytes.end());
+    REQUIRE(readSnapshot(copy) != nullptr);
+    REQUIRE(readSnapshot(std::span(copy).first(copy.size() / 2)) == nullptr);
+    REQUIRE(readSnapshot({}) == nullptr);
+
+    copy[4] ^= 0xFF; // file identifier
+    REQUIRE(readSnapshot(copy) == nullptr);
+}
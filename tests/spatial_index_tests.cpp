@@ -0,0 +1,150 @@
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <random>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+#include <entt/entt.hpp>
+
+#include "components.hpp"
+#include "spatial_index.hpp"
+
+using namespace void_crew;
+using namespace void_crew::server;
+
+namespace {
+
+entt::entity place(entt::registry &registry, glm::vec3 position) {
+    auto entity = registry.create();
+    registry.emplace<Transform>(entity, Transform{position});
+    return entity;
+}
+
+std::vector<entt::entity> sorted(std::vector<entt::entity> entities) {
+    std::sort(entities.begin(), entities.end());
+    return entities;
+}
+
+/// Random cloud around the origin, including negative coordinates and
+/// points exactly on cell boundaries.
+std::vector<entt::entity> scatter(entt::registry &registry, std::size_t count) {
+    std::minstd_rand random(42);
+    std::uniform_real_distribution<float> coordinate(-50.0f, 50.0f);
+    std::vector<entt::entity> entities;
+    for (std::size_t i = 0; i < count; ++i) {
+        glm::vec3 position{coordinate(random), coordinate(random), coordinate(random)};
+        if (i % 10 == 0) {
+            position.x = std::floor(position.x / DEFAULT_SPATIAL_CELL_SIZE) * DEFAULT_SPATIAL_CELL_SIZE;
+        }
+        entities.push_back(place(registry, position));
+    }
+    return entities;
+}
+
+float distance2(entt::registry &registry, entt::entity entity, glm::vec3 center) {
+    auto d = registry.get<Transform>(entity).position - center;
+    return glm::dot(d, d);
+}
+
+} // namespace
+
+TEST_CASE("SpatialIndex: radius and box queries match brute force", "[server][spatial]") {
+    entt::registry registry;
+    auto entities = scatter(registry, 2000);
+    SpatialIndex index(registry);
+    REQUIRE(index.size() == 2000);
+
+    std::vector<entt::entity> found;
+    for (glm::vec3 center : {glm::vec3{0.0f}, glm::vec3{-12.0f, 8.0f, 40.0f}, glm::vec3{49.0f, -49.0f, 0.0f}}) {
+        for (float radius : {0.0f, 3.0f, 10.0f, 200.0f}) {
+            std::vector<entt::entity> expected;
+            for (auto entity : entities) {
+                if (distance2(registry, entity, center) <= radius * radius) {
+                    expected.push_back(entity);
+                }
+            }
+            index.radius(center, radius, found);
+            REQUIRE(sorted(found) == sorted(expected));
+        }
+    }
+
+    Aabb box{{-20.0f, -4.0f, 0.0f}, {8.0f, 4.0f, 50.0f}};
+    std::vector<entt::entity> expected;
+    for (auto entity : entities) {
+        auto p = registry.get<Transform>(entity).position;
+        if (p.x >= box.min.x && p.x <= box.max.x && p.y >= box.min.y && p.y <= box.max.y && p.z >= box.min.z &&
+            p.z <= box.max.z) {
+            expected.push_back(entity);
+        }
+    }
+    index.box(box, found);
+    REQUIRE_FALSE(found.empty());
+    REQUIRE(sorted(found) == sorted(expected));
+
+    index.radius({0.0f, 0.0f, 0.0f}, -1.0f, found);
+    REQUIRE(found.empty());
+}
+
+TEST_CASE("SpatialIndex: nearest returns the k closest, nearest first", "[server][spatial]") {
+    entt::registry registry;
+    auto entities = scatter(registry, 1000);
+    SpatialIndex index(registry);
+
+    std::vector<entt::entity> found;
+    for (glm::vec3 center : {glm::vec3{0.0f}, glm::vec3{30.0f, -30.0f, 10.0f}, glm::vec3{500.0f, 0.0f, 0.0f}}) {
+        for (std::size_t k : {1u, 8u, 50u}) {
+            auto expected = entities;
+            std::sort(expected.begin(), expected.end(), [&](entt::entity lhs, entt::entity rhs) {
+                return distance2(registry, lhs, center) < distance2(registry, rhs, center);
+            });
+            expected.resize(k);
+
+            index.nearest(center, k, found);
+            REQUIRE(found.size() == k);
+            for (std::size_t i = 0; i < k; ++i) {
+                REQUIRE(distance2(registry, found[i], center) == distance2(registry, expected[i], center));
+            }
+        }
+    }
+
+    index.nearest({0.0f, 0.0f, 0.0f}, 5000, found);
+    REQUIRE(found.size() == 1000);
+    index.nearest({0.0f, 0.0f, 0.0f}, 0, found);
+    REQUIRE(found.empty());
+}
+
+TEST_CASE("SpatialIndex: follows patches, removals and in-place writes", "[server][spatial]") {
+    entt::registry registry;
+    auto early = place(registry, {1.0f, 1.0f, 1.0f});
+    SpatialIndex index(registry); // picks up entities that already exist
+    auto late = place(registry, {2.0f, 1.0f, 1.0f});
+    REQUIRE(index.size() == 2);
+
+    std::vector<entt::entity> found;
+    index.radius({1.5f, 1.0f, 1.0f}, 1.0f, found);
+    REQUIRE(found.size() == 2);
+
+    // Across several cells, then within one.
+    registry.patch<Transform>(late, [](Transform &t) { t.position = {-30.0f, 5.0f, 9.0f}; });
+    index.radius({1.5f, 1.0f, 1.0f}, 1.0f, found);
+    REQUIRE(found == std::vector<entt::entity>{early});
+    registry.patch<Transform>(late, [](Transform &t) { t.position.x += 0.1f; });
+    index.radius({-29.9f, 5.0f, 9.0f}, 0.01f, found);
+    REQUIRE(found == std::vector<entt::entity>{late});
+
+    // Written behind the index's back: stale until refreshed.
+    registry.get<Transform>(early).position = {100.0f, 0.0f, 0.0f};
+    index.radius({100.0f, 0.0f, 0.0f}, 1.0f, found);
+    REQUIRE(found.empty());
+    index.refresh(early);
+    index.radius({100.0f, 0.0f, 0.0f}, 1.0f, found);
+    REQUIRE(found == std::vector<entt::entity>{early});
+
+    registry.remove<Transform>(early);
+    registry.destroy(late);
+    REQUIRE(index.size() == 0);
+    REQUIRE(index.cellCount() == 0);
+    index.nearest({0.0f, 0.0f, 0.0f}, 3, found);
+    REQUIRE(found.empty());
+}
@@ -0,0 +1,351 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+#include <entt/entt.hpp>
+
+#include "system_scheduler.hpp"
+
+using namespace void_crew::server;
+
+namespace {
+
+struct Health {
+    float value = 0.0f;
+};
+
+struct Oxygen {
+    float value = 0.0f;
+};
+
+struct Power {
+    float value = 0.0f;
+};
+
+} // namespace
+
+// --- SystemAccess ---
+
+TEST_CASE("SystemAccess: shared reads do not conflict", "[server][systems]") {
+    auto a = SystemAccess{}.reads<Health, Oxygen>();
+    auto b = SystemAccess{}.reads<Health>();
+    REQUIRE_FALSE(a.conflictsWith(b));
+    REQUIRE_FALSE(b.conflictsWith(a));
+}
+
+TEST_CASE("SystemAccess: write conflicts with read and write of same pool", "[server][systems]") {
+    auto writer = SystemAccess{}.writes<Health>();
+    auto reader = SystemAccess{}.reads<Health>();
+    auto otherWriter = SystemAccess{}.writes<Health>();
+    REQUIRE(writer.conflictsWith(reader));
+    REQUIRE(reader.conflictsWith(writer));
+    REQUIRE(writer.conflictsWith(otherWriter));
+}
+
+TEST_CASE("SystemAccess: disjoint writes do not conflict", "[server][systems]") {
+    auto a = SystemAccess{}.writes<Health>();
+    auto b = SystemAccess{}.writes<Oxygen>().reads<Power>();
+    REQUIRE_FALSE(a.conflictsWith(b));
+}
+
+TEST_CASE("SystemAccess: exclusive conflicts with everything", "[server][systems]") {
+    auto exclusive = SystemAccess{}.exclusive();
+    auto empty = SystemAccess{};
+    REQUIRE(exclusive.conflictsWith(empty));
+    REQUIRE(empty.conflictsWith(exclusive));
+}
+
+// --- SystemScheduler ---
+
+TEST_CASE("SystemScheduler: runs every system once with dt", "[server][systems]") {
+    SystemScheduler scheduler(2);
+    entt::registry registry;
+    std::atomic<int> calls{0};
+    std::atomic<bool> dtMatches{true};
+
+    for (int i = 0; i < 4; ++i) {
+        scheduler.addSystem("s" + std::to_string(i), SystemAccess{}, [&](entt::registry &, float dt) {
+            calls++;
+            if (dt != 0.5f) {
+                dtMatches = false;
+            }
+        });
+    }
+
+    scheduler.update(registry, 0.5f);
+    REQUIRE(calls == 4);
+    REQUIRE(dtMatches);
+    REQUIRE(scheduler.systemCount() == 4);
+}
+
+TEST_CASE("SystemScheduler: conflicting systems keep registration order", "[server][systems]") {
+    SystemScheduler scheduler(4);
+    entt::registry registry;
+    std::mutex orderMutex;
+    std::vector<std::string> order;
+
+    auto record = [&](std::string name) {
+        return [&, name](entt::registry &, float) {
+            std::lock_guard lock(orderMutex);
+            order.push_back(name);
+        };
+    };
+
+    scheduler.addSystem("produce", SystemAccess{}.writes<Oxygen>(), record("produce"));
+    scheduler.addSystem("unrelated", SystemAccess{}.writes<Power>(), record("unrelated"));
+    scheduler.addSystem("consume", SystemAccess{}.reads<Oxygen>().writes<Health>(), record("consume"));
+    scheduler.addSystem("damage", SystemAccess{}.writes<Health>(), record("damage"));
+
+    for (int i = 0; i < 20; ++i) {
+        order.clear();
+        scheduler.update(registry, 0.016f);
+
+        auto position = [&](const std::string &name) { return std::find(order.begin(), order.end(), name); };
+        REQUIRE(order.size() == 4);
+        REQUIRE(position("produce") < position("consume"));
+        REQUIRE(position("consume") < position("damage"));
+    }
+}
+
+TEST_CASE("SystemScheduler: independent systems run concurrently", "[server][systems]") {
+    SystemScheduler scheduler(2);
+    entt::registry registry;
+    std::atomic<int> arrived{0};
+    std::atomic<bool> overlapped{true};
+
+    // Each system waits for the other to start; this only completes quickly
+    // if both are in flight at the same time.
+    auto rendezvous = [&](entt::registry &, float) {
+        arrived++;
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+        while (arrived.load() < 2) {
+            if (std::chrono::steady_clock::now() > deadline) {
+                overlapped = false;
+                return;
+            }
+            std::this_thread::yield();
+        }
+    };
+
+    scheduler.addSystem("a", SystemAccess{}.writes<Health>(), rendezvous);
+    scheduler.addSystem("b", SystemAccess{}.writes<Oxygen>(), rendezvous);
+    scheduler.update(registry, 0.016f);
+
+    REQUIRE(overlapped);
+}
+
+TEST_CASE("SystemScheduler: writers of pools with update listeners never overlap", "[server][systems]") {
+    // A listener on two pools with state shared between them, like
+    // ComponentLayout or WorldChecksum; it is not safe to call concurrently.
+    struct SharedListener {
+        std::atomic<int> inside{0};
+        std::atomic<bool> overlapped{false};
+        std::vector<entt::entity> changed;
+
+        void onChanged(entt::registry &, entt::entity entity) {
+            if (inside.fetch_add(1) != 0) {
+                overlapped = true;
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+            changed.push_back(entity);
+            inside.fetch_sub(1);
+        }
+    };
+
+    SystemScheduler scheduler(2);
+    entt::registry registry;
+    SharedListener listener;
+    registry.on_update<Health>().connect<&SharedListener::onChanged>(listener);
+    registry.on_update<Oxygen>().connect<&SharedListener::onChanged>(listener);
+    for (int i = 0; i < 8; ++i) {
+        auto entity = registry.create();
+        registry.emplace<Health>(entity);
+        registry.emplace<Oxygen>(entity);
+    }
+
+    // Disjoint pools by their declared access alone.
+    scheduler.addSystem("heal", SystemAccess{}.writes<Health>(), [](entt::registry &r, float) {
+        for (auto entity : r.view<Health>()) {
+            r.patch<Health>(entity, [](Health &health) { health.value += 1.0f; });
+        }
+    });
+    scheduler.addSystem("breathe", SystemAccess{}.writes<Oxygen>(), [](entt::registry &r, float) {
+        for (auto entity : r.view<Oxygen>()) {
+            r.patch<Oxygen>(entity, [](Oxygen &oxygen) { oxygen.value -= 1.0f; });
+        }
+    });
+
+    for (int i = 0; i < 5; ++i) {
+        scheduler.update(registry, 0.016f);
+    }
+    REQUIRE_FALSE(listener.overlapped);
+    REQUIRE(listener.changed.size() == 5 * 16);
+
+    registry.on_update<Health>().disconnect(listener);
+    registry.on_update<Oxygen>().disconnect(listener);
+}
+
+TEST_CASE("SystemScheduler: disabled systems are skipped", "[server][systems]") {
+    SystemScheduler scheduler(2);
+    entt::registry registry;
+    int aCalls = 0;
+    int bCalls = 0;
+
+    auto a = scheduler.addSystem("a", SystemAccess{}.writes<Health>(), [&](entt::registry &, float) { aCalls++; });
+    scheduler.addSystem("b", SystemAccess{}.writes<Oxygen>(), [&](entt::registry &, float) { bCalls++; });
+
+    scheduler.setEnabled(a, false);
+    REQUIRE_FALSE(scheduler.isEnabled(a));
+    scheduler.update(registry, 0.016f);
+    REQUIRE(aCalls == 0);
+    REQUIRE(bCalls == 1);
+
+    scheduler.setEnabled(a, true);
+    scheduler.update(registry, 0.016f);
+    REQUIRE(aCalls == 1);
+    REQUIRE(bCalls == 2);
+}
+
+TEST_CASE("SystemScheduler: divided systems run every Nth update with the summed dt", "[server][systems]") {
+    SystemScheduler scheduler(2);
+    entt::registry registry;
+    std::vector<float> slowDts;
+    int fastCalls = 0;
+
+    auto slow = scheduler.addSystem("needs", SystemAccess{}.writes<Health>(),
+                                    [&](entt::registry &, float dt) { slowDts.push_back(dt); }, 4);
+    scheduler.addSystem("movement", SystemAccess{}.writes<Oxygen>(), [&](entt::registry &, float) { fastCalls++; });
+    REQUIRE(scheduler.rateDivisor(slow) == 4);
+
+    for (int i = 0; i < 12; ++i) {
+        scheduler.update(registry, 0.25f);
+    }
+    REQUIRE(fastCalls == 12);
+    REQUIRE(slowDts.size() == 3);
+    REQUIRE(slowDts[1] == 1.0f);
+    REQUIRE(slowDts[2] == 1.0f);
+    REQUIRE(scheduler.durations(slow).count() == 3);
+
+    // Disabled time is not owed: the first run after re-enabling covers only
+    // the updates since then.
+    scheduler.setEnabled(slow, false);
+    for (int i = 0; i < 8; ++i) {
+        scheduler.update(registry, 0.25f);
+    }
+    scheduler.setEnabled(slow, true);
+    for (int i = 0; i < 4; ++i) {
+        scheduler.update(registry, 0.25f);
+    }
+    REQUIRE(slowDts.size() == 4);
+    REQUIRE(slowDts.back() <= 1.0f);
+
+    REQUIRE_THROWS_AS(scheduler.addSystem("never", SystemAccess{}, [](entt::registry &, float) {}, 0),
+                      std::invalid_argument);
+}
+
+TEST_CASE("SystemScheduler: slow systems are staggered across ticks", "[server][systems]") {
+    SystemScheduler scheduler(2);
+    entt::registry registry;
+    std::atomic<int> ranThisTick{0};
+    auto count = [&](entt::registry &, float) { ranThisTick++; };
+
+    // Four systems at 1/4 and two at 1/2 fit with at most two per tick; four
+    // at 1/30 then take ticks of their own.
+    std::vector<SystemScheduler::SystemId> ids;
+    for (int i = 0; i < 4; ++i) {
+        ids.push_back(scheduler.addSystem("quarter" + std::to_string(i), SystemAccess{}, count, 4));
+    }
+    for (int i = 0; i < 2; ++i) {
+        ids.push_back(scheduler.addSystem("half" + std::to_string(i), SystemAccess{}, count, 2));
+    }
+    for (int i = 0; i < 4; ++i) {
+        ids.push_back(scheduler.addSystem("slow" + std::to_string(i), SystemAccess{}, count, 30));
+    }
+    REQUIRE(scheduler.phase(ids[0]) != scheduler.phase(ids[1]));
+    REQUIRE(scheduler.phase(ids[4]) != scheduler.phase(ids[5]));
+
+    int busiest = 0;
+    int total = 0;
+    for (int tick = 0; tick < 60; ++tick) {
+        ranThisTick = 0;
+        scheduler.update(registry, 1.0f / 60.0f);
+        busiest = std::max(busiest, ranThisTick.load());
+        total += ranThisTick;
+    }
+    REQUIRE(total == 4 * 15 + 2 * 30 + 4 * 2);
+    REQUIRE(busiest == 3);
+}
+
+TEST_CASE("SystemScheduler: systems mutate registry components", "[server][systems]") {
+    SystemScheduler scheduler(2);
+    entt::registry registry;
+    for (int i = 0; i < 100; ++i) {
+        auto e = registry.create();
+        registry.emplace<Health>(e, 10.0f);
+        registry.emplace<Oxygen>(e, 1.0f);
+    }
+
+    auto suffocateAccess = SystemAccess{}.reads<Oxygen>().writes<Health>();
+    scheduler.addSystem("suffocate", suffocateAccess, [](entt::registry &reg, float dt) {
+        for (auto [entity, health, oxygen] : reg.view<Health, const Oxygen>().each()) {
+            health.value -= oxygen.value * dt;
+        }
+    });
+    scheduler.addSystem("breathe", SystemAccess{}.writes<Oxygen>(), [](entt::registry &reg, float) {
+        for (auto [entity, oxygen] : reg.view<Oxygen>().each()) {
+            oxygen.value = 0.0f;
+        }
+    });
+
+    scheduler.update(registry, 1.0f);
+    scheduler.update(registry, 1.0f);
+
+    for (auto [entity, health] : registry.view<Health>().each()) {
+        REQUIRE(health.value == 9.0f);
+    }
+}
+
+TEST_CASE("SystemScheduler: records per-system durations", "[server][systems]") {
+    SystemScheduler scheduler(2);
+    entt::registry registry;
+    auto slow = scheduler.addSystem("slow", SystemAccess{}.writes<Health>(), [](entt::registry &, float) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    });
+    auto fast = scheduler.addSystem("fast", SystemAccess{}.writes<Oxygen>(), [](entt::registry &, float) {});
+
+    scheduler.update(registry, 0.016f);
+    scheduler.update(registry, 0.016f);
+
+    REQUIRE(scheduler.lastDuration(slow) >= 0.005);
+    REQUIRE(scheduler.lastDuration(fast) < scheduler.lastDuration(slow));
+    REQUIRE(scheduler.durations(slow).count() == 2);
+    REQUIRE(scheduler.durations(fast).count() == 2);
+
+    scheduler.setEnabled(slow, false);
+    scheduler.update(registry, 0.016f);
+    REQUIRE(scheduler.lastDuration(slow) == 0.0);
+    REQUIRE(scheduler.durations(slow).count() == 2);
+}
+
+TEST_CASE("SystemScheduler: system exception surfaces from update", "[server][systems]") {
+    SystemScheduler scheduler(2);
+    entt::registry registry;
+    scheduler.addSystem("ok", SystemAccess{}.writes<Health>(), [](entt::registry &, float) {});
+    scheduler.addSystem("broken", SystemAccess{}.writes<Oxygen>(), [](entt::registry &, float) {
+        throw std::runtime_error("boom");
+    });
+
+    REQUIRE_THROWS_AS(scheduler.update(registry, 0.016f), std::runtime_error);
+}
+
+TEST_CASE("SystemScheduler: unknown system id throws", "[server][systems]") {
+    SystemScheduler scheduler(1);
+    REQUIRE_THROWS_AS(scheduler.setEnabled(42, false), std::out_of_range);
+    REQUIRE_THROWS_AS(scheduler.lastDuration(42), std::out_of_range);
+}
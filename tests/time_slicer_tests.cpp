@@ -0,0 +1,138 @@
+#include <algorithm>
+#include <map>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include <entt/entt.hpp>
+
+#include "components.hpp"
+#include "time_slicer.hpp"
+#include "timer.hpp"
+
+using namespace void_crew;
+using namespace void_crew::server;
+using Catch::Matchers::WithinRel;
+
+namespace {
+
+constexpr float DT = 1.0f / 60.0f;
+
+struct Creature {};
+
+std::vector<entt::entity> spawn(entt::registry &registry, int count, const glm::vec3 &position) {
+    std::vector<entt::entity> creatures;
+    for (int i = 0; i < count; ++i) {
+        auto entity = registry.create();
+        registry.emplace<Creature>(entity);
+        registry.emplace<Transform>(entity, Transform{position});
+        creatures.push_back(entity);
+    }
+    return creatures;
+}
+
+} // namespace
+
+TEST_CASE("TimeSlicer: rotates through every entity and hands over the owed dt", "[server][slicing]") {
+    entt::registry registry;
+    auto creatures = spawn(registry, 10, glm::vec3{0.0f});
+    TimeSlicer slicer(TimeSlicerConfig{.budgetSeconds = 0.0, .minPerUpdate = 2});
+
+    std::map<entt::entity, std::vector<float>> calls;
+    auto record = [&](entt::entity entity, float dt) { calls[entity].push_back(dt); };
+
+    for (int tick = 0; tick < 5; ++tick) {
+        slicer.update<Creature>(registry, DT, record);
+        REQUIRE(slicer.stats().processed == 2);
+    }
+    REQUIRE(calls.size() == 10);
+    for (const auto &[entity, dts] : calls) {
+        REQUIRE(dts.size() == 1);
+    }
+
+    // Over a longer run nothing is lost: what was handed over plus what is
+    // still owed is the time that passed.
+    for (int tick = 5; tick < 60; ++tick) {
+        slicer.update<Creature>(registry, DT, record);
+    }
+    for (auto entity : creatures) {
+        float handed = 0.0f;
+        for (float dt : calls[entity]) {
+            handed += dt;
+        }
+        REQUIRE_THAT(handed + slicer.pendingDt(entity), WithinRel(60 * DT, 1e-4f));
+        REQUIRE(calls[entity].size() >= 11);
+    }
+    REQUIRE(slicer.stats().maxPendingDt <= 5 * DT + 1e-6f);
+}
+
+TEST_CASE("TimeSlicer: creatures near players are updated more often, the rest still are", "[server][slicing]") {
+    entt::registry registry;
+    auto near = spawn(registry, 20, {2.0f, 0.0f, 0.0f});
+    auto far = spawn(registry, 20, {500.0f, 0.0f, 0.0f});
+    TimeSlicer slicer(TimeSlicerConfig{.budgetSeconds = 0.0, .minPerUpdate = 4});
+    std::vector<glm::vec3> players{{0.0f, 0.0f, 0.0f}};
+    slicer.setFocus(players);
+
+    std::map<entt::entity, int> calls;
+    for (int tick = 0; tick < 600; ++tick) {
+        slicer.update<Creature>(registry, DT, [&](entt::entity entity, float) { ++calls[entity]; });
+    }
+    auto count = [&](const std::vector<entt::entity> &group) {
+        int total = 0;
+        int fewest = 1 << 30;
+        for (auto entity : group) {
+            total += calls[entity];
+            fewest = std::min(fewest, calls[entity]);
+        }
+        return std::pair{total, fewest};
+    };
+    auto [nearTotal, nearFewest] = count(near);
+    auto [farTotal, farFewest] = count(far);
+    REQUIRE(nearTotal + farTotal == 600 * 4);
+    REQUIRE(nearTotal > 3 * farTotal);
+    REQUIRE(nearFewest > 0);
+    REQUIRE(farFewest > 0); // nobody starves
+    REQUIRE(slicer.stats().maxPendingDt < 2.0f);
+}
+
+TEST_CASE("TimeSlicer: the budget caps the work and departed entities are forgotten", "[server][slicing]") {
+    entt::registry registry;
+    auto creatures = spawn(registry, 200, glm::vec3{0.0f});
+    TimeSlicer slicer(TimeSlicerConfig{.budgetSeconds = 0.002});
+    auto think = [](entt::entity, float) {
+        Timer busy;
+        while (busy.elapsedSeconds() < 0.0002) {
+        }
+    };
+
+    for (int tick = 0; tick < 10; ++tick) {
+        slicer.update<Creature>(registry, DT, think);
+        REQUIRE(slicer.stats().processed >= 1);
+        REQUIRE(slicer.stats().processed < 50);
+    }
+    REQUIRE(slicer.stats().considered == 200);
+    REQUIRE(slicer.stats().costPerEntity >= 0.0002);
+
+    // Destroyed creatures leave the slicer's books.
+    auto gone = creatures[0];
+    for (std::size_t i = 0; i < 100; ++i) {
+        registry.destroy(creatures[i]);
+    }
+    slicer.update<Creature>(registry, DT, think);
+    REQUIRE(slicer.stats().considered == 100);
+    REQUIRE(slicer.pendingDt(gone) == 0.0f);
+
+    // One creature's turn destroys another: the victim is skipped, not passed on.
+    entt::entity victim = entt::null;
+    bool passedInvalid = false;
+    slicer.update<Creature>(registry, DT, [&](entt::entity entity, float) {
+        passedInvalid = passedInvalid || !registry.valid(entity);
+        if (victim == entt::null) {
+            victim = entity == creatures[150] ? creatures[151] : creatures[150];
+            registry.destroy(victim);
+        }
+    });
+    REQUIRE(slicer.stats().processed == 100); // trivial work: everyone fits
+    REQUIRE_FALSE(passedInvalid);
+}
@@ -0,0 +1,415 @@
+#include <chrono>
+#include <cstring>
+#include <optional>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "network_service.hpp"
+#include "packet_pool.hpp"
+#include "protocol.hpp"
+#include "reliable_channel.hpp"
+#include "timer.hpp"
+#include "udp_socket.hpp"
+#include "udp_transport.hpp"
+
+using namespace void_crew::server;
+
+namespace {
+
+struct SentPacket {
+    PacketHeader header;
+    std::vector<std::pair<uint16_t, std::vector<std::byte>>> reliable;
+};
+
+SentPacket buildPacket(ReliableChannel &channel, double now) {
+    SentPacket packet;
+    packet.header = channel.beginPacket(now);
+    channel.writeDueReliable(now, [&](uint16_t id, std::span<const std::byte> message) {
+        packet.reliable.emplace_back(id, std::vector<std::byte>(message.begin(), message.end()));
+        return true;
+    });
+    return packet;
+}
+
+std::vector<std::byte> bytesOf(uint32_t value) {
+    std::vector<std::byte> bytes(sizeof(value));
+    std::memcpy(bytes.data(), &value, sizeof(value));
+    return bytes;
+}
+
+/// Pumps every transport until @p done returns true or @p timeout expires.
+template <typename Predicate>
+bool pumpUntil(std::vector<UdpTransport *> transports, Predicate done,
+               std::chrono::milliseconds timeout = std::chrono::milliseconds(2000)) {
+    void_crew::Timer timer;
+    while (!done()) {
+        if (timer.elapsedMilliseconds() > static_cast<double>(timeout.count())) {
+            return false;
+        }
+        for (auto *transport : transports) {
+            transport->flush();
+        }
+        for (auto *transport : transports) {
+            transport->receive();
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+TEST_CASE("PacketPool: hands out each buffer once and counts exhaustion", "[server][net]") {
+    PacketPool pool(2);
+    REQUIRE(pool.capacity() == 2);
+
+    auto *first = pool.acquire();
+    auto *second = pool.acquire();
+    REQUIRE(first != nullptr);
+    REQUIRE(second != nullptr);
+    REQUIRE(first != second);
+    REQUIRE(pool.available() == 0);
+
+    REQUIRE(pool.acquire() == nullptr);
+    REQUIRE(pool.exhaustedCount() == 1);
+
+    first->size = 100;
+    pool.release(first);
+    auto *again = pool.acquire();
+    REQUIRE(again == first);
+    REQUIRE(again->size == 0);
+}
+
+TEST_CASE("PacketHeader: round-trips and rejects short input", "[server][net]") {
+    PacketHeader header;
+    header.sequence = 0xBEEF;
+    header.ack = 0x1234;
+    header.ackBits = 0x80000001;
+    header.messageCount = 7;
+
+    std::array<std::byte, PACKET_HEADER_SIZE> bytes{};
+    writePacketHeader(bytes, header);
+    auto parsed = readPacketHeader(bytes);
+    REQUIRE(parsed.has_value());
+    REQUIRE(parsed->protocolId == PROTOCOL_ID);
+    REQUIRE(parsed->sequence == 0xBEEF);
+    REQUIRE(parsed->ack == 0x1234);
+    REQUIRE(parsed->ackBits == 0x80000001);
+    REQUIRE(parsed->messageCount == 7);
+
+    REQUIRE_FALSE(readPacketHeader(std::span(bytes).first(PACKET_HEADER_SIZE - 1)).has_value());
+
+    REQUIRE(sequenceNewer(1, 0));
+    REQUIRE(sequenceNewer(0, 65535));
+    REQUIRE_FALSE(sequenceNewer(65535, 0));
+    REQUIRE_FALSE(sequenceNewer(5, 5));
+}
+
+TEST_CASE("ReliableChannel: delivers in order through loss, reordering and duplicates", "[server][net]") {
+    ReliableChannel sender;
+    ReliableChannel receiver;
+    constexpr uint32_t MESSAGES = 200;
+
+    uint32_t queued = 0;
+    std::vector<uint32_t> delivered;
+    std::optional<SentPacket> delayed;
+    double now = 0.0;
+    std::minstd_rand random(1234); // fixed seed: ~25% loss, ~15% reordered
+
+    for (int round = 0; round < 2000 && delivered.size() < MESSAGES; ++round) {
+        now += 0.02;
+        while (queued < MESSAGES && sender.queueReliable(bytesOf(queued))) {
+            ++queued;
+        }
+
+        auto packet = buildPacket(sender, now);
+        auto fate = random() % 100;
+        std::vector<SentPacket> arriving;
+        if (fate < 25) {
+            // lost
+        } else if (fate < 40) {
+            delayed = packet; // arrives after the next one
+        } else {
+            arriving.push_back(packet);
+            if (delayed) {
+                arriving.push_back(*delayed);
+                arriving.push_back(*delayed); // and twice
+                delayed.reset();
+            }
+        }
+
+        for (const auto &incoming : arriving) {
+            if (!receiver.onPacketReceived(incoming.header, now)) {
+                continue;
+            }
+            for (const auto &[id, payload] : incoming.reliable) {
+                receiver.receiveReliable(id, payload);
+            }
+            receiver.deliverReliable([&](std::span<const std::byte> message) {
+                uint32_t value = 0;
+                std::memcpy(&value, message.data(), sizeof(value));
+                delivered.push_back(value);
+            });
+        }
+
+        auto ack = buildPacket(receiver, now);
+        if (random() % 100 >= 25) {
+            sender.onPacketReceived(ack.header, now);
+        }
+    }
+
+    REQUIRE(delivered.size() == MESSAGES);
+    for (uint32_t i = 0; i < MESSAGES; ++i) {
+        REQUIRE(delivered[i] == i);
+    }
+    REQUIRE(sender.resentMessages() > 0);
+}
+
+TEST_CASE("ReliableChannel: window limits unacked messages and acks free it", "[server][net]") {
+    ReliableChannel sender;
+    ReliableChannel receiver;
+    std::array<std::byte, 4> message{};
+
+    for (std::size_t i = 0; i < ReliableChannel::MESSAGE_WINDOW; ++i) {
+        REQUIRE(sender.queueReliable(message));
+    }
+    REQUIRE_FALSE(sender.queueReliable(message));
+    REQUIRE(sender.unackedReliable() == ReliableChannel::MESSAGE_WINDOW);
+
+    std::array<std::byte, ReliableChannel::MAX_MESSAGE_SIZE + 1> oversized{};
+    ReliableChannel other;
+    REQUIRE_FALSE(other.queueReliable(oversized));
+
+    // Each packet carries at most MAX_MESSAGES_PER_PACKET; ack them all.
+    double now = 1.0;
+    while (sender.hasDueReliable(now)) {
+        auto packet = buildPacket(sender, now);
+        REQUIRE(packet.reliable.size() <= ReliableChannel::MAX_MESSAGES_PER_PACKET);
+        REQUIRE(receiver.onPacketReceived(packet.header, now));
+    }
+    REQUIRE(receiver.ackPending());
+    sender.onPacketReceived(buildPacket(receiver, now + 0.03).header, now + 0.03);
+
+    REQUIRE(sender.unackedReliable() == 0);
+    REQUIRE(sender.queueReliable(message));
+    REQUIRE(sender.rtt() < ReliableChannel::INITIAL_RTT);
+}
+
+TEST_CASE("ReliableChannel: ack bits survive a jump far ahead of the last packet", "[server][net]") {
+    ReliableChannel receiver;
+    PacketHeader header;
+    header.sequence = 10;
+    REQUIRE(receiver.onPacketReceived(header, 0.0));
+
+    header.sequence = 10 + 32; // the old newest lands on the top of the 32 ack bits
+    REQUIRE(receiver.onPacketReceived(header, 0.0));
+    auto ack = receiver.beginPacket(0.0);
+    REQUIRE(ack.ack == header.sequence);
+    REQUIRE(ack.ackBits == uint32_t{1} << 31);
+
+    // After a burst of loss: far more than 64 sequence numbers ahead.
+    header.sequence = static_cast<uint16_t>(header.sequence + 1000);
+    REQUIRE(receiver.onPacketReceived(header, 0.0));
+    ack = receiver.beginPacket(0.0);
+    REQUIRE(ack.ack == header.sequence);
+    REQUIRE(ack.ackBits == 0);
+
+    header.sequence = static_cast<uint16_t>(header.sequence - 1);
+    REQUIRE(receiver.onPacketReceived(header, 0.0));
+    REQUIRE_FALSE(receiver.onPacketReceived(header, 0.0)); // duplicate
+    REQUIRE(receiver.beginPacket(0.0).ackBits == 1);
+}
+
+TEST_CASE("UdpSocket: batch send and receive over loopback", "[server][net]") {
+    UdpSocket server(Endpoint::loopback(0));
+    UdpSocket client(Endpoint::loopback(0));
+    REQUIRE(server.localEndpoint().port != 0);
+
+    constexpr std::size_t COUNT = 32;
+    std::vector<std::array<std::byte, 8>> payloads(COUNT);
+    std::vector<Datagram> outgoing(COUNT);
+    for (std::size_t i = 0; i < COUNT; ++i) {
+        payloads[i].fill(static_cast<std::byte>(i));
+        outgoing[i] = {payloads[i].data(), payloads[i].size(), payloads[i].size(), server.localEndpoint()};
+    }
+    REQUIRE(client.sendBatch(outgoing) == COUNT);
+
+    std::vector<PacketBuffer> buffers(UdpSocket::MAX_BATCH);
+    std::vector<Datagram> incoming(UdpSocket::MAX_BATCH);
+    for (std::size_t i = 0; i < incoming.size(); ++i) {
+        incoming[i] = {buffers[i].data.data(), MAX_PACKET_SIZE, 0, {}};
+    }
+
+    std::size_t received = 0;
+    void_crew::Timer timer;
+    while (received < COUNT && timer.elapsedSeconds() < 2.0) {
+        server.waitReadable(std::chrono::milliseconds(10));
+        auto count = server.receiveBatch(std::span(incoming).first(COUNT - received));
+        for (std::size_t i = 0; i < count; ++i) {
+            REQUIRE(incoming[i].size == 8);
+            REQUIRE(incoming[i].endpoint == client.localEndpoint());
+        }
+        received += count;
+    }
+    REQUIRE(received == COUNT);
+}
+
+TEST_CASE("UdpTransport: twelve clients exchange unreliable and reliable messages", "[server][net]") {
+    constexpr std::size_t CLIENTS = 12;
+    constexpr uint32_t PER_CLIENT = 20;
+
+    std::vector<ConnectionId> connected;
+    std::vector<uint32_t> unreliableReceived;
+    std::vector<std::vector<uint32_t>> reliableReceived(CLIENTS + 1);
+    UdpTransport server({.local = Endpoint::loopback(0), .maxConnections = CLIENTS},
+                        {.onConnect = [&](ConnectionId id, Endpoint) { connected.push_back(id); },
+                         .onDisconnect = {},
+                         .onMessage =
+                             [&](ConnectionId id, std::span<const std::byte> message, Delivery delivery) {
+                                 uint32_t value = 0;
+                                 std::memcpy(&value, message.data(), sizeof(value));
+                                 if (delivery == Delivery::Reliable) {
+                                     reliableReceived[id].push_back(value);
+                                 } else {
+                                     unreliableReceived.push_back(value);
+                                 }
+                             }});
+
+    std::vector<std::unique_ptr<UdpTransport>> clients;
+    std::vector<UdpTransport *> all{&server};
+    for (std::size_t i = 0; i < CLIENTS; ++i) {
+        clients.push_back(std::make_unique<UdpTransport>(
+            TransportConfig{.local = Endpoint::loopback(0), .maxConnections = 1, .acceptConnections = false},
+            TransportCallbacks{}));
+        all.push_back(clients.back().get());
+    }
+
+    std::vector<ConnectionId> links;
+    for (auto &client : clients) {
+        auto link = client->connect(server.localEndpoint());
+        REQUIRE(link.has_value());
+        links.push_back(*link);
+    }
+    REQUIRE(pumpUntil(all, [&]() { return connected.size() == CLIENTS; }));
+    REQUIRE(server.connectionCount() == CLIENTS);
+
+    for (std::size_t i = 0; i < CLIENTS; ++i) {
+        for (uint32_t n = 0; n < PER_CLIENT; ++n) {
+            REQUIRE(clients[i]->sendUnreliable(links[i], bytesOf(n)));
+            REQUIRE(clients[i]->sendReliable(links[i], bytesOf(n)));
+        }
+    }
+
+    auto allReliable = [&]() {
+        for (auto id : connected) {
+            if (reliableReceived[id].size() < PER_CLIENT) {
+                return false;
+            }
+        }
+        return true;
+    };
+    REQUIRE(pumpUntil(all, allReliable));
+
+    // Loopback does not drop, so unreliable traffic arrives as well.
+    REQUIRE(unreliableReceived.size() == CLIENTS * PER_CLIENT);
+    for (auto id : connected) {
+        for (uint32_t n = 0; n < PER_CLIENT; ++n) {
+            REQUIRE(reliableReceived[id][n] == n);
+        }
+    }
+
+    auto stats = server.stats();
+    REQUIRE(stats.packetsReceived >= CLIENTS);
+    REQUIRE(stats.invalidPackets == 0);
+    REQUIRE(stats.poolExhausted == 0);
+}
+
+TEST_CASE("UdpTransport: rejects oversize messages and peers beyond capacity", "[server][net]") {
+    std::size_t disconnects = 0;
+    UdpTransport server({.local = Endpoint::loopback(0), .maxConnections = 1},
+                        {.onConnect = {}, .onDisconnect = [&](ConnectionId) { ++disconnects; }, .onMessage = {}});
+    UdpTransport first({.local = Endpoint::loopback(0), .acceptConnections = false}, {});
+    UdpTransport second({.local = Endpoint::loopback(0), .acceptConnections = false}, {});
+
+    auto link = first.connect(server.localEndpoint());
+    REQUIRE(link.has_value());
+    REQUIRE(second.connect(server.localEndpoint()).has_value());
+
+    std::vector<std::byte> oversized(UdpTransport::MAX_MESSAGE_SIZE + 1);
+    REQUIRE_FALSE(first.sendUnreliable(*link, oversized));
+    REQUIRE_FALSE(first.sendUnreliable(*link + 100, bytesOf(1)));
+
+    REQUIRE(pumpUntil({&server, &first, &second}, [&]() { return server.stats().invalidPackets > 0; }));
+    REQUIRE(server.connectionCount() == 1);
+
+    first.disconnect(*link);
+    REQUIRE_FALSE(first.isConnected(*link));
+    first.flush();
+    REQUIRE(first.connectionCount() == 0);
+    REQUIRE(disconnects == 0); // the server only notices after its timeout
+}
+
+TEST_CASE("Protocol: command messages round-trip", "[server][net]") {
+    ClientCommand command;
+    command.sequence = 0xA1B2C3D4;
+    command.type = 513;
+    command.payloadSize = 3;
+    command.payload[0] = std::byte{1};
+    command.payload[2] = std::byte{3};
+
+    std::array<std::byte, 64> buffer{};
+    auto size = encodeCommand(command, buffer);
+    REQUIRE(size == commandMessageSize(command));
+
+    auto decoded = decodeCommand(std::span(buffer).first(size));
+    REQUIRE(decoded.has_value());
+    REQUIRE(decoded->sequence == command.sequence);
+    REQUIRE(decoded->type == command.type);
+    REQUIRE(decoded->payloadSize == 3);
+    REQUIRE(decoded->payload == command.payload);
+
+    REQUIRE_FALSE(decodeCommand(std::span(buffer).first(size - 1)).has_value());
+    buffer[0] = std::byte{0xFF};
+    REQUIRE_FALSE(decodeCommand(std::span(buffer).first(size)).has_value());
+    REQUIRE(encodeCommand(command, std::span(buffer).first(4)) == 0);
+}
+
+TEST_CASE("NetworkService: decoded commands reach the command queue", "[server][net]") {
+    CommandQueue queue;
+    NetworkService service({.local = Endpoint::loopback(0), .maxConnections = 4}, queue);
+    service.start();
+
+    UdpTransport client({.local = Endpoint::loopback(0), .acceptConnections = false}, {});
+    auto link = client.connect(service.localEndpoint());
+    REQUIRE(link.has_value());
+
+    ClientCommand command;
+    command.type = 9;
+    std::array<std::byte, 64> buffer{};
+    for (uint32_t sequence = 1; sequence <= 5; ++sequence) {
+        command.sequence = sequence;
+        REQUIRE(client.sendReliable(*link, std::span(buffer).first(encodeCommand(command, buffer))));
+    }
+
+    std::vector<ClientCommand> received;
+    void_crew::Timer timer;
+    uint64_t tick = 0;
+    while (received.size() < 5 && timer.elapsedSeconds() < 2.0) {
+        client.flush();
+        client.receive();
+        for (const auto &drained : queue.drain(++tick)) {
+            received.push_back(drained);
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    service.stop();
+
+    REQUIRE(received.size() == 5);
+    for (uint32_t i = 0; i < 5; ++i) {
+        REQUIRE(received[i].sequence == i + 1);
+        REQUIRE(received[i].type == 9);
+    }
+    REQUIRE(service.connectionCount() == 1);
+}
@@ -0,0 +1,124 @@
+#include <array>
+#include <cstdint>
+#include <stdexcept>
+
+#include <catch2/catch_test_macros.hpp>
+#include <entt/entt.hpp>
+
+#include "components.hpp"
+#include "world_checksum.hpp"
+
+using namespace void_crew;
+using namespace void_crew::server;
+
+namespace {
+
+struct Frozen {}; // tag component
+
+void trackAll(WorldChecksum &checksum) {
+    checksum.track<Transform>("transform");
+    checksum.track<Velocity>("velocity");
+    checksum.track<Frozen>("frozen");
+    checksum.track<Door>("door", [](const Door &door) {
+        return std::array<uint32_t, 3>{door.first, door.second, door.open ? 1u : 0u};
+    });
+}
+
+} // namespace
+
+TEST_CASE("WorldChecksum: same state hashes equal whatever the pool order", "[server][checksum]") {
+    entt::registry forward;
+    entt::registry backward;
+    auto a = forward.create();
+    auto b = forward.create();
+    REQUIRE(backward.create() == a);
+    REQUIRE(backward.create() == b);
+
+    forward.emplace<Transform>(a, Transform{{1.0f, 2.0f, 3.0f}});
+    forward.emplace<Transform>(b, Transform{{4.0f, 5.0f, 6.0f}});
+    forward.emplace<Frozen>(b);
+    backward.emplace<Frozen>(b);
+    backward.emplace<Transform>(b, Transform{{4.0f, 5.0f, 6.0f}});
+    backward.emplace<Transform>(a, Transform{{1.0f, 2.0f, 3.0f}});
+
+    WorldChecksum first(forward);
+    WorldChecksum second(backward);
+    trackAll(first);
+    trackAll(second);
+    REQUIRE(first.update() == second.update());
+    REQUIRE(first.poolHash(0) == second.poolHash(0));
+
+    // The same values on swapped entities are a different world.
+    backward.patch<Transform>(a, [](Transform &t) { t.position = {4.0f, 5.0f, 6.0f}; });
+    backward.patch<Transform>(b, [](Transform &t) { t.position = {1.0f, 2.0f, 3.0f}; });
+    REQUIRE(second.update() != first.hash());
+}
+
+TEST_CASE("WorldChecksum: rehashes only changed components and matches a full rehash", "[server][checksum]") {
+    entt::registry registry;
+    WorldChecksum checksum(registry);
+    trackAll(checksum);
+    for (int i = 0; i < 100; ++i) {
+        auto entity = registry.create();
+        registry.emplace<Transform>(entity, Transform{{static_cast<float>(i), 0.0f, 0.0f}});
+        registry.emplace<Velocity>(entity, Velocity{{1.0f, 0.0f, 0.0f}, {}});
+    }
+    auto before = checksum.update();
+    REQUIRE(checksum.stats().pools == 4);
+    REQUIRE(checksum.stats().changedPools == 4);
+    REQUIRE(checksum.stats().rehashedComponents == 200);
+
+    REQUIRE(checksum.update() == before);
+    REQUIRE(checksum.stats().changedPools == 0);
+
+    auto moved = entt::entity{7};
+    registry.patch<Transform>(moved, [](Transform &t) { t.position.y = 0.5f; });
+    auto after = checksum.update();
+    REQUIRE(after != before);
+    REQUIRE(checksum.stats().changedPools == 1);
+    REQUIRE(checksum.stats().rehashedComponents == 1);
+
+    WorldChecksum full(registry);
+    trackAll(full);
+    REQUIRE(full.update() == after);
+
+    registry.patch<Transform>(moved, [](Transform &t) { t.position.y = 0.0f; });
+    REQUIRE(checksum.update() == before);
+    registry.destroy(moved);
+    REQUIRE(checksum.update() != before);
+    REQUIRE(checksum.stats().changedPools == 2);
+    REQUIRE(checksum.stats().rehashedComponents == 0);
+
+    checksum.invalidate();
+    auto rehashed = checksum.update();
+    REQUIRE(checksum.stats().rehashedComponents == 198);
+    REQUIRE(rehashed == full.update());
+}
+
+TEST_CASE("WorldChecksum: projections, tags and writes past the signals", "[server][checksum]") {
+    entt::registry registry;
+    WorldChecksum checksum(registry);
+    trackAll(checksum);
+    auto door = registry.create();
+    registry.emplace<Door>(door, Door{1, 2, false});
+    auto closed = checksum.update();
+
+    registry.patch<Door>(door, [](Door &d) { d.open = true; });
+    auto open = checksum.update();
+    REQUIRE(open != closed);
+
+    registry.emplace<Frozen>(door);
+    REQUIRE(checksum.update() != open);
+    registry.remove<Frozen>(door);
+    REQUIRE(checksum.update() == open);
+
+    // A direct write bypasses the signals until invalidate().
+    registry.get<Door>(door).open = false;
+    REQUIRE(checksum.update() == open);
+    checksum.invalidate();
+    REQUIRE(checksum.update() == closed);
+
+    REQUIRE(checksum.poolName(3) == "door");
+    REQUIRE_THROWS_AS(checksum.poolName(4), std::out_of_range);
+    REQUIRE_THROWS_AS(checksum.poolHash(4), std::out_of_range);
+}